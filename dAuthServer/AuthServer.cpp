@@ -13,6 +13,7 @@
 #include "dConfig.h"
 #include "Diagnostics.h"
 #include "BinaryPathFinder.h"
+#include "TimerHeap.h"
 
 //RakNet includes:
 #include "RakNetDefines.h"
@@ -39,8 +40,9 @@ namespace Game {
 void HandlePacket(Packet* packet);
 
 int main(int argc, char** argv) {
-	constexpr uint32_t authFramerate = mediumFramerate;
-	constexpr uint32_t authFrameDelta = mediumFrameDelta;
+	// Auth only wakes up for packets and timers, but never sleeps longer than this so that it notices signals.
+	constexpr auto maxIdleTime = std::chrono::milliseconds(mediumFrameDelta);
+	constexpr auto noMasterConnectionTimeout = std::chrono::seconds(1);
 	Diagnostics::SetProcessName("Auth");
 	Diagnostics::SetProcessFileName(argv[0]);
 	Diagnostics::Initialize();
@@ -92,67 +94,63 @@ int main(int argc, char** argv) {
 
 	Game::server = new dServer(ourIP, ourPort, 0, maxClients, false, true, Game::logger, masterIP, masterPort, ServerType::Auth, Game::config, &Game::lastSignal);
 
+	AuthPackets::LoadClaimCodes();
+	AuthPackets::StartPasswordWorkers(
+		GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("password_check_threads")).value_or(2),
+		GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("max_pending_logins")).value_or(500));
+
 	//Run it until server gets a kill message from Master:
-	auto t = std::chrono::high_resolution_clock::now();
 	Packet* packet = nullptr;
-	constexpr uint32_t logFlushTime = 30 * authFramerate; // 30 seconds in frames
-	constexpr uint32_t sqlPingTime = 10 * 60 * authFramerate; // 10 minutes in frames
-	uint32_t framesSinceLastFlush = 0;
-	uint32_t framesSinceMasterDisconnect = 0;
-	uint32_t framesSinceLastSQLPing = 0;
-
-	AuthPackets::LoadClaimCodes();
+	TimerHeap timers;
+	auto lastConnectedToMaster = std::chrono::steady_clock::now();
+
+	//Push our log every 30s:
+	timers.Every(std::chrono::seconds(30), []() {
+		AuthPackets::LogLoginQueueStats();
+		Game::logger->Flush();
+	});
+
+	//Every 10 min we ping our sql server to keep it alive hopefully:
+	timers.Every(std::chrono::minutes(10), []() {
+		//Find out the master's IP for absolutely no reason:
+		std::string masterIP;
+		uint32_t masterPort;
+		auto masterInfo = Database::Get()->GetMasterInfo();
+		if (masterInfo) {
+			masterIP = masterInfo->ip;
+			masterPort = masterInfo->port;
+		}
+	});
 
 	Game::logger->Flush(); // once immediately before main loop
 	while (!Game::ShouldShutdown()) {
 		//Check if we're still connected to master:
-		if (!Game::server->GetIsConnectedToMaster()) {
-			framesSinceMasterDisconnect++;
-
-			if (framesSinceMasterDisconnect >= authFramerate) {
-				LOG("No connection to master!");
-				break; //Exit our loop, shut down.
-			}
-		} else framesSinceMasterDisconnect = 0;
-
-		//In world we'd update our other systems here.
+		const auto now = std::chrono::steady_clock::now();
+		if (Game::server->GetIsConnectedToMaster()) lastConnectedToMaster = now;
+		else if (now - lastConnectedToMaster >= noMasterConnectionTimeout) {
+			LOG("No connection to master!");
+			break; //Exit our loop, shut down.
+		}
 
-		//Check for packets here:
-		Game::server->ReceiveFromMaster(); //ReceiveFromMaster also handles the master packets if needed.
-		packet = Game::server->Receive();
-		if (packet) {
+		//Handle everything that arrived since we last woke up:
+		Game::server->HandleMasterPackets();
+		while ((packet = Game::server->Receive())) {
 			HandlePacket(packet);
 			Game::server->DeallocatePacket(packet);
-			packet = nullptr;
 		}
 
-		//Push our log every 30s:
-		if (framesSinceLastFlush >= logFlushTime) {
-			Game::logger->Flush();
-			framesSinceLastFlush = 0;
-		} else framesSinceLastFlush++;
-
-		//Every 10 min we ping our sql server to keep it alive hopefully:
-		if (framesSinceLastSQLPing >= sqlPingTime) {
-			//Find out the master's IP for absolutely no reason:
-			std::string masterIP;
-			uint32_t masterPort;
-			auto masterInfo = Database::Get()->GetMasterInfo();
-			if (masterInfo) {
-				masterIP = masterInfo->ip;
-				masterPort = masterInfo->port;
-			}
+		//Answer the logins whose passwords have been checked:
+		AuthPackets::ProcessPasswordChecks();
 
-			framesSinceLastSQLPing = 0;
-		} else framesSinceLastSQLPing++;
+		timers.RunDue();
 
-		//Sleep our thread since auth can afford to.
-		t += std::chrono::milliseconds(authFrameDelta); //Auth can run at a lower "fps"
-		std::this_thread::sleep_until(t);
+		//Sleep until a packet arrives, a password check finishes or a timer is due:
+		Game::server->WaitForPackets(timers.GetNextDue(std::chrono::steady_clock::now() + maxIdleTime));
 	}
 
 	LOG("Exited Main Loop! (signal %d)", Game::lastSignal);
 	//Delete our objects here:
+	AuthPackets::StopPasswordWorkers();
 	Database::Destroy("AuthServer");
 	delete Game::server;
 	delete Game::logger;
@@ -0,0 +1,150 @@
+#include "AhoCorasick.h"
+
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <queue>
+
+#include "BinaryIO.h"
+
+namespace {
+	constexpr uint32_t NO_STATE = std::numeric_limits<uint32_t>::max();
+
+	// Guards against allocating absurd tables when reading a corrupt file.
+	constexpr uint32_t MAX_STATES = 1U << 24U;
+
+	template<typename T>
+	void WriteVector(std::ostream& stream, const std::vector<T>& values) {
+		BinaryIO::BinaryWrite(stream, static_cast<uint32_t>(values.size()));
+		stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+
+	template<typename T>
+	bool ReadVector(std::istream& stream, std::vector<T>& values, const uint64_t maxSize) {
+		uint32_t size = 0;
+		BinaryIO::BinaryRead(stream, size);
+		if (size > maxSize) return false;
+
+		values.resize(size);
+		stream.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+		return stream.good();
+	}
+};
+
+void AhoCorasick::Build(const std::vector<std::string>& patterns) {
+	Clear();
+	if (std::all_of(patterns.begin(), patterns.end(), [](const std::string& pattern) { return pattern.empty(); })) return;
+
+	for (const auto& pattern : patterns) {
+		for (const auto character : pattern) {
+			auto& charClass = m_CharClasses[static_cast<uint8_t>(character)];
+			if (charClass == 0) charClass = ++m_ClassCount;
+		}
+	}
+	m_ClassCount++; // The class of bytes that are in no pattern.
+
+	// Build the trie, with missing edges marked so they can be filled in below.
+	m_Transitions.assign(m_ClassCount, NO_STATE);
+	m_Accepting.assign(1, 0);
+	for (const auto& pattern : patterns) {
+		if (pattern.empty()) continue;
+
+		uint32_t state = 0;
+		for (const auto character : pattern) {
+			const auto index = state * m_ClassCount + m_CharClasses[static_cast<uint8_t>(character)];
+			if (m_Transitions[index] == NO_STATE) {
+				m_Transitions[index] = m_Accepting.size();
+				m_Transitions.resize(m_Transitions.size() + m_ClassCount, NO_STATE);
+				m_Accepting.push_back(0);
+			}
+			state = m_Transitions[index];
+		}
+		m_Accepting[state] = 1;
+	}
+
+	// Walk the trie breadth first so each state's failure link is final before its children need it,
+	// and replace every missing edge with the edge of the failure state.
+	std::vector<uint32_t> failure(m_Accepting.size(), 0);
+	std::queue<uint32_t> states;
+	for (uint32_t charClass = 0; charClass < m_ClassCount; charClass++) {
+		auto& next = m_Transitions[charClass];
+		if (next == NO_STATE) next = 0;
+		else states.push(next);
+	}
+
+	while (!states.empty()) {
+		const auto state = states.front();
+		states.pop();
+		m_Accepting[state] |= m_Accepting[failure[state]];
+
+		for (uint32_t charClass = 0; charClass < m_ClassCount; charClass++) {
+			auto& next = m_Transitions[state * m_ClassCount + charClass];
+			const auto failureNext = m_Transitions[failure[state] * m_ClassCount + charClass];
+			if (next == NO_STATE) {
+				next = failureNext;
+			} else {
+				failure[next] = failureNext;
+				states.push(next);
+			}
+		}
+	}
+}
+
+bool AhoCorasick::Matches(std::string_view text) const {
+	if (IsEmpty()) return false;
+
+	uint32_t state = 0;
+	for (const auto character : text) {
+		state = m_Transitions[state * m_ClassCount + m_CharClasses[static_cast<uint8_t>(character)]];
+		if (m_Accepting[state]) return true;
+	}
+
+	return false;
+}
+
+void AhoCorasick::Serialize(std::ostream& stream) const {
+	BinaryIO::BinaryWrite(stream, m_CharClasses);
+	BinaryIO::BinaryWrite(stream, m_ClassCount);
+	WriteVector(stream, m_Accepting);
+	WriteVector(stream, m_Transitions);
+}
+
+bool AhoCorasick::Deserialize(std::istream& stream) {
+	Clear();
+
+	const auto isValid = [this, &stream]() {
+		BinaryIO::BinaryRead(stream, m_CharClasses);
+		BinaryIO::BinaryRead(stream, m_ClassCount);
+		if (!stream.good() || m_ClassCount > m_CharClasses.size() + 1) return false;
+		if (!ReadVector(stream, m_Accepting, MAX_STATES)) return false;
+		if (!ReadVector(stream, m_Transitions, static_cast<uint64_t>(m_Accepting.size()) * m_ClassCount)) return false;
+		if (m_Transitions.size() != m_Accepting.size() * m_ClassCount) return false;
+
+		for (const auto charClass : m_CharClasses) {
+			if (charClass >= m_ClassCount && !m_Accepting.empty()) return false;
+		}
+
+		for (const auto next : m_Transitions) {
+			if (next >= m_Accepting.size()) return false;
+		}
+
+		return true;
+	};
+
+	try {
+		if (isValid()) return true;
+	} catch (const std::runtime_error&) {
+		// BinaryRead throws once the stream runs out.
+	}
+
+	Clear();
+	return false;
+}
+
+void AhoCorasick::Clear() {
+	m_CharClasses.fill(0);
+	m_ClassCount = 0;
+	m_Transitions.clear();
+	m_Accepting.clear();
+}
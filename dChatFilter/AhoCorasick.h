@@ -0,0 +1,55 @@
+#ifndef __AHOCORASICK__H__
+#define __AHOCORASICK__H__
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * An Aho-Corasick automaton flattened into a transition table, used to check a word
+ * against every substring rule of the chat filter in a single pass over the word.
+ *
+ * Bytes that do not appear in any pattern share one character class, so the table
+ * only has as many columns as there are distinct characters in the patterns.
+ */
+class AhoCorasick {
+public:
+	/**
+	 * Builds the automaton, replacing whatever was built or read before.
+	 * @param patterns The substrings to look for.  Empty patterns are ignored.
+	 */
+	void Build(const std::vector<std::string>& patterns);
+
+	/**
+	 * @return true if any of the patterns occurs in the text.
+	 */
+	[[nodiscard]] bool Matches(std::string_view text) const;
+
+	[[nodiscard]] bool IsEmpty() const { return m_Accepting.empty(); }
+
+	void Serialize(std::ostream& stream) const;
+
+	/**
+	 * Reads an automaton written by Serialize.
+	 * @return true if the automaton was read and is well formed.  The automaton is left empty otherwise.
+	 */
+	bool Deserialize(std::istream& stream);
+
+private:
+	void Clear();
+
+	// Maps each byte to its column in the transition table.  Column 0 is every byte that is in no pattern.
+	std::array<uint16_t, 256> m_CharClasses{};
+	uint32_t m_ClassCount = 0;
+
+	// The next state for every state and character class, indexed by state * m_ClassCount + class.
+	std::vector<uint32_t> m_Transitions;
+
+	// Whether a pattern ends at each state, including patterns that are a suffix of the state.
+	std::vector<uint8_t> m_Accepting;
+};
+
+#endif  //!__AHOCORASICK__H__
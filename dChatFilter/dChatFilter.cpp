@@ -1,11 +1,10 @@
 #include "dChatFilter.h"
 #include "BinaryIO.h"
+#include <array>
 #include <fstream>
 #include <string>
 #include <functional>
 #include <algorithm>
-#include <sstream>
-#include <regex>
 
 #include "dCommonVars.h"
 #include "Logger.h"
@@ -16,7 +15,25 @@
 
 using namespace dChatFilterDCF;
 
-dChatFilter::dChatFilter(const std::string& filepath, bool dontGenerateDCF) {
+namespace {
+	// How many distinct words keep their verdicts cached.
+	constexpr size_t WORD_CACHE_SIZE = 4096;
+
+	// Maps every byte to its lowercase form, or to 0 if the filter ignores it.
+	constexpr std::array<char, 256> NORMALIZE_TABLE = []() {
+		std::array<char, 256> table{};
+		for (size_t i = 0; i < table.size(); i++) {
+			const auto character = static_cast<char>(i);
+			if (character >= 'A' && character <= 'Z') table[i] = static_cast<char>(character - 'A' + 'a');
+			else table[i] = character;
+		}
+
+		for (const char ignored : { '!', '?', ';', '.', ',' }) table[static_cast<uint8_t>(ignored)] = '\0';
+		return table;
+	}();
+};
+
+dChatFilter::dChatFilter(const std::string& filepath, bool dontGenerateDCF) : m_UserUnapprovedWordCache(WORD_CACHE_SIZE) {
 	m_DontGenerateDCF = dontGenerateDCF;
 
 	if (!BinaryIO::DoesFileExist(filepath + ".dcf") || m_DontGenerateDCF) {
@@ -29,6 +46,9 @@ dChatFilter::dChatFilter(const std::string& filepath, bool dontGenerateDCF) {
 
 	if (BinaryIO::DoesFileExist("blocklist.dcf")) {
 		ReadWordlistDCF("blocklist.dcf", false);
+	} else if (BinaryIO::DoesFileExist("blocklist.txt")) {
+		ReadWordlistPlaintext("blocklist.txt", false);
+		if (!m_DontGenerateDCF) ExportWordlistToDCF("blocklist.dcf", false);
 	}
 
 	//Read player names that are ok as well:
@@ -37,9 +57,12 @@ dChatFilter::dChatFilter(const std::string& filepath, bool dontGenerateDCF) {
 		std::transform(name.begin(), name.end(), name.begin(), ::tolower); //Transform to lowercase
 		m_ApprovedWords.push_back(CalculateHash(name));
 	}
+	SortWordlist(true);
 }
 
 dChatFilter::~dChatFilter() {
+	// Stop the workers before the word lists they read go away.
+	m_Workers.reset();
 	m_ApprovedWords.clear();
 	m_DeniedWords.clear();
 }
@@ -47,13 +70,18 @@ dChatFilter::~dChatFilter() {
 void dChatFilter::ReadWordlistPlaintext(const std::string& filepath, bool allowList) {
 	std::ifstream file(filepath);
 	if (file) {
+		std::vector<std::string> deniedSubstrings;
 		std::string line;
 		while (std::getline(file, line)) {
 			line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
 			std::transform(line.begin(), line.end(), line.begin(), ::tolower); //Transform to lowercase
 			if (allowList) m_ApprovedWords.push_back(CalculateHash(line));
+			else if (line.starts_with('*')) deniedSubstrings.push_back(NormalizeWord(std::string_view(line).substr(1)));
 			else m_DeniedWords.push_back(CalculateHash(line));
 		}
+
+		if (!allowList) m_DeniedSubstringMatcher.Build(deniedSubstrings);
+		SortWordlist(allowList);
 	}
 }
 
@@ -67,18 +95,20 @@ bool dChatFilter::ReadWordlistDCF(const std::string& filepath, bool allowList) {
 			return false;
 		}
 
-		if (hdr.formatVersion == formatVersion) {
+		if (hdr.formatVersion >= minimumFormatVersion && hdr.formatVersion <= formatVersion) {
 			size_t wordsToRead = 0;
 			BinaryIO::BinaryRead(file, wordsToRead);
-			if (allowList) m_ApprovedWords.reserve(wordsToRead);
-			else m_DeniedWords.reserve(wordsToRead);
+			std::vector<size_t> words(wordsToRead);
+			file.read(reinterpret_cast<char*>(words.data()), words.size() * sizeof(size_t));
+			if (!file) return false;
 
-			size_t word = 0;
-			for (size_t i = 0; i < wordsToRead; ++i) {
-				BinaryIO::BinaryRead(file, word);
-				if (allowList) m_ApprovedWords.push_back(word);
-				else m_DeniedWords.push_back(word);
-			}
+			AhoCorasick substringMatcher;
+			if (hdr.formatVersion >= 3 && !substringMatcher.Deserialize(file)) return false;
+
+			auto& wordlist = allowList ? m_ApprovedWords : m_DeniedWords;
+			wordlist.insert(wordlist.end(), words.begin(), words.end());
+			if (!allowList) m_DeniedSubstringMatcher = std::move(substringMatcher);
+			SortWordlist(allowList);
 
 			return true;
 		} else {
@@ -101,6 +131,10 @@ void dChatFilter::ExportWordlistToDCF(const std::string& filepath, bool allowLis
 			BinaryIO::BinaryWrite(file, word);
 		}
 
+		// The allow list has no substring rules, so it gets an empty automaton.
+		if (allowList) AhoCorasick().Serialize(file);
+		else m_DeniedSubstringMatcher.Serialize(file);
+
 		file.close();
 	}
 }
@@ -108,42 +142,83 @@ void dChatFilter::ExportWordlistToDCF(const std::string& filepath, bool allowLis
 std::vector<std::pair<uint8_t, uint8_t>> dChatFilter::IsSentenceOkay(const std::string& message, eGameMasterLevel gmLevel, bool allowList) {
 	if (gmLevel > eGameMasterLevel::FORUM_MODERATOR) return { }; //If anything but a forum mod, return true.
 	if (message.empty()) return { };
-	if (!allowList && m_DeniedWords.empty()) return { { 0, message.length() } };
-
-	std::stringstream sMessage(message);
-	std::string segment;
-	std::regex reg("(!*|\\?*|\\;*|\\.*|\\,*)");
+	if (!allowList && m_DeniedWords.empty() && m_DeniedSubstringMatcher.IsEmpty()) return { { 0, message.length() } };
 
 	std::vector<std::pair<uint8_t, uint8_t>> listOfBadSegments = std::vector<std::pair<uint8_t, uint8_t>>();
 
-	uint32_t position = 0;
+	// Words are separated by single spaces, so two spaces in a row make an empty word.
+	const std::string_view sMessage = message;
+	size_t position = 0;
+	while (position < sMessage.size()) {
+		const auto end = std::min(sMessage.find(' ', position), sMessage.size());
+		const auto segment = sMessage.substr(position, end - position);
 
-	while (std::getline(sMessage, segment, ' ')) {
-		std::string originalSegment = segment;
+		const auto verdict = GetWordVerdict(NormalizeWord(segment));
+		if (verdict & (allowList ? NOT_APPROVED : DENIED)) {
+			listOfBadSegments.emplace_back(position, segment.length());
+		}
 
-		std::transform(segment.begin(), segment.end(), segment.begin(), ::tolower); //Transform to lowercase
-		segment = std::regex_replace(segment, reg, "");
+		position = end + 1;
+	}
 
-		size_t hash = CalculateHash(segment);
+	return listOfBadSegments;
+}
 
-		if (std::find(m_UserUnapprovedWordCache.begin(), m_UserUnapprovedWordCache.end(), hash) != m_UserUnapprovedWordCache.end() && allowList) {
-			listOfBadSegments.emplace_back(position, originalSegment.length());
-		}
+void dChatFilter::StartWorkers(const uint32_t threadCount) {
+	m_Workers = std::make_unique<WorkerPool>(threadCount);
+}
 
-		if (std::find(m_ApprovedWords.begin(), m_ApprovedWords.end(), hash) == m_ApprovedWords.end() && allowList) {
-			m_UserUnapprovedWordCache.push_back(hash);
-			listOfBadSegments.emplace_back(position, originalSegment.length());
-		}
+void dChatFilter::IsSentenceOkayAsync(std::string message, eGameMasterLevel gmLevel, bool allowList, std::function<void(std::vector<std::pair<uint8_t, uint8_t>>)> callback) {
+	if (!m_Workers) {
+		callback(IsSentenceOkay(message, gmLevel, allowList));
+		return;
+	}
 
-		if (std::find(m_DeniedWords.begin(), m_DeniedWords.end(), hash) != m_DeniedWords.end() && !allowList) {
-			m_UserUnapprovedWordCache.push_back(hash);
-			listOfBadSegments.emplace_back(position, originalSegment.length());
-		}
+	m_Workers->Submit(
+		[this, message = std::move(message), gmLevel, allowList]() { return IsSentenceOkay(message, gmLevel, allowList); },
+		std::move(callback)
+	);
+}
 
-		position += originalSegment.length() + 1;
+void dChatFilter::ProcessCompletions() {
+	if (m_Workers) m_Workers->ProcessCompletions();
+}
+
+std::string dChatFilter::NormalizeWord(std::string_view word) {
+	std::string normalized;
+	normalized.reserve(word.size());
+	for (const auto character : word) {
+		const auto normalizedCharacter = NORMALIZE_TABLE[static_cast<uint8_t>(character)];
+		if (normalizedCharacter != '\0') normalized.push_back(normalizedCharacter);
 	}
 
-	return listOfBadSegments;
+	return normalized;
+}
+
+uint8_t dChatFilter::GetWordVerdict(const std::string& word) {
+	const auto hash = CalculateHash(word);
+	{
+		std::lock_guard lock(m_CacheMutex);
+		if (const auto* cached = m_UserUnapprovedWordCache.Find(hash)) return *cached;
+	}
+
+	uint8_t verdict = 0;
+	if (!std::binary_search(m_ApprovedWords.begin(), m_ApprovedWords.end(), hash)) verdict |= NOT_APPROVED;
+	if (std::binary_search(m_DeniedWords.begin(), m_DeniedWords.end(), hash) || m_DeniedSubstringMatcher.Matches(word)) verdict |= DENIED;
+
+	std::lock_guard lock(m_CacheMutex);
+	m_UserUnapprovedWordCache.Insert(hash, verdict);
+	return verdict;
+}
+
+void dChatFilter::SortWordlist(bool allowList) {
+	auto& wordlist = allowList ? m_ApprovedWords : m_DeniedWords;
+	if (!std::is_sorted(wordlist.begin(), wordlist.end())) std::sort(wordlist.begin(), wordlist.end());
+	wordlist.erase(std::unique(wordlist.begin(), wordlist.end()), wordlist.end());
+
+	// Verdicts may have been cached against the old list.
+	std::lock_guard lock(m_CacheMutex);
+	m_UserUnapprovedWordCache.Clear();
 }
 
 size_t dChatFilter::CalculateHash(const std::string& word) {
@@ -1,13 +1,22 @@
 #pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include "dCommonVars.h"
+#include "AhoCorasick.h"
+#include "LruCache.h"
+#include "WorkerPool.h"
 
 enum class eGameMasterLevel : uint8_t;
 namespace dChatFilterDCF {
 	static const uint32_t header = ('D' + ('C' << 8) + ('F' << 16) + ('B' << 24));
-	static const uint32_t formatVersion = 2;
+	// Version 3 appends the substring rule automaton after the word list.  Version 2 files are still read.
+	static const uint32_t formatVersion = 3;
+	static const uint32_t minimumFormatVersion = 2;
 
 	struct fileHeader {
 		uint32_t header;
@@ -21,17 +30,59 @@ public:
 	dChatFilter(const std::string& filepath, bool dontGenerateDCF);
 	~dChatFilter();
 
+	/**
+	 * Reads a plaintext word list, one word per line.
+	 * Lines of a deny list that start with a * are substring rules: any word containing the rest of the line is denied.
+	 */
 	void ReadWordlistPlaintext(const std::string& filepath, bool allowList);
 	bool ReadWordlistDCF(const std::string& filepath, bool allowList);
 	void ExportWordlistToDCF(const std::string& filepath, bool allowList);
 	std::vector<std::pair<uint8_t, uint8_t>> IsSentenceOkay(const std::string& message, eGameMasterLevel gmLevel, bool allowList = true);
 
+	/**
+	 * Moves filtering onto worker threads.  The word lists must not change once this is called.
+	 * @param threadCount How many threads filter messages.  With 0, IsSentenceOkayAsync answers right away.
+	 */
+	void StartWorkers(uint32_t threadCount);
+
+	/**
+	 * Filters a message on a worker thread.
+	 * @param callback Receives the bad segments of the message.  It runs on the thread calling ProcessCompletions,
+	 * in the order the messages were submitted in, so it may touch game state.
+	 */
+	void IsSentenceOkayAsync(std::string message, eGameMasterLevel gmLevel, bool allowList, std::function<void(std::vector<std::pair<uint8_t, uint8_t>>)> callback);
+
+	/**
+	 * Runs the callbacks of every message that has finished filtering.  Called once per tick from the game thread.
+	 */
+	void ProcessCompletions();
+
+	/**
+	 * Lowercases a word and strips the punctuation the filter ignores, in a single pass.
+	 */
+	static std::string NormalizeWord(std::string_view word);
+
 private:
+	// Flags cached for each word a player has used.
+	enum WordVerdict : uint8_t {
+		NOT_APPROVED = 1 << 0,
+		DENIED = 1 << 1,
+	};
+
 	bool m_DontGenerateDCF;
+	// Both word lists are sorted hashes.
 	std::vector<size_t> m_DeniedWords;
 	std::vector<size_t> m_ApprovedWords;
-	std::vector<size_t> m_UserUnapprovedWordCache;
+	// Substring rules of the deny list, built into one automaton.
+	AhoCorasick m_DeniedSubstringMatcher;
+	// The verdicts of recently used words, so repeated words skip the lookups.
+	// The word lists are only read once workers run, so this is the only state that needs a lock.
+	LruCache<size_t, uint8_t> m_UserUnapprovedWordCache;
+	std::mutex m_CacheMutex;
+	std::unique_ptr<WorkerPool> m_Workers;
 
 	//Private functions:
 	size_t CalculateHash(const std::string& word);
+	void SortWordlist(bool allowList);
+	uint8_t GetWordVerdict(const std::string& word);
 };
@@ -34,13 +34,13 @@ void ChatIgnoreList::GetIgnoreList(Packet* packet) {
 	if (!receiver.ignoredPlayers.empty()) {
 		LOG_DEBUG("Player %llu already has an ignore list, but is requesting it again.", playerId);
 	} else {
-		auto ignoreList = Database::Get()->GetIgnoreList(static_cast<uint32_t>(playerId));
+		const auto& ignoreList = Game::playerContainer.GetSocialGraph().GetIgnores(static_cast<uint32_t>(playerId));
 		if (ignoreList.empty()) {
 			LOG_DEBUG("Player %llu has no ignores", playerId);
 			return;
 		}
 
-		for (auto& ignoredPlayer : ignoreList) {
+		for (const auto& ignoredPlayer : ignoreList) {
 			receiver.ignoredPlayers.emplace_back(ignoredPlayer.name, ignoredPlayer.id);
 			GeneralUtils::SetBit(receiver.ignoredPlayers.back().playerId, eObjectBits::CHARACTER);
 			GeneralUtils::SetBit(receiver.ignoredPlayers.back().playerId, eObjectBits::PERSISTENT);
@@ -103,7 +103,7 @@ void ChatIgnoreList::AddIgnore(Packet* packet) {
 		const auto& playerData = Game::playerContainer.GetPlayerData(toIgnoreStr);
 		if (!playerData) {
 			// Fall back to query
-			auto player = Database::Get()->GetCharacterInfo(toIgnoreStr);
+			auto player = Game::playerContainer.GetSocialGraph().GetCharacter(toIgnoreStr);
 			if (!player || player->name != toIgnoreStr) {
 				LOG_DEBUG("Player %s not found", toIgnoreStr.c_str());
 			} else {
@@ -114,7 +114,7 @@ void ChatIgnoreList::AddIgnore(Packet* packet) {
 		}
 
 		if (ignoredPlayerId != LWOOBJID_EMPTY) {
-			Database::Get()->AddIgnore(static_cast<uint32_t>(playerId), static_cast<uint32_t>(ignoredPlayerId));
+			Game::playerContainer.GetSocialGraph().AddIgnore(static_cast<uint32_t>(playerId), { toIgnoreStr, static_cast<uint32_t>(ignoredPlayerId) });
 			GeneralUtils::SetBit(ignoredPlayerId, eObjectBits::CHARACTER);
 			GeneralUtils::SetBit(ignoredPlayerId, eObjectBits::PERSISTENT);
 
@@ -157,7 +157,7 @@ void ChatIgnoreList::RemoveIgnore(Packet* packet) {
 		return;
 	}
 
-	Database::Get()->RemoveIgnore(static_cast<uint32_t>(playerId), static_cast<uint32_t>(toRemove->playerId));
+	Game::playerContainer.GetSocialGraph().RemoveIgnore(static_cast<uint32_t>(playerId), static_cast<uint32_t>(toRemove->playerId));
 	receiver.ignoredPlayers.erase(toRemove, receiver.ignoredPlayers.end());
 
 	CBITSTREAM;
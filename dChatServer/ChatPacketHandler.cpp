@@ -29,7 +29,7 @@ void ChatPacketHandler::HandleFriendlistRequest(Packet* packet) {
 	auto& player = Game::playerContainer.GetPlayerDataMutable(playerID);
 	if (!player) return;
 
-	auto friendsList = Database::Get()->GetFriendsList(playerID);
+	const auto& friendsList = Game::playerContainer.GetSocialGraph().GetFriends(static_cast<uint32_t>(playerID));
 	for (const auto& friendData : friendsList) {
 		FriendData fd;
 		fd.isFTP = false; // not a thing in DLU
@@ -130,7 +130,7 @@ void ChatPacketHandler::HandleFriendRequest(Packet* packet) {
 	// Send the response code that corresponds to what the error is.
 	if (!requestee) {
 		requestee.playerName = playerName;
-		auto responseType = Database::Get()->GetCharacterInfo(playerName)
+		auto responseType = Game::playerContainer.GetSocialGraph().GetCharacter(playerName)
 			? eAddFriendResponseType::NOTONLINE
 			: eAddFriendResponseType::INVALIDCHARACTER;
 
@@ -149,7 +149,7 @@ void ChatPacketHandler::HandleFriendRequest(Packet* packet) {
 
 		uint8_t oldBestFriendStatus{};
 		uint8_t bestFriendStatus{};
-		auto bestFriendInfo = Database::Get()->GetBestFriendStatus(requestorPlayerID, requestee.playerID);
+		auto bestFriendInfo = Game::playerContainer.GetSocialGraph().GetBestFriendStatus(static_cast<uint32_t>(requestorPlayerID), static_cast<uint32_t>(requestee.playerID));
 		if (bestFriendInfo) {
 			// Get the IDs
 			LWOOBJID queryPlayerID = bestFriendInfo->playerCharacterId;
@@ -185,7 +185,7 @@ void ChatPacketHandler::HandleFriendRequest(Packet* packet) {
 				}
 			} else {
 				// Then update the database with this new info.
-				Database::Get()->SetBestFriendStatus(requestorPlayerID, requestee.playerID, bestFriendStatus);
+				Game::playerContainer.GetSocialGraph().SetBestFriendStatus(static_cast<uint32_t>(requestorPlayerID), static_cast<uint32_t>(requestee.playerID), bestFriendStatus);
 				// Sent the best friend update here if the value is 3
 				if (bestFriendStatus == 3U) {
 					requestee.countOfBestFriends += 1;
@@ -286,7 +286,9 @@ void ChatPacketHandler::HandleFriendResponse(Packet* packet) {
 		requesteeData.isFTP = false;
 		requesteeData.isOnline = true;
 
-		Database::Get()->AddFriend(requestor.playerID, requestee.playerID);
+		Game::playerContainer.GetSocialGraph().AddFriend(
+			{ requestor.playerName, static_cast<uint32_t>(requestor.playerID) },
+			{ requestee.playerName, static_cast<uint32_t>(requestee.playerID) });
 	}
 
 	if (serverResponseCode != eAddFriendResponseType::DECLINED) SendFriendResponse(requestor, requestee, serverResponseCode, isAlreadyBestFriends);
@@ -302,10 +304,10 @@ void ChatPacketHandler::HandleRemoveFriend(Packet* packet) {
 	inStream.Read(LUFriendName);
 	auto friendName = LUFriendName.GetAsString();
 
-	//we'll have to query the db here to find the user, since you can delete them while they're offline.
+	//we'll have to look the user up by name, since you can delete them while they're offline.
 	//First, we need to find their ID:
 	LWOOBJID friendID = 0;
-	auto friendIdResult = Database::Get()->GetCharacterInfo(friendName);
+	auto friendIdResult = Game::playerContainer.GetSocialGraph().GetCharacter(friendName);
 	if (friendIdResult) {
 		friendID = friendIdResult->id;
 	}
@@ -314,7 +316,7 @@ void ChatPacketHandler::HandleRemoveFriend(Packet* packet) {
 	GeneralUtils::SetBit(friendID, eObjectBits::PERSISTENT);
 	GeneralUtils::SetBit(friendID, eObjectBits::CHARACTER);
 
-	Database::Get()->RemoveFriend(playerID, friendID);
+	Game::playerContainer.GetSocialGraph().RemoveFriend(static_cast<uint32_t>(playerID), static_cast<uint32_t>(friendID));
 
 	//Now, we need to send an update to notify the sender (and possibly, receiver) that their friendship has been ended:
 	auto& goonA = Game::playerContainer.GetPlayerDataMutable(playerID);
@@ -355,6 +357,13 @@ void ChatPacketHandler::HandleGMLevelUpdate(Packet* packet) {
 	inStream.Read(player.gmLevel);
 }
 
+void ChatPacketHandler::HandleCharacterChanged(Packet* packet) {
+	CINSTREAM_SKIP_HEADER;
+	LWOOBJID characterID;
+	inStream.Read(characterID);
+	Game::playerContainer.GetSocialGraph().Forget(static_cast<uint32_t>(characterID));
+}
+
 
 void ChatPacketHandler::HandleWho(Packet* packet) {
 	CINSTREAM_SKIP_HEADER;
@@ -401,7 +410,7 @@ void ChatPacketHandler::HandleShowAll(Packet* packet) {
 	bitStream.Write<uint8_t>(request.displayIndividualPlayers);
 	bitStream.Write<uint8_t>(request.displayZoneData);
 	if (request.displayZoneData || request.displayIndividualPlayers){
-		for (auto& [playerID, playerData ]: Game::playerContainer.GetAllPlayers()){
+		for (const auto& playerData : Game::playerContainer.GetAllPlayers()){
 			if (!playerData) continue;
 			bitStream.Write<uint8_t>(0); // structure packing
 			if (request.displayIndividualPlayers) bitStream.Write(LUWString(playerData.playerName));
@@ -491,7 +500,7 @@ void ChatPacketHandler::HandlePrivateChatMessage(Packet* packet) {
 	if (!receiver) {
 		PlayerData otherPlayer;
 		otherPlayer.playerName = receiverName;
-		auto responseType = Database::Get()->GetCharacterInfo(receiverName)
+		auto responseType = Game::playerContainer.GetSocialGraph().GetCharacter(receiverName)
 			? eChatMessageResponseCode::NOTONLINE
 			: eChatMessageResponseCode::GENERALERROR;
 
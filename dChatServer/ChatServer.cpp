@@ -13,6 +13,7 @@
 #include "Diagnostics.h"
 #include "AssetManager.h"
 #include "BinaryPathFinder.h"
+#include "TimerHeap.h"
 #include "eConnectionType.h"
 #include "PlayerContainer.h"
 #include "ChatPacketHandler.h"
@@ -42,8 +43,9 @@ namespace Game {
 void HandlePacket(Packet* packet);
 
 int main(int argc, char** argv) {
-	constexpr uint32_t chatFramerate = mediumFramerate;
-	constexpr uint32_t chatFrameDelta = mediumFrameDelta;
+	// Chat only wakes up for packets and timers, but never sleeps longer than this so that it notices signals.
+	constexpr auto maxIdleTime = std::chrono::milliseconds(mediumFrameDelta);
+	constexpr auto noMasterConnectionTimeout = std::chrono::seconds(1);
 	Diagnostics::SetProcessName("Chat");
 	Diagnostics::SetProcessFileName(argv[0]);
 	Diagnostics::Initialize();
@@ -114,59 +116,45 @@ int main(int argc, char** argv) {
 	Game::playerContainer.Initialize();
 
 	//Run it until server gets a kill message from Master:
-	auto t = std::chrono::high_resolution_clock::now();
 	Packet* packet = nullptr;
-	constexpr uint32_t logFlushTime = 30 * chatFramerate; // 30 seconds in frames
-	constexpr uint32_t sqlPingTime = 10 * 60 * chatFramerate; // 10 minutes in frames
-	uint32_t framesSinceLastFlush = 0;
-	uint32_t framesSinceMasterDisconnect = 0;
-	uint32_t framesSinceLastSQLPing = 0;
+	TimerHeap timers;
+	auto lastConnectedToMaster = std::chrono::steady_clock::now();
+
+	//Push our log every 30s:
+	timers.Every(std::chrono::seconds(30), []() { Game::logger->Flush(); });
+
+	//Every 10 min we ping our sql server to keep it alive hopefully:
+	timers.Every(std::chrono::minutes(10), []() {
+		//Find out the master's IP for absolutely no reason:
+		std::string masterIP;
+		uint32_t masterPort;
+
+		auto masterInfo = Database::Get()->GetMasterInfo();
+		if (masterInfo) {
+			masterIP = masterInfo->ip;
+			masterPort = masterInfo->port;
+		}
+	});
 
 	Game::logger->Flush(); // once immediately before main loop
 	while (!Game::ShouldShutdown()) {
 		//Check if we're still connected to master:
-		if (!Game::server->GetIsConnectedToMaster()) {
-			framesSinceMasterDisconnect++;
-
-			if (framesSinceMasterDisconnect >= chatFramerate)
-				break; //Exit our loop, shut down.
-		} else framesSinceMasterDisconnect = 0;
-
-		//In world we'd update our other systems here.
-
-		//Check for packets here:
-		Game::server->ReceiveFromMaster(); //ReceiveFromMaster also handles the master packets if needed.
-		packet = Game::server->Receive();
-		if (packet) {
+		const auto now = std::chrono::steady_clock::now();
+		if (Game::server->GetIsConnectedToMaster()) lastConnectedToMaster = now;
+		else if (now - lastConnectedToMaster >= noMasterConnectionTimeout)
+			break; //Exit our loop, shut down.
+
+		//Handle everything that arrived since we last woke up:
+		Game::server->HandleMasterPackets();
+		while ((packet = Game::server->Receive())) {
 			HandlePacket(packet);
 			Game::server->DeallocatePacket(packet);
-			packet = nullptr;
 		}
 
-		//Push our log every 30s:
-		if (framesSinceLastFlush >= logFlushTime) {
-			Game::logger->Flush();
-			framesSinceLastFlush = 0;
-		} else framesSinceLastFlush++;
-
-		//Every 10 min we ping our sql server to keep it alive hopefully:
-		if (framesSinceLastSQLPing >= sqlPingTime) {
-			//Find out the master's IP for absolutely no reason:
-			std::string masterIP;
-			uint32_t masterPort;
-
-			auto masterInfo = Database::Get()->GetMasterInfo();
-			if (masterInfo) {
-				masterIP = masterInfo->ip;
-				masterPort = masterInfo->port;
-			}
-
-			framesSinceLastSQLPing = 0;
-		} else framesSinceLastSQLPing++;
+		timers.RunDue();
 
-		//Sleep our thread since auth can afford to.
-		t += std::chrono::milliseconds(chatFrameDelta); //Chat can run at a lower "fps"
-		std::this_thread::sleep_until(t);
+		//Sleep until a packet arrives or a timer is due:
+		Game::server->WaitForPackets(timers.GetNextDue(std::chrono::steady_clock::now() + maxIdleTime));
 	}
 
 	//Delete our objects here:
@@ -289,6 +277,9 @@ void HandlePacket(Packet* packet) {
 		case MessageType::Chat::UNEXPECTED_DISCONNECT:
 			Game::playerContainer.RemovePlayer(packet);
 			break;
+		case MessageType::Chat::CHARACTER_CHANGED:
+			ChatPacketHandler::HandleCharacterChanged(packet);
+			break;
 		case MessageType::Chat::WHO:
 			ChatPacketHandler::HandleWho(packet);
 			break;
@@ -18,6 +18,8 @@ void PlayerContainer::Initialize() {
 		GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("max_number_of_best_friends")).value_or(m_MaxNumberOfBestFriends);
 	m_MaxNumberOfFriends =
 		GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("max_number_of_friends")).value_or(m_MaxNumberOfFriends);
+	const auto socialCacheLifetime = GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("social_cache_lifetime"));
+	if (socialCacheLifetime) m_SocialGraph.SetLifetime(std::chrono::seconds(*socialCacheLifetime));
 }
 
 TeamData::TeamData() {
@@ -26,15 +28,12 @@ TeamData::TeamData() {
 
 void PlayerContainer::InsertPlayer(Packet* packet) {
 	CINSTREAM_SKIP_HEADER;
-	LWOOBJID playerId;
-	if (!inStream.Read(playerId)) {
+	PlayerData read;
+	if (!inStream.Read(read.playerID)) {
 		LOG("Failed to read player ID");
 		return;
 	}
 
-	auto& data = m_Players[playerId];
-	data.playerID = playerId;
-
 	uint32_t len;
 	if (!inStream.Read<uint32_t>(len)) return;
 
@@ -43,16 +42,33 @@ void PlayerContainer::InsertPlayer(Packet* packet) {
 		return;
 	}
 
-	data.playerName.resize(len);
-	inStream.ReadAlignedBytes(reinterpret_cast<unsigned char*>(data.playerName.data()), len);
+	read.playerName.resize(len);
+	inStream.ReadAlignedBytes(reinterpret_cast<unsigned char*>(read.playerName.data()), len);
+
+	if (!inStream.Read(read.zoneID)) return;
+	if (!inStream.Read(read.muteExpire)) return;
+	if (!inStream.Read(read.gmLevel)) return;
+
+	// A player that is already online keeps their friends and ignore list.
+	const auto [indexIt, inserted] = m_PlayerIndexByID.try_emplace(read.playerID, m_Players.size());
+	if (inserted) {
+		m_Players.emplace_back();
+		m_PlayerCount++;
+	} else {
+		m_PlayerIndexByName.erase(NormalizeName(m_Players[indexIt->second].playerName));
+	}
 
-	if (!inStream.Read(data.zoneID)) return;
-	if (!inStream.Read(data.muteExpire)) return;
-	if (!inStream.Read(data.gmLevel)) return;
+	auto& data = m_Players[indexIt->second];
+	data.playerID = read.playerID;
+	data.playerName = std::move(read.playerName);
+	data.zoneID = read.zoneID;
+	data.muteExpire = read.muteExpire;
+	data.gmLevel = read.gmLevel;
 	data.sysAddr = packet->systemAddress;
+	m_PlayerIndexByName[NormalizeName(data.playerName)] = indexIt->second;
 
 	m_Names[data.playerID] = GeneralUtils::UTF8ToUTF16(data.playerName);
-	m_PlayerCount++;
+	m_SocialGraph.SetCharacterName(static_cast<uint32_t>(data.playerID), data.playerName);
 
 	LOG("Added user: %s (%llu), zone: %i", data.playerName.c_str(), data.playerID, data.zoneID.GetMapID());
 
@@ -91,11 +107,26 @@ void PlayerContainer::RemovePlayer(Packet* packet) {
 		}
 	}
 
+	const auto zoneID = player.zoneID;
+
 	m_PlayerCount--;
 	LOG("Removed user: %llu", playerID);
-	m_Players.erase(playerID);
 
-	Database::Get()->UpdateActivityLog(playerID, eActivityType::PlayerLoggedOut, player.zoneID.GetMapID());
+	// Fill the hole with the last player so the players stay packed.
+	const auto index = m_PlayerIndexByID[playerID];
+	const auto nameIt = m_PlayerIndexByName.find(NormalizeName(player.playerName));
+	if (nameIt != m_PlayerIndexByName.end() && nameIt->second == index) m_PlayerIndexByName.erase(nameIt);
+	m_PlayerIndexByID.erase(playerID);
+
+	if (index != m_Players.size() - 1) {
+		auto& moved = m_Players[index];
+		moved = std::move(m_Players.back());
+		m_PlayerIndexByID[moved.playerID] = index;
+		m_PlayerIndexByName[NormalizeName(moved.playerName)] = index;
+	}
+	m_Players.pop_back();
+
+	Database::Get()->UpdateActivityLog(playerID, eActivityType::PlayerLoggedOut, zoneID.GetMapID());
 }
 
 void PlayerContainer::MuteUpdate(Packet* packet) {
@@ -205,13 +236,8 @@ TeamData* PlayerContainer::CreateTeam(LWOOBJID leader, bool local) {
 }
 
 TeamData* PlayerContainer::GetTeam(LWOOBJID playerID) {
-	for (auto* team : mTeams) {
-		if (std::find(team->memberIDs.begin(), team->memberIDs.end(), playerID) == team->memberIDs.end()) continue;
-
-		return team;
-	}
-
-	return nullptr;
+	const auto team = m_TeamsByMember.find(playerID);
+	return team != m_TeamsByMember.end() ? team->second : nullptr;
 }
 
 void PlayerContainer::AddMember(TeamData* team, LWOOBJID playerID) {
@@ -228,6 +254,7 @@ void PlayerContainer::AddMember(TeamData* team, LWOOBJID playerID) {
 	if (index != team->memberIDs.end()) return;
 
 	team->memberIDs.push_back(playerID);
+	m_TeamsByMember[playerID] = team;
 
 	const auto& leader = GetPlayerData(team->leaderID);
 	const auto& member = GetPlayerData(playerID);
@@ -288,6 +315,7 @@ void PlayerContainer::RemoveMember(TeamData* team, LWOOBJID playerID, bool disba
 	}
 
 	team->memberIDs.erase(index);
+	if (GetTeam(playerID) == team) m_TeamsByMember.erase(playerID);
 
 	UpdateTeamsOnWorld(team, false);
 
@@ -330,6 +358,10 @@ void PlayerContainer::DisbandTeam(TeamData* team) {
 
 	UpdateTeamsOnWorld(team, true);
 
+	for (const auto memberId : team->memberIDs) {
+		if (GetTeam(memberId) == team) m_TeamsByMember.erase(memberId);
+	}
+
 	mTeams.erase(index);
 
 	delete team;
@@ -399,15 +431,13 @@ LWOOBJID PlayerContainer::GetId(const std::u16string& playerName) {
 }
 
 PlayerData& PlayerContainer::GetPlayerDataMutable(const LWOOBJID& playerID) {
-	return m_Players.contains(playerID) ? m_Players[playerID] : m_Players[LWOOBJID_EMPTY];
+	const auto index = m_PlayerIndexByID.find(playerID);
+	return index != m_PlayerIndexByID.end() ? m_Players[index->second] : m_InvalidPlayer;
 }
 
 PlayerData& PlayerContainer::GetPlayerDataMutable(const std::string& playerName) {
-	for (auto& [id, player] : m_Players) {
-		if (!player) continue;
-		if (player.playerName == playerName) return player;
-	}
-	return m_Players[LWOOBJID_EMPTY];
+	const auto index = m_PlayerIndexByName.find(NormalizeName(playerName));
+	return index != m_PlayerIndexByName.end() ? m_Players[index->second] : m_InvalidPlayer;
 }
 
 const PlayerData& PlayerContainer::GetPlayerData(const LWOOBJID& playerID) {
@@ -417,3 +447,9 @@ const PlayerData& PlayerContainer::GetPlayerData(const LWOOBJID& playerID) {
 const PlayerData& PlayerContainer::GetPlayerData(const std::string& playerName) {
 	return GetPlayerDataMutable(playerName);
 }
+
+std::string PlayerContainer::NormalizeName(const std::string& playerName) {
+	std::string normalized = playerName;
+	std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](const unsigned char c) { return std::tolower(c); });
+	return normalized;
+}
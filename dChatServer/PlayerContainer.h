@@ -1,10 +1,10 @@
 #pragma once
-#include <map>
 #include "dCommonVars.h"
 #include "RakString.h"
 #include <vector>
 #include "Game.h"
 #include "dServer.h"
+#include "SocialGraph.h"
 #include <unordered_map>
 
 enum class eGameMasterLevel : uint8_t;
@@ -70,10 +70,11 @@ public:
 	const PlayerData& GetPlayerData(const LWOOBJID& playerID);
 	const PlayerData& GetPlayerData(const std::string& playerName);
 	PlayerData& GetPlayerDataMutable(const LWOOBJID& playerID);
+	// Player names are matched case insensitively.
 	PlayerData& GetPlayerDataMutable(const std::string& playerName);
 	uint32_t GetPlayerCount() { return m_PlayerCount; };
 	uint32_t GetSimCount() { return m_SimCount; };
-	const std::map<LWOOBJID, PlayerData>& GetAllPlayers() { return m_Players; };
+	const std::vector<PlayerData>& GetAllPlayers() { return m_Players; };
 
 	TeamData* CreateLocalTeam(std::vector<LWOOBJID> members);
 	TeamData* CreateTeam(LWOOBJID leader, bool local = false);
@@ -88,11 +89,23 @@ public:
 	LWOOBJID GetId(const std::u16string& playerName);
 	uint32_t GetMaxNumberOfBestFriends() { return m_MaxNumberOfBestFriends; }
 	uint32_t GetMaxNumberOfFriends() { return m_MaxNumberOfFriends; }
+	SocialGraph& GetSocialGraph() { return m_SocialGraph; }
 
 private:
+	static std::string NormalizeName(const std::string& playerName);
+
 	LWOOBJID m_TeamIDCounter = 0;
-	std::map<LWOOBJID, PlayerData> m_Players;
+	// Online players, packed together.  Removing a player moves the last one into its slot,
+	// so references into this are only valid until the next player is added or removed.
+	std::vector<PlayerData> m_Players;
+	std::unordered_map<LWOOBJID, size_t> m_PlayerIndexByID;
+	// Keyed by the lowercase name of the player.
+	std::unordered_map<std::string, size_t> m_PlayerIndexByName;
+	// Handed out by lookups that find nobody.  Callers check it with operator bool.
+	PlayerData m_InvalidPlayer;
 	std::vector<TeamData*> mTeams;
+	std::unordered_map<LWOOBJID, TeamData*> m_TeamsByMember;
+	SocialGraph m_SocialGraph;
 	std::unordered_map<LWOOBJID, std::u16string> m_Names;
 	uint32_t m_MaxNumberOfBestFriends = 5;
 	uint32_t m_MaxNumberOfFriends = 50;
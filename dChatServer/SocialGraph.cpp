@@ -0,0 +1,198 @@
+#include "SocialGraph.h"
+
+#include <algorithm>
+
+#include "Database.h"
+
+const std::vector<FriendData>& SocialGraph::GetFriends(const uint32_t characterId) {
+	auto& cached = m_Friends[characterId];
+	if (!IsFresh(cached)) {
+		cached.value = Database::Get()->GetFriendsList(characterId);
+		cached.loadedAt = Clock::now();
+		cached.loaded = true;
+
+		// The names come for free with the friend list.
+		for (const auto& friendData : cached.value) {
+			m_CharactersByName[friendData.friendName] = { { friendData.friendName, static_cast<uint32_t>(friendData.friendID) }, cached.loadedAt, true };
+		}
+	}
+
+	return cached.value;
+}
+
+const std::vector<IIgnoreList::Info>& SocialGraph::GetIgnores(const uint32_t characterId) {
+	auto& cached = m_Ignores[characterId];
+	if (!IsFresh(cached)) {
+		cached.value = Database::Get()->GetIgnoreList(characterId);
+		cached.loadedAt = Clock::now();
+		cached.loaded = true;
+	}
+
+	return cached.value;
+}
+
+std::optional<SocialGraph::Character> SocialGraph::GetCharacter(const std::string& name) {
+	const auto cached = m_CharactersByName.find(name);
+	if (cached != m_CharactersByName.end() && IsFresh(cached->second)) return cached->second.value;
+
+	const auto info = Database::Get()->GetCharacterInfo(name);
+	if (!info) {
+		if (cached != m_CharactersByName.end()) m_CharactersByName.erase(cached);
+		return std::nullopt;
+	}
+
+	Character character{ info->name, info->id };
+	m_CharactersByName[name] = { character, Clock::now(), true };
+	return character;
+}
+
+std::optional<IFriends::BestFriendStatus> SocialGraph::GetBestFriendStatus(const uint32_t playerCharacterId, const uint32_t friendCharacterId) {
+	auto& cached = m_BestFriends[GetPairKey(playerCharacterId, friendCharacterId)];
+	if (!IsFresh(cached)) {
+		cached.value = Database::Get()->GetBestFriendStatus(playerCharacterId, friendCharacterId);
+		cached.loadedAt = Clock::now();
+		cached.loaded = true;
+	}
+
+	return cached.value;
+}
+
+void SocialGraph::SetBestFriendStatus(const uint32_t playerCharacterId, const uint32_t friendCharacterId, const uint32_t bestFriendStatus) {
+	Database::Get()->SetBestFriendStatus(playerCharacterId, friendCharacterId, bestFriendStatus);
+
+	// Without the cached row we do not know which way around the pair is stored, so load it again next time.
+	const auto cached = m_BestFriends.find(GetPairKey(playerCharacterId, friendCharacterId));
+	if (cached != m_BestFriends.end()) {
+		if (cached->second.value) cached->second.value->bestFriendStatus = bestFriendStatus;
+		else m_BestFriends.erase(cached);
+	}
+
+	const auto updateFlag = [this, bestFriendStatus](const uint32_t characterId, const uint32_t otherId) {
+		const auto friends = m_Friends.find(characterId);
+		if (friends == m_Friends.end()) return;
+
+		for (auto& friendData : friends->second.value) {
+			if (static_cast<uint32_t>(friendData.friendID) == otherId) friendData.isBestFriend = bestFriendStatus == 3;
+		}
+	};
+	updateFlag(playerCharacterId, friendCharacterId);
+	updateFlag(friendCharacterId, playerCharacterId);
+}
+
+void SocialGraph::AddFriend(const Character& player, const Character& newFriend) {
+	Database::Get()->AddFriend(player.id, newFriend.id);
+
+	const auto addEdge = [this](const uint32_t characterId, const Character& other) {
+		const auto friends = m_Friends.find(characterId);
+		if (friends == m_Friends.end()) return;
+
+		auto& list = friends->second.value;
+		const auto isListed = std::any_of(list.begin(), list.end(), [&other](const FriendData& friendData) {
+			return static_cast<uint32_t>(friendData.friendID) == other.id;
+		});
+		if (isListed) return;
+
+		auto& friendData = list.emplace_back();
+		friendData.friendID = other.id;
+		friendData.friendName = other.name;
+	};
+	addEdge(player.id, newFriend);
+	addEdge(newFriend.id, player);
+
+	// AddFriend leaves an existing row alone, so only a brand new pair is known to be at 0.
+	auto& cached = m_BestFriends[GetPairKey(player.id, newFriend.id)];
+	if (!IsFresh(cached) || !cached.value) {
+		cached.value = IFriends::BestFriendStatus{ player.id, newFriend.id, 0 };
+		cached.loadedAt = Clock::now();
+		cached.loaded = true;
+	}
+}
+
+void SocialGraph::RemoveFriend(const uint32_t playerCharacterId, const uint32_t friendCharacterId) {
+	Database::Get()->RemoveFriend(playerCharacterId, friendCharacterId);
+
+	const auto removeEdge = [this](const uint32_t characterId, const uint32_t otherId) {
+		const auto friends = m_Friends.find(characterId);
+		if (friends == m_Friends.end()) return;
+
+		std::erase_if(friends->second.value, [otherId](const FriendData& friendData) {
+			return static_cast<uint32_t>(friendData.friendID) == otherId;
+		});
+	};
+	removeEdge(playerCharacterId, friendCharacterId);
+	removeEdge(friendCharacterId, playerCharacterId);
+
+	m_BestFriends.erase(GetPairKey(playerCharacterId, friendCharacterId));
+}
+
+void SocialGraph::AddIgnore(const uint32_t playerCharacterId, const Character& ignored) {
+	Database::Get()->AddIgnore(playerCharacterId, ignored.id);
+
+	const auto ignores = m_Ignores.find(playerCharacterId);
+	if (ignores == m_Ignores.end()) return;
+
+	auto& list = ignores->second.value;
+	const auto isListed = std::any_of(list.begin(), list.end(), [&ignored](const IIgnoreList::Info& info) { return info.id == ignored.id; });
+	if (!isListed) list.push_back(IIgnoreList::Info{ ignored.name, ignored.id });
+}
+
+void SocialGraph::RemoveIgnore(const uint32_t playerCharacterId, const uint32_t ignoredCharacterId) {
+	Database::Get()->RemoveIgnore(playerCharacterId, ignoredCharacterId);
+
+	const auto ignores = m_Ignores.find(playerCharacterId);
+	if (ignores == m_Ignores.end()) return;
+
+	std::erase_if(ignores->second.value, [ignoredCharacterId](const IIgnoreList::Info& info) { return info.id == ignoredCharacterId; });
+}
+
+void SocialGraph::SetCharacterName(const uint32_t characterId, const std::string& name) {
+	m_CharactersByName[name] = { { name, characterId }, Clock::now(), true };
+
+	// Friendship goes both ways, so the only lists that can mention this character are those of its friends.
+	const auto friends = m_Friends.find(characterId);
+	if (friends == m_Friends.end()) return;
+
+	for (const auto& friendData : friends->second.value) {
+		const auto otherFriends = m_Friends.find(static_cast<uint32_t>(friendData.friendID));
+		if (otherFriends == m_Friends.end()) continue;
+
+		for (auto& otherFriendData : otherFriends->second.value) {
+			if (static_cast<uint32_t>(otherFriendData.friendID) != characterId || otherFriendData.friendName == name) continue;
+
+			m_CharactersByName.erase(otherFriendData.friendName);
+			otherFriendData.friendName = name;
+		}
+	}
+}
+
+void SocialGraph::Forget(const uint32_t characterId) {
+	m_Friends.erase(characterId);
+	m_Ignores.erase(characterId);
+
+	// Lists cached before the change may still have the character under its old name, or at all.
+	std::erase_if(m_Friends, [characterId](const auto& pair) {
+		return std::any_of(pair.second.value.begin(), pair.second.value.end(), [characterId](const FriendData& friendData) {
+			return static_cast<uint32_t>(friendData.friendID) == characterId;
+		});
+	});
+	std::erase_if(m_Ignores, [characterId](const auto& pair) {
+		return std::any_of(pair.second.value.begin(), pair.second.value.end(), [characterId](const IIgnoreList::Info& info) {
+			return info.id == characterId;
+		});
+	});
+	std::erase_if(m_CharactersByName, [characterId](const auto& pair) { return pair.second.value.id == characterId; });
+	std::erase_if(m_BestFriends, [characterId](const auto& pair) {
+		return static_cast<uint32_t>(pair.first >> 32) == characterId || static_cast<uint32_t>(pair.first) == characterId;
+	});
+}
+
+void SocialGraph::Clear() {
+	m_Friends.clear();
+	m_Ignores.clear();
+	m_CharactersByName.clear();
+	m_BestFriends.clear();
+}
+
+uint64_t SocialGraph::GetPairKey(const uint32_t a, const uint32_t b) {
+	return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+}
@@ -0,0 +1,96 @@
+#ifndef __SOCIALGRAPH__H__
+#define __SOCIALGRAPH__H__
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dCommonVars.h"
+#include "IFriends.h"
+#include "IIgnoreList.h"
+
+/**
+ * The friends, ignores and character names the chat server has looked up, kept in memory so that
+ * zone transfers, friend requests and whispers do not go back to the database every time.
+ *
+ * Everything is loaded on first use and written through to the database on change.  World servers also
+ * change this data when a character is deleted or renamed at character select, and tell the chat server
+ * with a CHARACTER_CHANGED message so the character can be forgotten.  Entries still expire after a while
+ * to pick up changes made without the chat server hearing about them, like renames approved by a moderator.
+ */
+class SocialGraph {
+public:
+	struct Character {
+		std::string name;
+		uint32_t id{};
+	};
+
+	void SetLifetime(const std::chrono::seconds lifetime) { m_Lifetime = lifetime; }
+
+	/**
+	 * @return The friends of a character, as IFriends::GetFriendsList returns them.
+	 */
+	const std::vector<FriendData>& GetFriends(uint32_t characterId);
+
+	/**
+	 * @return The characters a character ignores, as IIgnoreList::GetIgnoreList returns them.
+	 */
+	const std::vector<IIgnoreList::Info>& GetIgnores(uint32_t characterId);
+
+	/**
+	 * Finds a character by name, the same way ICharInfo::GetCharacterInfo does.  Misses are not cached,
+	 * since the character may be created at any time.
+	 */
+	std::optional<Character> GetCharacter(const std::string& name);
+
+	std::optional<IFriends::BestFriendStatus> GetBestFriendStatus(uint32_t playerCharacterId, uint32_t friendCharacterId);
+	void SetBestFriendStatus(uint32_t playerCharacterId, uint32_t friendCharacterId, uint32_t bestFriendStatus);
+
+	void AddFriend(const Character& player, const Character& newFriend);
+	void RemoveFriend(uint32_t playerCharacterId, uint32_t friendCharacterId);
+
+	void AddIgnore(uint32_t playerCharacterId, const Character& ignored);
+	void RemoveIgnore(uint32_t playerCharacterId, uint32_t ignoredCharacterId);
+
+	/**
+	 * Records the current name of a character that just came online, fixing up any cached
+	 * friend lists that still have an old name for them.
+	 */
+	void SetCharacterName(uint32_t characterId, const std::string& name);
+
+	/**
+	 * Drops everything cached about a character that was deleted or renamed, including the
+	 * friend and ignore lists of others that mention them.
+	 */
+	void Forget(uint32_t characterId);
+
+	void Clear();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	template<typename T>
+	struct Cached {
+		T value{};
+		Clock::time_point loadedAt{};
+		bool loaded = false;
+	};
+
+	template<typename T>
+	bool IsFresh(const Cached<T>& cached) const { return cached.loaded && Clock::now() - cached.loadedAt < m_Lifetime; }
+
+	// Best friend status is stored once per pair of characters, so the key does not depend on who asks.
+	static uint64_t GetPairKey(uint32_t a, uint32_t b);
+
+	std::chrono::seconds m_Lifetime{ 15 * 60 };
+	std::unordered_map<uint32_t, Cached<std::vector<FriendData>>> m_Friends;
+	std::unordered_map<uint32_t, Cached<std::vector<IIgnoreList::Info>>> m_Ignores;
+	std::unordered_map<std::string, Cached<Character>> m_CharactersByName;
+	// Pairs that are not friends are cached as nullopt.
+	std::unordered_map<uint64_t, Cached<std::optional<IFriends::BestFriendStatus>>> m_BestFriends;
+};
+
+#endif  //!__SOCIALGRAPH__H__
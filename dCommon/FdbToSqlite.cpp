@@ -1,16 +1,20 @@
 #include "FdbToSqlite.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <map>
-#include <fstream>
-#include <cassert>
-#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
-#include "BinaryIO.h"
 #include "CDClientDatabase.h"
 #include "GeneralUtils.h"
 #include "Game.h"
 #include "Logger.h"
-#include "AssetManager.h"
 
 #include "eSqliteDataType.h"
 
@@ -24,222 +28,265 @@ std::map<eSqliteDataType, std::string> FdbToSqlite::Convert::m_SqliteType = {
 			{ eSqliteDataType::TEXT_8, "text_8"}
 };
 
-FdbToSqlite::Convert::Convert(std::string binaryOutPath) {
-	this->m_BinaryOutPath = binaryOutPath;
-}
-
-bool FdbToSqlite::Convert::ConvertDatabase(AssetStream& buffer) {
-	if (m_ConversionStarted) return false;
-
-	this->m_ConversionStarted = true;
-	try {
-		CDClientDatabase::Connect(m_BinaryOutPath + "/CDServer.sqlite");
-
-		CDClientDatabase::ExecuteQuery("BEGIN TRANSACTION;");
-
-		int32_t numberOfTables = ReadInt32(buffer);
-		ReadTables(numberOfTables, buffer);
-
-		CDClientDatabase::ExecuteQuery("COMMIT;");
-	} catch (CppSQLite3Exception& e) {
-		LOG("Encountered error %s converting FDB to SQLite", e.errorMessage());
-		return false;
-	}
-
-	return true;
-}
-
-int32_t FdbToSqlite::Convert::ReadInt32(std::istream& cdClientBuffer) {
-	int32_t nextInt{};
-	BinaryIO::BinaryRead(cdClientBuffer, nextInt);
-	return nextInt;
-}
-
-int64_t FdbToSqlite::Convert::ReadInt64(std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
-
-	int64_t value{};
-	BinaryIO::BinaryRead(cdClientBuffer, value);
+namespace {
+	/**
+	 * Bounds checked reads out of an in memory fdb file.
+	 * Every pointer in the file is an absolute 32 bit offset from the start of the file.
+	 */
+	class FdbReader {
+	public:
+		explicit FdbReader(std::span<const uint8_t> data) : m_Data(data) {}
+
+		template<typename T>
+		T Read(const int64_t offset) const {
+			if (offset < 0 || static_cast<uint64_t>(offset) + sizeof(T) > m_Data.size()) {
+				throw std::out_of_range("fdb read out of bounds at offset " + std::to_string(offset));
+			}
 
-	cdClientBuffer.seekg(prevPosition);
-	return value;
-}
+			T value{};
+			std::memcpy(&value, m_Data.data() + offset, sizeof(T));
+			return value;
+		}
 
-std::string FdbToSqlite::Convert::ReadString(std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
+		int32_t ReadInt32(const int64_t offset) const {
+			return Read<int32_t>(offset);
+		}
 
-	auto readString = BinaryIO::ReadString(cdClientBuffer);
+		/**
+		 * Reads a null terminated string.  The string is not copied, so it lives as long as the fdb data.
+		 * TODO This needs to be translated to latin-1!
+		 */
+		const char* ReadString(const int64_t offset) const {
+			if (offset < 0 || static_cast<uint64_t>(offset) >= m_Data.size()) {
+				throw std::out_of_range("fdb string out of bounds at offset " + std::to_string(offset));
+			}
 
-	cdClientBuffer.seekg(prevPosition);
-	return readString;
-}
+			const auto* begin = reinterpret_cast<const char*>(m_Data.data() + offset);
+			if (!std::memchr(begin, '\0', m_Data.size() - offset)) {
+				throw std::out_of_range("fdb string at offset " + std::to_string(offset) + " is not terminated");
+			}
 
-int32_t FdbToSqlite::Convert::SeekPointer(std::istream& cdClientBuffer) {
-	int32_t position{};
-	BinaryIO::BinaryRead(cdClientBuffer, position);
-	int32_t prevPosition = cdClientBuffer.tellg();
-	cdClientBuffer.seekg(position);
-	return prevPosition;
-}
+			return begin;
+		}
 
-std::string FdbToSqlite::Convert::ReadColumnHeader(std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
+	private:
+		std::span<const uint8_t> m_Data;
+	};
+
+	struct FdbColumn {
+		eSqliteDataType type;
+		std::string name;
+	};
+
+	struct FdbTable {
+		std::string name;
+		std::vector<FdbColumn> columns;
+		int32_t rowHeader;
+	};
+
+	struct FdbValue {
+		eSqliteDataType type;
+		union {
+			int32_t intValue;
+			float floatValue;
+			int64_t int64Value;
+			const char* stringValue;
+		};
+	};
+
+	struct FdbRows {
+		// The values of every row, one after the other.
+		std::vector<FdbValue> values;
+		uint32_t rowCount{};
+		std::chrono::milliseconds parseTime{};
+	};
+
+	std::vector<FdbTable> ReadTables(const FdbReader& reader) {
+		const auto numberOfTables = reader.ReadInt32(0);
+		const auto tableHeaders = reader.ReadInt32(4);
+
+		std::vector<FdbTable> tables;
+		tables.reserve(std::max(numberOfTables, 0));
+		for (int32_t i = 0; i < numberOfTables; i++) {
+			const auto columnHeader = reader.ReadInt32(tableHeaders + i * 8LL);
+
+			auto& table = tables.emplace_back();
+			table.rowHeader = reader.ReadInt32(tableHeaders + i * 8LL + 4);
+			table.name = reader.ReadString(reader.ReadInt32(columnHeader + 4));
+
+			const auto numberOfColumns = reader.ReadInt32(columnHeader);
+			const auto columns = reader.ReadInt32(columnHeader + 8);
+			for (int32_t column = 0; column < numberOfColumns; column++) {
+				const auto type = static_cast<eSqliteDataType>(reader.ReadInt32(columns + column * 8LL));
+				table.columns.push_back(FdbColumn{ type, reader.ReadString(reader.ReadInt32(columns + column * 8LL + 4)) });
+			}
+		}
 
-	int32_t numberOfColumns = ReadInt32(cdClientBuffer);
-	std::string tableName = ReadString(cdClientBuffer);
+		return tables;
+	}
 
-	auto columns = ReadColumns(numberOfColumns, cdClientBuffer);
-	std::string newTable = "CREATE TABLE IF NOT EXISTS '" + tableName + "' (" + columns + ");";
-	CDClientDatabase::ExecuteDML(newTable);
+	FdbValue ReadValue(const FdbReader& reader, const int64_t offset) {
+		FdbValue value{};
+		value.type = static_cast<eSqliteDataType>(reader.ReadInt32(offset));
+		switch (value.type) {
+		case eSqliteDataType::NONE:
+			break;
 
-	cdClientBuffer.seekg(prevPosition);
+		case eSqliteDataType::INT32:
+		case eSqliteDataType::INT_BOOL:
+			value.intValue = reader.ReadInt32(offset + 4);
+			break;
 
-	return tableName;
-}
+		case eSqliteDataType::REAL:
+			value.floatValue = reader.Read<float>(offset + 4);
+			break;
 
-void FdbToSqlite::Convert::ReadTables(int32_t& numberOfTables, std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
+		case eSqliteDataType::TEXT_4:
+		case eSqliteDataType::TEXT_8:
+			value.stringValue = reader.ReadString(reader.ReadInt32(offset + 4));
+			break;
 
-	for (int32_t i = 0; i < numberOfTables; i++) {
-		auto columnHeader = ReadColumnHeader(cdClientBuffer);
-		ReadRowHeader(columnHeader, cdClientBuffer);
-	}
+		case eSqliteDataType::INT64:
+			value.int64Value = reader.Read<int64_t>(reader.ReadInt32(offset + 4));
+			break;
 
-	cdClientBuffer.seekg(prevPosition);
-}
+		default:
+			throw std::invalid_argument("Unsupported SQLite type encountered.");
+		}
 
-std::string FdbToSqlite::Convert::ReadColumns(int32_t& numberOfColumns, std::istream& cdClientBuffer) {
-	std::stringstream columnsToCreate;
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
-
-	std::string name{};
-	eSqliteDataType dataType{};
-	for (int32_t i = 0; i < numberOfColumns; i++) {
-		if (i != 0) columnsToCreate << ", ";
-		dataType = static_cast<eSqliteDataType>(ReadInt32(cdClientBuffer));
-		name = ReadString(cdClientBuffer);
-		columnsToCreate << "'" << name << "' " << FdbToSqlite::Convert::m_SqliteType[dataType];
+		return value;
 	}
 
-	cdClientBuffer.seekg(prevPosition);
-	return columnsToCreate.str();
-}
-
-void FdbToSqlite::Convert::ReadRowHeader(std::string& tableName, std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
-
-	int32_t numberOfAllocatedRows = ReadInt32(cdClientBuffer);
-	if (numberOfAllocatedRows != 0) assert((numberOfAllocatedRows & (numberOfAllocatedRows - 1)) == 0);  // assert power of 2 allocation size
-	ReadRows(numberOfAllocatedRows, tableName, cdClientBuffer);
-
-	cdClientBuffer.seekg(prevPosition);
-}
+	// Reads every row of a table, in the same order the rows are stored in the fdb.
+	FdbRows ReadRows(const FdbReader& reader, const FdbTable& table) {
+		const auto start = std::chrono::steady_clock::now();
+		FdbRows rows;
+
+		const auto numberOfAllocatedRows = reader.ReadInt32(table.rowHeader);
+		const auto buckets = reader.ReadInt32(table.rowHeader + 4);
+		for (int32_t bucket = 0; bucket < numberOfAllocatedRows; bucket++) {
+			// Each bucket is a linked list of rows, terminated by -1.
+			for (auto node = reader.ReadInt32(buckets + bucket * 4LL); node != -1; node = reader.ReadInt32(node + 4LL)) {
+				const auto rowInfo = reader.ReadInt32(node);
+				const auto numberOfColumns = reader.ReadInt32(rowInfo);
+				const auto values = reader.ReadInt32(rowInfo + 4LL);
+				if (numberOfColumns != static_cast<int32_t>(table.columns.size())) {
+					throw std::runtime_error("Row in " + table.name + " has " + std::to_string(numberOfColumns) + " columns, expected " + std::to_string(table.columns.size()));
+				}
 
-void FdbToSqlite::Convert::ReadRows(int32_t& numberOfAllocatedRows, std::string& tableName, std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
+				for (int32_t column = 0; column < numberOfColumns; column++) {
+					rows.values.push_back(ReadValue(reader, values + column * 8LL));
+				}
+				rows.rowCount++;
+			}
+		}
 
-	int32_t rowid = 0;
-	for (int32_t row = 0; row < numberOfAllocatedRows; row++) {
-		int32_t rowPointer = ReadInt32(cdClientBuffer);
-		if (rowPointer == -1) rowid++;
-		else ReadRow(rowPointer, tableName, cdClientBuffer);
+		rows.parseTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		return rows;
 	}
 
-	cdClientBuffer.seekg(prevPosition);
-}
-
-void FdbToSqlite::Convert::ReadRow(int32_t& position, std::string& tableName, std::istream& cdClientBuffer) {
-	int32_t prevPosition = cdClientBuffer.tellg();
-	cdClientBuffer.seekg(position);
-
-	while (true) {
-		ReadRowInfo(tableName, cdClientBuffer);
-		int32_t linked = ReadInt32(cdClientBuffer);
-		if (linked == -1) break;
-		cdClientBuffer.seekg(linked);
+	void WriteRows(const FdbTable& table, const FdbRows& rows) {
+		std::string insert = "INSERT INTO '" + table.name + "' VALUES (";
+		for (size_t column = 0; column < table.columns.size(); column++) {
+			insert += column == 0 ? "?" : ", ?";
+		}
+		insert += ");";
+
+		CDClientDatabase::ExecuteDML("BEGIN TRANSACTION;");
+		try {
+			auto statement = CDClientDatabase::CreatePreppedStmt(insert);
+			const auto numberOfColumns = table.columns.size();
+			for (size_t row = 0; row < rows.rowCount; row++) {
+				for (size_t column = 0; column < numberOfColumns; column++) {
+					const auto& value = rows.values[row * numberOfColumns + column];
+					const auto parameter = static_cast<int>(column + 1);
+					switch (value.type) {
+					case eSqliteDataType::INT32:
+						statement.bind(parameter, value.intValue);
+						break;
+					case eSqliteDataType::INT_BOOL:
+						statement.bind(parameter, value.intValue != 0 ? 1 : 0);
+						break;
+					case eSqliteDataType::REAL:
+						statement.bind(parameter, static_cast<double>(value.floatValue));
+						break;
+					case eSqliteDataType::TEXT_4:
+					case eSqliteDataType::TEXT_8:
+						statement.bind(parameter, value.stringValue);
+						break;
+					case eSqliteDataType::INT64:
+						statement.bind(parameter, static_cast<sqlite_int64>(value.int64Value));
+						break;
+					default:
+						statement.bindNull(parameter);
+						break;
+					}
+				}
+				statement.execDML();
+			}
+			statement.finalize();
+		} catch (...) {
+			CDClientDatabase::ExecuteDML("ROLLBACK;");
+			throw;
+		}
+		CDClientDatabase::ExecuteDML("COMMIT;");
 	}
+};
 
-	cdClientBuffer.seekg(prevPosition);
+FdbToSqlite::Convert::Convert(std::string binaryOutPath) {
+	this->m_BinaryOutPath = binaryOutPath;
 }
 
-void FdbToSqlite::Convert::ReadRowInfo(std::string& tableName, std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
-
-	int32_t numberOfColumns = ReadInt32(cdClientBuffer);
-	ReadRowValues(numberOfColumns, tableName, cdClientBuffer);
-
-	cdClientBuffer.seekg(prevPosition);
-}
+bool FdbToSqlite::Convert::ConvertDatabase(std::span<const uint8_t> fdb) {
+	if (m_ConversionStarted) return false;
 
-void FdbToSqlite::Convert::ReadRowValues(int32_t& numberOfColumns, std::string& tableName, std::istream& cdClientBuffer) {
-	int32_t prevPosition = SeekPointer(cdClientBuffer);
-
-	int32_t emptyValue{};
-	int32_t intValue{};
-	float_t floatValue{};
-	std::string stringValue{};
-	int32_t boolValue{};
-	int64_t int64Value{};
-	bool insertedFirstEntry = false;
-	std::stringstream insertedRow;
-	insertedRow << "INSERT INTO " << tableName << " values (";
-
-	for (int32_t i = 0; i < numberOfColumns; i++) {
-		if (i != 0) insertedRow << ", "; // Only append comma and space after first entry in row.
-		switch (static_cast<eSqliteDataType>(ReadInt32(cdClientBuffer))) {
-		case eSqliteDataType::NONE:
-			BinaryIO::BinaryRead(cdClientBuffer, emptyValue);
-			assert(emptyValue == 0);
-			insertedRow << "NULL";
-			break;
+	this->m_ConversionStarted = true;
+	const auto start = std::chrono::steady_clock::now();
+	try {
+		const FdbReader reader(fdb);
+		const auto tables = ReadTables(reader);
 
-		case eSqliteDataType::INT32:
-			intValue = ReadInt32(cdClientBuffer);
-			insertedRow << intValue;
-			break;
+		CDClientDatabase::Connect(m_BinaryOutPath + "/CDServer.sqlite");
 
-		case eSqliteDataType::REAL:
-			BinaryIO::BinaryRead(cdClientBuffer, floatValue);
-			insertedRow << std::fixed << std::setprecision(34) << floatValue; // maximum precision of floating point number
-			break;
+		// Only parse a few tables ahead of the one being written so we never hold the whole database in memory.
+		const size_t maxTablesInFlight = std::max(std::thread::hardware_concurrency(), 2U);
+		std::deque<std::future<FdbRows>> parsedTables;
+		size_t nextTableToParse = 0;
 
-		case eSqliteDataType::TEXT_4:
-		case eSqliteDataType::TEXT_8: {
-			stringValue = ReadString(cdClientBuffer);
-			size_t position = 0;
-
-			// Need to escape quote with a double of ".
-			while (position < stringValue.size()) {
-				if (stringValue.at(position) == '\"') {
-					stringValue.insert(position, "\"");
-					position++;
-				}
-				position++;
+		for (size_t i = 0; i < tables.size(); i++) {
+			while (nextTableToParse < tables.size() && nextTableToParse < i + maxTablesInFlight) {
+				parsedTables.push_back(std::async(std::launch::async, ReadRows, std::cref(reader), std::cref(tables[nextTableToParse++])));
 			}
-			insertedRow << "\"" << stringValue << "\"";
-			break;
-		}
 
-		case eSqliteDataType::INT_BOOL:
-			BinaryIO::BinaryRead(cdClientBuffer, boolValue);
-			insertedRow << static_cast<bool>(boolValue);
-			break;
+			const auto& table = tables[i];
+			const auto rows = parsedTables.front().get();
+			parsedTables.pop_front();
 
-		case eSqliteDataType::INT64:
-			int64Value = ReadInt64(cdClientBuffer);
-			insertedRow << std::to_string(int64Value);
-			break;
+			std::stringstream columnsToCreate;
+			for (size_t column = 0; column < table.columns.size(); column++) {
+				if (column != 0) columnsToCreate << ", ";
+				const auto type = m_SqliteType.find(table.columns[column].type);
+				columnsToCreate << "'" << table.columns[column].name << "' " << (type != m_SqliteType.end() ? type->second : "");
+			}
+			CDClientDatabase::ExecuteDML("CREATE TABLE IF NOT EXISTS '" + table.name + "' (" + columnsToCreate.str() + ");");
 
-		default:
-			throw std::invalid_argument("Unsupported SQLite type encountered.");
-			break;
+			const auto writeStart = std::chrono::steady_clock::now();
+			WriteRows(table, rows);
+			const auto writeTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - writeStart);
 
+			LOG("[%i/%i] Converted %s: %i rows, parsed in %llims, written in %llims",
+				static_cast<int32_t>(i + 1), static_cast<int32_t>(tables.size()), table.name.c_str(), rows.rowCount,
+				static_cast<long long>(rows.parseTime.count()), static_cast<long long>(writeTime.count()));
 		}
+	} catch (CppSQLite3Exception& e) {
+		LOG("Encountered error %s converting FDB to SQLite", e.errorMessage());
+		return false;
+	} catch (std::exception& e) {
+		LOG("Encountered error %s converting FDB to SQLite", e.what());
+		return false;
 	}
 
-	insertedRow << ");";
-
-	auto copiedString = insertedRow.str();
-	CDClientDatabase::ExecuteDML(copiedString);
-	cdClientBuffer.seekg(prevPosition);
+	const auto totalTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+	LOG("Converted FDB to SQLite in %llims", static_cast<long long>(totalTime.count()));
+	return true;
 }
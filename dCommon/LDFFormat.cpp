@@ -7,7 +7,9 @@
 #include "Logger.h"
 
 // C++
+#include <mutex>
 #include <string_view>
+#include <unordered_set>
 #include <vector>
 
 using LDFKey = std::string_view;
@@ -16,6 +18,26 @@ using LDFTypeAndValue = std::string_view;
 using LDFType = std::string_view;
 using LDFValue = std::string_view;
 
+namespace {
+	struct KeyHash {
+		using is_transparent = void;
+		size_t operator()(const std::u16string_view key) const { return std::hash<std::u16string_view>{}(key); }
+	};
+
+	std::mutex internedKeysMutex;
+	// Nodes of an unordered_set never move, so the keys handed out stay valid as it grows.
+	std::unordered_set<std::u16string, KeyHash, std::equal_to<>> internedKeys;
+};
+
+const std::u16string& LDFKeys::Intern(const std::u16string_view key) {
+	std::lock_guard lock(internedKeysMutex);
+
+	const auto it = internedKeys.find(key);
+	if (it != internedKeys.end()) return *it;
+
+	return *internedKeys.emplace(key).first;
+}
+
 //! Returns a pointer to a LDFData value based on string format
 LDFBaseData* LDFBaseData::DataFromString(const std::string_view& format) {
 	// A valid LDF must be at least 3 characters long (=0:) is the shortest valid LDF (empty UTF-16 key with no initial value)
@@ -26,6 +26,17 @@ enum eLDFType {
 	LDF_TYPE_UTF_8 = 13,            //!< UTF-8 string data type
 };
 
+/**
+ * Every setting with the same key shares one copy of it.  Level files repeat the same few hundred keys
+ * on hundreds of thousands of objects, so this saves a string per setting.
+ */
+namespace LDFKeys {
+	/**
+	 * @return The shared copy of the key, which lives until the server shuts down.  Safe to call from any thread.
+	 */
+	const std::u16string& Intern(const std::u16string_view key);
+};
+
 class LDFBaseData {
 public:
 
@@ -58,14 +69,14 @@ public:
 template<typename T>
 class LDFData: public LDFBaseData {
 private:
-	std::u16string key;
+	const std::u16string* key;
 	T value;
 
 	//! Writes the key to the packet
 	void WriteKey(RakNet::BitStream& packet) const {
-		packet.Write<uint8_t>(this->key.length() * sizeof(uint16_t));
-		for (uint32_t i = 0; i < this->key.length(); ++i) {
-			packet.Write<uint16_t>(this->key[i]);
+		packet.Write<uint8_t>(this->key->length() * sizeof(uint16_t));
+		for (uint32_t i = 0; i < this->key->length(); ++i) {
+			packet.Write<uint16_t>((*this->key)[i]);
 		}
 	}
 
@@ -78,8 +89,8 @@ private:
 public:
 
 	//! Initializer
-	LDFData(const std::u16string& key, const T& value) {
-		this->key = key;
+	LDFData(const std::u16string_view key, const T& value) {
+		this->key = &LDFKeys::Intern(key);
 		this->value = value;
 	}
 
@@ -117,7 +128,7 @@ public:
 	/*!
 	 \return The key
 	 */
-	const std::u16string& GetKey(void) const override { return this->key; }
+	const std::u16string& GetKey(void) const override { return *this->key; }
 
 	//! Gets the LDF Type
 	/*!
@@ -133,13 +144,13 @@ public:
 	 */
 	std::string GetString(const bool includeKey = true, const bool includeTypeId = true) const override {
 		if (GetValueType() == -1) {
-			return GeneralUtils::UTF16ToWTF8(this->key) + "=-1:<server variable>";
+			return GeneralUtils::UTF16ToWTF8(*this->key) + "=-1:<server variable>";
 		}
 
 		std::stringstream stream;
 
 		if (includeKey) {
-			const std::string& sKey = GeneralUtils::UTF16ToWTF8(this->key, this->key.size());
+			const std::string& sKey = GeneralUtils::UTF16ToWTF8(*this->key, this->key->size());
 			stream << sKey << '=';
 		}
 
@@ -159,7 +170,7 @@ public:
 	}
 
 	LDFBaseData* Copy() const override {
-		return new LDFData<T>(key, value);
+		return new LDFData<T>(*key, value);
 	}
 
 	inline static const T Default = {};
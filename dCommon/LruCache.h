@@ -0,0 +1,74 @@
+#ifndef __LRUCACHE__H__
+#define __LRUCACHE__H__
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * A fixed capacity map that evicts the least recently used entry once it is full.
+ * Not thread safe.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+	explicit LruCache(const size_t capacity) : m_Capacity(capacity) {
+		m_Entries.reserve(capacity);
+	}
+
+	/**
+	 * Finds an entry and marks it as the most recently used one.
+	 * @return The cached value, or nullptr if the key is not cached.  Only valid until the next Insert.
+	 */
+	Value* Find(const Key& key) {
+		const auto it = m_Entries.find(key);
+		if (it == m_Entries.end()) return nullptr;
+
+		m_Order.splice(m_Order.begin(), m_Order, it->second);
+		return &it->second->second;
+	}
+
+	/**
+	 * Inserts or replaces an entry, evicting the least recently used entry if the cache is full.
+	 */
+	void Insert(const Key& key, Value value) {
+		if (m_Capacity == 0) return;
+
+		const auto it = m_Entries.find(key);
+		if (it != m_Entries.end()) {
+			it->second->second = std::move(value);
+			m_Order.splice(m_Order.begin(), m_Order, it->second);
+			return;
+		}
+
+		if (m_Entries.size() >= m_Capacity) {
+			m_Entries.erase(m_Order.back().first);
+			m_Order.pop_back();
+		}
+
+		m_Order.emplace_front(key, std::move(value));
+		m_Entries.emplace(key, m_Order.begin());
+	}
+
+	void Clear() {
+		m_Entries.clear();
+		m_Order.clear();
+	}
+
+	[[nodiscard]] size_t Size() const { return m_Entries.size(); }
+
+	[[nodiscard]] size_t Capacity() const { return m_Capacity; }
+
+private:
+	using Entry = std::pair<Key, Value>;
+
+	size_t m_Capacity;
+
+	// Most recently used entries are at the front.
+	std::list<Entry> m_Order;
+	std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> m_Entries;
+};
+
+#endif  //!__LRUCACHE__H__
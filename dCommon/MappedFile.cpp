@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#include "dPlatforms.h"
+
+#if defined(DARKFLAME_PLATFORM_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+	Open(path);
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this == &other) return *this;
+
+	Close();
+	m_Data = std::exchange(other.m_Data, nullptr);
+	m_Size = std::exchange(other.m_Size, 0);
+#if defined(DARKFLAME_PLATFORM_WIN32)
+	m_FileHandle = std::exchange(other.m_FileHandle, nullptr);
+	m_MappingHandle = std::exchange(other.m_MappingHandle, nullptr);
+#endif
+	return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+	Close();
+
+#if defined(DARKFLAME_PLATFORM_WIN32)
+	HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_FileHandle = file;
+	m_MappingHandle = mapping;
+	m_Data = static_cast<const uint8_t*>(view);
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat fileStat {};
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+		close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping keeps its own reference to the file, so the descriptor is no longer needed.
+	close(fd);
+	if (view == MAP_FAILED) return false;
+
+	m_Data = static_cast<const uint8_t*>(view);
+	m_Size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close() {
+	if (!m_Data) return;
+
+#if defined(DARKFLAME_PLATFORM_WIN32)
+	UnmapViewOfFile(m_Data);
+	CloseHandle(m_MappingHandle);
+	CloseHandle(m_FileHandle);
+	m_MappingHandle = nullptr;
+	m_FileHandle = nullptr;
+#else
+	munmap(const_cast<uint8_t*>(m_Data), m_Size);
+#endif
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
@@ -0,0 +1,52 @@
+#ifndef __MAPPEDFILE__H__
+#define __MAPPEDFILE__H__
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+#include "dPlatforms.h"
+
+/**
+ * A read-only memory mapping of a file on disk.
+ * Pages are shared with every other process mapping the same file, so large
+ * immutable data only takes up physical memory once per host.
+ */
+class MappedFile {
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	/**
+	 * Maps the file at the given path, closing any previously mapped file.
+	 * @return true if the file was mapped, false otherwise.
+	 */
+	bool Open(const std::filesystem::path& path);
+
+	void Close();
+
+	[[nodiscard]] bool IsOpen() const { return m_Data != nullptr; }
+
+	[[nodiscard]] const uint8_t* GetData() const { return m_Data; }
+
+	[[nodiscard]] size_t GetSize() const { return m_Size; }
+
+	[[nodiscard]] std::span<const uint8_t> GetSpan() const { return { m_Data, m_Size }; }
+
+private:
+	const uint8_t* m_Data = nullptr;
+	size_t m_Size = 0;
+
+#if defined(DARKFLAME_PLATFORM_WIN32)
+	void* m_FileHandle = nullptr;
+	void* m_MappingHandle = nullptr;
+#endif
+};
+
+#endif  //!__MAPPEDFILE__H__
@@ -14,6 +14,7 @@ std::vector<MetricVariable> Metrics::m_Variables = {
 	MetricVariable::CPUTime,
 	MetricVariable::Sleep,
 	MetricVariable::Frame,
+	MetricVariable::ZoneTransfer,
 };
 
 void Metrics::AddMeasurement(MetricVariable variable, int64_t value) {
@@ -132,6 +133,8 @@ std::string Metrics::MetricVariableToString(MetricVariable variable) {
 		return "Frame";
 	case MetricVariable::Ghosting:
 		return "Ghosting";
+	case MetricVariable::ZoneTransfer:
+		return "ZoneTransfer";
 
 	default:
 		return "Invalid";
@@ -150,6 +153,18 @@ void Metrics::Clear() {
 	m_Metrics.clear();
 }
 
+void Metrics::Clear(MetricVariable variable) {
+	const auto& iter = m_Metrics.find(variable);
+
+	if (iter == m_Metrics.end()) {
+		return;
+	}
+
+	delete iter->second;
+
+	m_Metrics.erase(iter);
+}
+
 /* RSS Memory utilities
  *
  * Author:  David Robert Nadeau
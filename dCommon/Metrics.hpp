@@ -20,6 +20,7 @@ enum class MetricVariable : int32_t
 	CPUTime,
 	Sleep,
 	Frame,
+	ZoneTransfer,
 };
 
 struct Metric
@@ -52,6 +53,7 @@ public:
 	static size_t GetProcessID();
 
 	static void Clear();
+	static void Clear(MetricVariable variable);
 
 private:
 	Metrics();
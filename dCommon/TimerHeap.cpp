@@ -0,0 +1,61 @@
+#include "TimerHeap.h"
+
+#include <algorithm>
+
+TimerHeap::TimerId TimerHeap::After(const Clock::duration delay, std::function<void()> callback, const Clock::time_point now) {
+	return Add(now + delay, Clock::duration::zero(), false, std::move(callback));
+}
+
+TimerHeap::TimerId TimerHeap::Every(const Clock::duration interval, std::function<void()> callback, const Clock::time_point now) {
+	return Add(now + interval, interval, true, std::move(callback));
+}
+
+void TimerHeap::Cancel(const TimerId id) {
+	m_Timers.erase(id);
+}
+
+void TimerHeap::RunDue(const Clock::time_point now) {
+	std::vector<Deadline> due;
+	SkipCancelled();
+	while (!m_Deadlines.empty() && m_Deadlines.top().due <= now) {
+		due.push_back(m_Deadlines.top());
+		m_Deadlines.pop();
+		SkipCancelled();
+	}
+
+	for (const auto& deadline : due) {
+		const auto timer = m_Timers.find(deadline.id);
+		// Cancelled by an earlier callback.
+		if (timer == m_Timers.end()) continue;
+
+		// Copied since the callback may add or cancel timers, which can move the one in the map.
+		auto callback = timer->second.callback;
+		if (timer->second.repeats) {
+			// Keep to the original schedule unless we fell more than a whole interval behind.
+			auto next = deadline.due + timer->second.interval;
+			if (next <= now) next = now + timer->second.interval;
+			m_Deadlines.push({ next, deadline.id });
+		} else {
+			m_Timers.erase(timer);
+		}
+
+		callback();
+	}
+}
+
+TimerHeap::Clock::time_point TimerHeap::GetNextDue(const Clock::time_point latest) {
+	SkipCancelled();
+	if (m_Deadlines.empty()) return latest;
+	return std::min(m_Deadlines.top().due, latest);
+}
+
+TimerHeap::TimerId TimerHeap::Add(const Clock::time_point due, const Clock::duration interval, const bool repeats, std::function<void()> callback) {
+	const auto id = m_NextId++;
+	m_Timers[id] = { interval, repeats, std::move(callback) };
+	m_Deadlines.push({ due, id });
+	return id;
+}
+
+void TimerHeap::SkipCancelled() {
+	while (!m_Deadlines.empty() && !m_Timers.contains(m_Deadlines.top().id)) m_Deadlines.pop();
+}
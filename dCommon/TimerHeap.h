@@ -0,0 +1,68 @@
+#ifndef __TIMERHEAP__H__
+#define __TIMERHEAP__H__
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Callbacks to run at set times, for main loops that sleep until their next packet instead of running
+ * at a fixed frame rate.  The owning thread calls RunDue after waking up and uses GetNextDue to decide
+ * how long it may sleep.  Every call that needs the time takes it as `now`, so tests can drive the heap
+ * without sleeping.
+ */
+class TimerHeap {
+public:
+	using Clock = std::chrono::steady_clock;
+	using TimerId = uint32_t;
+
+	// Runs the callback once, after the delay.
+	TimerId After(Clock::duration delay, std::function<void()> callback, Clock::time_point now = Clock::now());
+
+	// Runs the callback every interval, starting one interval from now.
+	TimerId Every(Clock::duration interval, std::function<void()> callback, Clock::time_point now = Clock::now());
+
+	// Stops a timer from running again.  Safe to call from inside a callback, and for timers that already finished.
+	void Cancel(TimerId id);
+
+	/**
+	 * Runs every timer that is due.  Timers added by a callback wait for the next call, even if
+	 * they are already due.
+	 */
+	void RunDue(Clock::time_point now = Clock::now());
+
+	// @return When the next timer is due, or latest if no timer is due before then.
+	[[nodiscard]] Clock::time_point GetNextDue(Clock::time_point latest);
+
+	[[nodiscard]] size_t GetTimerCount() const { return m_Timers.size(); }
+
+private:
+	struct Timer {
+		Clock::duration interval{};
+		bool repeats = false;
+		std::function<void()> callback;
+	};
+
+	struct Deadline {
+		Clock::time_point due;
+		TimerId id;
+
+		bool operator>(const Deadline& other) const { return due > other.due; }
+	};
+
+	TimerId Add(Clock::time_point due, Clock::duration interval, bool repeats, std::function<void()> callback);
+
+	// Drops deadlines of cancelled timers from the top of the heap.
+	void SkipCancelled();
+
+	TimerId m_NextId = 1;
+	std::unordered_map<TimerId, Timer> m_Timers;
+
+	// Cancelled timers leave their deadline behind, which is skipped once it reaches the top.
+	std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> m_Deadlines;
+};
+
+#endif  //!__TIMERHEAP__H__
@@ -0,0 +1,83 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(const uint32_t threadCount, std::function<void()> onWorkDone) : m_OnWorkDone(std::move(onWorkDone)) {
+	m_Threads.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; i++) {
+		m_Threads.emplace_back(&WorkerPool::WorkerLoop, this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_WorkAvailable.notify_all();
+
+	for (auto& thread : m_Threads) thread.join();
+}
+
+void WorkerPool::Enqueue(std::function<void()> work, std::function<void()> completion) {
+	if (m_Threads.empty()) {
+		work();
+		completion();
+		return;
+	}
+
+	auto job = std::make_shared<Job>();
+	job->work = std::move(work);
+	job->completion = std::move(completion);
+
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Queue.push_back(job);
+		m_Pending.push_back(std::move(job));
+	}
+	m_WorkAvailable.notify_one();
+}
+
+void WorkerPool::ProcessCompletions() {
+	while (true) {
+		std::shared_ptr<Job> job;
+		{
+			std::lock_guard lock(m_Mutex);
+			if (m_Pending.empty() || !m_Pending.front()->done) return;
+
+			job = std::move(m_Pending.front());
+			m_Pending.pop_front();
+		}
+
+		// Run outside the lock, since a completion may submit more work.
+		job->completion();
+	}
+}
+
+size_t WorkerPool::GetPendingCount() {
+	std::lock_guard lock(m_Mutex);
+	return m_Pending.size();
+}
+
+void WorkerPool::WorkerLoop() {
+	while (true) {
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [this]() { return m_Stopping || !m_Queue.empty(); });
+			if (m_Stopping) return;
+
+			job = std::move(m_Queue.front());
+			m_Queue.pop_front();
+		}
+
+		// Submit wraps the work so that whatever it throws is kept for the completion.
+		job->work();
+		job->work = nullptr;
+
+		{
+			std::lock_guard lock(m_Mutex);
+			job->done = true;
+		}
+
+		if (m_OnWorkDone) m_OnWorkDone();
+	}
+}
@@ -0,0 +1,113 @@
+#ifndef __WORKERPOOL__H__
+#define __WORKERPOOL__H__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * A small pool of threads that runs work off the game thread and hands the results back to it.
+ *
+ * Work runs on any of the worker threads, but completions only run when the owning thread calls
+ * ProcessCompletions, and always in the order the work was submitted in.  Completions are free
+ * to touch game state; work must only touch data that is safe to share between threads.
+ *
+ * A pool with no threads runs the work and the completion right away, inside Submit.
+ */
+class WorkerPool {
+public:
+	/**
+	 * @param threadCount How many worker threads to start.
+	 * @param onWorkDone Runs on the worker thread after each piece of work finishes, so that an owning
+	 * thread that sleeps between frames can be woken up to run the completion.
+	 */
+	explicit WorkerPool(uint32_t threadCount, std::function<void()> onWorkDone = nullptr);
+
+	// Stops the workers.  Work that has not finished by then is dropped along with its completion.
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/**
+	 * Queues work for the worker threads.
+	 * An exception thrown by the work is caught on the worker thread and handed to the completion.
+	 * @param work Runs on a worker thread and returns the result.
+	 * @param completion Runs on the thread calling ProcessCompletions.  It either takes the result and the
+	 * exception the work threw, which is null if it did not throw and leaves the result value initialized if it did,
+	 * or it takes just the result, in which case the exception is rethrown from ProcessCompletions instead of
+	 * running it, the same as if the work had run on that thread.
+	 */
+	template<typename Work, typename Completion>
+	void Submit(Work&& work, Completion&& completion) {
+		using Result = std::invoke_result_t<Work&>;
+		struct Outcome {
+			std::optional<Result> result;
+			std::exception_ptr error;
+		};
+
+		auto outcome = std::make_shared<Outcome>();
+		Enqueue(
+			[outcome, work = std::forward<Work>(work)]() mutable {
+				try {
+					outcome->result.emplace(work());
+				} catch (...) {
+					outcome->error = std::current_exception();
+				}
+			},
+			[outcome, completion = std::forward<Completion>(completion)]() mutable {
+				if constexpr (std::is_invocable_v<Completion&, Result, std::exception_ptr>) {
+					completion(outcome->result ? std::move(*outcome->result) : Result{}, outcome->error);
+				} else {
+					if (outcome->error) std::rethrow_exception(outcome->error);
+					completion(std::move(*outcome->result));
+				}
+			}
+		);
+	}
+
+	/**
+	 * Runs the completions of all work that has finished, stopping at the first work still running
+	 * so that completions keep the order their work was submitted in.  If a completion throws, the
+	 * completions after it stay queued for the next call.
+	 */
+	void ProcessCompletions();
+
+	[[nodiscard]] uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Threads.size()); }
+
+	// How much work has been submitted without its completion having run yet.
+	[[nodiscard]] size_t GetPendingCount();
+
+private:
+	struct Job {
+		std::function<void()> work;
+		std::function<void()> completion;
+		bool done = false;
+	};
+
+	void Enqueue(std::function<void()> work, std::function<void()> completion);
+	void WorkerLoop();
+
+	std::function<void()> m_OnWorkDone;
+	std::vector<std::thread> m_Threads;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+	bool m_Stopping = false;
+
+	// Work no worker has picked up yet.
+	std::deque<std::shared_ptr<Job>> m_Queue;
+
+	// Every job whose completion has not run yet, in submission order.
+	std::deque<std::shared_ptr<Job>> m_Pending;
+};
+
+#endif  //!__WORKERPOOL__H__
@@ -1,4 +1,6 @@
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 
 #include "AssetManager.h"
 #include "Game.h"
@@ -66,98 +68,103 @@ eAssetBundleType AssetManager::GetAssetBundleType() {
 	return m_AssetBundleType;
 }
 
-bool AssetManager::HasFile(const char* name) {
+std::string AssetManager::GetFixedName(const char* name) {
 	auto fixedName = std::string(name);
 	std::transform(fixedName.begin(), fixedName.end(), fixedName.begin(), [](uint8_t c) { return std::tolower(c); });
+	std::replace(fixedName.begin(), fixedName.end(), '\\', '/'); // On the off chance someone has the wrong slashes, force forward slashes
 
 	// Special case for unpacked client have BrickModels in upper case
 	if (this->m_AssetBundleType == eAssetBundleType::Unpacked) GeneralUtils::ReplaceInString(fixedName, "brickmodels", "BrickModels");
 
-	std::replace(fixedName.begin(), fixedName.end(), '\\', '/');
-	if (std::filesystem::exists(m_ResPath / fixedName)) return true;
-
-	if (this->m_AssetBundleType == eAssetBundleType::Unpacked) return false;
+	return fixedName;
+}
 
+uint32_t AssetManager::GetPackCrc(std::string fixedName) {
+	// The crc in side of the pack always uses backslashes, so we need to convert them again...
 	std::replace(fixedName.begin(), fixedName.end(), '/', '\\');
-	if (fixedName.rfind("client\\res\\", 0) != 0) fixedName = "client\\res\\" + fixedName;
+	if (fixedName.rfind("client\\res\\", 0) != 0) {
+		fixedName = "client\\res\\" + fixedName;
+	}
 
 	uint32_t crc = crc32b(0xFFFFFFFF, reinterpret_cast<uint8_t*>(const_cast<char*>(fixedName.c_str())), fixedName.size());
 	crc = crc32b(crc, reinterpret_cast<Bytef*>(const_cast<char*>("\0\0\0\0")), 4);
 
-	for (const auto& item : this->m_PackIndex->GetPackFileIndices()) {
-		if (item.m_Crc == crc) {
-			return true;
-		}
-	}
-
-	return false;
+	return crc;
 }
 
-bool AssetManager::GetFile(const char* name, char** data, uint32_t* len) {
-	auto fixedName = std::string(name);
-	std::transform(fixedName.begin(), fixedName.end(), fixedName.begin(), [](uint8_t c) { return std::tolower(c); });
-	std::replace(fixedName.begin(), fixedName.end(), '\\', '/'); // On the off chance someone has the wrong slashes, force forward slashes
+bool AssetManager::HasFile(const char* name) {
+	const auto fixedName = GetFixedName(name);
+	if (std::filesystem::exists(m_ResPath / fixedName)) return true;
 
-	// Special case for unpacked client have BrickModels in upper case
-	if (this->m_AssetBundleType == eAssetBundleType::Unpacked) GeneralUtils::ReplaceInString(fixedName, "brickmodels", "BrickModels");
+	if (this->m_AssetBundleType == eAssetBundleType::Unpacked) return false;
+
+	return this->m_PackIndex->FindFile(GetPackCrc(fixedName)) != nullptr;
+}
+
+bool AssetManager::ReadFile(const char* name, PackFileData& file) {
+	const auto fixedName = GetFixedName(name);
 
 	if (std::filesystem::exists(m_ResPath / fixedName)) {
-		FILE* file;
-#ifdef _WIN32
-		fopen_s(&file, (m_ResPath / fixedName).string().c_str(), "rb");
-#elif __APPLE__
-		// macOS has 64bit file IO by default
-		file = fopen((m_ResPath / fixedName).string().c_str(), "rb");
-#else
-		file = fopen64((m_ResPath / fixedName).string().c_str(), "rb");
-#endif
-		fseek(file, 0, SEEK_END);
-		*len = ftell(file);
-		*data = static_cast<char*>(malloc(*len));
-		fseek(file, 0, SEEK_SET);
-		int32_t readInData = fread(*data, sizeof(uint8_t), *len, file);
-		fclose(file);
+		std::ifstream stream(m_ResPath / fixedName, std::ios::in | std::ios::binary);
+		if (!stream) return false;
+
+		auto data = std::make_shared<std::vector<uint8_t>>(std::filesystem::file_size(m_ResPath / fixedName));
+		stream.read(reinterpret_cast<char*>(data->data()), data->size());
+
+		file.data = *data;
+		file.owner = std::move(data);
 
 		return true;
 	}
 
 	if (this->m_AssetBundleType == eAssetBundleType::Unpacked) return false;
 
-	// The crc in side of the pack always uses backslashes, so we need to convert them again...
-	std::replace(fixedName.begin(), fixedName.end(), '/', '\\');
-	if (fixedName.rfind("client\\res\\", 0) != 0) {
-		fixedName = "client\\res\\" + fixedName;
+	const auto crc = GetPackCrc(fixedName);
+	const auto* index = this->m_PackIndex->FindFile(crc);
+
+	if (index == nullptr || !crc) {
+		return false;
 	}
-	int32_t packIndex = -1;
-	uint32_t crc = crc32b(0xFFFFFFFF, reinterpret_cast<uint8_t*>(const_cast<char*>(fixedName.c_str())), fixedName.size());
-	crc = crc32b(crc, reinterpret_cast<Bytef*>(const_cast<char*>("\0\0\0\0")), 4);
 
-	for (const auto& item : this->m_PackIndex->GetPackFileIndices()) {
-		if (item.m_Crc == crc) {
-			packIndex = item.m_PackFileIndex;
-			crc = item.m_Crc;
-			break;
+	{
+		std::lock_guard lock(m_DecompressedFilesMutex);
+		const auto* cached = m_DecompressedFiles.Find(crc);
+		if (cached) {
+			file = *cached;
+			return true;
 		}
 	}
 
-	if (packIndex == -1 || !crc) {
-		return false;
+	const auto* pack = this->m_PackIndex->GetPacks().at(index->m_PackFileIndex);
+	if (!pack->ReadFile(crc, file)) return false;
+
+	// Views into the mapped pack are free to read again
+	if (file.owner) {
+		std::lock_guard lock(m_DecompressedFilesMutex);
+		m_DecompressedFiles.Insert(crc, file);
 	}
 
-	auto packs = this->m_PackIndex->GetPacks();
-	auto* pack = packs.at(packIndex);
+	return true;
+}
+
+bool AssetManager::GetFile(const char* name, char** data, uint32_t* len) {
+	PackFileData file;
+
+	if (!ReadFile(name, file)) return false;
 
-	bool success = pack->ReadFileFromPack(crc, data, len);
+	*len = file.data.size();
+	*data = static_cast<char*>(malloc(*len));
+	std::memcpy(*data, file.data.data(), *len);
 
-	return success;
+	return true;
 }
 
 AssetStream AssetManager::GetFile(const char* name) {
-	char* buf; uint32_t len;
+	PackFileData file;
 
-	bool success = this->GetFile(name, &buf, &len);
+	bool success = this->ReadFile(name, file);
 
-	return AssetStream(buf, len, success);
+	return AssetStream(file, success);
 }
 
 uint32_t AssetManager::crc32b(uint32_t base, uint8_t* message, size_t l) {
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <filesystem>
 
+#include "LruCache.h"
 #include "Pack.h"
 #include "PackIndex.h"
 
@@ -15,18 +19,29 @@ enum class eAssetBundleType {
 };
 
 struct AssetMemoryBuffer : std::streambuf {
-	char* m_Base;
+	// Keeps the bytes alive while the buffer reads them.  Empty for views into a mapped pack.
+	std::shared_ptr<const void> m_Owner;
 	bool m_Success;
 
 	AssetMemoryBuffer(char* base, std::ptrdiff_t n, bool success) {
-		m_Base = base;
 		m_Success = success;
 		if (!m_Success) return;
+		m_Owner = std::shared_ptr<const void>(base, free);
 		this->setg(base, base, base + n);
 	}
 
-	~AssetMemoryBuffer() {
-		if (m_Success) free(m_Base);
+	AssetMemoryBuffer(const PackFileData& file, bool success) {
+		m_Success = success;
+		if (!m_Success) return;
+		m_Owner = file.owner;
+		// The get area is never written to, it only has to be non-const for std::streambuf.
+		auto* base = reinterpret_cast<char*>(const_cast<uint8_t*>(file.data.data()));
+		this->setg(base, base, base + file.data.size());
+	}
+
+	std::span<const uint8_t> GetData() const {
+		if (!m_Success) return {};
+		return { reinterpret_cast<const uint8_t*>(eback()), static_cast<size_t>(egptr() - eback()) };
 	}
 
 	pos_type seekpos(pos_type sp, std::ios_base::openmode which) override {
@@ -48,6 +63,7 @@ struct AssetMemoryBuffer : std::streambuf {
 
 struct AssetStream : std::istream {
 	AssetStream(char* base, std::ptrdiff_t n, bool success) : std::istream(new AssetMemoryBuffer(base, n, success)) {}
+	AssetStream(const PackFileData& file, bool success) : std::istream(new AssetMemoryBuffer(file, success)) {}
 
 	~AssetStream() {
 		delete rdbuf();
@@ -56,6 +72,11 @@ struct AssetStream : std::istream {
 	operator bool() {
 		return reinterpret_cast<AssetMemoryBuffer*>(rdbuf())->m_Success;
 	}
+
+	// The whole file, regardless of where the stream is currently reading.
+	std::span<const uint8_t> GetData() {
+		return reinterpret_cast<AssetMemoryBuffer*>(rdbuf())->GetData();
+	}
 };
 
 class AssetManager {
@@ -68,11 +89,22 @@ public:
 
 	bool HasFile(const char* name);
 	bool GetFile(const char* name, char** data, uint32_t* len);
+
+	/**
+	 * Files in packs are read without copying them when they are stored uncompressed, and recently
+	 * decompressed files are shared between readers.  Safe to call from several threads at once.
+	 */
 	AssetStream GetFile(const char* name);
 
 private:
 	void LoadPackIndex();
 
+	bool ReadFile(const char* name, PackFileData& file);
+
+	// Lower cases the name and fixes up its slashes for the bundle type
+	std::string GetFixedName(const char* name);
+	uint32_t GetPackCrc(std::string fixedName);
+
 	// Modified crc algorithm (mpeg2)
 	// Reference: https://stackoverflow.com/questions/54339800/how-to-modify-crc-32-to-crc-32-mpeg-2
 	inline uint32_t crc32b(uint32_t base, uint8_t* message, size_t l);
@@ -86,4 +118,8 @@ private:
 	eAssetBundleType m_AssetBundleType = eAssetBundleType::None;
 
 	PackIndex* m_PackIndex;
+
+	// Zones, triggers and brick models are read several times while a world starts up.
+	LruCache<uint32_t, PackFileData> m_DecompressedFiles{ 32 };
+	std::mutex m_DecompressedFilesMutex;
 };
@@ -1,119 +1,137 @@
 #include "Pack.h"
 
-#include "BinaryIO.h"
+#include <algorithm>
+#include <cstring>
+
+#include "Game.h"
+#include "Logger.h"
 #include "ZCompression.h"
 
+namespace {
+	template<typename T>
+	T ReadAt(const std::span<const uint8_t> data, const size_t offset) {
+		T value{};
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		return value;
+	}
+};
+
 Pack::Pack(const std::filesystem::path& filePath) {
 	m_FilePath = filePath;
+	m_RecordCount = 0;
 
-	if (!std::filesystem::exists(filePath)) {
+	if (!std::filesystem::exists(filePath) || !m_File.Open(filePath)) {
 		return;
 	}
 
-	m_FileStream = std::ifstream(filePath, std::ios::in | std::ios::binary);
-
-	m_FileStream.read(m_Version, 7);
-
-	m_FileStream.seekg(-8, std::ios::end); // move file pointer to 8 bytes before the end (location of the address of the record count)
-
-	uint32_t recordCountPos = 0;
-	BinaryIO::BinaryRead<uint32_t>(m_FileStream, recordCountPos);
-
-	m_FileStream.seekg(recordCountPos, std::ios::beg);
-
-	BinaryIO::BinaryRead<uint32_t>(m_FileStream, m_RecordCount);
+	const auto data = m_File.GetSpan();
+	if (data.size() < sizeof(m_Version) + 8) {
+		LOG("Pack file %s is too small to be a pack", m_FilePath.string().c_str());
+		return;
+	}
 
-	for (int i = 0; i < m_RecordCount; i++) {
-		PackRecord record;
-		BinaryIO::BinaryRead<PackRecord>(m_FileStream, record);
+	std::memcpy(m_Version, data.data(), sizeof(m_Version));
 
-		m_Records.push_back(record);
+	// The address of the record count is 8 bytes before the end.
+	const auto recordCountPos = ReadAt<uint32_t>(data, data.size() - 8);
+	if (recordCountPos + sizeof(uint32_t) > data.size()) {
+		LOG("Pack file %s has an invalid record table", m_FilePath.string().c_str());
+		return;
 	}
 
-	m_FileStream.close();
-}
+	m_RecordCount = ReadAt<uint32_t>(data, recordCountPos);
 
-bool Pack::HasFile(uint32_t crc) {
-	for (const auto& record : m_Records) {
-		if (record.m_Crc == crc) {
-			return true;
-		}
+	const auto recordsPos = recordCountPos + sizeof(uint32_t);
+	if (m_RecordCount > (data.size() - recordsPos) / sizeof(PackRecord)) {
+		LOG("Pack file %s has more records than fit in it", m_FilePath.string().c_str());
+		m_RecordCount = 0;
+		return;
 	}
 
-	return false;
+	m_Records.resize(m_RecordCount);
+	std::memcpy(m_Records.data(), data.data() + recordsPos, m_RecordCount * sizeof(PackRecord));
+
+	// Stable, so a CRC listed twice still finds the record that comes first in the pack, like the old linear scan.
+	std::stable_sort(m_Records.begin(), m_Records.end(), [](const PackRecord& a, const PackRecord& b) { return a.m_Crc < b.m_Crc; });
 }
 
-bool Pack::ReadFileFromPack(uint32_t crc, char** data, uint32_t* len) {
-	// Time for some wacky C file reading for speed reasons
+const PackRecord* Pack::FindRecord(uint32_t crc) const {
+	const auto it = std::lower_bound(m_Records.begin(), m_Records.end(), crc, [](const PackRecord& record, uint32_t crc) { return record.m_Crc < crc; });
 
-	PackRecord pkRecord{};
+	if (it == m_Records.end() || it->m_Crc != crc) return nullptr;
 
-	for (const auto& record : m_Records) {
-		if (record.m_Crc == crc) {
-			pkRecord = record;
-			break;
-		}
-	}
+	return &*it;
+}
 
-	if (pkRecord.m_Crc == 0) return false;
+bool Pack::HasFile(uint32_t crc) const {
+	return FindRecord(crc) != nullptr;
+}
 
-	size_t pos = 0;
-	pos += pkRecord.m_FilePointer;
+bool Pack::ReadFile(uint32_t crc, PackFileData& file) const {
+	const auto* record = FindRecord(crc);
 
-	bool isCompressed = (pkRecord.m_IsCompressed & 0xff) > 0;
-	auto inPackSize = isCompressed ? pkRecord.m_CompressedSize : pkRecord.m_UncompressedSize;
+	if (record == nullptr || record->m_Crc == 0) return false;
 
-	FILE* file;
-#ifdef _WIN32
-	fopen_s(&file, m_FilePath.string().c_str(), "rb");
-#elif __APPLE__
-	// macOS has 64bit file IO by default
-	file = fopen(m_FilePath.string().c_str(), "rb");
-#else
-	file = fopen64(m_FilePath.string().c_str(), "rb");
-#endif
+	const auto data = m_File.GetSpan();
+	const bool isCompressed = (record->m_IsCompressed & 0xff) > 0;
+	const uint64_t inPackSize = isCompressed ? record->m_CompressedSize : record->m_UncompressedSize;
 
-	fseek(file, pos, SEEK_SET);
+	if (record->m_FilePointer + inPackSize > data.size()) {
+		LOG("File %08x runs past the end of pack %s", crc, m_FilePath.string().c_str());
+		return false;
+	}
 
 	if (!isCompressed) {
-		char* tempData = static_cast<char*>(malloc(pkRecord.m_UncompressedSize));
-		int32_t readInData = fread(tempData, sizeof(uint8_t), pkRecord.m_UncompressedSize, file);
-
-		*data = tempData;
-		*len = pkRecord.m_UncompressedSize;
-		fclose(file);
+		file.data = data.subspan(record->m_FilePointer, record->m_UncompressedSize);
+		file.owner = nullptr;
 
 		return true;
 	}
 
-	pos += 5; // skip header
-
-	fseek(file, pos, SEEK_SET);
+	// sd0 files are a 5 byte header followed by zlib chunks, each prefixed with its compressed size.
+	auto pos = record->m_FilePointer + 5;
+	const auto end = record->m_FilePointer + inPackSize;
 
-	char* decompressedData = static_cast<char*>(malloc(pkRecord.m_UncompressedSize));
+	auto decompressed = std::make_shared<std::vector<uint8_t>>(record->m_UncompressedSize);
 	uint32_t currentReadPos = 0;
 
-	while (true) {
-		if (currentReadPos >= pkRecord.m_UncompressedSize) break;
+	while (currentReadPos < record->m_UncompressedSize) {
+		if (pos + sizeof(uint32_t) > end) break;
 
-		uint32_t size;
-		int32_t readInData = fread(&size, sizeof(uint32_t), 1, file);
-		pos += 4; // Move pointer position 4 to the right
+		const auto size = ReadAt<uint32_t>(data, pos);
+		pos += sizeof(uint32_t);
 
-		char* chunk = static_cast<char*>(malloc(size));
-		int32_t readInData2 = fread(chunk, sizeof(int8_t), size, file);
-		pos += size; // Move pointer position the amount of bytes read to the right
+		if (pos + size > end) break;
 
 		int32_t err;
-		currentReadPos += ZCompression::Decompress(reinterpret_cast<uint8_t*>(chunk), size, reinterpret_cast<uint8_t*>(decompressedData + currentReadPos), ZCompression::MAX_SD0_CHUNK_SIZE, err);
+		const auto maxSize = std::min(record->m_UncompressedSize - currentReadPos, ZCompression::MAX_SD0_CHUNK_SIZE);
+		const auto read = ZCompression::Decompress(data.data() + pos, size, decompressed->data() + currentReadPos, maxSize, err);
+		pos += size;
+
+		if (read <= 0) break;
 
-		free(chunk);
+		currentReadPos += read;
 	}
 
-	*data = decompressedData;
-	*len = pkRecord.m_UncompressedSize;
+	if (currentReadPos != record->m_UncompressedSize) {
+		LOG("Failed to decompress file %08x from pack %s", crc, m_FilePath.string().c_str());
+		return false;
+	}
+
+	file.data = *decompressed;
+	file.owner = std::move(decompressed);
+
+	return true;
+}
+
+bool Pack::ReadFileFromPack(uint32_t crc, char** data, uint32_t* len) const {
+	PackFileData file;
+
+	if (!ReadFile(crc, file)) return false;
 
-	fclose(file);
+	*data = static_cast<char*>(malloc(file.data.size()));
+	std::memcpy(*data, file.data.data(), file.data.size());
+	*len = file.data.size();
 
 	return true;
 }
@@ -1,9 +1,13 @@
 #pragma once
 
-#include <vector>
-#include <string>
+#include <cstdint>
 #include <filesystem>
-#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
 
 #pragma pack(push, 1)
 struct PackRecord {
@@ -21,19 +25,42 @@ struct PackRecord {
 };
 #pragma pack(pop)
 
+/**
+ * The contents of a file read from a pack.  Files stored uncompressed are a view straight into the mapped
+ * pack, valid for as long as the pack is loaded, and have no owner.  Compressed files own their
+ * decompressed bytes through owner.
+ */
+struct PackFileData {
+	std::span<const uint8_t> data;
+	std::shared_ptr<const void> owner;
+};
+
 class Pack {
 public:
 	Pack(const std::filesystem::path& filePath);
 	~Pack() = default;
 
-	bool HasFile(uint32_t crc);
-	bool ReadFileFromPack(uint32_t crc, char** data, uint32_t* len);
+	bool HasFile(uint32_t crc) const;
+
+	/**
+	 * Reads a file out of the pack.  Safe to call from several threads at once.
+	 * @return false if the pack has no file with the crc or it could not be read
+	 */
+	bool ReadFile(uint32_t crc, PackFileData& file) const;
+
+	/**
+	 * Reads a file into a buffer allocated with malloc, which the caller has to free
+	 */
+	bool ReadFileFromPack(uint32_t crc, char** data, uint32_t* len) const;
 private:
-	std::ifstream m_FileStream;
+	const PackRecord* FindRecord(uint32_t crc) const;
+
 	std::filesystem::path m_FilePath;
+	MappedFile m_File;
 
 	char m_Version[7];
 
 	uint32_t m_RecordCount;
+	// Sorted by crc.
 	std::vector<PackRecord> m_Records;
 };
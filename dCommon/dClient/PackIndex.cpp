@@ -16,10 +16,13 @@ PackIndex::PackIndex(const std::filesystem::path& filePath) {
 
 	BinaryIO::BinaryRead<uint32_t>(m_FileStream, m_PackFileIndexCount);
 
+	m_PackFileIndicesByCrc.reserve(m_PackFileIndexCount);
 	for (int i = 0; i < m_PackFileIndexCount; i++) {
 		PackFileIndex packFileIndex;
 		BinaryIO::BinaryRead<PackFileIndex>(m_FileStream, packFileIndex);
 
+		// The first entry wins, same as the linear scan this replaced
+		m_PackFileIndicesByCrc.try_emplace(packFileIndex.m_Crc, m_PackFileIndices.size());
 		m_PackFileIndices.push_back(packFileIndex);
 	}
 
@@ -36,6 +39,13 @@ PackIndex::PackIndex(const std::filesystem::path& filePath) {
 	m_FileStream.close();
 }
 
+const PackFileIndex* PackIndex::FindFile(uint32_t crc) const {
+	const auto it = m_PackFileIndicesByCrc.find(crc);
+	if (it == m_PackFileIndicesByCrc.end()) return nullptr;
+
+	return &m_PackFileIndices[it->second];
+}
+
 PackIndex::~PackIndex() {
 	for (const auto* item : m_Packs) {
 		delete item;
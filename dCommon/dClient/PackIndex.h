@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <fstream>
+#include <unordered_map>
 
 #include "Pack.h"
 
@@ -26,6 +28,11 @@ public:
 	const std::vector<std::string>& GetPackPaths() { return m_PackPaths; }
 	const std::vector<PackFileIndex>& GetPackFileIndices() { return m_PackFileIndices; }
 	const std::vector<Pack*>& GetPacks() { return m_Packs; }
+
+	/**
+	 * @return The index entry of the file with the crc, or nullptr if no pack has it
+	 */
+	const PackFileIndex* FindFile(uint32_t crc) const;
 private:
 	std::ifstream m_FileStream;
 
@@ -35,6 +42,8 @@ private:
 	std::vector<std::string> m_PackPaths;
 	uint32_t m_PackFileIndexCount;
 	std::vector<PackFileIndex> m_PackFileIndices;
+	// Crc to position in m_PackFileIndices
+	std::unordered_map<uint32_t, uint32_t> m_PackFileIndicesByCrc;
 
 	std::vector<Pack*> m_Packs;
 };
@@ -74,5 +74,6 @@ namespace MessageType {
 		UPDATE_FREE_TRIAL_STATUS,
 		// CUSTOM DLU MESSAGE ID FOR INTERNAL USE
 		CREATE_TEAM,
+		CHARACTER_CHANGED,
 	};
 }
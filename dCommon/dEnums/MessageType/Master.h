@@ -29,6 +29,8 @@ namespace MessageType {
 		AFFIRM_TRANSFER_REQUEST,
 		AFFIRM_TRANSFER_RESPONSE,
 
-		NEW_SESSION_ALERT
+		NEW_SESSION_ALERT,
+
+		WORLD_LOAD
 	};
 }
@@ -0,0 +1,21 @@
+#ifndef __EQOSCLASS__H__
+#define __EQOSCLASS__H__
+
+#include <cstdint>
+
+/**
+ * What kind of traffic a message sent to a client is, so that dServer::Send can deliver each kind with its
+ * own priority and ordering channel.  A datagram lost on one channel only holds up the messages on that channel.
+ */
+enum class eQosClass : uint8_t {
+	// Replica construction, serialization and destruction, which carries movement along with all other object state.
+	STATE,
+	// Game messages and anything else without a class of its own.
+	GAMEPLAY,
+	// Chat messages and the social packets routed from the chat server.
+	CHAT,
+	// Large responses nothing else waits on, like leaderboards, property lists and the blueprints sent on login.
+	BULK
+};
+
+#endif  //!__EQOSCLASS__H__
@@ -4,15 +4,33 @@
 // Static Variables
 static CppSQLite3DB* conn = new CppSQLite3DB();
 
+static std::string connectedFilename;
+
 // Status Variables
 bool CDClientDatabase::isConnected = false;
 
 //! Opens a connection with the CDClient
 void CDClientDatabase::Connect(const std::string& filename) {
 	conn->open(filename.c_str());
+	// Let SQLite read pages straight out of a mapping of the file that is shared between every server on the host,
+	// rather than copying them into a page cache per process.
+	conn->execDML("PRAGMA mmap_size = 268435456;");
+	connectedFilename = filename;
 	isConnected = true;
 }
 
+//! Closes the connection with the CDClient
+void CDClientDatabase::Disconnect() {
+	conn->close();
+	connectedFilename.clear();
+	isConnected = false;
+}
+
+//! Gets the filename of the connected CDClient
+const std::string& CDClientDatabase::GetFilename() {
+	return connectedFilename;
+}
+
 //! Queries the CDClient
 CppSQLite3Query CDClientDatabase::ExecuteQuery(const std::string& query) {
 	return conn->execQuery(query.c_str());
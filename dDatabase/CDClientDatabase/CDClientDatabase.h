@@ -26,6 +26,15 @@ namespace CDClientDatabase {
 	 */
 	void Connect(const std::string& filename);
 
+	//! Closes the connection with the CDClient
+	void Disconnect();
+
+	//! Gets the filename of the connected CDClient
+	/*!
+	  \return The filename passed to Connect, or an empty string if not connected
+	 */
+	const std::string& GetFilename();
+
 	//! Queries the CDClient
 	/*!
 	  \param query The query
@@ -4,6 +4,7 @@
 #include "CDBehaviorParameterTable.h"
 #include "CDBehaviorTemplateTable.h"
 #include "CDClientDatabase.h"
+#include "CDClientSnapshot.h"
 #include "CDComponentsRegistryTable.h"
 #include "CDCurrencyTableTable.h"
 #include "CDDestructibleComponentTable.h"
@@ -109,6 +110,12 @@ void CDClientManager::LoadValuesFromDatabase() {
 		throw std::runtime_error{ "CDClientDatabase is not connected!" };
 	}
 
+	// Tables that support it will read their rows out of the shared snapshot instead of the database.
+	const auto snapshotPath = std::filesystem::path(CDClientDatabase::GetFilename()).replace_extension(".snapshot");
+	const auto sourceHash = CDClientSnapshot::HashFile(CDClientDatabase::GetFilename());
+	const bool snapshotLoaded = CDClientSnapshot::Load(snapshotPath, sourceHash);
+	if (snapshotLoaded) LOG("Using CDClient snapshot %s", snapshotPath.string().c_str());
+
 	CDActivityRewardsTable::Instance().LoadValuesFromDatabase();
 	CDActivitiesTable::Instance().LoadValuesFromDatabase();
 	CDCLIENT_DONT_CACHE_TABLE(CDAnimationsTable::Instance().LoadValuesFromDatabase());
@@ -150,6 +157,16 @@ void CDClientManager::LoadValuesFromDatabase() {
 	CDTamingBuildPuzzleTable::Instance().LoadValuesFromDatabase();
 	CDVendorComponentTable::Instance().LoadValuesFromDatabase();
 	CDZoneTableTable::Instance().LoadValuesFromDatabase();
+
+	if (!snapshotLoaded && !sourceHash.empty()) {
+		CDClientSnapshot::Writer writer;
+		CDBehaviorParameterTable::Instance().AddToSnapshot(writer);
+		if (writer.Save(snapshotPath, sourceHash)) {
+			LOG("Wrote CDClient snapshot to %s", snapshotPath.string().c_str());
+		} else {
+			LOG("Failed to write CDClient snapshot to %s", snapshotPath.string().c_str());
+		}
+	}
 }
 
 void CDClientManager::LoadValuesFromDefaults() {
@@ -0,0 +1,182 @@
+#include "CDClientSnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include "MD5.h"
+#include "MappedFile.h"
+
+namespace {
+	constexpr uint32_t SNAPSHOT_MAGIC = 0x53534443; // "CDSS"
+	constexpr size_t SECTION_NAME_LENGTH = 48;
+	constexpr size_t SECTION_ALIGNMENT = 16;
+	constexpr size_t HASH_LENGTH = 32;
+
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		char sourceHash[HASH_LENGTH];
+		uint32_t sectionCount;
+		uint32_t padding;
+	};
+
+	struct SectionHeader {
+		char name[SECTION_NAME_LENGTH];
+		uint64_t offset;
+		uint64_t size;
+		uint32_t rowSize;
+		uint32_t padding;
+	};
+
+	MappedFile snapshot;
+
+	size_t AlignUp(const size_t value) {
+		return (value + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+	}
+
+	const FileHeader& GetFileHeader() {
+		return *reinterpret_cast<const FileHeader*>(snapshot.GetData());
+	}
+
+	const SectionHeader* GetSectionHeaders() {
+		return reinterpret_cast<const SectionHeader*>(snapshot.GetData() + sizeof(FileHeader));
+	}
+};
+
+std::string CDClientSnapshot::HashFile(const std::filesystem::path& path) {
+	const MappedFile file(path);
+	if (!file.IsOpen()) return "";
+
+	MD5 md5;
+	// MD5 takes 32 bit lengths, so feed it the file in chunks.
+	constexpr size_t chunkSize = 1024 * 1024;
+	for (size_t offset = 0; offset < file.GetSize(); offset += chunkSize) {
+		const auto length = std::min(chunkSize, file.GetSize() - offset);
+		md5.update(file.GetData() + offset, static_cast<MD5::size_type>(length));
+	}
+	md5.finalize();
+
+	return md5.hexdigest();
+}
+
+bool CDClientSnapshot::Load(const std::filesystem::path& snapshotPath, const std::string& sourceHash) {
+	Unload();
+	if (sourceHash.size() != HASH_LENGTH || !snapshot.Open(snapshotPath)) return false;
+
+	const auto isValid = [&sourceHash]() {
+		if (snapshot.GetSize() < sizeof(FileHeader)) return false;
+
+		const auto& header = GetFileHeader();
+		if (header.magic != SNAPSHOT_MAGIC || header.version != FORMAT_VERSION) return false;
+		if (std::memcmp(header.sourceHash, sourceHash.data(), HASH_LENGTH) != 0) return false;
+		if (snapshot.GetSize() < sizeof(FileHeader) + header.sectionCount * sizeof(SectionHeader)) return false;
+
+		const auto* sections = GetSectionHeaders();
+		for (uint32_t i = 0; i < header.sectionCount; i++) {
+			const auto& section = sections[i];
+			if (section.offset % SECTION_ALIGNMENT != 0 || section.offset > snapshot.GetSize()) return false;
+			if (section.size > snapshot.GetSize() - section.offset) return false;
+			if (section.rowSize == 0 || section.size % section.rowSize != 0) return false;
+		}
+
+		return true;
+	};
+
+	if (!isValid()) {
+		snapshot.Close();
+		return false;
+	}
+
+	return true;
+}
+
+void CDClientSnapshot::Unload() {
+	snapshot.Close();
+}
+
+bool CDClientSnapshot::IsLoaded() {
+	return snapshot.IsOpen();
+}
+
+std::span<const uint8_t> CDClientSnapshot::GetRawSection(std::string_view name, uint32_t rowSize) {
+	if (!snapshot.IsOpen() || name.size() >= SECTION_NAME_LENGTH) return {};
+
+	const auto& header = GetFileHeader();
+	const auto* sections = GetSectionHeaders();
+	for (uint32_t i = 0; i < header.sectionCount; i++) {
+		const auto& section = sections[i];
+		if (name != std::string_view(section.name, strnlen(section.name, SECTION_NAME_LENGTH))) continue;
+		if (section.rowSize != rowSize) return {};
+
+		return { snapshot.GetData() + section.offset, static_cast<size_t>(section.size) };
+	}
+
+	return {};
+}
+
+void CDClientSnapshot::Writer::AddRawSection(std::string_view name, std::span<const uint8_t> data, uint32_t rowSize) {
+	if (name.size() >= SECTION_NAME_LENGTH) throw std::invalid_argument("Snapshot section name is too long: " + std::string(name));
+
+	m_Sections.push_back(Section{ std::string(name), rowSize, std::vector<uint8_t>(data.begin(), data.end()) });
+}
+
+bool CDClientSnapshot::Writer::Save(const std::filesystem::path& snapshotPath, const std::string& sourceHash) const {
+	if (sourceHash.size() != HASH_LENGTH) return false;
+
+	FileHeader header{};
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = FORMAT_VERSION;
+	std::memcpy(header.sourceHash, sourceHash.data(), HASH_LENGTH);
+	header.sectionCount = m_Sections.size();
+
+	std::vector<SectionHeader> sectionHeaders(m_Sections.size());
+	size_t offset = AlignUp(sizeof(FileHeader) + sectionHeaders.size() * sizeof(SectionHeader));
+	for (size_t i = 0; i < m_Sections.size(); i++) {
+		auto& sectionHeader = sectionHeaders[i];
+		std::memcpy(sectionHeader.name, m_Sections[i].name.data(), m_Sections[i].name.size());
+		sectionHeader.offset = offset;
+		sectionHeader.size = m_Sections[i].data.size();
+		sectionHeader.rowSize = m_Sections[i].rowSize;
+		offset = AlignUp(offset + sectionHeader.size);
+	}
+
+	// Several servers may be generating the snapshot at the same time, so each one writes to its own file.
+	auto tempPath = snapshotPath;
+	tempPath += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file) return false;
+
+		const auto writePadding = [&file]() {
+			const char zeroes[SECTION_ALIGNMENT] = {};
+			const auto position = static_cast<size_t>(file.tellp());
+			file.write(zeroes, AlignUp(position) - position);
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(sectionHeaders.data()), sectionHeaders.size() * sizeof(SectionHeader));
+		for (const auto& section : m_Sections) {
+			writePadding();
+			file.write(reinterpret_cast<const char*>(section.data.data()), section.data.size());
+		}
+		writePadding();
+
+		if (!file) {
+			file.close();
+			std::filesystem::remove(tempPath);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, snapshotPath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
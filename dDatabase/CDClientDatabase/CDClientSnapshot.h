@@ -0,0 +1,84 @@
+#ifndef __CDCLIENTSNAPSHOT__H__
+#define __CDCLIENTSNAPSHOT__H__
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A compact, read-only binary image of the cached CDClient tables.
+ *
+ * The snapshot is written once (by the master server, or by whichever server loads the tables first)
+ * and is memory mapped by every other server on the host, so tables that read their rows out of it
+ * share the same physical pages instead of each process holding its own copy.
+ * A snapshot is only used if it was generated from a CDServer.sqlite with the same hash as the one we are connected to.
+ */
+namespace CDClientSnapshot {
+	// Bump this whenever the layout of the file or of any row stored in it changes.
+	constexpr uint32_t FORMAT_VERSION = 1;
+
+	/**
+	 * Computes the hash a snapshot is versioned against.
+	 * @param path The source CDServer.sqlite
+	 * @return The hex digest of the file, or an empty string if the file could not be read.
+	 */
+	std::string HashFile(const std::filesystem::path& path);
+
+	/**
+	 * Maps the snapshot at the given path.
+	 * @param snapshotPath The snapshot to map
+	 * @param sourceHash The hash of the CDServer.sqlite currently in use
+	 * @return true if the snapshot exists, is well formed and matches sourceHash.
+	 */
+	bool Load(const std::filesystem::path& snapshotPath, const std::string& sourceHash);
+
+	void Unload();
+
+	[[nodiscard]] bool IsLoaded();
+
+	/**
+	 * Gets the raw bytes of a section of the loaded snapshot.
+	 * @return The section, or an empty span if there is no loaded snapshot, no section with this name or its row size differs.
+	 */
+	[[nodiscard]] std::span<const uint8_t> GetRawSection(std::string_view name, uint32_t rowSize);
+
+	template<typename T>
+	[[nodiscard]] std::span<const T> GetSection(std::string_view name) {
+		static_assert(std::is_trivially_copyable_v<T>, "Snapshot rows must be trivially copyable");
+		const auto raw = GetRawSection(name, sizeof(T));
+		return { reinterpret_cast<const T*>(raw.data()), raw.size() / sizeof(T) };
+	}
+
+	class Writer {
+	public:
+		void AddRawSection(std::string_view name, std::span<const uint8_t> data, uint32_t rowSize);
+
+		template<typename T>
+		void AddSection(std::string_view name, std::span<const T> rows) {
+			static_assert(std::is_trivially_copyable_v<T>, "Snapshot rows must be trivially copyable");
+			AddRawSection(name, { reinterpret_cast<const uint8_t*>(rows.data()), rows.size_bytes() }, sizeof(T));
+		}
+
+		/**
+		 * Writes the snapshot to disk.  The file is written next to its destination and then renamed into place
+		 * so servers that are starting up never map a half written snapshot.
+		 * @return true if the snapshot was written.
+		 */
+		bool Save(const std::filesystem::path& snapshotPath, const std::string& sourceHash) const;
+
+	private:
+		struct Section {
+			std::string name;
+			uint32_t rowSize;
+			std::vector<uint8_t> data;
+		};
+
+		std::vector<Section> m_Sections;
+	};
+};
+
+#endif  //!__CDCLIENTSNAPSHOT__H__
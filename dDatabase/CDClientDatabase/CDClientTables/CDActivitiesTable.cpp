@@ -46,6 +46,8 @@ void CDActivitiesTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByActivityID, m_ByInstanceMapID);
 }
 
 std::vector<CDActivities> CDActivitiesTable::Query(std::function<bool(CDActivities)> predicate) {
@@ -56,3 +58,11 @@ std::vector<CDActivities> CDActivitiesTable::Query(std::function<bool(CDActiviti
 
 	return data;
 }
+
+const CDActivities* CDActivitiesTable::GetByActivityID(uint32_t activityID) const {
+	return m_ByActivityID.Find(activityID);
+}
+
+std::span<const CDActivities* const> CDActivitiesTable::GetByInstanceMapID(uint32_t instanceMapID) const {
+	return m_ByInstanceMapID.Find(instanceMapID);
+}
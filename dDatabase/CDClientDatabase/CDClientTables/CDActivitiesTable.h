@@ -31,4 +31,12 @@ public:
 
 	// Queries the table with a custom "where" clause
 	std::vector<CDActivities> Query(std::function<bool(CDActivities)> predicate);
+
+	const CDActivities* GetByActivityID(uint32_t activityID) const;
+
+	std::span<const CDActivities* const> GetByInstanceMapID(uint32_t instanceMapID) const;
+
+private:
+	CDUniqueIndex<&CDActivities::ActivityID> m_ByActivityID;
+	CDMultiIndex<&CDActivities::instanceMapID> m_ByInstanceMapID;
 };
@@ -35,6 +35,8 @@ void CDActivityRewardsTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByObjectTemplate, m_ByLootMatrixIndex);
 }
 
 std::vector<CDActivityRewards> CDActivityRewardsTable::Query(std::function<bool(CDActivityRewards)> predicate) {
@@ -45,3 +47,11 @@ std::vector<CDActivityRewards> CDActivityRewardsTable::Query(std::function<bool(
 
 	return data;
 }
+
+std::span<const CDActivityRewards* const> CDActivityRewardsTable::GetByObjectTemplate(uint32_t objectTemplate) const {
+	return m_ByObjectTemplate.Find(objectTemplate);
+}
+
+std::span<const CDActivityRewards* const> CDActivityRewardsTable::GetByLootMatrixIndex(uint32_t lootMatrixIndex) const {
+	return m_ByLootMatrixIndex.Find(lootMatrixIndex);
+}
@@ -18,4 +18,12 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDActivityRewards> Query(std::function<bool(CDActivityRewards)> predicate);
+
+	std::span<const CDActivityRewards* const> GetByObjectTemplate(uint32_t objectTemplate) const;
+
+	std::span<const CDActivityRewards* const> GetByLootMatrixIndex(uint32_t lootMatrixIndex) const;
+
+private:
+	CDMultiIndex<&CDActivityRewards::objectTemplate> m_ByObjectTemplate;
+	CDMultiIndex<&CDActivityRewards::LootMatrixIndex> m_ByLootMatrixIndex;
 };
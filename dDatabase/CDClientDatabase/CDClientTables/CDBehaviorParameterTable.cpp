@@ -1,8 +1,26 @@
 #include "CDBehaviorParameterTable.h"
 #include "GeneralUtils.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace {
-	std::unordered_map<std::string, uint32_t> m_ParametersList;
+	std::unordered_map<std::string, uint32_t, GeneralUtils::transparent_string_hash, std::equal_to<>> m_ParametersList;
+	std::vector<std::string> m_ParameterNames;
+
+	constexpr std::string_view PARAMETERS_SECTION = "BehaviorParameter";
+	constexpr std::string_view PARAMETER_NAMES_SECTION = "BehaviorParameterNames";
+
+	// Behavior ids above this are looked up with a binary search rather than getting an offset slot.
+	constexpr uint32_t MAX_OFFSET_BEHAVIOR_ID = 1U << 20U;
+
+	constexpr uint32_t GetBehaviorIDFromHash(const BehaviorParameterHash hash) {
+		return static_cast<uint32_t>(hash >> 31U);
+	}
+
+	constexpr uint32_t GetParameterIDFromHash(const BehaviorParameterHash hash) {
+		return static_cast<uint32_t>(hash & 0x7FFFFFFFU);
+	}
 };
 
 uint64_t GetKey(const uint32_t behaviorID, const uint32_t parameterID) {
@@ -14,6 +32,8 @@ uint64_t GetKey(const uint32_t behaviorID, const uint32_t parameterID) {
 }
 
 void CDBehaviorParameterTable::LoadValuesFromDatabase() {
+	if (LoadValuesFromSnapshot()) return;
+
 	auto tableData = CDClientDatabase::ExecuteQuery("SELECT * FROM BehaviorParameter");
 	auto& entries = GetEntriesMutable();
 	while (!tableData.eof()) {
@@ -25,38 +45,116 @@ void CDBehaviorParameterTable::LoadValuesFromDatabase() {
 			parameterId = parameter->second;
 		} else {
 			parameterId = m_ParametersList.insert(std::make_pair(candidateStringToAdd, m_ParametersList.size())).first->second;
+			m_ParameterNames.push_back(candidateStringToAdd);
 		}
 		uint64_t hash = GetKey(behaviorID, parameterId);
 		float value = tableData.getFloatField("value", -1.0f);
 
-		entries.insert(std::make_pair(hash, value));
+		entries.push_back(CDBehaviorParameter{ hash, value });
 
 		tableData.nextRow();
 	}
 	tableData.finalize();
+
+	// Keep the first value of any duplicated parameter, same as inserting into a map would.
+	std::stable_sort(entries.begin(), entries.end(), [](const CDBehaviorParameter& a, const CDBehaviorParameter& b) {
+		return a.hash < b.hash;
+	});
+	const auto duplicates = std::unique(entries.begin(), entries.end(), [](const CDBehaviorParameter& a, const CDBehaviorParameter& b) {
+		return a.hash == b.hash;
+	});
+	entries.erase(duplicates, entries.end());
+	entries.shrink_to_fit();
+
+	m_Parameters = entries;
+	BuildBehaviorOffsets();
 }
 
-float CDBehaviorParameterTable::GetValue(const uint32_t behaviorID, const std::string& name, const float defaultValue) {
-	auto parameterID = m_ParametersList.find(name);
-	if (parameterID == m_ParametersList.end()) return defaultValue;
-	auto hash = GetKey(behaviorID, parameterID->second);
+bool CDBehaviorParameterTable::LoadValuesFromSnapshot() {
+	const auto parameters = CDClientSnapshot::GetSection<CDBehaviorParameter>(PARAMETERS_SECTION);
+	const auto names = CDClientSnapshot::GetSection<char>(PARAMETER_NAMES_SECTION);
+	if (parameters.empty() || names.empty()) return false;
 
-	// Search for specific parameter
-	auto& entries = GetEntriesMutable();
-	auto it = entries.find(hash);
-	return it != entries.end() ? it->second : defaultValue;
+	// Names are stored null terminated in the order of their IDs.
+	for (auto begin = names.begin(); begin != names.end();) {
+		const auto end = std::find(begin, names.end(), '\0');
+		std::string name(begin, end);
+		m_ParametersList.insert(std::make_pair(name, m_ParameterNames.size()));
+		m_ParameterNames.push_back(std::move(name));
+		begin = end == names.end() ? end : end + 1;
+	}
+
+	m_Parameters = parameters;
+	BuildBehaviorOffsets();
+	return true;
+}
+
+void CDBehaviorParameterTable::BuildBehaviorOffsets() {
+	m_BehaviorOffsets.clear();
+	if (m_Parameters.empty()) return;
+
+	const auto maxBehaviorID = std::min(GetBehaviorIDFromHash(m_Parameters.back().hash), MAX_OFFSET_BEHAVIOR_ID);
+	m_BehaviorOffsets.resize(maxBehaviorID + 2);
+
+	uint32_t row = 0;
+	for (uint32_t behaviorID = 0; behaviorID < m_BehaviorOffsets.size(); behaviorID++) {
+		while (row < m_Parameters.size() && GetBehaviorIDFromHash(m_Parameters[row].hash) < behaviorID) row++;
+		m_BehaviorOffsets[behaviorID] = row;
+	}
+}
+
+void CDBehaviorParameterTable::AddToSnapshot(CDClientSnapshot::Writer& writer) const {
+	std::vector<char> names;
+	for (const auto& name : m_ParameterNames) {
+		names.insert(names.end(), name.begin(), name.end());
+		names.push_back('\0');
+	}
+
+	writer.AddSection<CDBehaviorParameter>(PARAMETERS_SECTION, m_Parameters);
+	writer.AddSection<char>(PARAMETER_NAMES_SECTION, names);
+}
+
+std::optional<uint32_t> CDBehaviorParameterTable::GetParameterID(const std::string_view name) const {
+	const auto parameterID = m_ParametersList.find(name);
+	if (parameterID == m_ParametersList.end()) return std::nullopt;
+	return parameterID->second;
+}
+
+std::span<const CDBehaviorParameter> CDBehaviorParameterTable::GetParameters(const uint32_t behaviorID) const {
+	if (behaviorID + 1ULL < m_BehaviorOffsets.size()) {
+		const auto begin = m_BehaviorOffsets[behaviorID];
+		return m_Parameters.subspan(begin, m_BehaviorOffsets[behaviorID + 1] - begin);
+	}
+
+	// Only reachable for ids with no parameters or absurdly large ids, which don't get an offset slot.
+	const auto byHash = [](const CDBehaviorParameter& entry, const uint64_t hash) {
+		return entry.hash < hash;
+	};
+	const auto begin = std::lower_bound(m_Parameters.begin(), m_Parameters.end(), GetKey(behaviorID, 0), byHash);
+	const auto end = std::lower_bound(begin, m_Parameters.end(), GetKey(behaviorID, 0) + (1ULL << 31U), byHash);
+	return { begin, end };
+}
+
+float CDBehaviorParameterTable::GetValue(const std::span<const CDBehaviorParameter> parameters, const uint32_t parameterID, const float defaultValue) {
+	// A behavior only has a handful of parameters, so a linear scan beats anything smarter.
+	for (const auto& parameter : parameters) {
+		if (GetParameterIDFromHash(parameter.hash) == parameterID) return parameter.value;
+	}
+	return defaultValue;
+}
+
+float CDBehaviorParameterTable::GetValue(const uint32_t behaviorID, const std::string_view name, const float defaultValue) {
+	const auto parameterID = GetParameterID(name);
+	if (!parameterID) return defaultValue;
+
+	return GetValue(GetParameters(behaviorID), parameterID.value(), defaultValue);
 }
 
 std::map<std::string, float> CDBehaviorParameterTable::GetParametersByBehaviorID(uint32_t behaviorID) {
-	auto& entries = GetEntriesMutable();
-	uint64_t hashBase = behaviorID;
 	std::map<std::string, float> returnInfo;
-	for (auto& [parameterString, parameterId] : m_ParametersList) {
-		uint64_t hash = GetKey(hashBase, parameterId);
-		auto infoCandidate = entries.find(hash);
-		if (infoCandidate != entries.end()) {
-			returnInfo.insert(std::make_pair(parameterString, infoCandidate->second));
-		}
+	for (const auto& parameter : GetParameters(behaviorID)) {
+		const auto parameterId = GetParameterIDFromHash(parameter.hash);
+		if (parameterId < m_ParameterNames.size()) returnInfo.insert(std::make_pair(m_ParameterNames[parameterId], parameter.value));
 	}
 	return returnInfo;
 }
@@ -2,17 +2,54 @@
 
 // Custom Classes
 #include "CDTable.h"
-#include <unordered_map>
-#include <unordered_set>
+#include "CDClientSnapshot.h"
+#include <optional>
+#include <span>
+#include <string_view>
 
 typedef uint64_t BehaviorParameterHash;
 typedef float BehaviorParameterValue;
 
-class CDBehaviorParameterTable : public CDTable<CDBehaviorParameterTable, std::unordered_map<BehaviorParameterHash, BehaviorParameterValue>> {
+struct CDBehaviorParameter {
+	BehaviorParameterHash hash;
+	BehaviorParameterValue value;
+};
+
+// Rows are kept sorted by hash so all parameters of a behavior are stored next to each other.
+class CDBehaviorParameterTable : public CDTable<CDBehaviorParameterTable, std::vector<CDBehaviorParameter>> {
 public:
 	void LoadValuesFromDatabase();
 
-	float GetValue(const uint32_t behaviorID, const std::string& name, const float defaultValue = 0);
+	// Adds the loaded parameters to a snapshot so other servers can map them instead of loading them.
+	void AddToSnapshot(CDClientSnapshot::Writer& writer) const;
+
+	float GetValue(const uint32_t behaviorID, const std::string_view name, const float defaultValue = 0);
 
 	std::map<std::string, float> GetParametersByBehaviorID(uint32_t behaviorID);
+
+	/**
+	 * Gets the id a parameter name was interned as when the table was loaded.
+	 * @return The id, or nullopt if no behavior has a parameter with this name.
+	 */
+	[[nodiscard]] std::optional<uint32_t> GetParameterID(const std::string_view name) const;
+
+	/**
+	 * Gets all parameters of a behavior, sorted by parameter id.
+	 * The returned rows live as long as the table, so behaviors can hold on to them.
+	 */
+	[[nodiscard]] std::span<const CDBehaviorParameter> GetParameters(const uint32_t behaviorID) const;
+
+	// Finds a parameter in the rows returned by GetParameters.
+	[[nodiscard]] static float GetValue(const std::span<const CDBehaviorParameter> parameters, const uint32_t parameterID, const float defaultValue = 0);
+
+private:
+	bool LoadValuesFromSnapshot();
+
+	void BuildBehaviorOffsets();
+
+	// Either the loaded entries or the rows of the mapped snapshot.
+	std::span<const CDBehaviorParameter> m_Parameters;
+
+	// Index of the first row of every behavior id, so a behavior's rows are m_BehaviorOffsets[id] to m_BehaviorOffsets[id + 1].
+	std::vector<uint32_t> m_BehaviorOffsets;
 };
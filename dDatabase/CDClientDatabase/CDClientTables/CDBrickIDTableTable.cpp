@@ -29,6 +29,8 @@ void CDBrickIDTableTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByLEGOBrickID);
 }
 
 std::vector<CDBrickIDTable> CDBrickIDTableTable::Query(std::function<bool(CDBrickIDTable)> predicate) {
@@ -38,3 +40,7 @@ std::vector<CDBrickIDTable> CDBrickIDTableTable::Query(std::function<bool(CDBric
 
 	return data;
 }
+
+std::span<const CDBrickIDTable* const> CDBrickIDTableTable::GetByLEGOBrickID(uint32_t legoBrickID) const {
+	return m_ByLEGOBrickID.Find(legoBrickID);
+}
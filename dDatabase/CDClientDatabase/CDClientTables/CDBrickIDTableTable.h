@@ -21,4 +21,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDBrickIDTable> Query(std::function<bool(CDBrickIDTable)> predicate);
+
+	std::span<const CDBrickIDTable* const> GetByLEGOBrickID(uint32_t legoBrickID) const;
+
+private:
+	CDMultiIndex<&CDBrickIDTable::LEGOBrickID> m_ByLEGOBrickID;
 };
@@ -33,6 +33,8 @@ void CDCurrencyTableTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByCurrencyIndexAndLevel);
 }
 
 std::vector<CDCurrencyTable> CDCurrencyTableTable::Query(std::function<bool(CDCurrencyTable)> predicate) {
@@ -42,3 +44,7 @@ std::vector<CDCurrencyTable> CDCurrencyTableTable::Query(std::function<bool(CDCu
 
 	return data;
 }
+
+std::span<const CDCurrencyTable* const> CDCurrencyTableTable::GetByCurrencyIndex(uint32_t currencyIndex, uint32_t npcMinLevel) const {
+	return m_ByCurrencyIndexAndLevel.Find({ currencyIndex, npcMinLevel });
+}
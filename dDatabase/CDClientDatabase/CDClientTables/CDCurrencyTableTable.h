@@ -23,4 +23,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDCurrencyTable> Query(std::function<bool(CDCurrencyTable)> predicate);
+
+	std::span<const CDCurrencyTable* const> GetByCurrencyIndex(uint32_t currencyIndex, uint32_t npcMinLevel) const;
+
+private:
+	CDMultiIndex<&CDCurrencyTable::currencyIndex, &CDCurrencyTable::npcminlevel> m_ByCurrencyIndexAndLevel;
 };
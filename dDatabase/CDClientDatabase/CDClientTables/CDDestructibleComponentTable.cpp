@@ -40,6 +40,8 @@ void CDDestructibleComponentTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByID);
 }
 
 std::vector<CDDestructibleComponent> CDDestructibleComponentTable::Query(std::function<bool(CDDestructibleComponent)> predicate) {
@@ -49,3 +51,7 @@ std::vector<CDDestructibleComponent> CDDestructibleComponentTable::Query(std::fu
 
 	return data;
 }
+
+const CDDestructibleComponent* CDDestructibleComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
@@ -25,4 +25,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDDestructibleComponent> Query(std::function<bool(CDDestructibleComponent)> predicate);
+
+	const CDDestructibleComponent* GetByID(uint32_t id) const;
+
+private:
+	CDUniqueIndex<&CDDestructibleComponent::id> m_ByID;
 };
@@ -31,6 +31,8 @@ void CDInventoryComponentTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByID);
 }
 
 std::vector<CDInventoryComponent> CDInventoryComponentTable::Query(std::function<bool(CDInventoryComponent)> predicate) {
@@ -40,3 +42,7 @@ std::vector<CDInventoryComponent> CDInventoryComponentTable::Query(std::function
 
 	return data;
 }
+
+std::span<const CDInventoryComponent* const> CDInventoryComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
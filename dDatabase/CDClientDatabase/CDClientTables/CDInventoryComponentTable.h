@@ -15,4 +15,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDInventoryComponent> Query(std::function<bool(CDInventoryComponent)> predicate);
+
+	std::span<const CDInventoryComponent* const> GetByID(uint32_t id) const;
+
+private:
+	CDMultiIndex<&CDInventoryComponent::id> m_ByID;
 };
@@ -32,6 +32,8 @@ void CDMissionEmailTable::LoadValuesFromDatabase() {
 
 		tableData.nextRow();
 	}
+
+	BuildIndexes(m_ByMissionID);
 }
 
 //! Queries the table with a custom "where" clause
@@ -42,3 +44,7 @@ std::vector<CDMissionEmail> CDMissionEmailTable::Query(std::function<bool(CDMiss
 
 	return data;
 }
+
+std::span<const CDMissionEmail* const> CDMissionEmailTable::GetByMissionID(uint32_t missionID) const {
+	return m_ByMissionID.Find(missionID);
+}
@@ -22,4 +22,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDMissionEmail> Query(std::function<bool(CDMissionEmail)> predicate);
+
+	std::span<const CDMissionEmail* const> GetByMissionID(uint32_t missionID) const;
+
+private:
+	CDMultiIndex<&CDMissionEmail::missionID> m_ByMissionID;
 };
@@ -29,6 +29,8 @@ void CDMissionNPCComponentTable::LoadValuesFromDatabase() {
 
 		tableData.nextRow();
 	}
+
+	BuildIndexes(m_ByID);
 }
 
 //! Queries the table with a custom "where" clause
@@ -40,3 +42,7 @@ std::vector<CDMissionNPCComponent> CDMissionNPCComponentTable::Query(std::functi
 
 	return data;
 }
+
+std::span<const CDMissionNPCComponent* const> CDMissionNPCComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
@@ -18,4 +18,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDMissionNPCComponent> Query(std::function<bool(CDMissionNPCComponent)> predicate);
+
+	std::span<const CDMissionNPCComponent* const> GetByID(uint32_t id) const;
+
+private:
+	CDMultiIndex<&CDMissionNPCComponent::id> m_ByID;
 };
@@ -1,5 +1,14 @@
 #include "CDMissionTasksTable.h"
 
+#include <algorithm>
+#include <sstream>
+
+namespace {
+	uint64_t GetTypeAndTargetKey(const uint32_t taskType, const uint32_t target) {
+		return static_cast<uint64_t>(taskType) << 32 | target;
+	}
+};
+
 void CDMissionTasksTable::LoadValuesFromDatabase() {
 
 	// First, get the size of the table
@@ -37,6 +46,34 @@ void CDMissionTasksTable::LoadValuesFromDatabase() {
 
 		tableData.nextRow();
 	}
+
+	BuildIndexes(m_ByMissionID, m_ByTypeAndTargetGroup);
+	BuildTargetIndex();
+}
+
+void CDMissionTasksTable::BuildTargetIndex() {
+	m_ByTypeAndTarget.clear();
+
+	std::vector<uint32_t> targets;
+	for (const auto& entry : GetEntries()) {
+		targets.clear();
+		targets.push_back(entry.target);
+
+		// Parsed the same way MissionComponent matches target groups, so the index finds every task it would.
+		auto stream = std::istringstream(entry.targetGroup);
+		std::string token;
+		while (std::getline(stream, token, ',')) {
+			try {
+				targets.push_back(static_cast<uint32_t>(std::stoi(token)));
+			} catch (std::exception&) {
+				// Not a target
+			}
+		}
+
+		std::sort(targets.begin(), targets.end());
+		targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+		for (const auto target : targets) m_ByTypeAndTarget[GetTypeAndTargetKey(entry.taskType, target)].push_back(&entry);
+	}
 }
 
 std::vector<CDMissionTasks> CDMissionTasksTable::Query(std::function<bool(CDMissionTasks)> predicate) {
@@ -51,16 +88,24 @@ std::vector<CDMissionTasks> CDMissionTasksTable::Query(std::function<bool(CDMiss
 std::vector<CDMissionTasks*> CDMissionTasksTable::GetByMissionID(const uint32_t missionID) {
 	std::vector<CDMissionTasks*> tasks;
 
-	// TODO: this should not be linear(?) and also shouldnt need to be a pointer
-	for (auto& entry : GetEntriesMutable()) {
-		if (entry.id == missionID) {
-			tasks.push_back(&entry);
-		}
+	// TODO: this shouldnt need to be a pointer
+	for (const auto* entry : m_ByMissionID.Find(missionID)) {
+		tasks.push_back(const_cast<CDMissionTasks*>(entry));
 	}
 
 	return tasks;
 }
 
+std::span<const CDMissionTasks* const> CDMissionTasksTable::GetByTypeAndTarget(const uint32_t taskType, const int32_t target) const {
+	const auto it = m_ByTypeAndTarget.find(GetTypeAndTargetKey(taskType, static_cast<uint32_t>(target)));
+	if (it == m_ByTypeAndTarget.end()) return {};
+	return it->second;
+}
+
+std::span<const CDMissionTasks* const> CDMissionTasksTable::GetByTypeAndTargetGroup(const uint32_t taskType, const std::string& targetGroup) const {
+	return m_ByTypeAndTargetGroup.Find({ taskType, targetGroup });
+}
+
 const typename CDMissionTasksTable::StorageType& CDMissionTasksTable::GetEntries() const {
 	return CDTable::GetEntries();
 }
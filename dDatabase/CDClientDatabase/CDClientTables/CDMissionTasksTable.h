@@ -4,6 +4,8 @@
 #include "CDTable.h"
 
 #include <cstdint>
+#include <span>
+#include <unordered_map>
 
 struct CDMissionTasks {
 	uint32_t id;                //!< The Mission ID that the task belongs to
@@ -29,7 +31,22 @@ public:
 
 	std::vector<CDMissionTasks*> GetByMissionID(const uint32_t missionID);
 
+	// Gets the tasks of a type whose target, or any entry of whose target group, is this value, in table order.
+	std::span<const CDMissionTasks* const> GetByTypeAndTarget(const uint32_t taskType, const int32_t target) const;
+
+	// Gets the tasks of a type with exactly this target group, in table order.
+	std::span<const CDMissionTasks* const> GetByTypeAndTargetGroup(const uint32_t taskType, const std::string& targetGroup) const;
+
 	// TODO: Remove this and replace it with a proper lookup function.
 	const CDTable::StorageType& GetEntries() const;
+
+private:
+	void BuildTargetIndex();
+
+	CDMultiIndex<&CDMissionTasks::id> m_ByMissionID;
+	CDMultiIndex<&CDMissionTasks::taskType, &CDMissionTasks::targetGroup> m_ByTypeAndTargetGroup;
+
+	// Keyed by task type in the high half and target in the low half.
+	std::unordered_map<uint64_t, std::vector<const CDMissionTasks*>> m_ByTypeAndTarget;
 };
 
@@ -81,6 +81,8 @@ void CDMissionsTable::LoadValuesFromDatabase() {
 	tableData.finalize();
 
 	Default.id = -1;
+
+	BuildIndexes(m_ByMissionID);
 }
 
 std::vector<CDMissions> CDMissionsTable::Query(std::function<bool(CDMissions)> predicate) {
@@ -93,27 +95,15 @@ std::vector<CDMissions> CDMissionsTable::Query(std::function<bool(CDMissions)> p
 }
 
 const CDMissions* CDMissionsTable::GetPtrByMissionID(uint32_t missionID) const {
-	for (const auto& entry : GetEntries()) {
-		if (entry.id == missionID) {
-			return const_cast<CDMissions*>(&entry);
-		}
-	}
-
-	return &Default;
+	const auto* entry = m_ByMissionID.Find(missionID);
+	return entry ? entry : &Default;
 }
 
 const CDMissions& CDMissionsTable::GetByMissionID(uint32_t missionID, bool& found) const {
-	for (const auto& entry : GetEntries()) {
-		if (entry.id == missionID) {
-			found = true;
-
-			return entry;
-		}
-	}
-
-	found = false;
+	const auto* entry = m_ByMissionID.Find(missionID);
+	found = entry != nullptr;
 
-	return Default;
+	return found ? *entry : Default;
 }
 
 const std::set<int32_t> CDMissionsTable::GetMissionsForReward(LOT lot) {
@@ -74,4 +74,7 @@ public:
 
 
 	static CDMissions Default;
+
+private:
+	CDUniqueIndex<&CDMissions::id> m_ByMissionID;
 };
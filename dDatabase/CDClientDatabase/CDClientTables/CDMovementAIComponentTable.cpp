@@ -32,6 +32,8 @@ void CDMovementAIComponentTable::LoadValuesFromDatabase() {
 
 		tableData.nextRow();
 	}
+
+	BuildIndexes(m_ByID);
 }
 
 std::vector<CDMovementAIComponent> CDMovementAIComponentTable::Query(std::function<bool(CDMovementAIComponent)> predicate) {
@@ -42,3 +44,7 @@ std::vector<CDMovementAIComponent> CDMovementAIComponentTable::Query(std::functi
 
 	return data;
 }
+
+const CDMovementAIComponent* CDMovementAIComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
@@ -21,4 +21,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDMovementAIComponent> Query(std::function<bool(CDMovementAIComponent)> predicate);
+
+	const CDMovementAIComponent* GetByID(uint32_t id) const;
+
+private:
+	CDUniqueIndex<&CDMovementAIComponent::id> m_ByID;
 };
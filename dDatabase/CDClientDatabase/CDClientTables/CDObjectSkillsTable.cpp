@@ -28,6 +28,8 @@ void CDObjectSkillsTable::LoadValuesFromDatabase() {
 
 		tableData.nextRow();
 	}
+
+	BuildIndexes(m_ByObjectTemplate);
 }
 
 std::vector<CDObjectSkills> CDObjectSkillsTable::Query(std::function<bool(CDObjectSkills)> predicate) {
@@ -38,3 +40,7 @@ std::vector<CDObjectSkills> CDObjectSkillsTable::Query(std::function<bool(CDObje
 
 	return data;
 }
+
+std::span<const CDObjectSkills* const> CDObjectSkillsTable::GetByObjectTemplate(uint32_t objectTemplate) const {
+	return m_ByObjectTemplate.Find(objectTemplate);
+}
@@ -17,5 +17,10 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDObjectSkills> Query(std::function<bool(CDObjectSkills)> predicate);
+
+	std::span<const CDObjectSkills* const> GetByObjectTemplate(uint32_t objectTemplate) const;
+
+private:
+	CDMultiIndex<&CDObjectSkills::objectTemplate> m_ByObjectTemplate;
 };
 
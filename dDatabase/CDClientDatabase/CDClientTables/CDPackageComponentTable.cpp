@@ -28,6 +28,8 @@ void CDPackageComponentTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByID);
 }
 
 //! Queries the table with a custom "where" clause
@@ -39,3 +41,7 @@ std::vector<CDPackageComponent> CDPackageComponentTable::Query(std::function<boo
 
 	return data;
 }
+
+std::span<const CDPackageComponent* const> CDPackageComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
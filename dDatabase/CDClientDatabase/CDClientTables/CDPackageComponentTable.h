@@ -16,4 +16,9 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDPackageComponent> Query(std::function<bool(CDPackageComponent)> predicate);
+
+	std::span<const CDPackageComponent* const> GetByID(uint32_t id) const;
+
+private:
+	CDMultiIndex<&CDPackageComponent::id> m_ByID;
 };
@@ -31,6 +31,8 @@ void CDProximityMonitorComponentTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByID);
 }
 
 std::vector<CDProximityMonitorComponent> CDProximityMonitorComponentTable::Query(std::function<bool(CDProximityMonitorComponent)> predicate) {
@@ -41,3 +43,7 @@ std::vector<CDProximityMonitorComponent> CDProximityMonitorComponentTable::Query
 
 	return data;
 }
+
+const CDProximityMonitorComponent* CDProximityMonitorComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
@@ -15,4 +15,9 @@ public:
 	void LoadValuesFromDatabase();
 	//! Queries the table with a custom "where" clause
 	std::vector<CDProximityMonitorComponent> Query(std::function<bool(CDProximityMonitorComponent)> predicate);
+
+	const CDProximityMonitorComponent* GetByID(uint32_t id) const;
+
+private:
+	CDUniqueIndex<&CDProximityMonitorComponent::id> m_ByID;
 };
@@ -37,6 +37,8 @@ void CDRebuildComponentTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByID);
 }
 
 std::vector<CDRebuildComponent> CDRebuildComponentTable::Query(std::function<bool(CDRebuildComponent)> predicate) {
@@ -47,3 +49,7 @@ std::vector<CDRebuildComponent> CDRebuildComponentTable::Query(std::function<boo
 
 	return data;
 }
+
+const CDRebuildComponent* CDRebuildComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
@@ -21,5 +21,10 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDRebuildComponent> Query(std::function<bool(CDRebuildComponent)> predicate);
+
+	const CDRebuildComponent* GetByID(uint32_t id) const;
+
+private:
+	CDUniqueIndex<&CDRebuildComponent::id> m_ByID;
 };
 
@@ -9,6 +9,9 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <span>
+#include <tuple>
 #include <cstdint>
 
 // CPPLinq
@@ -30,6 +33,115 @@
 #pragma warning (disable : 4244) //Disable double to float conversion warnings
 // #pragma warning (disable : 4715) //Disable "not all control paths return a value"
 
+namespace CDTableIndex {
+	template<typename T>
+	struct MemberTraits;
+
+	template<typename Class, typename Value>
+	struct MemberTraits<Value Class::*> {
+		using Row = Class;
+		using Type = Value;
+	};
+
+	template<auto Member, auto... Members>
+	struct Key {
+		using Row = typename MemberTraits<decltype(Member)>::Row;
+		using Type = std::conditional_t<sizeof...(Members) == 0,
+			typename MemberTraits<decltype(Member)>::Type,
+			std::tuple<typename MemberTraits<decltype(Member)>::Type, typename MemberTraits<decltype(Members)>::Type...>>;
+
+		static Type Get(const Row& row) {
+			if constexpr (sizeof...(Members) == 0) return row.*Member;
+			else return Type{ row.*Member, row.*Members... };
+		}
+
+		struct Hash {
+			size_t operator()(const Type& key) const {
+				if constexpr (sizeof...(Members) == 0) {
+					return std::hash<typename MemberTraits<decltype(Member)>::Type>{}(key);
+				} else {
+					size_t hash = 0;
+					std::apply([&hash](const auto&... values) {
+						((hash ^= std::hash<std::decay_t<decltype(values)>>{}(values) + 0x9e3779b9 + (hash << 6) + (hash >> 2)), ...);
+					}, key);
+					return hash;
+				}
+			}
+		};
+	};
+};
+
+/**
+ * A secondary index over a vector backed table where each key maps to at most one row.
+ * If several rows share a key, the first one in table order wins, same as taking the front of a Query().
+ * The members to key on are given as template arguments, e.g. CDUniqueIndex<&CDMissions::id>.
+ */
+template<auto... Members>
+class CDUniqueIndex {
+public:
+	using Key = CDTableIndex::Key<Members...>;
+	using Row = typename Key::Row;
+	using KeyType = typename Key::Type;
+
+	void Build(std::span<const Row> rows) {
+		m_Index.clear();
+		m_Index.reserve(rows.size());
+		for (const auto& row : rows) m_Index.try_emplace(Key::Get(row), &row);
+	}
+
+	// Returns the row with this key, or nullptr if there is none.
+	[[nodiscard]] const Row* Find(const KeyType& key) const {
+		const auto it = m_Index.find(key);
+		return it != m_Index.end() ? it->second : nullptr;
+	}
+
+private:
+	std::unordered_map<KeyType, const Row*, typename Key::Hash> m_Index;
+};
+
+/**
+ * A secondary index over a vector backed table where each key maps to any number of rows.
+ * Matching rows are stored next to each other in table order, so a lookup is a single hash lookup and a span.
+ * The members to key on are given as template arguments, e.g. CDMultiIndex<&CDCurrencyTable::currencyIndex, &CDCurrencyTable::npcminlevel>.
+ */
+template<auto... Members>
+class CDMultiIndex {
+public:
+	using Key = CDTableIndex::Key<Members...>;
+	using Row = typename Key::Row;
+	using KeyType = typename Key::Type;
+
+	void Build(std::span<const Row> rows) {
+		m_Ranges.clear();
+		for (const auto& row : rows) m_Ranges[Key::Get(row)].second++;
+
+		uint32_t offset = 0;
+		for (auto& [key, range] : m_Ranges) {
+			range.first = offset;
+			offset += range.second;
+			range.second = 0;
+		}
+
+		m_Rows.resize(rows.size());
+		for (const auto& row : rows) {
+			auto& range = m_Ranges[Key::Get(row)];
+			m_Rows[range.first + range.second++] = &row;
+		}
+	}
+
+	// Returns all rows with this key in table order.
+	[[nodiscard]] std::span<const Row* const> Find(const KeyType& key) const {
+		const auto it = m_Ranges.find(key);
+		if (it == m_Ranges.end()) return {};
+		return std::span<const Row* const>(m_Rows).subspan(it->second.first, it->second.second);
+	}
+
+private:
+	// Offset and count into m_Rows for each key
+	std::unordered_map<KeyType, std::pair<uint32_t, uint32_t>, typename Key::Hash> m_Ranges;
+	std::vector<const Row*> m_Rows;
+};
+
 template<class Table, typename Storage>
 class CDTable : public Singleton<Table> {
 public:
@@ -38,6 +150,12 @@ public:
 protected:
 	virtual ~CDTable() = default;
 
+	// Builds the given indexes over the loaded entries.  Call this once the table has finished loading.
+	template<typename... Indexes>
+	void BuildIndexes(Indexes&... indexes) const {
+		(indexes.Build(GetEntries()), ...);
+	}
+
 	// If you need these for a specific table, override it such that there is a public variant.
 	[[nodiscard]] StorageType& GetEntriesMutable() const {
 		return CDClientManager::GetEntriesMutable<Table>();
@@ -32,6 +32,8 @@ void CDVendorComponentTable::LoadValuesFromDatabase() {
 	}
 
 	tableData.finalize();
+
+	BuildIndexes(m_ByID);
 }
 
 //! Queries the table with a custom "where" clause
@@ -43,3 +45,7 @@ std::vector<CDVendorComponent> CDVendorComponentTable::Query(std::function<bool(
 
 	return data;
 }
+
+const CDVendorComponent* CDVendorComponentTable::GetByID(uint32_t id) const {
+	return m_ByID.Find(id);
+}
@@ -16,5 +16,10 @@ public:
 	void LoadValuesFromDatabase();
 	// Queries the table with a custom "where" clause
 	std::vector<CDVendorComponent> Query(std::function<bool(CDVendorComponent)> predicate);
+
+	const CDVendorComponent* GetByID(uint32_t id) const;
+
+private:
+	CDUniqueIndex<&CDVendorComponent::id> m_ByID;
 };
 
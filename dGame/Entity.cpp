@@ -378,7 +378,7 @@ void Entity::Initialize() {
 	if (buffComponentID > 0) componentID = buffComponentID;
 
 	CDDestructibleComponentTable* destCompTable = CDClientManager::GetTable<CDDestructibleComponentTable>();
-	std::vector<CDDestructibleComponent> destCompData = destCompTable->Query([=](CDDestructibleComponent entry) { return (entry.id == componentID); });
+	const auto* destCompData = destCompTable->GetByID(componentID);
 
 	bool isSmashable = GetVarAs<int32_t>(u"is_smashable") != 0;
 	if (buffComponentID > 0 || collectibleComponentID > 0 || isSmashable) {
@@ -387,38 +387,34 @@ void Entity::Initialize() {
 			comp->LoadFromXml(m_Character->GetXMLDoc());
 		} else {
 			if (componentID > 0) {
-				std::vector<CDDestructibleComponent> destCompData = destCompTable->Query([=](CDDestructibleComponent entry) { return (entry.id == componentID); });
+				if (destCompData) {
+					const auto imagination = HasComponent(eReplicaComponentType::RACING_STATS) ? 60 : destCompData->imagination;
 
-				if (destCompData.size() > 0) {
-					if (HasComponent(eReplicaComponentType::RACING_STATS)) {
-						destCompData[0].imagination = 60;
-					}
-
-					comp->SetHealth(destCompData[0].life);
-					comp->SetImagination(destCompData[0].imagination);
-					comp->SetArmor(destCompData[0].armor);
+					comp->SetHealth(destCompData->life);
+					comp->SetImagination(imagination);
+					comp->SetArmor(destCompData->armor);
 
-					comp->SetMaxHealth(destCompData[0].life);
-					comp->SetMaxImagination(destCompData[0].imagination);
-					comp->SetMaxArmor(destCompData[0].armor);
-					comp->SetDeathBehavior(destCompData[0].death_behavior);
+					comp->SetMaxHealth(destCompData->life);
+					comp->SetMaxImagination(imagination);
+					comp->SetMaxArmor(destCompData->armor);
+					comp->SetDeathBehavior(destCompData->death_behavior);
 
-					comp->SetIsSmashable(destCompData[0].isSmashable);
+					comp->SetIsSmashable(destCompData->isSmashable);
 
-					comp->SetLootMatrixID(destCompData[0].LootMatrixIndex);
-					Loot::CacheMatrix(destCompData[0].LootMatrixIndex);
+					comp->SetLootMatrixID(destCompData->LootMatrixIndex);
+					Loot::CacheMatrix(destCompData->LootMatrixIndex);
 
 					// Now get currency information
-					uint32_t npcMinLevel = destCompData[0].level;
-					uint32_t currencyIndex = destCompData[0].CurrencyIndex;
+					uint32_t npcMinLevel = destCompData->level;
+					uint32_t currencyIndex = destCompData->CurrencyIndex;
 
 					CDCurrencyTableTable* currencyTable = CDClientManager::GetTable<CDCurrencyTableTable>();
-					std::vector<CDCurrencyTable> currencyValues = currencyTable->Query([=](CDCurrencyTable entry) { return (entry.currencyIndex == currencyIndex && entry.npcminlevel == npcMinLevel); });
+					const auto currencyValues = currencyTable->GetByCurrencyIndex(currencyIndex, npcMinLevel);
 
-					if (currencyValues.size() > 0) {
+					if (!currencyValues.empty()) {
 						// Set the coins
-						comp->SetMinCoins(currencyValues[0].minvalue);
-						comp->SetMaxCoins(currencyValues[0].maxvalue);
+						comp->SetMinCoins(currencyValues[0]->minvalue);
+						comp->SetMaxCoins(currencyValues[0]->maxvalue);
 					}
 
 					// extraInfo overrides. Client ORs the database smashable and the luz smashable.
@@ -441,13 +437,13 @@ void Entity::Initialize() {
 			}
 		}
 
-		if (destCompData.size() > 0) {
-			comp->AddFaction(destCompData[0].faction);
-			std::stringstream ss(destCompData[0].factionList);
+		if (destCompData) {
+			comp->AddFaction(destCompData->faction);
+			std::stringstream ss(destCompData->factionList);
 			std::string token;
 
 			while (std::getline(ss, token, ',')) {
-				if (std::stoi(token) == destCompData[0].faction) continue;
+				if (std::stoi(token) == destCompData->faction) continue;
 
 				if (token != "") {
 					comp->AddFaction(std::stoi(token));
@@ -569,17 +565,17 @@ void Entity::Initialize() {
 		auto* quickBuildComponent = AddComponent<QuickBuildComponent>();
 
 		CDRebuildComponentTable* rebCompTable = CDClientManager::GetTable<CDRebuildComponentTable>();
-		std::vector<CDRebuildComponent> rebCompData = rebCompTable->Query([=](CDRebuildComponent entry) { return (entry.id == quickBuildComponentID); });
-
-		if (rebCompData.size() > 0) {
-			quickBuildComponent->SetResetTime(rebCompData[0].reset_time);
-			quickBuildComponent->SetCompleteTime(rebCompData[0].complete_time);
-			quickBuildComponent->SetTakeImagination(rebCompData[0].take_imagination);
-			quickBuildComponent->SetInterruptible(rebCompData[0].interruptible);
-			quickBuildComponent->SetSelfActivator(rebCompData[0].self_activator);
-			quickBuildComponent->SetActivityId(rebCompData[0].activityID);
-			quickBuildComponent->SetPostImaginationCost(rebCompData[0].post_imagination_cost);
-			quickBuildComponent->SetTimeBeforeSmash(rebCompData[0].time_before_smash);
+		const auto* rebCompData = rebCompTable->GetByID(quickBuildComponentID);
+
+		if (rebCompData) {
+			quickBuildComponent->SetResetTime(rebCompData->reset_time);
+			quickBuildComponent->SetCompleteTime(rebCompData->complete_time);
+			quickBuildComponent->SetTakeImagination(rebCompData->take_imagination);
+			quickBuildComponent->SetInterruptible(rebCompData->interruptible);
+			quickBuildComponent->SetSelfActivator(rebCompData->self_activator);
+			quickBuildComponent->SetActivityId(rebCompData->activityID);
+			quickBuildComponent->SetPostImaginationCost(rebCompData->post_imagination_cost);
+			quickBuildComponent->SetTimeBeforeSmash(rebCompData->time_before_smash);
 
 			const auto rebuildResetTime = GetVar<float>(u"rebuild_reset_time");
 
@@ -695,17 +691,17 @@ void Entity::Initialize() {
 	int movementAIID = compRegistryTable->GetByIDAndType(m_TemplateID, eReplicaComponentType::MOVEMENT_AI);
 	if (movementAIID > 0) {
 		CDMovementAIComponentTable* moveAITable = CDClientManager::GetTable<CDMovementAIComponentTable>();
-		std::vector<CDMovementAIComponent> moveAIComp = moveAITable->Query([=](CDMovementAIComponent entry) {return (entry.id == movementAIID); });
+		const auto* moveAIComp = moveAITable->GetByID(movementAIID);
 
-		if (moveAIComp.size() > 0) {
+		if (moveAIComp) {
 			MovementAIInfo moveInfo = MovementAIInfo();
 
-			moveInfo.movementType = moveAIComp[0].MovementType;
-			moveInfo.wanderChance = moveAIComp[0].WanderChance;
-			moveInfo.wanderRadius = moveAIComp[0].WanderRadius;
-			moveInfo.wanderSpeed = moveAIComp[0].WanderSpeed;
-			moveInfo.wanderDelayMax = moveAIComp[0].WanderDelayMax;
-			moveInfo.wanderDelayMin = moveAIComp[0].WanderDelayMin;
+			moveInfo.movementType = moveAIComp->MovementType;
+			moveInfo.wanderChance = moveAIComp->WanderChance;
+			moveInfo.wanderRadius = moveAIComp->WanderRadius;
+			moveInfo.wanderSpeed = moveAIComp->WanderSpeed;
+			moveInfo.wanderDelayMax = moveAIComp->WanderDelayMax;
+			moveInfo.wanderDelayMin = moveAIComp->WanderDelayMin;
 
 			bool useWanderDB = GetVar<bool>(u"usewanderdb");
 
@@ -765,9 +761,9 @@ void Entity::Initialize() {
 	int proximityMonitorID = compRegistryTable->GetByIDAndType(m_TemplateID, eReplicaComponentType::PROXIMITY_MONITOR);
 	if (proximityMonitorID > 0) {
 		CDProximityMonitorComponentTable* proxCompTable = CDClientManager::GetTable<CDProximityMonitorComponentTable>();
-		std::vector<CDProximityMonitorComponent> proxCompData = proxCompTable->Query([=](CDProximityMonitorComponent entry) { return (entry.id == proximityMonitorID); });
-		if (proxCompData.size() > 0) {
-			std::vector<std::string> proximityStr = GeneralUtils::SplitString(proxCompData[0].Proximities, ',');
+		const auto* proxCompData = proxCompTable->GetByID(proximityMonitorID);
+		if (proxCompData) {
+			std::vector<std::string> proximityStr = GeneralUtils::SplitString(proxCompData->Proximities, ',');
 			AddComponent<ProximityMonitorComponent>(std::stoi(proximityStr[0]), std::stoi(proximityStr[1]));
 		}
 	}
@@ -1643,15 +1639,14 @@ void Entity::PickupItem(const LWOOBJID& objectID) {
 			const CDObjects& object = objectsTable->GetByID(p.second.lot);
 			if (object.id != 0 && object.type == "Powerup") {
 				CDObjectSkillsTable* skillsTable = CDClientManager::GetTable<CDObjectSkillsTable>();
-				std::vector<CDObjectSkills> skills = skillsTable->Query([=](CDObjectSkills entry) {return (entry.objectTemplate == p.second.lot); });
-				for (CDObjectSkills skill : skills) {
+				for (const auto* skill : skillsTable->GetByObjectTemplate(p.second.lot)) {
 					auto* skillComponent = GetComponent<SkillComponent>();
-					if (skillComponent) skillComponent->CastSkill(skill.skillID, GetObjectID(), GetObjectID(), skill.castOnType, NiQuaternion(0, 0, 0, 0));
+					if (skillComponent) skillComponent->CastSkill(skill->skillID, GetObjectID(), GetObjectID(), skill->castOnType, NiQuaternion(0, 0, 0, 0));
 
 					auto* missionComponent = GetComponent<MissionComponent>();
 
 					if (missionComponent != nullptr) {
-						missionComponent->Progress(eMissionTaskType::POWERUP, skill.skillID);
+						missionComponent->Progress(eMissionTaskType::POWERUP, skill->skillID);
 					}
 				}
 			} else {
@@ -1811,6 +1806,12 @@ void Entity::Sleep() {
 	if (baseCombatAIComponent != nullptr) {
 		baseCombatAIComponent->Sleep();
 	}
+
+	auto* buffComponent = GetComponent<BuffComponent>();
+
+	if (buffComponent != nullptr) {
+		buffComponent->Sleep();
+	}
 }
 
 void Entity::Wake() {
@@ -1819,6 +1820,12 @@ void Entity::Wake() {
 	if (baseCombatAIComponent != nullptr) {
 		baseCombatAIComponent->Wake();
 	}
+
+	auto* buffComponent = GetComponent<BuffComponent>();
+
+	if (buffComponent != nullptr) {
+		buffComponent->Wake();
+	}
 }
 
 bool Entity::IsSleeping() const {
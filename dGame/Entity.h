@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <functional>
 #include <typeinfo>
 #include <type_traits>
@@ -315,9 +317,13 @@ protected:
 
 	LOT m_TemplateID;
 
+	// Shared with the spawner node or level object this entity came from, until SetVar writes to them.
 	std::vector<LDFBaseData*> m_Settings;
 	std::vector<LDFBaseData*> m_NetworkSettings;
 
+	// The settings SetVar made for this entity alone.
+	std::vector<std::unique_ptr<LDFBaseData>> m_OwnedSettings;
+
 	NiPoint3 m_DefaultPosition;
 	NiQuaternion m_DefaultRotation;
 	float m_Scale;
@@ -422,6 +428,7 @@ void Entity::SetVar(const std::u16string& name, T value) {
 		auto* data = new LDFData<T>(name, value);
 
 		m_Settings.push_back(data);
+		m_OwnedSettings.emplace_back(data);
 
 		return;
 	}
@@ -432,6 +439,17 @@ void Entity::SetVar(const std::u16string& name, T value) {
 		return;
 	}
 
+	const auto owned = std::ranges::find(m_OwnedSettings, data, &std::unique_ptr<LDFBaseData>::get) != m_OwnedSettings.end();
+	if (!owned) {
+		// Every other spawn of this object reads the same setting, so write to a copy.
+		auto* copy = new LDFData<T>(typed->GetKey(), value);
+
+		std::ranges::replace(m_Settings, data, copy);
+		m_OwnedSettings.emplace_back(copy);
+
+		return;
+	}
+
 	typed->SetValue(value);
 }
 
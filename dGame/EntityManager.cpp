@@ -8,6 +8,7 @@
 #include "dServer.h"
 #include "Spawner.h"
 #include "SkillComponent.h"
+#include "BuffComponent.h"
 #include "SwitchComponent.h"
 #include "UserManager.h"
 #include "Metrics.hpp"
@@ -185,11 +186,11 @@ void EntityManager::SerializeEntities() {
 			for (auto* player : PlayerManager::GetAllPlayers()) {
 				auto* ghostComponent = player->GetComponent<GhostComponent>();
 				if (ghostComponent && ghostComponent->IsObserved(toSerialize)) {
-					Game::server->Send(stream, player->GetSystemAddress(), false);
+					Game::server->Send(stream, player->GetSystemAddress(), false, eQosClass::STATE);
 				}
 			}
 		} else {
-			Game::server->Send(stream, UNASSIGNED_SYSTEM_ADDRESS, true);
+			Game::server->Send(stream, UNASSIGNED_SYSTEM_ADDRESS, true, eQosClass::STATE);
 		}
 	}
 	m_EntitiesToSerialize.clear();
@@ -243,6 +244,8 @@ void EntityManager::UpdateEntities(const float deltaTime) {
 		entity->Update(deltaTime);
 	}
 
+	BuffComponent::UpdateTimers(deltaTime);
+
 	SerializeEntities();
 	KillEntities();
 	DeleteEntities();
@@ -364,11 +367,11 @@ void EntityManager::ConstructEntity(Entity* entity, const SystemAddress& sysAddr
 
 	if (sysAddr == UNASSIGNED_SYSTEM_ADDRESS) {
 		if (skipChecks) {
-			Game::server->Send(stream, UNASSIGNED_SYSTEM_ADDRESS, true);
+			Game::server->Send(stream, UNASSIGNED_SYSTEM_ADDRESS, true, eQosClass::STATE);
 		} else {
 			for (auto* player : PlayerManager::GetAllPlayers()) {
 				if (player->GetPlayerReadyForUpdates()) {
-					Game::server->Send(stream, player->GetSystemAddress(), false);
+					Game::server->Send(stream, player->GetSystemAddress(), false, eQosClass::STATE);
 				} else {
 					auto* ghostComponent = player->GetComponent<GhostComponent>();
 					if (ghostComponent) ghostComponent->AddLimboConstruction(entity->GetObjectID());
@@ -376,7 +379,7 @@ void EntityManager::ConstructEntity(Entity* entity, const SystemAddress& sysAddr
 			}
 		}
 	} else {
-		Game::server->Send(stream, sysAddr, false);
+		Game::server->Send(stream, sysAddr, false, eQosClass::STATE);
 	}
 
 	if (entity->IsPlayer()) {
@@ -407,7 +410,7 @@ void EntityManager::DestructEntity(Entity* entity, const SystemAddress& sysAddr)
 	stream.Write<uint8_t>(ID_REPLICA_MANAGER_DESTRUCTION);
 	stream.Write<uint16_t>(entity->GetNetworkId());
 
-	Game::server->Send(stream, sysAddr, sysAddr == UNASSIGNED_SYSTEM_ADDRESS);
+	Game::server->Send(stream, sysAddr, sysAddr == UNASSIGNED_SYSTEM_ADDRESS, eQosClass::STATE);
 
 	for (auto* player : PlayerManager::GetAllPlayers()) {
 		if (!player->GetPlayerReadyForUpdates()) {
@@ -312,10 +312,8 @@ Leaderboard::Type LeaderboardManager::GetLeaderboardType(const GameID gameID) {
 	if (lookup != leaderboardCache.end()) return lookup->second;
 
 	auto* activitiesTable = CDClientManager::GetTable<CDActivitiesTable>();
-	std::vector<CDActivities> activities = activitiesTable->Query([gameID](const CDActivities& entry) {
-		return entry.ActivityID == gameID;
-		});
-	auto type = !activities.empty() ? static_cast<Leaderboard::Type>(activities.at(0).leaderboardType) : Leaderboard::Type::None;
+	const auto* activity = activitiesTable->GetByActivityID(gameID);
+	auto type = activity ? static_cast<Leaderboard::Type>(activity->leaderboardType) : Leaderboard::Type::None;
 	leaderboardCache.insert_or_assign(gameID, type);
 	return type;
 }
@@ -35,6 +35,7 @@ UserManager* UserManager::m_Address = nullptr;
 //Local functions as they aren't needed by anything else, leave the implementations at the bottom!
 uint32_t FindCharShirtID(uint32_t shirtColor, uint32_t shirtStyle);
 uint32_t FindCharPantsID(uint32_t pantsColor);
+void SendCharacterChanged(uint32_t charID);
 
 inline void StripCR(std::string& str) {
 	str.erase(std::remove(str.begin(), str.end(), '\r'), str.end());
@@ -420,6 +421,7 @@ void UserManager::DeleteCharacter(const SystemAddress& sysAddr, Packet* packet)
 	} else {
 		LOG("Deleting character %i", charID);
 		Database::Get()->DeleteCharacter(charID);
+		SendCharacterChanged(charID);
 
 		CBITSTREAM;
 		BitStreamUtils::WriteHeader(bitStream, eConnectionType::CHAT, MessageType::Chat::UNEXPECTED_DISCONNECT);
@@ -479,6 +481,7 @@ void UserManager::RenameCharacter(const SystemAddress& sysAddr, Packet* packet)
 		if (!Database::Get()->GetCharacterInfo(newName)) {
 			if (IsNamePreapproved(newName)) {
 				Database::Get()->SetCharacterName(charID, newName);
+				SendCharacterChanged(charID);
 				LOG("Character %s now known as %s", character->GetName().c_str(), newName.c_str());
 				WorldPackets::SendCharacterRenameResponse(sysAddr, eRenameResponse::SUCCESS);
 				UserManager::RequestCharacterList(sysAddr);
@@ -570,6 +573,14 @@ uint32_t FindCharPantsID(uint32_t pantsColor) {
 	}
 }
 
+// Lets the chat server drop what it has cached about a character that was deleted or renamed.
+void SendCharacterChanged(uint32_t charID) {
+	CBITSTREAM;
+	BitStreamUtils::WriteHeader(bitStream, eConnectionType::CHAT, MessageType::Chat::CHARACTER_CHANGED);
+	bitStream.Write<LWOOBJID>(charID);
+	Game::chatServer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE, 0, Game::chatSysAddr, false);
+}
+
 void UserManager::SaveAllActiveCharacters() {
 	for (auto user : m_Users) {
 		if (user.second) {
@@ -10,6 +10,9 @@ public:
 	void Calculate(BehaviorContext* context, RakNet::BitStream& bitStream, BehaviorBranchContext branch) override;
 	void Load() override;
 private:
+	// Copies the parameters into its nodes.
+	friend class BehaviorProgram;
+
 	Behavior* m_action;
 	uint32_t m_maxTargets;
 	float m_radius;
@@ -48,6 +48,9 @@ public:
 	 */
 	void Load() override;
 private:
+	// Copies the parameters into its nodes.
+	friend class BehaviorProgram;
+
 	bool m_DontApplyImmune;
 
 	uint32_t m_MinDamage;
@@ -414,6 +414,9 @@ Behavior::Behavior(const uint32_t behaviorId) {
 
 	this->m_behaviorId = behaviorId;
 
+	if (!BehaviorParameterTable) BehaviorParameterTable = CDClientManager::GetTable<CDBehaviorParameterTable>();
+	this->m_Parameters = BehaviorParameterTable->GetParameters(behaviorId);
+
 	// Add to cache
 	Cache.insert_or_assign(behaviorId, this);
 
@@ -440,24 +443,27 @@ Behavior::Behavior(const uint32_t behaviorId) {
 }
 
 
-float Behavior::GetFloat(const std::string& name, const float defaultValue) const {
+float Behavior::GetFloat(const std::string_view name, const float defaultValue) const {
 	// Get the behavior parameter entry and return its value.
 	if (!BehaviorParameterTable) BehaviorParameterTable = CDClientManager::GetTable<CDBehaviorParameterTable>();
-	return BehaviorParameterTable->GetValue(this->m_behaviorId, name, defaultValue);
+	const auto parameterID = BehaviorParameterTable->GetParameterID(name);
+	if (!parameterID) return defaultValue;
+
+	return CDBehaviorParameterTable::GetValue(this->m_Parameters, parameterID.value(), defaultValue);
 }
 
 
-bool Behavior::GetBoolean(const std::string& name, const bool defaultValue) const {
+bool Behavior::GetBoolean(const std::string_view name, const bool defaultValue) const {
 	return GetFloat(name, defaultValue) > 0;
 }
 
 
-int32_t Behavior::GetInt(const std::string& name, const int defaultValue) const {
+int32_t Behavior::GetInt(const std::string_view name, const int defaultValue) const {
 	return static_cast<int32_t>(GetFloat(name, defaultValue));
 }
 
 
-Behavior* Behavior::GetAction(const std::string& name) const {
+Behavior* Behavior::GetAction(const std::string_view name) const {
 	const auto id = GetInt(name);
 
 	return CreateBehavior(id);
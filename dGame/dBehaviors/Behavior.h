@@ -1,17 +1,19 @@
 #pragma once
 
 #include <map>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
 #include "BitStream.h"
 #include "BehaviorTemplate.h"
 #include "dCommonVars.h"
+#include "CDBehaviorParameterTable.h"
 
 struct BehaviorContext;
 struct BehaviorBranchContext;
-class CDBehaviorParameterTable;
 
 class Behavior
 {
@@ -45,17 +47,20 @@ public:
 	std::unordered_map<std::string, std::string> m_effectNames;
 	std::string m_effectType;
 
+	// The parameter rows of this behavior, looked up once so reading a parameter doesn't search the whole table.
+	std::span<const CDBehaviorParameter> m_Parameters;
+
 	/*
 	 * Behavior parameters
 	 */
 
-	float GetFloat(const std::string& name, const float defaultValue = 0) const;
+	float GetFloat(const std::string_view name, const float defaultValue = 0) const;
 
-	bool GetBoolean(const std::string& name, const bool defaultValue = false) const;
+	bool GetBoolean(const std::string_view name, const bool defaultValue = false) const;
 
-	int32_t GetInt(const std::string& name, const int32_t defaultValue = 0) const;
+	int32_t GetInt(const std::string_view name, const int32_t defaultValue = 0) const;
 
-	Behavior* GetAction(const std::string& name) const;
+	Behavior* GetAction(const std::string_view name) const;
 
 	Behavior* GetAction(float value) const;
 
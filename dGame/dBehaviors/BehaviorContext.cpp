@@ -337,7 +337,7 @@ void BehaviorContext::Reset() {
 	this->scheduledUpdates.clear();
 }
 
-void BehaviorContext::FilterTargets(std::vector<Entity*>& targets, std::forward_list<int32_t>& ignoreFactionList, std::forward_list<int32_t>& includeFactionList, bool targetSelf, bool targetEnemy, bool targetFriend, bool targetTeam) const {
+void BehaviorContext::FilterTargets(std::vector<Entity*>& targets, const std::forward_list<int32_t>& ignoreFactionList, const std::forward_list<int32_t>& includeFactionList, bool targetSelf, bool targetEnemy, bool targetFriend, bool targetTeam) const {
 
 	// if we aren't targeting anything, then clear the targets vector
 	if (!targetSelf && !targetEnemy && !targetFriend && !targetTeam && ignoreFactionList.empty() && includeFactionList.empty()) {
@@ -448,7 +448,7 @@ bool BehaviorContext::CheckTargetingRequirements(const Entity* target) const {
 }
 
 // returns true if any of the object factions are in the faction list
-bool BehaviorContext::CheckFactionList(std::forward_list<int32_t>& factionList, std::vector<int32_t>& objectsFactions) const {
+bool BehaviorContext::CheckFactionList(const std::forward_list<int32_t>& factionList, std::vector<int32_t>& objectsFactions) const {
 	if (factionList.empty() || objectsFactions.empty()) return false;
 	for (auto faction : factionList) {
 		if (std::find(objectsFactions.begin(), objectsFactions.end(), faction) != objectsFactions.end()) return true;
@@ -457,10 +457,17 @@ bool BehaviorContext::CheckFactionList(std::forward_list<int32_t>& factionList,
 }
 
 
-BehaviorContext::BehaviorContext(const LWOOBJID originator, const bool calculation) {
+void BehaviorContext::Initialize(const LWOOBJID originator, const bool calculation) {
+	Reset();
+
 	this->originator = originator;
-	this->syncEntries = {};
-	this->timerEntries = {};
+	this->foundTarget = false;
+	this->skillTime = 0;
+	this->skillID = 0;
+	this->failed = false;
+	this->clientInitalized = false;
+	this->unmanaged = false;
+	this->caster = LWOOBJID_EMPTY;
 
 	if (calculation) {
 		this->skillUId = GetUniqueSkillId();
@@ -469,6 +476,10 @@ BehaviorContext::BehaviorContext(const LWOOBJID originator, const bool calculati
 	}
 }
 
+BehaviorContext::BehaviorContext(const LWOOBJID originator, const bool calculation) {
+	Initialize(originator, calculation);
+}
+
 BehaviorContext::~BehaviorContext() {
 	Reset();
 }
@@ -107,11 +107,16 @@ struct BehaviorContext
 
 	void Reset();
 
-	void FilterTargets(std::vector<Entity*>& targetsReference, std::forward_list<int32_t>& ignoreFaction, std::forward_list<int32_t>& includeFaction, const bool targetSelf = false, const bool targetEnemy = true, const bool targetFriend = false, const bool targetTeam = false) const;
+	/**
+	 * Prepares the context for a new cast, keeping the capacity of the entry vectors so a reused context does not allocate.
+	 */
+	void Initialize(LWOOBJID originator, bool calculation = false);
+
+	void FilterTargets(std::vector<Entity*>& targetsReference, const std::forward_list<int32_t>& ignoreFaction, const std::forward_list<int32_t>& includeFaction, const bool targetSelf = false, const bool targetEnemy = true, const bool targetFriend = false, const bool targetTeam = false) const;
 
 	bool CheckTargetingRequirements(const Entity* target) const;
 
-	bool CheckFactionList(std::forward_list<int32_t>& factionList, std::vector<int32_t>& objectsFactions) const;
+	bool CheckFactionList(const std::forward_list<int32_t>& factionList, std::vector<int32_t>& objectsFactions) const;
 
 	explicit BehaviorContext(LWOOBJID originator, bool calculation = false);
 
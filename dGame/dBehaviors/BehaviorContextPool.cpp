@@ -0,0 +1,79 @@
+#include "BehaviorContextPool.h"
+
+#include <memory>
+#include <vector>
+
+#include "BehaviorContext.h"
+#include "BitStream.h"
+#include "LDFFormat.h" // GameMessages.h only forward declares LDFBaseData
+
+namespace {
+	// Enough for every cast in flight in a busy zone; anything past this is freed instead of kept.
+	constexpr size_t MAX_FREE = 1024;
+
+	std::vector<std::unique_ptr<BehaviorContext>> g_FreeContexts;
+	std::vector<std::unique_ptr<RakNet::BitStream>> g_FreeBitStreams;
+
+	size_t g_Allocations = 0;
+};
+
+BehaviorContext* BehaviorContextPool::Acquire(const LWOOBJID originator, const bool calculation) {
+	if (g_FreeContexts.empty()) {
+		g_Allocations++;
+		return new BehaviorContext(originator, calculation);
+	}
+
+	auto* context = g_FreeContexts.back().release();
+	g_FreeContexts.pop_back();
+	context->Initialize(originator, calculation);
+
+	return context;
+}
+
+void BehaviorContextPool::Release(BehaviorContext* context) {
+	if (!context) return;
+
+	// Resetting can run end behaviors that cast again, so the context only goes back on the list afterwards.
+	context->Reset();
+
+	if (g_FreeContexts.size() >= MAX_FREE) {
+		delete context;
+		return;
+	}
+
+	g_FreeContexts.emplace_back(context);
+}
+
+BehaviorContextPool::ScratchBitStream::ScratchBitStream() {
+	if (g_FreeBitStreams.empty()) {
+		g_Allocations++;
+		m_BitStream = new RakNet::BitStream();
+		return;
+	}
+
+	m_BitStream = g_FreeBitStreams.back().release();
+	g_FreeBitStreams.pop_back();
+}
+
+BehaviorContextPool::ScratchBitStream::~ScratchBitStream() {
+	if (g_FreeBitStreams.size() >= MAX_FREE) {
+		delete m_BitStream;
+		return;
+	}
+
+	m_BitStream->Reset();
+	g_FreeBitStreams.emplace_back(m_BitStream);
+}
+
+size_t BehaviorContextPool::GetFreeCount() {
+	return g_FreeContexts.size();
+}
+
+size_t BehaviorContextPool::GetAllocationCount() {
+	return g_Allocations;
+}
+
+void BehaviorContextPool::Clear() {
+	g_FreeContexts.clear();
+	g_FreeBitStreams.clear();
+}
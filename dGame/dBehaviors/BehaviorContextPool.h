@@ -0,0 +1,64 @@
+#ifndef __BEHAVIORCONTEXTPOOL__H__
+#define __BEHAVIORCONTEXTPOOL__H__
+
+#include <cstddef>
+
+#include "dCommonVars.h"
+
+struct BehaviorContext;
+
+namespace RakNet {
+	class BitStream;
+};
+
+/**
+ * Reusable behavior contexts and bitstreams for skill casts.  Every cast and every buff tick needs a fresh context,
+ * and a released context keeps the capacity of its entry vectors, so casting from the pool stops allocating once
+ * the zone has warmed up.
+ *
+ * Only the game thread may use the pool.
+ */
+namespace BehaviorContextPool {
+	/**
+	 * @return A context set up as if it was just constructed with (originator, calculation).
+	 */
+	BehaviorContext* Acquire(LWOOBJID originator, bool calculation = false);
+
+	/**
+	 * Resets the context, running its remaining timer and end behaviors, and returns it to the pool.
+	 */
+	void Release(BehaviorContext* context);
+
+	/**
+	 * An empty bitstream borrowed from the pool for as long as this object lives.  Casts can nest, so every
+	 * lease gets its own bitstream.
+	 */
+	class ScratchBitStream {
+	public:
+		ScratchBitStream();
+		~ScratchBitStream();
+
+		ScratchBitStream(const ScratchBitStream&) = delete;
+		ScratchBitStream& operator=(const ScratchBitStream&) = delete;
+
+		RakNet::BitStream& operator*() const { return *m_BitStream; }
+		RakNet::BitStream* operator->() const { return m_BitStream; }
+
+	private:
+		RakNet::BitStream* m_BitStream;
+	};
+
+	size_t GetFreeCount();
+
+	/**
+	 * @return How many contexts and bitstreams the pool has had to allocate because none were free.
+	 */
+	size_t GetAllocationCount();
+
+	/**
+	 * Frees every pooled context and bitstream.
+	 */
+	void Clear();
+};
+
+#endif  //!__BEHAVIORCONTEXTPOOL__H__
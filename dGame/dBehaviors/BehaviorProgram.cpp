@@ -0,0 +1,813 @@
+#include "BehaviorProgram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <typeinfo>
+
+#include "AndBehavior.h"
+#include "AreaOfEffectBehavior.h"
+#include "BaseCombatAIComponent.h"
+#include "BasicAttackBehavior.h"
+#include "Behavior.h"
+#include "BehaviorBranchContext.h"
+#include "BehaviorContext.h"
+#include "BuffComponent.h"
+#include "ChainBehavior.h"
+#include "DestroyableComponent.h"
+#include "EmptyBehavior.h"
+#include "Entity.h"
+#include "EntityManager.h"
+#include "Game.h"
+#include "Logger.h"
+#include "OverTimeBehavior.h"
+#include "SwitchBehavior.h"
+#include "TacArcBehavior.h"
+#include "WorldConfig.h"
+#include "dZoneManager.h"
+#include "eBasicAttackSuccessTypes.h"
+
+bool BehaviorProgram::m_Enabled = false;
+
+namespace {
+	std::unordered_map<uint32_t, std::unique_ptr<BehaviorProgram>> g_Programs;
+
+	// Children of a BASIC_ATTACK node
+	constexpr uint32_t ON_SUCCESS = 0;
+	constexpr uint32_t ON_FAIL_ARMOR = 1;
+	constexpr uint32_t ON_FAIL_IMMUNE = 2;
+	constexpr uint32_t ON_FAIL_BLOCKED = 3;
+
+	// Children of a TAC_ARC node
+	constexpr uint32_t ACTION = 0;
+	constexpr uint32_t MISS_ACTION = 1;
+	constexpr uint32_t BLOCKED_ACTION = 2;
+};
+
+BehaviorProgram::BehaviorProgram(Behavior* root) {
+	std::unordered_map<Behavior*, uint32_t> compiled;
+	Compile(root, compiled);
+}
+
+uint32_t BehaviorProgram::Compile(Behavior* behavior, std::unordered_map<Behavior*, uint32_t>& compiled) {
+	const auto existing = compiled.find(behavior);
+	if (existing != compiled.end()) return existing->second;
+
+	// The node is registered before its children, so a behavior that refers back to itself loops the same way it always did.
+	const auto index = static_cast<uint32_t>(m_Nodes.size());
+	m_Nodes.emplace_back().behavior = behavior;
+	compiled.emplace(behavior, index);
+
+	Node node;
+	node.behavior = behavior;
+	std::vector<Behavior*> children;
+
+	if (behavior == nullptr) {
+		node.op = Op::CALL;
+	} else if (typeid(*behavior) == typeid(EmptyBehavior)) {
+		node.op = Op::EMPTY;
+	} else if (auto* andBehavior = dynamic_cast<AndBehavior*>(behavior)) {
+		node.op = Op::AND;
+		children = andBehavior->m_behaviors;
+	} else if (auto* chain = dynamic_cast<ChainBehavior*>(behavior); chain && !chain->m_behaviors.empty()) {
+		// An empty chain throws when calculated, so it is left to the behavior itself.
+		node.op = Op::CHAIN;
+		children = chain->m_behaviors;
+	} else if (auto* switchBehavior = dynamic_cast<SwitchBehavior*>(behavior)) {
+		node.op = Op::SWITCH;
+		node.parameters = static_cast<uint32_t>(m_Switches.size());
+		m_Switches.push_back({
+			.imagination = switchBehavior->m_imagination,
+			.targetHasBuff = switchBehavior->m_targetHasBuff,
+			.distance = switchBehavior->m_Distance,
+			.isEnemyFaction = switchBehavior->m_isEnemyFaction
+		});
+		children = { switchBehavior->m_actionTrue, switchBehavior->m_actionFalse };
+	} else if (auto* basicAttack = dynamic_cast<BasicAttackBehavior*>(behavior)) {
+		node.op = Op::BASIC_ATTACK;
+		node.parameters = static_cast<uint32_t>(m_BasicAttacks.size());
+		m_BasicAttacks.push_back({
+			.minDamage = basicAttack->m_MinDamage,
+			.maxDamage = basicAttack->m_MaxDamage,
+			.dontApplyImmune = basicAttack->m_DontApplyImmune,
+			.failArmorIsEmpty = basicAttack->m_OnFailArmor && basicAttack->m_OnFailArmor->m_templateId == BehaviorTemplate::EMPTY
+		});
+		children = { basicAttack->m_OnSuccess, basicAttack->m_OnFailArmor, basicAttack->m_OnFailImmune, basicAttack->m_OnFailBlocked };
+	} else if (auto* tacArc = dynamic_cast<TacArcBehavior*>(behavior)) {
+		node.op = Op::TAC_ARC;
+		node.parameters = static_cast<uint32_t>(m_TacArcs.size());
+		m_TacArcs.push_back({
+			.filter = { tacArc->m_ignoreFactionList, tacArc->m_includeFactionList, tacArc->m_targetSelf, tacArc->m_targetEnemy, tacArc->m_targetFriend, tacArc->m_targetTeam },
+			.offset = tacArc->m_offset,
+			.maxRange = tacArc->m_maxRange,
+			.minRange = tacArc->m_minRange,
+			.angle = tacArc->m_angle,
+			.upperBound = tacArc->m_upperBound,
+			.lowerBound = tacArc->m_lowerBound,
+			.farWidth = tacArc->m_farWidth,
+			.method = tacArc->m_method,
+			.maxTargets = tacArc->m_maxTargets,
+			.usePickedTarget = tacArc->m_usePickedTarget,
+			.checkEnv = tacArc->m_checkEnv
+		});
+		children = { tacArc->m_action, tacArc->m_missAction, tacArc->m_blockedAction };
+	} else if (auto* areaOfEffect = dynamic_cast<AreaOfEffectBehavior*>(behavior)) {
+		node.op = Op::AREA_OF_EFFECT;
+		node.parameters = static_cast<uint32_t>(m_AreasOfEffect.size());
+		m_AreasOfEffect.push_back({
+			.filter = { areaOfEffect->m_ignoreFactionList, areaOfEffect->m_includeFactionList, areaOfEffect->m_targetSelf, areaOfEffect->m_targetEnemy, areaOfEffect->m_targetFriend, areaOfEffect->m_targetTeam },
+			.offset = areaOfEffect->m_offset,
+			.radius = areaOfEffect->m_radius,
+			.maxTargets = areaOfEffect->m_maxTargets,
+			.useTargetPosition = areaOfEffect->m_useTargetPosition,
+			.useTargetAsCaster = areaOfEffect->m_useTargetAsCaster
+		});
+		children = { areaOfEffect->m_action };
+	} else if (dynamic_cast<OverTimeBehavior*>(behavior)) {
+		node.op = Op::OVER_TIME;
+	}
+
+	// Children are compiled first so that their indices can be stored next to each other.
+	std::vector<uint32_t> childIndices;
+	childIndices.reserve(children.size());
+	for (auto* child : children) childIndices.push_back(child ? Compile(child, compiled) : UINT32_MAX);
+
+	if (std::find(childIndices.begin(), childIndices.end(), UINT32_MAX) != childIndices.end()) {
+		// A missing child crashes the behavior, so it is left to do that itself.
+		node.op = Op::CALL;
+		childIndices.clear();
+	}
+
+	node.firstChild = static_cast<uint32_t>(m_Children.size());
+	node.childCount = static_cast<uint32_t>(childIndices.size());
+	m_Children.insert(m_Children.end(), childIndices.begin(), childIndices.end());
+	m_Nodes[index] = node;
+
+	return index;
+}
+
+void BehaviorProgram::Handle(BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	if (!m_Nodes.empty()) Handle(0, context, bitStream, branch);
+}
+
+void BehaviorProgram::Calculate(BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	if (!m_Nodes.empty()) Calculate(0, context, bitStream, branch);
+}
+
+void BehaviorProgram::Handle(const uint32_t index, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& node = m_Nodes[index];
+
+	switch (node.op) {
+	case Op::CALL:
+	case Op::OVER_TIME:
+		node.behavior->Handle(context, bitStream, branch);
+		break;
+	case Op::EMPTY:
+		break;
+	case Op::AND:
+		for (uint32_t i = 0; i < node.childCount; i++) Handle(m_Children[node.firstChild + i], context, bitStream, branch);
+		break;
+	case Op::CHAIN: {
+		uint32_t chainIndex{};
+
+		if (!bitStream.Read(chainIndex)) {
+			LOG("Unable to read chainIndex from bitStream, aborting Handle! %i", bitStream.GetNumberOfUnreadBits());
+			return;
+		}
+
+		chainIndex--;
+
+		if (chainIndex < node.childCount) {
+			Handle(m_Children[node.firstChild + chainIndex], context, bitStream, branch);
+		} else {
+			LOG("chainIndex out of bounds, aborting handle of chain %i bits unread %i", chainIndex, bitStream.GetNumberOfUnreadBits());
+		}
+		break;
+	}
+	case Op::SWITCH: {
+		const auto& parameters = m_Switches[node.parameters];
+		bool state = true;
+
+		if (parameters.imagination > 0 || parameters.targetHasBuff > 0 || parameters.distance > -1.0f) {
+			if (!bitStream.Read(state)) {
+				LOG("Unable to read state from bitStream, aborting Handle! %i", bitStream.GetNumberOfUnreadBits());
+				return;
+			}
+		}
+
+		auto* entity = Game::entityManager->GetEntity(context->originator);
+
+		if (!entity) return;
+
+		auto* destroyableComponent = entity->GetComponent<DestroyableComponent>();
+
+		if (destroyableComponent) {
+			if (parameters.isEnemyFaction) {
+				auto* target = Game::entityManager->GetEntity(branch.target);
+				if (target) state = destroyableComponent->IsEnemy(target);
+			}
+
+			LOG_DEBUG("[%i] State: (%d), imagination: (%i) / (%f)", entity->GetLOT(), state, destroyableComponent->GetImagination(), destroyableComponent->GetMaxImagination());
+		}
+
+		Handle(m_Children[node.firstChild + (state ? 0 : 1)], context, bitStream, branch);
+		break;
+	}
+	case Op::BASIC_ATTACK:
+		HandleBasicAttack(node, context, bitStream, branch);
+		break;
+	case Op::TAC_ARC:
+		HandleTacArc(node, context, bitStream, branch);
+		break;
+	case Op::AREA_OF_EFFECT:
+		HandleAreaOfEffect(node, context, bitStream, branch);
+		break;
+	}
+}
+
+void BehaviorProgram::Calculate(const uint32_t index, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& node = m_Nodes[index];
+
+	switch (node.op) {
+	case Op::CALL:
+		node.behavior->Calculate(context, bitStream, branch);
+		break;
+	case Op::EMPTY:
+	case Op::OVER_TIME:
+		break;
+	case Op::AND:
+		for (uint32_t i = 0; i < node.childCount; i++) Calculate(m_Children[node.firstChild + i], context, bitStream, branch);
+		break;
+	case Op::CHAIN:
+		bitStream.Write(1);
+
+		Calculate(m_Children[node.firstChild], context, bitStream, branch);
+		break;
+	case Op::SWITCH: {
+		const auto& parameters = m_Switches[node.parameters];
+		bool state = true;
+		if (parameters.imagination > 0 || parameters.targetHasBuff > 0 || parameters.distance > -1.0f) {
+			auto* entity = Game::entityManager->GetEntity(branch.target);
+
+			state = entity != nullptr;
+
+			if (state) {
+				if (parameters.targetHasBuff != 0) {
+					auto* buffComponent = entity->GetComponent<BuffComponent>();
+
+					if (buffComponent != nullptr && !buffComponent->HasBuff(parameters.targetHasBuff)) {
+						state = false;
+					}
+				} else if (parameters.imagination > 0) {
+					auto* destroyableComponent = entity->GetComponent<DestroyableComponent>();
+
+					if (destroyableComponent && destroyableComponent->GetImagination() < parameters.imagination) {
+						state = false;
+					}
+				} else if (parameters.distance > -1.0f) {
+					auto* originator = Game::entityManager->GetEntity(context->originator);
+
+					if (originator) {
+						const auto distance = (originator->GetPosition() - entity->GetPosition()).Length();
+
+						state = distance <= parameters.distance;
+					}
+				}
+			}
+
+			bitStream.Write(state);
+		}
+
+		Calculate(m_Children[node.firstChild + (state ? 0 : 1)], context, bitStream, branch);
+		break;
+	}
+	case Op::BASIC_ATTACK:
+		CalculateBasicAttack(node, context, bitStream, branch);
+		break;
+	case Op::TAC_ARC:
+		CalculateTacArc(node, context, bitStream, branch);
+		break;
+	case Op::AREA_OF_EFFECT:
+		CalculateAreaOfEffect(node, context, bitStream, branch);
+		break;
+	}
+}
+
+void BehaviorProgram::HandleBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& parameters = m_BasicAttacks[node.parameters];
+
+	if (context->unmanaged) {
+		auto* entity = Game::entityManager->GetEntity(branch.target);
+
+		auto* destroyableComponent = entity->GetComponent<DestroyableComponent>();
+		if (destroyableComponent != nullptr) {
+			node.behavior->PlayFx(u"onhit", entity->GetObjectID());
+			destroyableComponent->Damage(parameters.maxDamage, context->originator, context->skillID);
+
+			//Handle player damage cooldown
+			if (entity->IsPlayer() && !parameters.dontApplyImmune) {
+				const float immunityTime = Game::zoneManager->GetWorldConfig()->globalImmunityTime;
+				destroyableComponent->SetDamageCooldownTimer(immunityTime);
+			}
+		}
+
+		Handle(m_Children[node.firstChild + ON_SUCCESS], context, bitStream, branch);
+
+		return;
+	}
+
+	bitStream.AlignReadToByteBoundary();
+
+	uint16_t allocatedBits{};
+	if (!bitStream.Read(allocatedBits) || allocatedBits == 0) {
+		LOG_DEBUG("No allocated bits");
+		return;
+	}
+	LOG_DEBUG("Number of allocated bits %i", allocatedBits);
+	const auto baseAddress = bitStream.GetReadOffset();
+
+	DoHandleBasicAttack(node, context, bitStream, branch);
+
+	bitStream.SetReadOffset(baseAddress + allocatedBits);
+}
+
+void BehaviorProgram::DoHandleBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& parameters = m_BasicAttacks[node.parameters];
+
+	auto* targetEntity = Game::entityManager->GetEntity(branch.target);
+	if (!targetEntity) {
+		LOG("Target targetEntity %llu not found.", branch.target);
+		return;
+	}
+
+	auto* destroyableComponent = targetEntity->GetComponent<DestroyableComponent>();
+	if (!destroyableComponent) {
+		LOG("No destroyable found on the obj/lot %llu/%i", branch.target, targetEntity->GetLOT());
+		return;
+	}
+
+	bool isBlocked{};
+	bool isImmune{};
+	bool isSuccess{};
+
+	if (!bitStream.Read(isBlocked)) {
+		LOG("Unable to read isBlocked");
+		return;
+	}
+
+	if (isBlocked) {
+		destroyableComponent->SetAttacksToBlock(std::min(destroyableComponent->GetAttacksToBlock() - 1, 0U));
+		Game::entityManager->SerializeEntity(targetEntity);
+		Handle(m_Children[node.firstChild + ON_FAIL_BLOCKED], context, bitStream, branch);
+		return;
+	}
+
+	if (!bitStream.Read(isImmune)) {
+		LOG("Unable to read isImmune");
+		return;
+	}
+
+	if (isImmune) {
+		LOG_DEBUG("Target targetEntity %llu is immune!", branch.target);
+		Handle(m_Children[node.firstChild + ON_FAIL_IMMUNE], context, bitStream, branch);
+		return;
+	}
+
+	if (!bitStream.Read(isSuccess)) {
+		LOG("failed to read success from bitstream");
+		return;
+	}
+
+	if (isSuccess) {
+		uint32_t armorDamageDealt{};
+		if (!bitStream.Read(armorDamageDealt)) {
+			LOG("Unable to read armorDamageDealt");
+			return;
+		}
+
+		uint32_t healthDamageDealt{};
+		if (!bitStream.Read(healthDamageDealt)) {
+			LOG("Unable to read healthDamageDealt");
+			return;
+		}
+
+		uint32_t totalDamageDealt = armorDamageDealt + healthDamageDealt;
+
+		// A value that's too large may be a cheating attempt, so we set it to MIN
+		if (totalDamageDealt > parameters.maxDamage) {
+			totalDamageDealt = parameters.minDamage;
+		}
+
+		bool died{};
+		if (!bitStream.Read(died)) {
+			LOG("Unable to read died");
+			return;
+		}
+		node.behavior->PlayFx(u"onhit", targetEntity->GetObjectID());
+		destroyableComponent->Damage(totalDamageDealt, context->originator, context->skillID);
+	}
+
+	uint8_t successState{};
+	if (!bitStream.Read(successState)) {
+		LOG("Unable to read success state");
+		return;
+	}
+
+	switch (static_cast<eBasicAttackSuccessTypes>(successState)) {
+	case eBasicAttackSuccessTypes::SUCCESS:
+		Handle(m_Children[node.firstChild + ON_SUCCESS], context, bitStream, branch);
+		break;
+	case eBasicAttackSuccessTypes::FAILARMOR:
+		Handle(m_Children[node.firstChild + ON_FAIL_ARMOR], context, bitStream, branch);
+		break;
+	default:
+		if (static_cast<eBasicAttackSuccessTypes>(successState) != eBasicAttackSuccessTypes::FAILIMMUNE) {
+			LOG("Unknown success state (%i)!", successState);
+			return;
+		}
+		Handle(m_Children[node.firstChild + ON_FAIL_IMMUNE], context, bitStream, branch);
+		break;
+	}
+}
+
+void BehaviorProgram::CalculateBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	bitStream.AlignWriteToByteBoundary();
+
+	const auto allocatedAddress = bitStream.GetWriteOffset();
+
+	bitStream.Write<uint16_t>(0);
+
+	const auto startAddress = bitStream.GetWriteOffset();
+
+	DoCalculateBasicAttack(node, context, bitStream, branch);
+
+	const auto endAddress = bitStream.GetWriteOffset();
+	const uint16_t allocate = endAddress - startAddress;
+
+	bitStream.SetWriteOffset(allocatedAddress);
+	bitStream.Write(allocate);
+	bitStream.SetWriteOffset(startAddress + allocate);
+}
+
+void BehaviorProgram::DoCalculateBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& parameters = m_BasicAttacks[node.parameters];
+
+	auto* targetEntity = Game::entityManager->GetEntity(branch.target);
+	if (!targetEntity) {
+		LOG("Target entity %llu is null!", branch.target);
+		return;
+	}
+
+	auto* destroyableComponent = targetEntity->GetComponent<DestroyableComponent>();
+	if (!destroyableComponent || !destroyableComponent->GetParent()) {
+		LOG("No destroyable component on %llu", branch.target);
+		return;
+	}
+
+	const bool isBlocking = destroyableComponent->GetAttacksToBlock() > 0;
+
+	bitStream.Write(isBlocking);
+
+	if (isBlocking) {
+		destroyableComponent->SetAttacksToBlock(destroyableComponent->GetAttacksToBlock() - 1);
+		Game::entityManager->SerializeEntity(targetEntity);
+		Calculate(m_Children[node.firstChild + ON_FAIL_BLOCKED], context, bitStream, branch);
+		return;
+	}
+
+	const bool isImmune = destroyableComponent->IsImmune() || destroyableComponent->IsCooldownImmune();
+	bitStream.Write(isImmune);
+
+	if (isImmune) {
+		LOG_DEBUG("Target targetEntity %llu is immune!", branch.target);
+		Calculate(m_Children[node.firstChild + ON_FAIL_IMMUNE], context, bitStream, branch);
+		return;
+	}
+
+	const uint32_t previousHealth = destroyableComponent->GetHealth();
+	const uint32_t previousArmor = destroyableComponent->GetArmor();
+
+	node.behavior->PlayFx(u"onhit", targetEntity->GetObjectID(), 1);
+	destroyableComponent->Damage(parameters.minDamage, context->originator, context->skillID, false);
+	context->ScheduleUpdate(branch.target);
+
+	const uint32_t armorDamageDealt = previousArmor - destroyableComponent->GetArmor();
+	const uint32_t healthDamageDealt = previousHealth - destroyableComponent->GetHealth();
+	const bool isSuccess = armorDamageDealt > 0 || healthDamageDealt > 0;
+
+	bitStream.Write(isSuccess);
+
+	//Handle player damage cooldown
+	if (isSuccess && targetEntity->IsPlayer() && !parameters.dontApplyImmune) {
+		destroyableComponent->SetDamageCooldownTimer(Game::zoneManager->GetWorldConfig()->globalImmunityTime);
+	}
+
+	eBasicAttackSuccessTypes successState = eBasicAttackSuccessTypes::FAILIMMUNE;
+	if (isSuccess) {
+		if (healthDamageDealt >= 1) {
+			successState = eBasicAttackSuccessTypes::SUCCESS;
+		} else if (armorDamageDealt >= 1) {
+			successState = parameters.failArmorIsEmpty ? eBasicAttackSuccessTypes::FAILIMMUNE : eBasicAttackSuccessTypes::FAILARMOR;
+		}
+
+		bitStream.Write(armorDamageDealt);
+		bitStream.Write(healthDamageDealt);
+		bitStream.Write(targetEntity->GetIsDead());
+	}
+
+	bitStream.Write(successState);
+
+	switch (successState) {
+	case eBasicAttackSuccessTypes::SUCCESS:
+		Calculate(m_Children[node.firstChild + ON_SUCCESS], context, bitStream, branch);
+		break;
+	case eBasicAttackSuccessTypes::FAILARMOR:
+		Calculate(m_Children[node.firstChild + ON_FAIL_ARMOR], context, bitStream, branch);
+		break;
+	default:
+		Calculate(m_Children[node.firstChild + ON_FAIL_IMMUNE], context, bitStream, branch);
+		break;
+	}
+}
+
+void BehaviorProgram::HandleTacArc(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& parameters = m_TacArcs[node.parameters];
+	const auto& filter = parameters.filter;
+	std::vector<Entity*> targets = {};
+
+	if (parameters.usePickedTarget && branch.target != LWOOBJID_EMPTY) {
+		auto target = Game::entityManager->GetEntity(branch.target);
+		if (!target) LOG("target %llu is null", branch.target);
+		else {
+			targets.push_back(target);
+			context->FilterTargets(targets, filter.ignoreFactionList, filter.includeFactionList, filter.targetSelf, filter.targetEnemy, filter.targetFriend, filter.targetTeam);
+			if (!targets.empty()) {
+				Handle(m_Children[node.firstChild + ACTION], context, bitStream, branch);
+				return;
+			}
+		}
+	}
+
+	bool hasTargets = false;
+	if (!bitStream.Read(hasTargets)) {
+		LOG("Unable to read hasTargets from bitStream, aborting Handle! %i", bitStream.GetNumberOfUnreadBits());
+		return;
+	}
+
+	if (parameters.checkEnv) {
+		bool blocked = false;
+
+		if (!bitStream.Read(blocked)) {
+			LOG("Unable to read blocked from bitStream, aborting Handle! %i", bitStream.GetNumberOfUnreadBits());
+			return;
+		}
+
+		if (blocked) {
+			Handle(m_Children[node.firstChild + BLOCKED_ACTION], context, bitStream, branch);
+			return;
+		}
+	}
+
+	if (hasTargets) {
+		uint32_t count = 0;
+		if (!bitStream.Read(count)) {
+			LOG("Unable to read count from bitStream, aborting Handle! %i", bitStream.GetNumberOfUnreadBits());
+			return;
+		}
+
+		if (count > parameters.maxTargets) {
+			LOG("Bitstream has too many targets Max:%i Recv:%i", parameters.maxTargets, count);
+			return;
+		}
+
+		for (auto i = 0u; i < count; i++) {
+			LWOOBJID id{};
+
+			if (!bitStream.Read(id)) {
+				LOG("Unable to read id from bitStream, aborting Handle! %i", bitStream.GetNumberOfUnreadBits());
+				return;
+			}
+
+			if (id != LWOOBJID_EMPTY) {
+				auto* canidate = Game::entityManager->GetEntity(id);
+				if (canidate) targets.push_back(canidate);
+			} else {
+				LOG("Bitstream has LWOOBJID_EMPTY as a target!");
+			}
+		}
+
+		auto actionBranch = branch;
+		for (auto target : targets) {
+			actionBranch.target = target->GetObjectID();
+			Handle(m_Children[node.firstChild + ACTION], context, bitStream, actionBranch);
+		}
+	} else Handle(m_Children[node.firstChild + MISS_ACTION], context, bitStream, branch);
+}
+
+void BehaviorProgram::CalculateTacArc(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& parameters = m_TacArcs[node.parameters];
+	const auto& filter = parameters.filter;
+
+	auto* self = Game::entityManager->GetEntity(context->originator);
+	if (self == nullptr) {
+		LOG("Invalid self for (%llu)!", context->originator);
+		return;
+	}
+
+	std::vector<Entity*> targets = {};
+	if (parameters.usePickedTarget && branch.target != LWOOBJID_EMPTY) {
+		auto target = Game::entityManager->GetEntity(branch.target);
+		targets.push_back(target);
+		context->FilterTargets(targets, filter.ignoreFactionList, filter.includeFactionList, filter.targetSelf, filter.targetEnemy, filter.targetFriend, filter.targetTeam);
+		if (!targets.empty()) {
+			// TacArcBehavior handles rather than calculates its action here, and so does the program.
+			Handle(m_Children[node.firstChild + ACTION], context, bitStream, branch);
+			return;
+		}
+	}
+
+	auto* combatAi = self->GetComponent<BaseCombatAIComponent>();
+
+	const auto casterPosition = self->GetPosition();
+
+	auto reference = self->GetPosition() + parameters.offset;
+
+	targets.clear();
+
+	std::vector<Entity*> validTargets = Game::entityManager->GetEntitiesByProximity(reference, parameters.maxRange);
+
+	// filter all valid targets, based on whether we target enemies or friends
+	context->FilterTargets(validTargets, filter.ignoreFactionList, filter.includeFactionList, filter.targetSelf, filter.targetEnemy, filter.targetFriend, filter.targetTeam);
+
+	for (auto validTarget : validTargets) {
+		if (targets.size() >= parameters.maxTargets) break;
+		if (std::find(targets.begin(), targets.end(), validTarget) != targets.end()) continue;
+		if (validTarget->GetIsDead()) continue;
+
+		const auto targetPos = validTarget->GetPosition();
+
+		// make sure we aren't too high or low in comparison to the targer
+		const auto heightDifference = std::abs(reference.y - targetPos.y);
+		if ((targetPos.y > reference.y && heightDifference > parameters.upperBound) || (targetPos.y < reference.y && heightDifference > parameters.lowerBound))
+			continue;
+
+		const auto forward = self->GetRotation().GetForwardVector();
+
+		const auto distance = Vector3::Distance(reference, targetPos);
+
+		if (parameters.method == 2) {
+			NiPoint3 rayPoint = casterPosition + forward * distance;
+			if (parameters.farWidth > 0 && Vector3::DistanceSquared(rayPoint, targetPos) > parameters.farWidth * parameters.farWidth)
+				continue;
+		}
+
+		auto normalized = (reference - targetPos) / distance;
+		const float degreeAngle = std::abs(Vector3::Angle(forward, normalized) * (180 / 3.14) - 180);
+		if (distance >= parameters.minRange && parameters.maxRange >= distance && degreeAngle <= 2 * parameters.angle) {
+			targets.push_back(validTarget);
+		}
+	}
+
+	std::sort(targets.begin(), targets.end(), [reference](Entity* a, Entity* b) {
+		const auto aDistance = Vector3::DistanceSquared(reference, a->GetPosition());
+		const auto bDistance = Vector3::DistanceSquared(reference, b->GetPosition());
+
+		return aDistance > bDistance;
+		});
+
+	const auto hit = !targets.empty();
+	bitStream.Write(hit);
+
+	if (parameters.checkEnv) {
+		const auto blocked = false; // TODO
+		bitStream.Write(blocked);
+	}
+
+	if (hit) {
+		if (combatAi) combatAi->LookAt(targets[0]->GetPosition());
+
+		context->foundTarget = true; // We want to continue with this behavior
+		const auto count = static_cast<uint32_t>(targets.size());
+
+		bitStream.Write(count);
+		for (auto* target : targets) {
+			bitStream.Write(target->GetObjectID());
+		}
+
+		auto actionBranch = branch;
+		for (auto* target : targets) {
+			actionBranch.target = target->GetObjectID();
+			Calculate(m_Children[node.firstChild + ACTION], context, bitStream, actionBranch);
+		}
+	} else {
+		Calculate(m_Children[node.firstChild + MISS_ACTION], context, bitStream, branch);
+	}
+}
+
+void BehaviorProgram::HandleAreaOfEffect(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& parameters = m_AreasOfEffect[node.parameters];
+	uint32_t targetCount{};
+
+	if (!bitStream.Read(targetCount)) {
+		LOG("Unable to read targetCount from bitStream, aborting Handle! %i", bitStream.GetNumberOfUnreadBits());
+		return;
+	}
+
+	if (parameters.useTargetPosition && branch.target == LWOOBJID_EMPTY) return;
+
+	if (targetCount == 0) {
+		node.behavior->PlayFx(u"miss", context->originator);
+		return;
+	}
+
+	if (targetCount > parameters.maxTargets) {
+		LOG("Serialized size is greater than max targets! Size: %i, Max: %i", targetCount, parameters.maxTargets);
+		return;
+	}
+
+	auto caster = context->caster;
+	if (parameters.useTargetAsCaster) context->caster = branch.target;
+
+	std::vector<LWOOBJID> targets;
+	targets.reserve(targetCount);
+
+	for (auto i = 0u; i < targetCount; ++i) {
+		LWOOBJID target{};
+		if (!bitStream.Read(target)) {
+			LOG("failed to read in target %i from bitStream, aborting target Handle!", i);
+		}
+		targets.push_back(target);
+	}
+
+	auto actionBranch = branch;
+	for (auto target : targets) {
+		actionBranch.target = target;
+		Handle(m_Children[node.firstChild], context, bitStream, actionBranch);
+	}
+	context->caster = caster;
+	node.behavior->PlayFx(u"cast", context->originator);
+}
+
+void BehaviorProgram::CalculateAreaOfEffect(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const {
+	const auto& parameters = m_AreasOfEffect[node.parameters];
+	const auto& filter = parameters.filter;
+
+	auto* caster = Game::entityManager->GetEntity(context->caster);
+	if (!caster) return;
+
+	// determine the position we are casting the AOE from
+	auto reference = branch.isProjectile ? branch.referencePosition : caster->GetPosition();
+	if (parameters.useTargetPosition) {
+		if (branch.target == LWOOBJID_EMPTY) return;
+		auto branchTarget = Game::entityManager->GetEntity(branch.target);
+		if (branchTarget) reference = branchTarget->GetPosition();
+	}
+
+	reference += parameters.offset;
+
+	std::vector<Entity*> targets = Game::entityManager->GetEntitiesByProximity(reference, parameters.radius);
+	context->FilterTargets(targets, filter.ignoreFactionList, filter.includeFactionList, filter.targetSelf, filter.targetEnemy, filter.targetFriend, filter.targetTeam);
+
+	// sort by distance
+	std::sort(targets.begin(), targets.end(), [reference](Entity* a, Entity* b) {
+		const auto aDistance = NiPoint3::Distance(a->GetPosition(), reference);
+		const auto bDistance = NiPoint3::Distance(b->GetPosition(), reference);
+		return aDistance < bDistance;
+		}
+	);
+
+	// resize if we have more than max targets allows
+	if (targets.size() > parameters.maxTargets) targets.resize(parameters.maxTargets);
+
+	bitStream.Write<uint32_t>(targets.size());
+
+	if (targets.empty()) {
+		node.behavior->PlayFx(u"miss", context->originator);
+		return;
+	}
+
+	context->foundTarget = true;
+	// write all the targets to the bitstream
+	for (auto* target : targets) {
+		bitStream.Write(target->GetObjectID());
+	}
+
+	// then cast all the actions
+	auto actionBranch = branch;
+	for (auto* target : targets) {
+		actionBranch.target = target->GetObjectID();
+		Calculate(m_Children[node.firstChild], context, bitStream, actionBranch);
+	}
+	node.behavior->PlayFx(u"cast", context->originator);
+}
+
+const BehaviorProgram& BehaviorProgram::Get(const uint32_t behaviorId) {
+	auto& program = g_Programs[behaviorId];
+	if (!program) program = std::make_unique<BehaviorProgram>(Behavior::CreateBehavior(behaviorId));
+
+	return *program;
+}
+
+void BehaviorProgram::ClearCache() {
+	g_Programs.clear();
+}
@@ -0,0 +1,165 @@
+#ifndef __BEHAVIORPROGRAM__H__
+#define __BEHAVIORPROGRAM__H__
+
+#include <cstdint>
+#include <forward_list>
+#include <unordered_map>
+#include <vector>
+
+#include "NiPoint3.h"
+
+class Behavior;
+struct BehaviorContext;
+struct BehaviorBranchContext;
+
+namespace RakNet {
+	class BitStream;
+};
+
+/**
+ * A skill's behavior tree flattened into one array, so casting it walks contiguous nodes instead of chasing
+ * pointers through Behavior::Cache.  AND, CHAIN, SWITCH, BASIC_ATTACK, TAC_ARC and AREA_OF_EFFECT have their
+ * parameters copied in and are run by the program itself, and the templates that do nothing for a cast are skipped.
+ * Every other template is called on its Behavior as before, since those register sync, timer and end entries that
+ * point back at the Behavior.
+ *
+ * Running a program gives exactly the same result as calling Handle or Calculate on the root behavior.
+ */
+class BehaviorProgram {
+public:
+	/**
+	 * Flattens the tree below a behavior.  Subtrees shared by several branches are only stored once.
+	 */
+	explicit BehaviorProgram(Behavior* root);
+
+	void Handle(BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void Calculate(BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	size_t GetNodeCount() const { return m_Nodes.size(); }
+
+	/**
+	 * @return The program of a behavior, compiled on first use.
+	 */
+	static const BehaviorProgram& Get(uint32_t behaviorId);
+
+	/**
+	 * Whether skill casts should run programs instead of the behavior objects.  Off unless the server turns it on.
+	 */
+	static void SetEnabled(const bool enabled) { m_Enabled = enabled; }
+	static bool IsEnabled() { return m_Enabled; }
+
+	static void ClearCache();
+
+private:
+	enum class Op : uint8_t {
+		CALL,           // Calls Handle or Calculate on the behavior
+		EMPTY,          // Does nothing for a cast
+		AND,
+		CHAIN,
+		SWITCH,         // Children: true, false
+		BASIC_ATTACK,   // Children: on success, on fail armor, on fail immune, on fail blocked
+		TAC_ARC,        // Children: action, miss action, blocked action
+		AREA_OF_EFFECT, // Children: action
+		OVER_TIME       // Only its Handle does anything
+	};
+
+	struct Node {
+		Op op = Op::CALL;
+
+		// Called by CALL and OVER_TIME nodes.  The others only play its effects.
+		Behavior* behavior = nullptr;
+
+		// Into m_Children.
+		uint32_t firstChild = 0;
+		uint32_t childCount = 0;
+
+		// Into the parameters of the node's template below.
+		uint32_t parameters = 0;
+	};
+
+	struct SwitchParameters {
+		uint32_t imagination = 0;
+		int32_t targetHasBuff = 0;
+		float distance = 0;
+		bool isEnemyFaction = false;
+	};
+
+	struct BasicAttackParameters {
+		uint32_t minDamage = 0;
+		uint32_t maxDamage = 0;
+		bool dontApplyImmune = false;
+
+		// A failed armor hit counts as immune when there is nothing to do for it.
+		bool failArmorIsEmpty = false;
+	};
+
+	// What BehaviorContext::FilterTargets keeps.
+	struct TargetFilter {
+		std::forward_list<int32_t> ignoreFactionList;
+		std::forward_list<int32_t> includeFactionList;
+		bool targetSelf = false;
+		bool targetEnemy = false;
+		bool targetFriend = false;
+		bool targetTeam = false;
+	};
+
+	struct TacArcParameters {
+		TargetFilter filter;
+		NiPoint3 offset;
+		float maxRange = 0;
+		float minRange = 0;
+		float angle = 0;
+		float upperBound = 0;
+		float lowerBound = 0;
+		float farWidth = 0;
+		uint32_t method = 0;
+		uint32_t maxTargets = 0;
+		bool usePickedTarget = false;
+		bool checkEnv = false;
+	};
+
+	struct AreaOfEffectParameters {
+		TargetFilter filter;
+		NiPoint3 offset;
+		float radius = 0;
+		uint32_t maxTargets = 0;
+		bool useTargetPosition = false;
+		bool useTargetAsCaster = false;
+	};
+
+	uint32_t Compile(Behavior* behavior, std::unordered_map<Behavior*, uint32_t>& compiled);
+
+	void Handle(uint32_t index, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void Calculate(uint32_t index, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	// The larger templates, which do the same as the Handle and Calculate of their behaviors.
+
+	void HandleBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void DoHandleBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void CalculateBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void DoCalculateBasicAttack(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void HandleTacArc(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void CalculateTacArc(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void HandleAreaOfEffect(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	void CalculateAreaOfEffect(const Node& node, BehaviorContext* context, RakNet::BitStream& bitStream, const BehaviorBranchContext& branch) const;
+
+	std::vector<Node> m_Nodes;
+	std::vector<uint32_t> m_Children;
+	std::vector<SwitchParameters> m_Switches;
+	std::vector<BasicAttackParameters> m_BasicAttacks;
+	std::vector<TacArcParameters> m_TacArcs;
+	std::vector<AreaOfEffectParameters> m_AreasOfEffect;
+
+	static bool m_Enabled;
+};
+
+#endif  //!__BEHAVIORPROGRAM__H__
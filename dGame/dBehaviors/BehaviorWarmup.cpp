@@ -0,0 +1,162 @@
+#include "BehaviorWarmup.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+
+#include "Behavior.h"
+#include "BehaviorProgram.h"
+#include "CDClientManager.h"
+#include "CDComponentsRegistryTable.h"
+#include "CDItemSetSkillsTable.h"
+#include "CDItemSetsTable.h"
+#include "CDLootMatrixTable.h"
+#include "CDLootTableTable.h"
+#include "CDObjectSkillsTable.h"
+#include "CDSkillBehaviorTable.h"
+#include "CDVendorComponentTable.h"
+#include "dZoneManager.h"
+#include "eReplicaComponentType.h"
+#include "Entity.h"
+#include "Game.h"
+#include "GeneralUtils.h"
+#include "Logger.h"
+#include "Metrics.hpp"
+#include "Spawner.h"
+
+namespace {
+	// Calls work(begin, end, part) for parts of [0, count), one part per thread, and waits for all of them.
+	template<typename Part>
+	std::vector<Part> ParallelFor(const size_t count, const uint32_t threadCount, const std::function<void(size_t, size_t, Part&)>& work) {
+		const size_t partCount = std::max<size_t>(1, std::min<size_t>(threadCount, count));
+		std::vector<Part> parts(partCount);
+		const size_t partSize = (count + partCount - 1) / partCount;
+
+		if (threadCount == 0 || partCount == 1) {
+			work(0, count, parts.front());
+			return parts;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(partCount);
+		for (size_t i = 0; i < partCount; i++) {
+			const auto begin = std::min(count, i * partSize);
+			const auto end = std::min(count, begin + partSize);
+			threads.emplace_back([&work, &parts, begin, end, i]() { work(begin, end, parts[i]); });
+		}
+		for (auto& thread : threads) thread.join();
+
+		return parts;
+	}
+};
+
+std::vector<LOT> BehaviorWarmup::CollectZoneLots() {
+	std::unordered_set<LOT> lots;
+
+	for (const auto& [id, spawner] : Game::zoneManager->GetSpawners()) {
+		if (spawner && spawner->m_Info.templateID != LOT_NULL) lots.insert(spawner->m_Info.templateID);
+	}
+
+	auto* zoneControl = Game::zoneManager->GetZoneControlObject();
+	if (zoneControl) lots.insert(zoneControl->GetLOT());
+
+	// Everything the zone's vendors sell.
+	auto* componentsRegistryTable = CDClientManager::GetTable<CDComponentsRegistryTable>();
+	auto* vendorComponentTable = CDClientManager::GetTable<CDVendorComponentTable>();
+	auto* lootMatrixTable = CDClientManager::GetTable<CDLootMatrixTable>();
+	auto* lootTableTable = CDClientManager::GetTable<CDLootTableTable>();
+	std::vector<LOT> soldItems;
+	for (const auto lot : lots) {
+		const auto vendorComponentId = componentsRegistryTable->GetByIDAndType(lot, eReplicaComponentType::VENDOR, -1);
+		if (vendorComponentId == -1) continue;
+
+		const auto* vendor = vendorComponentTable->GetByID(vendorComponentId);
+		if (!vendor) continue;
+
+		for (const auto& matrix : lootMatrixTable->GetMatrix(vendor->LootMatrixIndex)) {
+			for (const auto& item : lootTableTable->GetTable(matrix.LootTableIndex)) soldItems.push_back(item.itemid);
+		}
+	}
+	lots.insert(soldItems.begin(), soldItems.end());
+
+	return { lots.begin(), lots.end() };
+}
+
+BehaviorWarmup::Result BehaviorWarmup::WarmUp(const std::span<const LOT> lots, const uint32_t threadCount) {
+	const auto start = std::chrono::steady_clock::now();
+	const auto memoryBefore = static_cast<int64_t>(Metrics::GetCurrentRSS());
+	const auto behaviorsBefore = Behavior::Cache.size();
+
+	Result result;
+	std::unordered_set<LOT> allLots(lots.begin(), lots.end());
+
+	// Item sets that contain any of the objects bring in the rest of their items and their bonus skills.
+	struct SetPart {
+		std::vector<LOT> items;
+		std::vector<uint32_t> skills;
+	};
+	auto* itemSetSkillsTable = CDClientManager::GetTable<CDItemSetSkillsTable>();
+	const auto itemSets = CDClientManager::GetTable<CDItemSetsTable>()->Query([](const CDItemSets&) { return true; });
+	const auto setParts = ParallelFor<SetPart>(itemSets.size(), threadCount, [&](const size_t begin, const size_t end, SetPart& part) {
+		for (size_t i = begin; i < end; i++) {
+			const auto& itemSet = itemSets[i];
+			auto ids = itemSet.itemIDs;
+			ids.erase(std::remove_if(ids.begin(), ids.end(), ::isspace), ids.end());
+
+			std::vector<LOT> items;
+			auto inZone = false;
+			for (const auto& token : GeneralUtils::SplitString(ids, ',')) {
+				const auto item = GeneralUtils::TryParse<LOT>(token);
+				if (!item) continue;
+
+				items.push_back(*item);
+				inZone |= allLots.contains(*item);
+			}
+			if (!inZone) continue;
+
+			part.items.insert(part.items.end(), items.begin(), items.end());
+			for (const auto skillSet : { itemSet.skillSetWith2, itemSet.skillSetWith3, itemSet.skillSetWith4, itemSet.skillSetWith5, itemSet.skillSetWith6 }) {
+				for (const auto& skill : itemSetSkillsTable->GetBySkillID(skillSet)) part.skills.push_back(skill.SkillID);
+			}
+		}
+	});
+
+	std::unordered_set<uint32_t> skills;
+	for (const auto& part : setParts) {
+		allLots.insert(part.items.begin(), part.items.end());
+		skills.insert(part.skills.begin(), part.skills.end());
+	}
+
+	// The skills of every object, and the root behavior of every skill.
+	auto* objectSkillsTable = CDClientManager::GetTable<CDObjectSkillsTable>();
+	auto* skillBehaviorTable = CDClientManager::GetTable<CDSkillBehaviorTable>();
+	const std::vector<LOT> lotList(allLots.begin(), allLots.end());
+	const auto skillParts = ParallelFor<std::vector<uint32_t>>(lotList.size(), threadCount, [&](const size_t begin, const size_t end, std::vector<uint32_t>& part) {
+		for (size_t i = begin; i < end; i++) {
+			for (const auto* objectSkill : objectSkillsTable->GetByObjectTemplate(lotList[i])) part.push_back(objectSkill->skillID);
+		}
+	});
+	for (const auto& part : skillParts) skills.insert(part.begin(), part.end());
+
+	std::unordered_set<uint32_t> roots;
+	for (const auto skill : skills) {
+		const auto behaviorId = skillBehaviorTable->GetSkillByID(skill).behaviorID;
+		if (behaviorId != 0) roots.insert(behaviorId);
+	}
+
+	for (const auto root : roots) {
+		Behavior::CreateBehavior(root);
+		if (BehaviorProgram::IsEnabled()) BehaviorProgram::Get(root);
+	}
+
+	result.lots = allLots.size();
+	result.skills = skills.size();
+	result.behaviors = Behavior::Cache.size() - behaviorsBefore;
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.memoryBytes = static_cast<int64_t>(Metrics::GetCurrentRSS()) - memoryBefore;
+
+	return result;
+}
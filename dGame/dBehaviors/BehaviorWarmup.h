@@ -0,0 +1,38 @@
+#ifndef __BEHAVIORWARMUP__H__
+#define __BEHAVIORWARMUP__H__
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "dCommonVars.h"
+
+/**
+ * Builds the behavior trees of every skill a zone is likely to cast before the zone opens, so the first cast of a
+ * boss attack or a vendor item does not make the game thread read the CDClient and allocate its whole tree mid combat.
+ */
+namespace BehaviorWarmup {
+	struct Result {
+		size_t lots = 0;
+		size_t skills = 0;
+		size_t behaviors = 0;
+		double seconds = 0;
+		int64_t memoryBytes = 0;
+	};
+
+	/**
+	 * @return The objects the loaded zone spawns and the items its vendors sell.  Must run on the game thread,
+	 * since the vendor tables load rows on demand.
+	 */
+	std::vector<LOT> CollectZoneLots();
+
+	/**
+	 * Builds the behaviors of every skill of the given objects, of the item sets they belong to, and of those sets' bonuses.
+	 * Finding the skills is split across threads since those tables are only read; the trees themselves are built
+	 * on the calling thread, as building one adds to Behavior::Cache.
+	 * @param threadCount How many threads look up skills.  0 looks them up on the calling thread.
+	 */
+	Result WarmUp(std::span<const LOT> lots, uint32_t threadCount);
+};
+
+#endif  //!__BEHAVIORWARMUP__H__
@@ -11,6 +11,9 @@ public:
 	void Calculate(BehaviorContext* context, RakNet::BitStream& bitStream, BehaviorBranchContext branch) override;
 	void Load() override;
 private:
+	// Copies the parameters into its nodes.
+	friend class BehaviorProgram;
+
 	float m_maxRange;
 	float m_height;
 	float m_distanceWeight;
@@ -47,23 +47,22 @@ ActivityComponent::ActivityComponent(Entity* parent, int32_t activityID) : Compo
 	if (destroyableComponent) {
 		// First lookup the loot matrix id for this component id.
 		CDActivityRewardsTable* activityRewardsTable = CDClientManager::GetTable<CDActivityRewardsTable>();
-		std::vector<CDActivityRewards> activityRewards = activityRewardsTable->Query([=](CDActivityRewards entry) {return (entry.LootMatrixIndex == destroyableComponent->GetLootMatrixID()); });
+		const auto activityRewards = activityRewardsTable->GetByLootMatrixIndex(destroyableComponent->GetLootMatrixID());
 
 		uint32_t startingLMI = 0;
 
 		// If we have one, set the starting loot matrix id to that.
-		if (activityRewards.size() > 0) {
-			startingLMI = activityRewards[0].LootMatrixIndex;
+		if (!activityRewards.empty()) {
+			startingLMI = activityRewards[0]->LootMatrixIndex;
 		}
 
 		if (startingLMI > 0) {
 			// We may have more than 1 loot matrix index to use depending ont the size of the team that is looting the activity.
 			// So this logic will get the rest of the loot matrix indices for this activity.
 
-			std::vector<CDActivityRewards> objectTemplateActivities = activityRewardsTable->Query([=](CDActivityRewards entry) {return (activityRewards[0].objectTemplate == entry.objectTemplate); });
-			for (const auto& item : objectTemplateActivities) {
-				if (item.activityRating > 0 && item.activityRating < 5) {
-					m_ActivityLootMatrices.insert({ item.activityRating, item.LootMatrixIndex });
+			for (const auto* item : activityRewardsTable->GetByObjectTemplate(activityRewards[0]->objectTemplate)) {
+				if (item->activityRating > 0 && item->activityRating < 5) {
+					m_ActivityLootMatrices.insert({ item->activityRating, item->LootMatrixIndex });
 				}
 			}
 		}
@@ -71,12 +70,12 @@ ActivityComponent::ActivityComponent(Entity* parent, int32_t activityID) : Compo
 }
 void ActivityComponent::LoadActivityData(const int32_t activityId) {
 	CDActivitiesTable* activitiesTable = CDClientManager::GetTable<CDActivitiesTable>();
-	std::vector<CDActivities> activities = activitiesTable->Query([activityId](CDActivities entry) {return (entry.ActivityID == activityId); });
+	const auto* activity = activitiesTable->GetByActivityID(activityId);
 
 	bool soloRacing = Game::config->GetValue("solo_racing") == "1";
-	for (CDActivities activity : activities) {
-		m_ActivityInfo = activity;
-		if (static_cast<Leaderboard::Type>(activity.leaderboardType) == Leaderboard::Type::Racing && soloRacing) {
+	if (activity) {
+		m_ActivityInfo = *activity;
+		if (static_cast<Leaderboard::Type>(activity->leaderboardType) == Leaderboard::Type::Racing && soloRacing) {
 			m_ActivityInfo.minTeamSize = 1;
 			m_ActivityInfo.minTeams = 1;
 		}
@@ -108,15 +107,14 @@ void ActivityComponent::Serialize(RakNet::BitStream& outBitStream, bool bIsIniti
 
 void ActivityComponent::ReloadConfig() {
 	CDActivitiesTable* activitiesTable = CDClientManager::GetTable<CDActivitiesTable>();
-	std::vector<CDActivities> activities = activitiesTable->Query([this](CDActivities entry) {return (entry.ActivityID == m_ActivityID); });
-	for (auto activity : activities) {
-		auto mapID = m_ActivityInfo.instanceMapID;
-		if (static_cast<Leaderboard::Type>(activity.leaderboardType) == Leaderboard::Type::Racing && Game::config->GetValue("solo_racing") == "1") {
+	const auto* activity = activitiesTable->GetByActivityID(m_ActivityID);
+	if (activity) {
+		if (static_cast<Leaderboard::Type>(activity->leaderboardType) == Leaderboard::Type::Racing && Game::config->GetValue("solo_racing") == "1") {
 			m_ActivityInfo.minTeamSize = 1;
 			m_ActivityInfo.minTeams = 1;
 		} else {
-			m_ActivityInfo.minTeamSize = activity.minTeamSize;
-			m_ActivityInfo.minTeams = activity.minTeams;
+			m_ActivityInfo.minTeamSize = activity->minTeamSize;
+			m_ActivityInfo.minTeams = activity->minTeams;
 		}
 	}
 }
@@ -547,21 +545,21 @@ void ActivityInstance::RewardParticipant(Entity* participant) {
 
 	// First, get the activity data
 	auto* activityRewardsTable = CDClientManager::GetTable<CDActivityRewardsTable>();
-	std::vector<CDActivityRewards> activityRewards = activityRewardsTable->Query([this](CDActivityRewards entry) { return (entry.objectTemplate == m_ActivityInfo.ActivityID); });
+	const auto activityRewards = activityRewardsTable->GetByObjectTemplate(m_ActivityInfo.ActivityID);
 
 	if (!activityRewards.empty()) {
 		uint32_t minCoins = 0;
 		uint32_t maxCoins = 0;
 
 		auto* currencyTableTable = CDClientManager::GetTable<CDCurrencyTableTable>();
-		std::vector<CDCurrencyTable> currencyTable = currencyTableTable->Query([=](CDCurrencyTable entry) { return (entry.currencyIndex == activityRewards[0].CurrencyIndex && entry.npcminlevel == 1); });
+		const auto currencyTable = currencyTableTable->GetByCurrencyIndex(activityRewards[0]->CurrencyIndex, 1);
 
 		if (!currencyTable.empty()) {
-			minCoins = currencyTable[0].minvalue;
-			maxCoins = currencyTable[0].maxvalue;
+			minCoins = currencyTable[0]->minvalue;
+			maxCoins = currencyTable[0]->maxvalue;
 		}
 
-		Loot::DropLoot(participant, m_Parent, activityRewards[0].LootMatrixIndex, minCoins, maxCoins);
+		Loot::DropLoot(participant, m_Parent, activityRewards[0]->LootMatrixIndex, minCoins, maxCoins);
 	}
 }
 
@@ -13,6 +13,10 @@
 #include "CDSkillBehaviorTable.h"
 #include "TeamManager.h"
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+
 std::unordered_map<int32_t, std::vector<BuffParameter>> BuffComponent::m_Cache{};
 
 namespace {
@@ -24,12 +28,36 @@ namespace {
 		{ "speed", "SPEED_" },
 		{ "loot", "LOOT_" }
 	};
+
+	constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+	struct BuffTimer {
+		double at;
+		uint64_t sequence;
+		BuffComponent* component;
+
+		bool operator>(const BuffTimer& other) const { return at > other.at; }
+	};
+
+	// Seconds of buff time that have passed in this zone.
+	double BuffClock = 0.0;
+
+	uint64_t TimerSequence = 0;
+	std::priority_queue<BuffTimer, std::vector<BuffTimer>, std::greater<BuffTimer>> BuffTimers;
+
+	// The sequence of the latest timer of each queued component.  Timers that were replaced by a sooner one,
+	// or whose component has since been destroyed, are skipped when they come up.
+	std::unordered_map<BuffComponent*, uint64_t> QueuedComponents;
+
+	std::vector<BuffTimer> DueTimers;
 }
 
 BuffComponent::BuffComponent(Entity* parent) : Component(parent) {
+	m_NextTimer = NEVER;
 }
 
 BuffComponent::~BuffComponent() {
+	QueuedComponents.erase(this);
 }
 
 void BuffComponent::Serialize(RakNet::BitStream& outBitStream, bool bIsInitialUpdate) {
@@ -38,10 +66,10 @@ void BuffComponent::Serialize(RakNet::BitStream& outBitStream, bool bIsInitialUp
 	if (!m_Buffs.empty()) {
 		outBitStream.Write<uint32_t>(m_Buffs.size());
 
-		for (const auto& [id, buff] : m_Buffs) {
-			outBitStream.Write<uint32_t>(id);
+		for (const auto& buff : m_Buffs) {
+			outBitStream.Write<uint32_t>(buff.id);
 			outBitStream.Write(buff.time != 0.0f);
-			if (buff.time != 0.0f) outBitStream.Write<uint32_t>(buff.time * 1000.0f);
+			if (buff.time != 0.0f) outBitStream.Write<uint32_t>(GetRemainingTime(buff) * 1000.0f);
 			outBitStream.Write(buff.cancelOnDeath);
 			outBitStream.Write(buff.cancelOnZone);
 			outBitStream.Write(buff.cancelOnDamaged);
@@ -69,44 +97,129 @@ void BuffComponent::Serialize(RakNet::BitStream& outBitStream, bool bIsInitialUp
 }
 
 void BuffComponent::Update(float deltaTime) {
-	/**
-	 * Loop through all buffs and apply deltaTime to ther time.
-	 * If they have expired, remove the buff and break.
-	 */
+	RemovePendingBuffs();
+}
+
+void BuffComponent::Sleep() {
+	if (m_SleptAt < 0.0) m_SleptAt = BuffClock;
+}
+
+void BuffComponent::Wake() {
+	if (m_SleptAt < 0.0) return;
+
+	const auto slept = BuffClock - m_SleptAt;
 	for (auto& buff : m_Buffs) {
+		buff.expiresAt += slept;
+		buff.nextTickAt += slept;
+	}
+
+	m_SleptAt = -1.0;
+	ScheduleNextTimer();
+}
+
+void BuffComponent::UpdateTimers(float deltaTime) {
+	BuffClock += deltaTime;
+
+	// Take every due timer off the queue first, so buffs that are still due after being handled wait for the next frame.
+	while (!BuffTimers.empty() && BuffTimers.top().at <= BuffClock) {
+		DueTimers.push_back(BuffTimers.top());
+		BuffTimers.pop();
+	}
+
+	for (const auto& timer : DueTimers) {
+		const auto queued = QueuedComponents.find(timer.component);
+		if (queued == QueuedComponents.end() || queued->second != timer.sequence) continue;
+
+		QueuedComponents.erase(queued);
+		timer.component->m_NextTimer = NEVER;
+		timer.component->OnTimer();
+	}
+
+	DueTimers.clear();
+}
+
+void BuffComponent::OnTimer() {
+	// Buffs wait on sleeping entities until they wake up.  The parent may have fallen asleep since its last update.
+	if (m_Parent->IsSleeping()) {
+		Sleep();
+		return;
+	}
+
+	// A tick runs a behavior, which can add or remove buffs on this entity, so look the buffs up again by id.
+	std::vector<int32_t> dueBuffs;
+	for (const auto& buff : m_Buffs) {
+		const auto tickDue = buff.tick != 0.0f && buff.stacks > 0 && buff.nextTickAt <= BuffClock;
+		const auto expired = buff.time != 0.0f && buff.expiresAt <= BuffClock;
+		if (tickDue || expired) dueBuffs.push_back(buff.id);
+	}
+
+	for (const auto id : dueBuffs) {
+		auto* buff = FindBuff(id);
+		if (buff == nullptr || m_BuffsToRemove.contains(id)) continue;
+
 		// For damage buffs
-		if (buff.second.tick != 0.0f && buff.second.stacks > 0) {
-			buff.second.tickTime -= deltaTime;
+		if (buff->tick != 0.0f && buff->stacks > 0 && buff->nextTickAt <= BuffClock) {
+			buff->nextTickAt = BuffClock + buff->tick;
+			buff->stacks--;
 
-			if (buff.second.tickTime <= 0.0f) {
-				buff.second.tickTime = buff.second.tick;
-				buff.second.stacks--;
+			SkillComponent::HandleUnmanaged(buff->behaviorID, m_Parent->GetObjectID(), buff->source);
 
-				SkillComponent::HandleUnmanaged(buff.second.behaviorID, m_Parent->GetObjectID(), buff.second.source);
-			}
+			buff = FindBuff(id);
+			if (buff == nullptr) continue;
 		}
 
-		// These are indefinate buffs, don't update them.
-		if (buff.second.time == 0.0f) {
-			continue;
+		if (buff->time != 0.0f && buff->expiresAt <= BuffClock) {
+			RemoveBuff(id);
 		}
+	}
+
+	RemovePendingBuffs();
+	ScheduleNextTimer();
+}
 
-		buff.second.time -= deltaTime;
+void BuffComponent::ScheduleNextTimer() {
+	if (m_SleptAt >= 0.0) return;
 
-		if (buff.second.time <= 0.0f) {
-			RemoveBuff(buff.first);
-		}
+	auto next = NEVER;
+	for (const auto& buff : m_Buffs) {
+		if (m_BuffsToRemove.contains(buff.id)) continue;
+
+		if (buff.tick != 0.0f && buff.stacks > 0) next = std::min(next, buff.nextTickAt);
+		// These are indefinate buffs, they never run out.
+		if (buff.time != 0.0f) next = std::min(next, buff.expiresAt);
 	}
 
+	if (next >= m_NextTimer) return;
+
+	m_NextTimer = next;
+	const auto sequence = ++TimerSequence;
+	QueuedComponents.insert_or_assign(this, sequence);
+	BuffTimers.push({ next, sequence, this });
+}
+
+void BuffComponent::RemovePendingBuffs() {
 	if (m_BuffsToRemove.empty()) return;
 
-	for (const auto& buff : m_BuffsToRemove) {
-		m_Buffs.erase(buff);
-	}
+	std::erase_if(m_Buffs, [this](const Buff& buff) { return m_BuffsToRemove.contains(buff.id); });
 
 	m_BuffsToRemove.clear();
 }
 
+Buff* BuffComponent::FindBuff(int32_t id) {
+	const auto it = std::lower_bound(m_Buffs.begin(), m_Buffs.end(), id, [](const Buff& buff, int32_t id) { return buff.id < id; });
+	return it != m_Buffs.end() && it->id == id ? &*it : nullptr;
+}
+
+double BuffComponent::GetTime() const {
+	return m_SleptAt >= 0.0 ? m_SleptAt : BuffClock;
+}
+
+float BuffComponent::GetRemainingTime(const Buff& buff) const {
+	if (buff.time == 0.0f) return 0.0f;
+
+	return static_cast<float>(std::max(buff.expiresAt - GetTime(), 0.0));
+}
+
 const std::string& GetFxName(const std::string& buffname) {
 	const auto& toReturn = BuffFx[buffname];
 	if (toReturn.empty()) {
@@ -141,9 +254,11 @@ void BuffComponent::ApplyBuff(const int32_t id, const float duration, const LWOO
 	bool cancelOnDamaged, bool cancelOnDeath, bool cancelOnLogout, bool cancelOnRemoveBuff,
 	bool cancelOnUi, bool cancelOnUnequip, bool cancelOnZone, bool applyOnTeammates) {
 	// Prevent buffs from stacking.
-	if (HasBuff(id)) {
-		m_Buffs[id].refCount++;
-		m_Buffs[id].time = duration;
+	if (auto* existing = FindBuff(id)) {
+		existing->refCount++;
+		existing->time = duration;
+		existing->expiresAt = GetTime() + duration;
+		ScheduleNextTimer();
 		return;
 	}
 
@@ -179,7 +294,6 @@ void BuffComponent::ApplyBuff(const int32_t id, const float duration, const LWOO
 	buff.id = id;
 	buff.time = duration;
 	buff.tick = tick;
-	buff.tickTime = tick;
 	buff.stacks = stacks;
 	buff.source = source;
 	buff.behaviorID = behaviorID;
@@ -191,8 +305,11 @@ void BuffComponent::ApplyBuff(const int32_t id, const float duration, const LWOO
 	buff.cancelOnUnequip = cancelOnUnequip;
 	buff.cancelOnZone = cancelOnZone;
 	buff.refCount = 1;
+	buff.expiresAt = GetTime() + duration;
+	buff.nextTickAt = GetTime() + tick;
 
-	m_Buffs.emplace(id, buff);
+	m_Buffs.insert(std::upper_bound(m_Buffs.begin(), m_Buffs.end(), id, [](int32_t id, const Buff& buff) { return id < buff.id; }), buff);
+	ScheduleNextTimer();
 
 	auto* parent = GetParent();
 	if (!cancelOnDeath) return;
@@ -206,15 +323,15 @@ void BuffComponent::ApplyBuff(const int32_t id, const float duration, const LWOO
 }
 
 void BuffComponent::RemoveBuff(int32_t id, bool fromUnEquip, bool removeImmunity, bool ignoreRefCount) {
-	const auto& iter = m_Buffs.find(id);
+	auto* buff = FindBuff(id);
 
 	// If the buff is already scheduled to be removed, don't do it again
-	if (iter == m_Buffs.end() || m_BuffsToRemove.contains(id)) return;
+	if (buff == nullptr || m_BuffsToRemove.contains(id)) return;
 
-	if (!ignoreRefCount && !iter->second.cancelOnRemoveBuff) {
-		iter->second.refCount--;
-		LOG_DEBUG("refCount for buff %i is now %i", id, iter->second.refCount);
-		if (iter->second.refCount > 0) {
+	if (!ignoreRefCount && !buff->cancelOnRemoveBuff) {
+		buff->refCount--;
+		LOG_DEBUG("refCount for buff %i is now %i", id, buff->refCount);
+		if (buff->refCount > 0) {
 			return;
 		}
 	}
@@ -227,7 +344,7 @@ void BuffComponent::RemoveBuff(int32_t id, bool fromUnEquip, bool removeImmunity
 }
 
 bool BuffComponent::HasBuff(int32_t id) {
-	return m_Buffs.find(id) != m_Buffs.end();
+	return FindBuff(id) != nullptr;
 }
 
 void BuffComponent::ApplyBuffEffect(int32_t id) {
@@ -306,7 +423,7 @@ void BuffComponent::RemoveBuffEffect(int32_t id) {
 
 void BuffComponent::RemoveAllBuffs() {
 	for (const auto& buff : m_Buffs) {
-		RemoveBuffEffect(buff.first);
+		RemoveBuffEffect(buff.id);
 	}
 
 	m_Buffs.clear();
@@ -318,7 +435,7 @@ void BuffComponent::Reset() {
 
 void BuffComponent::ReApplyBuffs() {
 	for (const auto& buff : m_Buffs) {
-		ApplyBuffEffect(buff.first);
+		ApplyBuffEffect(buff.id);
 	}
 }
 
@@ -368,7 +485,8 @@ void BuffComponent::LoadFromXml(const tinyxml2::XMLDocument& doc) {
 		buff.source = sr;
 		buff.behaviorID = b;
 		buff.refCount = refCount;
-		buff.tickTime = tt;
+		buff.expiresAt = GetTime() + t;
+		buff.nextTickAt = GetTime() + tt;
 
 		buff.cancelOnDamaged = cancelOnDamaged;
 		buff.cancelOnDeath = cancelOnDeath;
@@ -380,10 +498,14 @@ void BuffComponent::LoadFromXml(const tinyxml2::XMLDocument& doc) {
 		buff.applyOnTeammates = applyOnTeammates;
 
 
-		m_Buffs.emplace(id, buff);
+		if (!HasBuff(id)) {
+			m_Buffs.insert(std::upper_bound(m_Buffs.begin(), m_Buffs.end(), id, [](int32_t id, const Buff& buff) { return id < buff.id; }), buff);
+		}
 
 		buffEntry = buffEntry->NextSiblingElement("b");
 	}
+
+	ScheduleNextTimer();
 }
 
 void BuffComponent::UpdateXml(tinyxml2::XMLDocument& doc) {
@@ -401,15 +523,15 @@ void BuffComponent::UpdateXml(tinyxml2::XMLDocument& doc) {
 		buffElement->DeleteChildren();
 	}
 
-	for (const auto& [id, buff] : m_Buffs) {
+	for (const auto& buff : m_Buffs) {
 		auto* buffEntry = doc.NewElement("b");
 		// TODO: change this if to if (buff.cancelOnZone || buff.cancelOnLogout) handling at some point.  No current way to differentiate between zone transfer and logout.
 		if (buff.cancelOnZone) continue;
 
-		buffEntry->SetAttribute("id", id);
-		buffEntry->SetAttribute("t", buff.time);
+		buffEntry->SetAttribute("id", buff.id);
+		buffEntry->SetAttribute("t", GetRemainingTime(buff));
 		buffEntry->SetAttribute("tk", buff.tick);
-		buffEntry->SetAttribute("tt", buff.tickTime);
+		buffEntry->SetAttribute("tt", static_cast<float>(std::max(buff.nextTickAt - GetTime(), 0.0)));
 		buffEntry->SetAttribute("s", buff.stacks);
 		buffEntry->SetAttribute("sr", buff.source);
 		buffEntry->SetAttribute("b", buff.behaviorID);
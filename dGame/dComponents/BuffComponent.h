@@ -6,6 +6,7 @@
 #include <vector>
 #include <unordered_map>
 #include <map>
+#include <set>
 #include "Component.h"
 #include "eReplicaComponentType.h"
 
@@ -27,9 +28,8 @@ struct BuffParameter {
  */
 struct Buff {
 	int32_t id = 0;
-	float time = 0;
+	float time = 0; // Duration in seconds, or 0 for a buff that lasts until it is removed
 	float tick = 0;
-	float tickTime = 0;
 	int32_t stacks = 0;
 	LWOOBJID source = 0;
 	int32_t behaviorID = 0;
@@ -42,6 +42,10 @@ struct Buff {
 	bool cancelOnZone = false;
 	bool applyOnTeammates = false;
 	uint32_t refCount = 0;
+
+	// When the buff runs out and when it next ticks, on the buff clock of the zone
+	double expiresAt = 0;
+	double nextTickAt = 0;
 };
 
 /**
@@ -65,6 +69,24 @@ public:
 
 	void Update(float deltaTime) override;
 
+	/**
+	 * Stops the buff clock for this component, called every frame the parent is asleep
+	 */
+	void Sleep();
+
+	/**
+	 * Pushes the buffs back by however long the parent slept, called every frame the parent is awake
+	 */
+	void Wake();
+
+	/**
+	 * Advances the buff clock of the zone, ticking and expiring the buffs that are due.
+	 * Buffs are not counted down every frame; each component with a buff that can tick or run out has one entry
+	 * in a zone wide timer queue, for whichever of its buffs is due first.
+	 * @param deltaTime the time since the last call in seconds
+	 */
+	static void UpdateTimers(float deltaTime);
+
 	/**
 	 * Applies a buff to the parent entity
 	 * @param id the id of the buff to apply
@@ -135,10 +157,45 @@ public:
 	const std::vector<BuffParameter>& GetBuffParameters(int32_t buffId);
 
 private:
+	Buff* FindBuff(int32_t id);
+
+	/**
+	 * Returns the buff clock as this component sees it, which stands still while the parent is asleep
+	 */
+	double GetTime() const;
+
+	/**
+	 * Returns how long a buff has left in seconds, or 0 for a buff that lasts until it is removed
+	 */
+	float GetRemainingTime(const Buff& buff) const;
+
+	/**
+	 * Ticks and expires the buffs that are due, called by UpdateTimers
+	 */
+	void OnTimer();
+
+	/**
+	 * Puts this component in the timer queue for its next due buff, if that is sooner than it is queued for
+	 */
+	void ScheduleNextTimer();
+
+	void RemovePendingBuffs();
+
+	/**
+	 * The currently active buffs, sorted by id.  Entities only ever have a handful of buffs.
+	 */
+	std::vector<Buff> m_Buffs;
+
+	/**
+	 * When this component is next due in the timer queue, or infinity if it is not queued
+	 */
+	double m_NextTimer;
+
 	/**
-	 * The currently active buffs
+	 * When the parent fell asleep, or a negative value while it is awake.  Buffs do not tick or run out
+	 * on sleeping entities, so their timers are pushed back by however long the parent slept.
 	 */
-	std::map<int32_t, Buff> m_Buffs;
+	double m_SleptAt = -1.0;
 
 	// Buffs to remove at the end of the update frame.
 	std::set<int32_t> m_BuffsToRemove;
@@ -96,21 +96,20 @@ void DestroyableComponent::Reinitialize(LOT templateID) {
 	if (buffComponentID > 0) componentID = buffComponentID;
 
 	CDDestructibleComponentTable* destCompTable = CDClientManager::GetTable<CDDestructibleComponentTable>();
-	std::vector<CDDestructibleComponent> destCompData = destCompTable->Query([=](CDDestructibleComponent entry) { return (entry.id == componentID); });
 
 	if (componentID > 0) {
-		std::vector<CDDestructibleComponent> destCompData = destCompTable->Query([=](CDDestructibleComponent entry) { return (entry.id == componentID); });
+		const auto* destCompData = destCompTable->GetByID(componentID);
 
-		if (destCompData.size() > 0) {
-			SetHealth(destCompData[0].life);
-			SetImagination(destCompData[0].imagination);
-			SetArmor(destCompData[0].armor);
+		if (destCompData) {
+			SetHealth(destCompData->life);
+			SetImagination(destCompData->imagination);
+			SetArmor(destCompData->armor);
 
-			SetMaxHealth(destCompData[0].life);
-			SetMaxImagination(destCompData[0].imagination);
-			SetMaxArmor(destCompData[0].armor);
+			SetMaxHealth(destCompData->life);
+			SetMaxImagination(destCompData->imagination);
+			SetMaxArmor(destCompData->armor);
 
-			SetIsSmashable(destCompData[0].isSmashable);
+			SetIsSmashable(destCompData->isSmashable);
 		}
 	} else {
 		SetHealth(1);
@@ -64,20 +64,20 @@ InventoryComponent::InventoryComponent(Entity* parent) : Component(parent) {
 	const auto componentId = compRegistryTable->GetByIDAndType(lot, eReplicaComponentType::INVENTORY);
 
 	auto* inventoryComponentTable = CDClientManager::GetTable<CDInventoryComponentTable>();
-	auto items = inventoryComponentTable->Query([=](const CDInventoryComponent entry) { return entry.id == componentId; });
+	const auto items = inventoryComponentTable->GetByID(componentId);
 
 	auto slot = 0u;
 
-	for (const auto& item : items) {
-		if (!item.equip || !Inventory::IsValidItem(item.itemid)) {
+	for (const auto* item : items) {
+		if (!item->equip || !Inventory::IsValidItem(item->itemid)) {
 			continue;
 		}
 
 		const LWOOBJID id = ObjectIDManager::GenerateObjectID();
 
-		const auto& info = Inventory::FindItemComponent(item.itemid);
+		const auto& info = Inventory::FindItemComponent(item->itemid);
 
-		UpdateSlot(info.equipLocation, { id, static_cast<LOT>(item.itemid), item.count, slot++ });
+		UpdateSlot(info.equipLocation, { id, static_cast<LOT>(item->itemid), item->count, slot++ });
 
 		// Equip this items proxies.
 		auto subItems = info.subItems;
@@ -94,7 +94,7 @@ InventoryComponent::InventoryComponent(Entity* parent) : Component(parent) {
 				const LWOOBJID proxyId = ObjectIDManager::GenerateObjectID();
 
 				// Use item.count since we equip item.count number of the item this is a requested proxy of
-				UpdateSlot(proxyInfo.equipLocation, { proxyId, proxyLOT, item.count, slot++ });
+				UpdateSlot(proxyInfo.equipLocation, { proxyId, proxyLOT, item->count, slot++ });
 			}
 		}
 	}
@@ -378,6 +378,13 @@ void InventoryComponent::MoveItemToInventory(Item* item, const eInventoryType in
 }
 
 void InventoryComponent::MoveStack(Item* item, const eInventoryType inventory, const uint32_t slot) {
+	// The slot comes from the client
+	auto* const target = inventory != INVALID ? GetInventory(inventory) : item->GetInventory();
+	if (slot >= target->GetSize()) {
+		LOG("Can't move item %llu to slot %u of inventory %i with %u slots", item->GetId(), slot, target->GetType(), target->GetSize());
+		return;
+	}
+
 	if (inventory != INVALID && item->GetInventory()->GetType() != inventory) {
 		auto* newInventory = GetInventory(inventory);
 
@@ -1324,13 +1331,9 @@ bool InventoryComponent::IsTransferInventory(eInventoryType type) {
 uint32_t InventoryComponent::FindSkill(const LOT lot) {
 	auto* table = CDClientManager::GetTable<CDObjectSkillsTable>();
 
-	const auto results = table->Query([=](const CDObjectSkills& entry) {
-		return entry.objectTemplate == static_cast<unsigned int>(lot);
-		});
-
-	for (const auto& result : results) {
-		if (result.castOnType == 0) {
-			return result.skillID;
+	for (const auto* result : table->GetByObjectTemplate(lot)) {
+		if (result->castOnType == 0) {
+			return result->skillID;
 		}
 	}
 
@@ -1343,24 +1346,20 @@ std::vector<uint32_t> InventoryComponent::FindBuffs(Item* item, bool castOnEquip
 	auto* table = CDClientManager::GetTable<CDObjectSkillsTable>();
 	auto* behaviors = CDClientManager::GetTable<CDSkillBehaviorTable>();
 
-	const auto results = table->Query([=](const CDObjectSkills& entry) {
-		return entry.objectTemplate == static_cast<unsigned int>(item->GetLot());
-		});
-
 	auto* missions = static_cast<MissionComponent*>(m_Parent->GetComponent(eReplicaComponentType::MISSION));
 
-	for (const auto& result : results) {
-		if (result.castOnType == 1) {
-			const auto entry = behaviors->GetSkillByID(result.skillID);
+	for (const auto* result : table->GetByObjectTemplate(item->GetLot())) {
+		if (result->castOnType == 1) {
+			const auto entry = behaviors->GetSkillByID(result->skillID);
 
 			if (entry.skillID == 0) {
-				LOG("Failed to find buff behavior for skill (%i)!", result.skillID);
+				LOG("Failed to find buff behavior for skill (%i)!", result->skillID);
 
 				continue;
 			}
 
 			if (missions != nullptr && castOnEquip) {
-				missions->Progress(eMissionTaskType::USE_SKILL, result.skillID);
+				missions->Progress(eMissionTaskType::USE_SKILL, result->skillID);
 			}
 
 			// If item is not a proxy, add its buff to the added buffs.
@@ -3,7 +3,8 @@
  * Copyright 2019
  */
 
-#include <sstream>
+#include <algorithm>
+#include <iterator>
 #include <string>
 
 #include "MissionComponent.h"
@@ -24,6 +25,23 @@
 
 std::unordered_map<AchievementCacheKey, std::vector<uint32_t>> MissionComponent::m_AchievementCache = {};
 
+namespace {
+	// The tasks of a type that target the value, list it in their target group or have exactly this target group.
+	// The index parsed the target groups when the table was loaded.  Both lists are in table order, so merging them
+	// gives every match once and in the same order as a scan of the whole table.
+	std::vector<const CDMissionTasks*> GetMatchingTasks(const eMissionTaskType type, const int32_t value, const std::string& targets) {
+		auto* missionTasksTable = CDClientManager::GetTable<CDMissionTasksTable>();
+
+		const auto byTarget = missionTasksTable->GetByTypeAndTarget(static_cast<uint32_t>(type), value);
+		const auto byTargetGroup = missionTasksTable->GetByTypeAndTargetGroup(static_cast<uint32_t>(type), targets);
+		std::vector<const CDMissionTasks*> tasks;
+		tasks.reserve(byTarget.size() + byTargetGroup.size());
+		std::set_union(byTarget.begin(), byTarget.end(), byTargetGroup.begin(), byTargetGroup.end(), std::back_inserter(tasks));
+
+		return tasks;
+	}
+};
+
 //! Initializer
 MissionComponent::MissionComponent(Entity* parent) : Component(parent) {
 	m_LastUsedMissionOrderUID = Game::zoneManager->GetUniqueMissionIdStartingValue();
@@ -36,6 +54,7 @@ MissionComponent::~MissionComponent() {
 	}
 
 	this->m_Missions.clear();
+	this->m_ActiveMissionsByTaskType.clear();
 }
 
 
@@ -98,7 +117,7 @@ void MissionComponent::AcceptMission(const uint32_t missionId, const bool skipCh
 
 	mission->Accept();
 
-	this->m_Missions.insert_or_assign(missionId, mission);
+	AddMission(missionId, mission);
 
 	if (missionId == 1728) {
 		//Needs to send a mail
@@ -139,6 +158,8 @@ void MissionComponent::RemoveMission(uint32_t missionId) {
 		return;
 	}
 
+	UnindexMission(mission);
+
 	delete mission;
 
 	m_Missions.erase(missionId);
@@ -150,14 +171,69 @@ void MissionComponent::Progress(eMissionTaskType type, int32_t value, LWOOBJID a
 		acceptedAchievements = LookForAchievements(type, value, true, associate, targets, count);
 	}
 
-	for (const auto& [id, mission] : m_Missions) {
-		if (!mission || std::find(acceptedAchievements.begin(), acceptedAchievements.end(), mission->GetMissionId()) != acceptedAchievements.end()) continue;
+	m_ProgressDepth++;
+
+	const auto activeMissions = m_ActiveMissionsByTaskType.find(type);
+	if (activeMissions != m_ActiveMissionsByTaskType.end()) {
+		// Progressing a mission can accept or complete others, which adds to or punches holes in this list, so it is walked by index.
+		auto& missions = activeMissions->second;
+		for (size_t i = 0; i < missions.size(); i++) {
+			auto* mission = missions[i];
+			if (!mission || std::find(acceptedAchievements.begin(), acceptedAchievements.end(), mission->GetMissionId()) != acceptedAchievements.end()) continue;
+
+			if (mission->IsAchievement() && ignoreAchievements) continue;
+
+			if (mission->IsComplete()) continue;
+
+			mission->Progress(type, value, associate, targets, count);
+		}
+	}
+
+	if (--m_ProgressDepth == 0 && m_ActiveMissionsHaveHoles) {
+		for (auto& [taskType, missions] : m_ActiveMissionsByTaskType) std::erase(missions, nullptr);
+		m_ActiveMissionsHaveHoles = false;
+	}
+}
+
+void MissionComponent::OnMissionStateChanged(Mission* mission) {
+	// Missions are only indexed once they belong to this component.
+	if (!mission || GetMission(mission->GetMissionId()) != mission) return;
+
+	if (mission->IsComplete()) {
+		UnindexMission(mission);
+	} else {
+		IndexMission(mission);
+	}
+}
 
-		if (mission->IsAchievement() && ignoreAchievements) continue;
+void MissionComponent::AddMission(const uint32_t missionId, Mission* mission) {
+	auto* existing = GetMission(missionId);
+	if (existing && existing != mission) UnindexMission(existing);
+
+	m_Missions.insert_or_assign(missionId, mission);
+	IndexMission(mission);
+}
+
+void MissionComponent::IndexMission(Mission* mission) {
+	if (!mission || mission->IsComplete()) return;
+
+	for (const auto* task : mission->GetTasks()) {
+		auto& missions = m_ActiveMissionsByTaskType[task->GetType()];
+		if (std::find(missions.begin(), missions.end(), mission) == missions.end()) missions.push_back(mission);
+	}
+}
 
-		if (mission->IsComplete()) continue;
+void MissionComponent::UnindexMission(Mission* mission) {
+	for (auto& [taskType, missions] : m_ActiveMissionsByTaskType) {
+		const auto it = std::find(missions.begin(), missions.end(), mission);
+		if (it == missions.end()) continue;
 
-		mission->Progress(type, value, associate, targets, count);
+		if (m_ProgressDepth > 0) {
+			*it = nullptr;
+			m_ActiveMissionsHaveHoles = true;
+		} else {
+			missions.erase(it);
+		}
 	}
 }
 
@@ -268,15 +344,14 @@ void MissionComponent::ForceProgressValue(uint32_t missionId, uint32_t taskType,
 bool MissionComponent::GetMissionInfo(uint32_t missionId, CDMissions& result) {
 	auto* missionsTable = CDClientManager::GetTable<CDMissionsTable>();
 
-	const auto missions = missionsTable->Query([=](const CDMissions& entry) {
-		return entry.id == static_cast<int>(missionId);
-		});
+	bool found = false;
+	const auto& mission = missionsTable->GetByMissionID(missionId, found);
 
-	if (missions.empty()) {
+	if (!found) {
 		return false;
 	}
 
-	result = missions[0];
+	result = mission;
 
 	return true;
 }
@@ -304,7 +379,7 @@ const std::vector<uint32_t> MissionComponent::LookForAchievements(eMissionTaskTy
 		// Instantiate new mission and accept it
 		auto* instance = new Mission(this, missionID);
 
-		m_Missions.insert_or_assign(missionID, instance);
+		AddMission(missionID, instance);
 
 		if (instance->IsMission()) instance->SetUniqueMissionOrderID(++m_LastUsedMissionOrderUID);
 
@@ -320,62 +395,29 @@ const std::vector<uint32_t> MissionComponent::LookForAchievements(eMissionTaskTy
 
 	return acceptedAchievements;
 #else
-	auto* missionTasksTable = CDClientManager::GetTable<CDMissionTasksTable>();
 	auto* missionsTable = CDClientManager::GetTable<CDMissionsTable>();
 
-	auto tasks = missionTasksTable->Query([=](const CDMissionTasks& entry) {
-		return entry.taskType == static_cast<unsigned>(type);
-		});
-
 	std::vector<uint32_t> acceptedAchievements;
 
-	for (const auto& task : tasks) {
-		if (GetMission(task.id) != nullptr) {
+	for (const auto* task : GetMatchingTasks(type, value, targets)) {
+		if (GetMission(task->id) != nullptr) {
 			continue;
 		}
 
-		const auto missionEntries = missionsTable->Query([=](const CDMissions& entry) {
-			return entry.id == static_cast<int>(task.id) && !entry.isMission;
-			});
+		bool foundMission = false;
+		const auto& mission = missionsTable->GetByMissionID(task->id, foundMission);
 
-		if (missionEntries.empty()) {
+		if (!foundMission) {
 			continue;
 		}
 
-		const auto mission = missionEntries[0];
-
 		if (mission.isMission || !MissionPrerequisites::CanAccept(mission.id, m_Missions)) {
 			continue;
 		}
 
-		if (task.target != value && task.targetGroup != targets) {
-			auto stream = std::istringstream(task.targetGroup);
-			std::string token;
-
-			auto found = false;
-
-			while (std::getline(stream, token, ',')) {
-				try {
-					const auto target = std::stoul(token);
-
-					found = target == value;
-
-					if (found) {
-						break;
-					}
-				} catch (std::invalid_argument& exception) {
-					LOG("Failed to parse target (%s): (%s)!", token.c_str(), exception.what());
-				}
-			}
-
-			if (!found) {
-				continue;
-			}
-		}
-
 		auto* instance = new Mission(this, mission.id);
 
-		m_Missions.insert_or_assign(mission.id, instance);
+		AddMission(mission.id, instance);
 
 		if (instance->IsMission()) instance->SetUniqueMissionOrderID(++m_LastUsedMissionOrderUID);
 
@@ -407,48 +449,21 @@ const std::vector<uint32_t>& MissionComponent::QueryAchievements(eMissionTaskTyp
 	}
 
 	// Find relevent tables
-	auto* missionTasksTable = CDClientManager::GetTable<CDMissionTasksTable>();
 	auto* missionsTable = CDClientManager::GetTable<CDMissionsTable>();
 
 	std::vector<uint32_t> result;
 
-	// Loop through all mission tasks, might cache this task check later
-	for (const auto& task : missionTasksTable->GetEntries()) {
-		if (task.taskType != static_cast<uint32_t>(type)) {
-			continue;
-		}
-
+	for (const auto* task : GetMatchingTasks(type, value, targets)) {
 		// Seek the assosicated mission
 		auto foundMission = false;
 
-		const auto& mission = missionsTable->GetByMissionID(task.id, foundMission);
+		const auto& mission = missionsTable->GetByMissionID(task->id, foundMission);
 
 		if (!foundMission || mission.isMission) {
 			continue;
 		}
 
-		// Compare the easy values
-		if (task.target == value || task.targetGroup == targets) {
-			result.push_back(mission.id);
-
-			continue;
-		}
-
-		// Compare the target group, array separated by ','
-		auto stream = std::istringstream(task.targetGroup);
-		std::string token;
-
-		while (std::getline(stream, token, ',')) {
-			try {
-				if (std::stoi(token) == value) {
-					result.push_back(mission.id);
-
-					continue;
-				}
-			} catch (std::invalid_argument& exception) {
-				// Ignored
-			}
-		}
+		result.push_back(mission.id);
 	}
 	// Insert into cache
 	m_AchievementCache.insert_or_assign(toFind, result);
@@ -525,7 +540,7 @@ void MissionComponent::LoadFromXml(const tinyxml2::XMLDocument& doc) {
 
 		doneM = doneM->NextSiblingElement();
 
-		m_Missions.insert_or_assign(missionId, mission);
+		AddMission(missionId, mission);
 	}
 
 	auto* currentM = cur->FirstChildElement();
@@ -547,7 +562,7 @@ void MissionComponent::LoadFromXml(const tinyxml2::XMLDocument& doc) {
 
 		currentM = currentM->NextSiblingElement();
 
-		m_Missions.insert_or_assign(missionId, mission);
+		AddMission(missionId, mission);
 	}
 }
 
@@ -623,6 +638,7 @@ void MissionComponent::ResetMission(const int32_t missionId) {
 
 	if (!mission) return;
 
+	UnindexMission(mission);
 	m_Missions.erase(missionId);
 	GameMessages::SendResetMissions(m_Parent, m_Parent->GetSystemAddress(), missionId);
 }
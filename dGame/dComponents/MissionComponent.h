@@ -170,12 +170,44 @@ public:
 	bool HasMission(uint32_t missionId);
 
 	void ResetMission(const int32_t missionId);
+
+	/**
+	 * Adds or removes a mission from the progress index after its state changed, so Progress only visits
+	 * missions that are not complete.
+	 * @param mission the mission whose state changed
+	 */
+	void OnMissionStateChanged(Mission* mission);
 private:
+	/**
+	 * Adds a mission to this entity, replacing any mission with the same ID
+	 * @param missionId the ID of the mission
+	 * @param mission the mission to add
+	 */
+	void AddMission(uint32_t missionId, Mission* mission);
+
+	void IndexMission(Mission* mission);
+
+	void UnindexMission(Mission* mission);
+
 	/**
 	 * All the missions owned by this entity, mapped by mission ID
 	 */
 	std::unordered_map<uint32_t, Mission*> m_Missions;
 
+	/**
+	 * The missions that are not complete, mapped by the types of their tasks, so progressing a task type
+	 * only visits the missions that have a task of that type
+	 */
+	std::unordered_map<eMissionTaskType, std::vector<Mission*>> m_ActiveMissionsByTaskType;
+
+	/**
+	 * How many calls to Progress are running.  Missions unindexed while one runs leave a nullptr behind,
+	 * which is cleaned up once the outermost call returns.
+	 */
+	uint32_t m_ProgressDepth = 0;
+
+	bool m_ActiveMissionsHaveHoles = false;
+
 	/**
 	 * All the collectibles currently collected by the entity
 	 */
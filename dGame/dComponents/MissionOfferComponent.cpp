@@ -50,12 +50,8 @@ MissionOfferComponent::MissionOfferComponent(Entity* parent, const LOT parentLot
 		// Now lookup the missions in the MissionNPCComponent table
 		auto* missionNpcComponentTable = CDClientManager::GetTable<CDMissionNPCComponentTable>();
 
-		auto missions = missionNpcComponentTable->Query([=](const CDMissionNPCComponent& entry) {
-			return entry.id == static_cast<unsigned>(componentId);
-			});
-
-		for (auto& mission : missions) {
-			this->offeredMissions.emplace_back(mission.missionID, mission.offersMission, mission.acceptsMission);
+		for (const auto* mission : missionNpcComponentTable->GetByID(componentId)) {
+			this->offeredMissions.emplace_back(mission->missionID, mission->offersMission, mission->acceptsMission);
 		}
 	}
 }
@@ -58,6 +58,12 @@ MovementAIComponent::MovementAIComponent(Entity* parent, MovementAIInfo info) :
 	if (!m_Parent->GetComponent<BaseCombatAIComponent>()) SetPath(m_Parent->GetVarAsString(u"attached_path"));
 }
 
+MovementAIComponent::~MovementAIComponent() {
+	// The navmesh is gone already when the zone shuts down
+	auto* navMesh = dpWorld::GetNavMesh();
+	if (m_CrowdAgent >= 0 && navMesh) navMesh->RemoveCrowdAgent(m_CrowdAgent);
+}
+
 void MovementAIComponent::SetPath(const std::string pathName) {
 	m_Path = Game::zoneManager->GetZone()->GetPath(pathName);
 	if (!pathName.empty()) LOG("WARNING: %s path %s", m_Path ? "Found" : "Failed to find", pathName.c_str());
@@ -73,6 +79,7 @@ void MovementAIComponent::Pause() {
 	SetPosition(ApproximateLocation());
 	m_SavedVelocity = GetVelocity();
 	SetVelocity(NiPoint3Constant::ZERO);
+	if (m_CrowdAgent >= 0) dpWorld::GetNavMesh()->ResetCrowdAgentTarget(m_CrowdAgent);
 	Game::entityManager->SerializeEntity(m_Parent);
 }
 
@@ -82,6 +89,7 @@ void MovementAIComponent::Resume() {
 	SetVelocity(m_SavedVelocity);
 	m_SavedVelocity = NiPoint3Constant::ZERO;
 	SetRotation(NiQuaternion::LookAt(m_Parent->GetPosition(), m_NextWaypoint));
+	if (m_CrowdAgent >= 0) dpWorld::GetNavMesh()->SetCrowdAgentTarget(m_CrowdAgent, m_Destination, GetCrowdSpeed());
 	Game::entityManager->SerializeEntity(m_Parent);
 }
 
@@ -115,6 +123,14 @@ void MovementAIComponent::Update(const float deltaTime) {
 		}
 	}
 
+	if (m_CrowdAgent >= 0) {
+		UpdateCrowdAgent();
+		return;
+	}
+
+	// Nothing to follow until the path to the destination has been found.
+	if (m_WaitingForPath && m_InterpolatedWaypoints.empty()) return;
+
 	m_TimeTravelled += deltaTime;
 
 	SetPosition(ApproximateLocation());
@@ -152,6 +168,15 @@ void MovementAIComponent::Update(const float deltaTime) {
 			SetRotation(NiQuaternion::LookAt(source, m_NextWaypoint));
 		}
 	} else {
+		// Hold still at the end of the old path until the new one arrives.
+		if (m_WaitingForPath) {
+			if (GetVelocity() != NiPoint3Constant::ZERO) {
+				SetVelocity(NiPoint3Constant::ZERO);
+				Game::entityManager->SerializeEntity(m_Parent);
+			}
+			return;
+		}
+
 		// Check if there are more waypoints in the queue, if so set our next destination to the next waypoint
 		if (m_CurrentPath.empty()) {
 			if (m_Path) {
@@ -235,6 +260,8 @@ bool MovementAIComponent::Warp(const NiPoint3& point) {
 }
 
 void MovementAIComponent::Stop() {
+	LeaveCrowd();
+
 	if (AtFinalWaypoint()) return;
 
 	SetPosition(ApproximateLocation());
@@ -249,6 +276,10 @@ void MovementAIComponent::Stop() {
 	m_InterpolatedWaypoints.clear();
 	while (!m_CurrentPath.empty()) m_CurrentPath.pop();
 
+	// Drop the path we are still waiting on, if any.
+	m_WaitingForPath = false;
+	m_PathRequest++;
+
 	m_PathIndex = 0;
 
 	m_CurrentSpeed = 0;
@@ -350,6 +381,42 @@ void MovementAIComponent::SetVelocity(const NiPoint3& value) {
 void MovementAIComponent::SetDestination(const NiPoint3 destination) {
 	if (m_PullingToPoint) return;
 
+	auto* navMesh = dpWorld::GetNavMesh();
+	if (dpWorld::IsLoaded() && m_BaseCombatAI && navMesh->HasCrowd() && SetCrowdDestination(destination)) return;
+
+	m_Destination = destination;
+
+	if (!dpWorld::IsLoaded()) {
+		SetWaypoints({});
+		return;
+	}
+
+	// An entity that is already moving keeps following its old path until the new one arrives.
+	const auto location = ApproximateLocation();
+	if (AtFinalWaypoint()) {
+		m_SourcePosition = location;
+		m_InterpolatedWaypoints.clear();
+		m_PathIndex = 0;
+		m_TimeTravelled = 0;
+		m_TimeToTravel = 0;
+		m_AtFinalWaypoint = false;
+	}
+
+	// A newer destination or a stop replaces the request.
+	m_WaitingForPath = true;
+	const auto request = ++m_PathRequest;
+	navMesh->GetPathAsync(location, destination, m_Info.wanderSpeed, [objectID = m_Parent->GetObjectID(), request](std::vector<NiPoint3> path) {
+		auto* entity = Game::entityManager->GetEntity(objectID);
+		auto* movementAI = entity ? entity->GetComponent<MovementAIComponent>() : nullptr;
+		if (movementAI && movementAI->m_WaitingForPath && movementAI->m_PathRequest == request) {
+			movementAI->SetWaypoints(std::move(path));
+		}
+	});
+}
+
+void MovementAIComponent::SetWaypoints(std::vector<NiPoint3> path) {
+	m_WaitingForPath = false;
+
 	const auto location = ApproximateLocation();
 
 	if (!AtFinalWaypoint()) {
@@ -358,39 +425,33 @@ void MovementAIComponent::SetDestination(const NiPoint3 destination) {
 
 	m_SourcePosition = location;
 
-	std::vector<NiPoint3> computedPath;
-	if (dpWorld::IsLoaded()) {
-		computedPath = dpWorld::GetNavMesh()->GetPath(m_Parent->GetPosition(), destination, m_Info.wanderSpeed);
-	}
-
 	// Somehow failed
-	if (computedPath.empty()) {
+	if (path.empty()) {
 		// Than take 10 points between the current position and the destination and make that the path
 
 		auto start = location;
 
-		auto delta = destination - start;
+		auto delta = m_Destination - start;
 
 		auto step = delta / 10.0f;
 
 		for (int i = 0; i < 10; i++) {
 			start += step;
 
-			computedPath.push_back(start);
-		}
-	}
-
-	m_InterpolatedWaypoints.clear();
+			if (dpWorld::IsLoaded()) {
+				start.y = dpWorld::GetNavMesh()->GetHeightAtPoint(start);
+			}
 
-	// Simply path
-	for (auto& point : computedPath) {
-		if (dpWorld::IsLoaded()) {
-			point.y = dpWorld::GetNavMesh()->GetHeightAtPoint(point);
+			path.push_back(start);
 		}
-
-		m_InterpolatedWaypoints.push_back(point);
+	} else {
+		// The path starts where the entity was when it asked for it, which may be a little behind by now.
+		path.front() = location;
 	}
 
+	// Paths from the navmesh are already on the ground
+	m_InterpolatedWaypoints = std::move(path);
+
 	m_PathIndex = 0;
 
 	m_TimeTravelled = 0;
@@ -399,7 +460,69 @@ void MovementAIComponent::SetDestination(const NiPoint3 destination) {
 	m_AtFinalWaypoint = false;
 }
 
+bool MovementAIComponent::SetCrowdDestination(const NiPoint3& destination) {
+	auto* navMesh = dpWorld::GetNavMesh();
+
+	if (m_CrowdAgent < 0) {
+		const auto location = ApproximateLocation();
+		m_CrowdAgent = navMesh->AddCrowdAgent(location, GetCrowdSpeed());
+
+		// Follow a path of our own if the crowd is full
+		if (m_CrowdAgent < 0) return false;
+
+		m_InterpolatedWaypoints.clear();
+		m_WaitingForPath = false;
+		m_PathRequest++;
+		m_SourcePosition = location;
+		m_PathIndex = 0;
+		m_TimeTravelled = 0;
+		m_TimeToTravel = 0;
+		m_AtFinalWaypoint = false;
+	} else if (Vector3::DistanceSquared(destination, m_Destination) < 1.0f) {
+		// Chasers ask every tick, but the crowd only needs to plan again once the target has really moved
+		return true;
+	}
+
+	m_Destination = destination;
+	navMesh->SetCrowdAgentTarget(m_CrowdAgent, destination, GetCrowdSpeed());
+	return true;
+}
+
+void MovementAIComponent::UpdateCrowdAgent() {
+	auto* navMesh = dpWorld::GetNavMesh();
+	const auto position = navMesh->GetCrowdAgentPosition(m_CrowdAgent);
+	const auto velocity = navMesh->GetCrowdAgentVelocity(m_CrowdAgent);
+
+	m_SourcePosition = position;
+	SetPosition(position);
+
+	if (Vector3::DistanceSquared(position, m_Destination) < std::pow(std::max(m_HaltDistance, 1.0f), 2)) {
+		Stop();
+		return;
+	}
+
+	// The client keeps moving the entity along its velocity, so only send it again once it has changed noticeably.
+	if (Vector3::DistanceSquared(velocity, GetVelocity()) < 1.0f) return;
+
+	SetVelocity(velocity);
+	if (velocity.SquaredLength() > 0.01f) SetRotation(NiQuaternion::LookAt(position, position + velocity));
+	Game::entityManager->SerializeEntity(m_Parent);
+}
+
+float MovementAIComponent::GetCrowdSpeed() const {
+	return m_MaxSpeed * m_BaseSpeed;
+}
+
+void MovementAIComponent::LeaveCrowd() {
+	if (m_CrowdAgent < 0) return;
+
+	dpWorld::GetNavMesh()->RemoveCrowdAgent(m_CrowdAgent);
+	m_CrowdAgent = -1;
+}
+
 NiPoint3 MovementAIComponent::GetDestination() const {
+	if (m_WaitingForPath || m_CrowdAgent >= 0) return m_Destination;
+
 	return m_InterpolatedWaypoints.empty() ? m_Parent->GetPosition() : m_InterpolatedWaypoints.back();
 }
 
@@ -63,6 +63,7 @@ public:
 	static constexpr eReplicaComponentType ComponentType = eReplicaComponentType::MOVEMENT_AI;
 
 	MovementAIComponent(Entity* parentEntity, MovementAIInfo info);
+	~MovementAIComponent() override;
 
 	void SetPath(const std::string pathName);
 
@@ -223,6 +224,35 @@ private:
 	 */
 	void SetRotation(const NiQuaternion& value);
 
+	/**
+	 * Replaces the path to the destination with a newly found one
+	 * @param path the path, already on the navmesh, or empty if none was found
+	 */
+	void SetWaypoints(std::vector<NiPoint3> path);
+
+	/**
+	 * Steers towards a destination with the navmesh crowd, joining it if needed
+	 * @param destination the point to move towards
+	 * @return false if the crowd is full
+	 */
+	bool SetCrowdDestination(const NiPoint3& destination);
+
+	/**
+	 * Moves the entity to where the crowd has steered it
+	 */
+	void UpdateCrowdAgent();
+
+	/**
+	 * Returns the speed the crowd may move this entity at
+	 * @return the speed the crowd may move this entity at
+	 */
+	float GetCrowdSpeed() const;
+
+	/**
+	 * Takes the entity out of the navmesh crowd, so the crowd no longer moves it
+	 */
+	void LeaveCrowd();
+
 	/**
 	 * Sets the current velocity of the entityes
 	 * @param value the velocity to set
@@ -316,6 +346,26 @@ private:
 
 	const Path* m_Path = nullptr;
 
+	/**
+	 * The point the entity was last told to move to
+	 */
+	NiPoint3 m_Destination;
+
+	/**
+	 * If the path to the destination is still being found on a navmesh worker
+	 */
+	bool m_WaitingForPath = false;
+
+	/**
+	 * Counts path requests, so that a path found for an old destination is ignored
+	 */
+	uint32_t m_PathRequest = 0;
+
+	/**
+	 * The agent steering this entity in the navmesh crowd, or -1 if it follows a path of its own
+	 */
+	int32_t m_CrowdAgent = -1;
+
 	NiPoint3 m_SourcePosition;
 
 	bool m_Paused;
@@ -1038,15 +1038,19 @@ PetComponent::~PetComponent() {
 }
 
 void PetComponent::SetPetNameForModeration(const std::string& petName) {
-	int approved = 1; //default, in mod
-
-	//Make sure that the name isn't already auto-approved:
-	if (Game::chatFilter->IsSentenceOkay(petName, eGameMasterLevel::CIVILIAN).empty()) {
-		approved = 2; //approved
-	}
+	// The pet may be gone by the time the name is filtered, so only capture what the save needs.
+	Game::chatFilter->IsSentenceOkayAsync(petName, eGameMasterLevel::CIVILIAN, true,
+		[databaseId = m_DatabaseId, petName](std::vector<std::pair<uint8_t, uint8_t>> segments) {
+		int approved = 1; //default, in mod
+
+		//Make sure that the name isn't already auto-approved:
+		if (segments.empty()) {
+			approved = 2; //approved
+		}
 
-	//Save to db:
-	Database::Get()->SetPetNameModerationStatus(m_DatabaseId, IPetNames::Info{ petName, approved });
+		//Save to db:
+		Database::Get()->SetPetNameModerationStatus(databaseId, IPetNames::Info{ petName, approved });
+	});
 }
 
 void PetComponent::LoadPetNameFromModeration() {
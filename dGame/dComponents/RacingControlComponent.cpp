@@ -55,8 +55,8 @@ RacingControlComponent::RacingControlComponent(Entity* parent)
 
 	m_ActivityID = 42;
 	CDActivitiesTable* activitiesTable = CDClientManager::GetTable<CDActivitiesTable>();
-	std::vector<CDActivities> activities = activitiesTable->Query([=](CDActivities entry) {return (entry.instanceMapID == worldID); });
-	for (CDActivities activity : activities) m_ActivityID = activity.ActivityID;
+	const auto activities = activitiesTable->GetByInstanceMapID(worldID);
+	if (!activities.empty()) m_ActivityID = activities.back()->ActivityID;
 }
 
 RacingControlComponent::~RacingControlComponent() {}
@@ -9,6 +9,8 @@
 #include <vector>
 
 #include "BehaviorContext.h"
+#include "BehaviorContextPool.h"
+#include "BehaviorProgram.h"
 #include "BehaviorBranchContext.h"
 #include "Behavior.h"
 #include "CDClientDatabase.h"
@@ -32,7 +34,7 @@ ProjectileSyncEntry::ProjectileSyncEntry() {
 std::unordered_map<uint32_t, uint32_t> SkillComponent::m_skillBehaviorCache = {};
 
 bool SkillComponent::CastPlayerSkill(const uint32_t behaviorId, const uint32_t skillUid, RakNet::BitStream& bitStream, const LWOOBJID target, uint32_t skillID) {
-	auto* context = new BehaviorContext(this->m_Parent->GetObjectID());
+	auto* context = BehaviorContextPool::Acquire(this->m_Parent->GetObjectID());
 
 	context->caster = m_Parent->GetObjectID();
 
@@ -40,11 +42,13 @@ bool SkillComponent::CastPlayerSkill(const uint32_t behaviorId, const uint32_t s
 
 	this->m_managedBehaviors.insert({ skillUid, context });
 
-	auto* behavior = Behavior::CreateBehavior(behaviorId);
-
 	const auto branch = BehaviorBranchContext(target, 0);
 
-	behavior->Handle(context, bitStream, branch);
+	if (BehaviorProgram::IsEnabled()) {
+		BehaviorProgram::Get(behaviorId).Handle(context, bitStream, branch);
+	} else {
+		Behavior::CreateBehavior(behaviorId)->Handle(context, bitStream, branch);
+	}
 
 	context->ExecuteUpdates();
 
@@ -145,13 +149,12 @@ void SkillComponent::Update(const float deltaTime) {
 		for (const auto& pair : this->m_managedBehaviors) pair.second->UpdatePlayerSyncs(deltaTime);
 	}
 
-	std::multimap<uint32_t, BehaviorContext*> keep{};
-
-	for (const auto& pair : this->m_managedBehaviors) {
+	// Finished contexts are erased in place rather than copying the survivors into a new map every frame.
+	std::erase_if(this->m_managedBehaviors, [this, deltaTime](const auto& pair) {
 		auto* context = pair.second;
 
 		if (context == nullptr) {
-			continue;
+			return true;
 		}
 
 		if (context->clientInitalized) {
@@ -173,25 +176,19 @@ void SkillComponent::Update(const float deltaTime) {
 			}
 
 			if (!any) {
-				context->Reset();
+				BehaviorContextPool::Release(context);
 
-				delete context;
-
-				context = nullptr;
-
-				continue;
+				return true;
 			}
 		}
 
-		keep.insert({ pair.first, context });
-	}
-
-	this->m_managedBehaviors = keep;
+		return false;
+	});
 }
 
 void SkillComponent::Reset() {
 	for (const auto& behavior : this->m_managedBehaviors) {
-		delete behavior.second;
+		BehaviorContextPool::Release(behavior.second);
 	}
 
 	this->m_managedProjectiles.clear();
@@ -267,11 +264,13 @@ SkillExecutionResult SkillComponent::CalculateBehavior(
 	const LWOOBJID originatorOverride,
 	const int32_t castType,
 	const NiQuaternion rotationOverride) {
-	RakNet::BitStream bitStream{};
+	BehaviorContextPool::ScratchBitStream bitStream;
 
-	auto* behavior = Behavior::CreateBehavior(behaviorId);
+	const auto originator = originatorOverride != LWOOBJID_EMPTY ? originatorOverride : this->m_Parent->GetObjectID();
 
-	auto* context = new BehaviorContext(originatorOverride != LWOOBJID_EMPTY ? originatorOverride : this->m_Parent->GetObjectID(), true);
+	// Our own casts take the next skill id from this component directly instead of looking ourselves up.
+	auto* context = BehaviorContextPool::Acquire(originator, originator != this->m_Parent->GetObjectID());
+	if (originator == this->m_Parent->GetObjectID()) context->skillUId = GetUniqueSkillId();
 
 	context->caster = m_Parent->GetObjectID();
 
@@ -281,12 +280,16 @@ SkillExecutionResult SkillComponent::CalculateBehavior(
 
 	context->foundTarget = target != LWOOBJID_EMPTY || ignoreTarget || clientInitalized;
 
-	behavior->Calculate(context, bitStream, { target, 0 });
+	if (BehaviorProgram::IsEnabled()) {
+		BehaviorProgram::Get(behaviorId).Calculate(context, *bitStream, { target, 0 });
+	} else {
+		Behavior::CreateBehavior(behaviorId)->Calculate(context, *bitStream, { target, 0 });
+	}
 
 	m_Parent->GetScript()->OnSkillCast(m_Parent, skillId);
 
 	if (!context->foundTarget) {
-		delete context;
+		BehaviorContextPool::Release(context);
 
 		// Invalid attack
 		return { false, 0 };
@@ -315,7 +318,7 @@ SkillExecutionResult SkillComponent::CalculateBehavior(
 		}
 		//start.optionalTargetID = target;
 
-		start.sBitStream.assign(reinterpret_cast<char*>(bitStream.GetData()), bitStream.GetNumberOfBytesUsed());
+		start.sBitStream.assign(reinterpret_cast<char*>(bitStream->GetData()), bitStream->GetNumberOfBytesUsed());
 
 		// Write message
 		RakNet::BitStream message;
@@ -461,26 +464,32 @@ void SkillComponent::SyncProjectileCalculation(const ProjectileSyncEntry& entry)
 }
 
 void SkillComponent::HandleUnmanaged(const uint32_t behaviorId, const LWOOBJID target, LWOOBJID source) {
-	BehaviorContext context{ source };
+	auto* context = BehaviorContextPool::Acquire(source);
 
-	context.unmanaged = true;
-	context.caster = target;
+	context->unmanaged = true;
+	context->caster = target;
 
-	auto* behavior = Behavior::CreateBehavior(behaviorId);
+	BehaviorContextPool::ScratchBitStream bitStream;
 
-	RakNet::BitStream bitStream{};
+	if (BehaviorProgram::IsEnabled()) {
+		BehaviorProgram::Get(behaviorId).Handle(context, *bitStream, { target });
+	} else {
+		Behavior::CreateBehavior(behaviorId)->Handle(context, *bitStream, { target });
+	}
 
-	behavior->Handle(&context, bitStream, { target });
+	BehaviorContextPool::Release(context);
 }
 
 void SkillComponent::HandleUnCast(const uint32_t behaviorId, const LWOOBJID target) {
-	BehaviorContext context{ target };
+	auto* context = BehaviorContextPool::Acquire(target);
 
-	context.caster = target;
+	context->caster = target;
 
 	auto* behavior = Behavior::CreateBehavior(behaviorId);
 
-	behavior->UnCast(&context, { target });
+	behavior->UnCast(context, { target });
+
+	BehaviorContextPool::Release(context);
 }
 
 SkillComponent::SkillComponent(Entity* parent) : Component(parent) {
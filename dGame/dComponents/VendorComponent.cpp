@@ -98,14 +98,13 @@ void VendorComponent::SetupConstants() {
 	int componentID = compRegistryTable->GetByIDAndType(m_Parent->GetLOT(), eReplicaComponentType::VENDOR);
 
 	auto* vendorComponentTable = CDClientManager::GetTable<CDVendorComponentTable>();
-	std::vector<CDVendorComponent> vendorComps = vendorComponentTable->Query([=](CDVendorComponent entry) { return (entry.id == componentID); });
-	if (vendorComps.empty()) return;
-	auto vendorData = vendorComps.at(0);
-	if (vendorData.buyScalar == 0.0) m_BuyScalar = Game::zoneManager->GetWorldConfig()->vendorBuyMultiplier;
-	else m_BuyScalar = vendorData.buyScalar;
-	m_SellScalar = vendorData.sellScalar;
-	m_RefreshTimeSeconds = vendorData.refreshTimeSeconds;
-	m_LootMatrixID = vendorData.LootMatrixIndex;
+	const auto* vendorData = vendorComponentTable->GetByID(componentID);
+	if (!vendorData) return;
+	if (vendorData->buyScalar == 0.0) m_BuyScalar = Game::zoneManager->GetWorldConfig()->vendorBuyMultiplier;
+	else m_BuyScalar = vendorData->buyScalar;
+	m_SellScalar = vendorData->sellScalar;
+	m_RefreshTimeSeconds = vendorData->refreshTimeSeconds;
+	m_LootMatrixID = vendorData->LootMatrixIndex;
 }
 
 bool VendorComponent::SellsItem(const LOT item) const {
@@ -1670,7 +1670,7 @@ void GameMessages::SendActivitySummaryLeaderboardData(const LWOOBJID& objectID,
 	bitStream.Write(MessageType::Game::SEND_ACTIVITY_SUMMARY_LEADERBOARD_DATA);
 
 	leaderboard->Serialize(bitStream);
-	SEND_PACKET;
+	Game::server->Send(bitStream, sysAddr, false, eQosClass::BULK);
 }
 
 void GameMessages::HandleRequestActivitySummaryLeaderboardData(RakNet::BitStream& inStream, Entity* entity, const SystemAddress& sysAddr) {
@@ -2080,8 +2080,8 @@ void GameMessages::SendGetModelsOnProperty(LWOOBJID objectId, std::map<LWOOBJID,
 
 	LOG("Sending property models to (%llu) (%d)", objectId, sysAddr == UNASSIGNED_SYSTEM_ADDRESS);
 
-	if (sysAddr == UNASSIGNED_SYSTEM_ADDRESS) SEND_PACKET_BROADCAST;
-	SEND_PACKET;
+	if (sysAddr == UNASSIGNED_SYSTEM_ADDRESS) Game::server->Send(bitStream, UNASSIGNED_SYSTEM_ADDRESS, true, eQosClass::BULK);
+	Game::server->Send(bitStream, sysAddr, false, eQosClass::BULK);
 }
 
 void GameMessages::SendZonePropertyModelEquipped(LWOOBJID objectId, LWOOBJID playerId, LWOOBJID propertyId, const SystemAddress& sysAddr) {
@@ -3062,8 +3062,8 @@ void GameMessages::SendPropertySelectQuery(LWOOBJID objectId, int32_t navOffset,
 		entry.Serialize(bitStream);
 	}
 
-	if (sysAddr == UNASSIGNED_SYSTEM_ADDRESS) SEND_PACKET_BROADCAST;
-	SEND_PACKET;
+	if (sysAddr == UNASSIGNED_SYSTEM_ADDRESS) Game::server->Send(bitStream, UNASSIGNED_SYSTEM_ADDRESS, true, eQosClass::BULK);
+	Game::server->Send(bitStream, sysAddr, false, eQosClass::BULK);
 }
 
 void GameMessages::SendNotifyObject(LWOOBJID objectId, LWOOBJID objIDSender, std::u16string name, const SystemAddress& sysAddr, int param1, int param2) {
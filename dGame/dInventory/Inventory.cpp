@@ -8,6 +8,9 @@
 
 #include "CDComponentsRegistryTable.h"
 
+#include <algorithm>
+#include <bit>
+
 std::vector<LOT> Inventory::m_GameMasterRestrictedItems = {
 		1727, // GM Only - JetPack
 		2243, // GM Only - Hammer of Doom
@@ -24,6 +27,8 @@ Inventory::Inventory(const eInventoryType type, const uint32_t size, const std::
 	this->free = size;
 	this->component = component;
 
+	occupiedSlots.resize((size + 63) / 64, 0);
+
 	for (auto* item : items) {
 		AddManagedItem(item);
 	}
@@ -41,15 +46,7 @@ std::map<LWOOBJID, Item*>& Inventory::GetItems() {
 	return items;
 }
 
-std::map<uint32_t, Item*> Inventory::GetSlots() const {
-	std::map<uint32_t, Item*> slots;
-
-	for (const auto& pair : items) {
-		auto* item = pair.second;
-
-		slots.insert_or_assign(item->GetSlot(), item);
-	}
-
+const std::map<uint32_t, Item*>& Inventory::GetSlots() const {
 	return slots;
 }
 
@@ -60,12 +57,13 @@ InventoryComponent* Inventory::GetComponent() const {
 uint32_t Inventory::GetLotCount(const LOT lot) const {
 	uint32_t count = 0;
 
-	for (const auto& pair : items) {
-		const auto* item = pair.second;
+	const auto it = itemsByLot.find(lot);
+	if (it == itemsByLot.end()) {
+		return count;
+	}
 
-		if (item->GetLot() == lot) {
-			count += item->GetCount();
-		}
+	for (const auto* item : it->second) {
+		count += item->GetCount();
 	}
 
 	return count;
@@ -74,8 +72,17 @@ uint32_t Inventory::GetLotCount(const LOT lot) const {
 void Inventory::SetSize(const uint32_t value) {
 	free += static_cast<int32_t>(value) - static_cast<int32_t>(size);
 
+	const auto oldSize = size;
 	size = value;
 
+	// The bitmap only covers slots inside the inventory, so mark items that were past its old end.
+	occupiedSlots.resize((size + 63) / 64, 0);
+	if (size > oldSize) {
+		for (auto it = slots.lower_bound(oldSize); it != slots.end() && it->first < size; ++it) {
+			SetSlotOccupied(it->first, true);
+		}
+	}
+
 	GameMessages::SendSetInventorySize(component->GetParent(), type, static_cast<int>(size));
 }
 
@@ -103,15 +110,20 @@ int32_t Inventory::FindEmptySlot() {
 		return -1;
 	}
 
-	const auto slots = GetSlots();
-
-	for (auto i = 0u; i < size; ++i) {
-		if (slots.find(i) == slots.end()) {
-			return i;
+	for (uint32_t word = 0; word < occupiedSlots.size(); ++word) {
+		if (occupiedSlots[word] == UINT64_MAX) {
+			continue;
 		}
+
+		const auto slot = word * 64 + std::countr_one(occupiedSlots[word]);
+
+		return slot < size ? slot : -1;
 	}
 
-	return -1;
+	// Every slot the bitmap covers is taken, but the ones after it are free
+	const auto slot = static_cast<uint32_t>(occupiedSlots.size() * 64);
+
+	return slot < size ? slot : -1;
 }
 
 int32_t Inventory::GetEmptySlots() {
@@ -119,11 +131,7 @@ int32_t Inventory::GetEmptySlots() {
 }
 
 bool Inventory::IsSlotEmpty(int32_t slot) {
-	const auto slots = GetSlots();
-
-	const auto& index = slots.find(slot);
-
-	return index == slots.end();
+	return slots.find(slot) == slots.end();
 }
 
 Item* Inventory::FindItemById(const LWOOBJID id) const {
@@ -139,13 +147,12 @@ Item* Inventory::FindItemById(const LWOOBJID id) const {
 Item* Inventory::FindItemByLot(const LOT lot, const bool ignoreEquipped, const bool ignoreBound) const {
 	Item* smallest = nullptr;
 
-	for (const auto& pair : items) {
-		auto* item = pair.second;
-
-		if (item->GetLot() != lot) {
-			continue;
-		}
+	const auto it = itemsByLot.find(lot);
+	if (it == itemsByLot.end()) {
+		return smallest;
+	}
 
+	for (auto* item : it->second) {
 		if (ignoreEquipped && item->IsEquipped()) {
 			continue;
 		}
@@ -160,7 +167,8 @@ Item* Inventory::FindItemByLot(const LOT lot, const bool ignoreEquipped, const b
 			continue;
 		}
 
-		if (smallest->GetCount() > item->GetCount()) {
+		// Ties go to the lowest object ID, which is the order the items map keeps
+		if (smallest->GetCount() > item->GetCount() || (smallest->GetCount() == item->GetCount() && smallest->GetId() > item->GetId())) {
 			smallest = item;
 		}
 	}
@@ -169,8 +177,6 @@ Item* Inventory::FindItemByLot(const LOT lot, const bool ignoreEquipped, const b
 }
 
 Item* Inventory::FindItemBySlot(const uint32_t slot) const {
-	const auto slots = GetSlots();
-
 	const auto index = slots.find(slot);
 
 	if (index == slots.end()) {
@@ -199,8 +205,6 @@ void Inventory::AddManagedItem(Item* item) {
 		return;
 	}
 
-	const auto slots = GetSlots();
-
 	const auto slot = item->GetSlot();
 
 	if (slots.find(slot) != slots.end()) {
@@ -210,6 +214,7 @@ void Inventory::AddManagedItem(Item* item) {
 	}
 
 	items.insert_or_assign(id, item);
+	IndexItem(item);
 
 	free--;
 }
@@ -224,10 +229,72 @@ void Inventory::RemoveManagedItem(Item* item) {
 	}
 
 	items.erase(id);
+	UnindexItem(item);
 
 	free++;
 }
 
+void Inventory::OnSlotChanged(Item* item, const uint32_t oldSlot, Item* displaced) {
+	// An item that was turned away by AddManagedItem still swaps slots with the item it lands on
+	const auto managed = items.find(item->GetId()) != items.end();
+
+	if (managed) {
+		slots.insert_or_assign(item->GetSlot(), item);
+		SetSlotOccupied(item->GetSlot(), true);
+	} else if (displaced != nullptr) {
+		slots.erase(item->GetSlot());
+		SetSlotOccupied(item->GetSlot(), false);
+	}
+
+	if (displaced != nullptr) {
+		slots.insert_or_assign(oldSlot, displaced);
+		SetSlotOccupied(oldSlot, true);
+	} else if (managed) {
+		slots.erase(oldSlot);
+		SetSlotOccupied(oldSlot, false);
+	}
+}
+
+void Inventory::IndexItem(Item* item) {
+	slots.insert_or_assign(item->GetSlot(), item);
+	SetSlotOccupied(item->GetSlot(), true);
+
+	itemsByLot[item->GetLot()].push_back(item);
+}
+
+void Inventory::UnindexItem(Item* item) {
+	const auto slot = slots.find(item->GetSlot());
+	if (slot != slots.end() && slot->second == item) {
+		slots.erase(slot);
+		SetSlotOccupied(item->GetSlot(), false);
+	}
+
+	const auto lotItems = itemsByLot.find(item->GetLot());
+	if (lotItems != itemsByLot.end()) {
+		std::erase(lotItems->second, item);
+
+		if (lotItems->second.empty()) {
+			itemsByLot.erase(lotItems);
+		}
+	}
+}
+
+void Inventory::SetSlotOccupied(const uint32_t slot, const bool occupied) {
+	// Slots past the end of the inventory are never handed out, so the bitmap does not grow for them
+	if (slot >= size) {
+		return;
+	}
+
+	const auto word = slot / 64;
+	const auto bit = uint64_t{ 1 } << (slot % 64);
+
+	if (occupied) {
+		occupiedSlots[word] |= bit;
+	} else {
+		occupiedSlots[word] &= ~bit;
+	}
+}
+
 eInventoryType Inventory::FindInventoryTypeForLot(const LOT lot) {
 	auto itemComponent = FindItemComponent(lot);
 
@@ -316,4 +383,7 @@ Inventory::~Inventory() {
 	}
 
 	items.clear();
+	slots.clear();
+	itemsByLot.clear();
+	occupiedSlots.clear();
 }
@@ -4,6 +4,7 @@
 #define INVENTORY_H
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "CDItemComponentTable.h"
@@ -44,7 +45,7 @@ public:
 	 * Returns all the items that are currently in this inventory, mapped by slot
 	 * @return all the items that are currently in this inventory, mapped by slot
 	 */
-	std::map<uint32_t, Item*> GetSlots() const;
+	const std::map<uint32_t, Item*>& GetSlots() const;
 
 	/**
 	 * Returns the inventory component that this inventory is part of
@@ -126,6 +127,14 @@ public:
 	 */
 	void RemoveManagedItem(Item* item);
 
+	/**
+	 * Updates the slot index after an item moved slots, called by Item::SetSlot
+	 * @param item the item that moved
+	 * @param oldSlot the slot the item was in
+	 * @param displaced the item that was in the new slot and has been moved to the old one, if any
+	 */
+	void OnSlotChanged(Item* item, uint32_t oldSlot, Item* displaced);
+
 	/**
 	 * Returns the inventory type an item of the specified lot should be placed in
 	 * @param lot the lot to find the inventory type for
@@ -161,6 +170,19 @@ public:
 	~Inventory();
 
 private:
+	/**
+	 * Adds or removes an item from the slot and LOT indexes
+	 * @param item the item to index
+	 */
+	void IndexItem(Item* item);
+	void UnindexItem(Item* item);
+
+	/**
+	 * Marks a slot as taken or free in the free slot bitmap
+	 * @param slot the slot to mark
+	 * @param occupied whether an item is in the slot
+	 */
+	void SetSlotOccupied(uint32_t slot, bool occupied);
 	/**
 	 * The type of this inventory
 	 */
@@ -181,6 +203,22 @@ private:
 	 */
 	std::map<LWOOBJID, Item*> items;
 
+	/**
+	 * The items stored in this inventory, mapped by slot
+	 */
+	std::map<uint32_t, Item*> slots;
+
+	/**
+	 * The items stored in this inventory, grouped by LOT
+	 */
+	std::unordered_map<LOT, std::vector<Item*>> itemsByLot;
+
+	/**
+	 * One bit per slot, set if the slot is taken, so empty slots can be found without looking at every item.
+	 * Sized to the inventory, so slots at or past its size are not tracked.
+	 */
+	std::vector<uint64_t> occupiedSlots;
+
 	/**
 	 * The inventory component this inventory belongs to
 	 */
@@ -210,15 +210,22 @@ void Item::SetSlot(const uint32_t value) {
 		return;
 	}
 
-	for (const auto& pair : inventory->GetItems()) {
-		auto* item = pair.second;
+	if (value >= inventory->GetSize()) {
+		LOG("Can't move item %llu to slot %u of an inventory with %u slots", id, value, inventory->GetSize());
+		return;
+	}
 
-		if (item->slot == value) {
-			item->slot = slot;
-		}
+	const auto oldSlot = slot;
+
+	auto* displaced = inventory->FindItemBySlot(value);
+
+	if (displaced != nullptr) {
+		displaced->slot = oldSlot;
 	}
 
 	slot = value;
+
+	inventory->OnSlotChanged(this, oldSlot, displaced);
 }
 
 void Item::SetBound(const bool value) {
@@ -270,14 +277,10 @@ bool Item::IsEquipped() const {
 bool Item::Consume() {
 	auto* skillsTable = CDClientManager::GetTable<CDObjectSkillsTable>();
 
-	auto skills = skillsTable->Query([this](const CDObjectSkills entry) {
-		return entry.objectTemplate == static_cast<uint32_t>(lot);
-		});
-
 	auto success = false;
 
-	for (auto& skill : skills) {
-		if (skill.castOnType == 3) // Consumable type
+	for (const auto* skill : skillsTable->GetByObjectTemplate(lot)) {
+		if (skill->castOnType == 3) // Consumable type
 		{
 			success = true;
 		}
@@ -340,7 +343,7 @@ void Item::UseNonEquip(Item* item) {
 			if (packageComponentId == 0) return;
 
 			auto* packCompTable = CDClientManager::GetTable<CDPackageComponentTable>();
-			auto packages = packCompTable->Query([=](const CDPackageComponent entry) {return entry.id == static_cast<uint32_t>(packageComponentId); });
+			const auto packages = packCompTable->GetByID(packageComponentId);
 
 			auto success = !packages.empty();
 			if (success) {
@@ -348,8 +351,8 @@ void Item::UseNonEquip(Item* item) {
 					auto* entityParent = playerInventoryComponent->GetParent();
 					// Roll the loot for all the packages then see if it all fits.  If it fits, give it to the player, otherwise don't.
 					std::unordered_map<LOT, int32_t> rolledLoot{};
-					for (auto& pack : packages) {
-						auto thisPackage = Loot::RollLootMatrix(entityParent, pack.LootMatrixIndex);
+					for (const auto* pack : packages) {
+						auto thisPackage = Loot::RollLootMatrix(entityParent, pack->LootMatrixIndex);
 						for (auto& loot : thisPackage) {
 							// If we already rolled this lot, add it to the existing one, otherwise create a new entry.
 							auto existingLoot = rolledLoot.find(loot.first);
@@ -451,19 +454,13 @@ void Item::DisassembleModel(uint32_t numToDismantle) {
 		return;
 	}
 
-	std::stringstream data;
-	data << file.rdbuf();
-
-	uint32_t fileSize;
-	file.seekg(0, std::ios::end);
-	fileSize = static_cast<uint32_t>(file.tellg());
-	file.seekg(0, std::ios::beg);
+	const auto data = file.GetData();
 
-	if (fileSize == 0) return;
+	if (data.empty()) return;
 
 	tinyxml2::XMLDocument doc;
 
-	if (doc.Parse(data.str().c_str(), data.str().size()) != tinyxml2::XML_SUCCESS) {
+	if (doc.Parse(reinterpret_cast<const char*>(data.data()), data.size()) != tinyxml2::XML_SUCCESS) {
 		return;
 	}
 
@@ -506,14 +503,11 @@ void Item::DisassembleModel(uint32_t numToDismantle) {
 
 	// Second iteration actually distributes the bricks
 	for (const auto& [part, count] : parts) {
-		const auto partLocal = part;
-		const auto brickID = brickIDTable->Query([&](const CDBrickIDTable& entry) {
-			return entry.LEGOBrickID == partLocal;
-			});
+		const auto brickID = brickIDTable->GetByLEGOBrickID(part);
 
 		if (brickID.empty()) continue;
 
-		GetInventory()->GetComponent()->AddItem(brickID[0].NDObjectID, count * numToDismantle, eLootSourceType::DELETION);
+		GetInventory()->GetComponent()->AddItem(brickID[0]->NDObjectID, count * numToDismantle, eLootSourceType::DELETION);
 	}
 }
 
@@ -182,25 +182,23 @@ void Mission::UpdateXml(tinyxml2::XMLElement& element) {
 bool Mission::IsValidMission(const uint32_t missionId) {
 	auto* table = CDClientManager::GetTable<CDMissionsTable>();
 
-	const auto missions = table->Query([=](const CDMissions& entry) {
-		return entry.id == static_cast<int>(missionId);
-		});
+	bool found = false;
+	table->GetByMissionID(missionId, found);
 
-	return !missions.empty();
+	return found;
 }
 
 bool Mission::IsValidMission(const uint32_t missionId, CDMissions& info) {
 	auto* table = CDClientManager::GetTable<CDMissionsTable>();
 
-	const auto missions = table->Query([=](const CDMissions& entry) {
-		return entry.id == static_cast<int>(missionId);
-		});
+	bool found = false;
+	const auto& mission = table->GetByMissionID(missionId, found);
 
-	if (missions.empty()) {
+	if (!found) {
 		return false;
 	}
 
-	info = missions[0];
+	info = mission;
 
 	return true;
 }
@@ -338,19 +336,15 @@ void Mission::Complete(const bool yieldRewards) {
 
 	const auto missionId = GetMissionId();
 
-	const auto missionEmails = missionEmailTable->Query([missionId](const CDMissionEmail& entry) {
-		return entry.missionID == missionId;
-		});
+	for (const auto* email : missionEmailTable->GetByMissionID(missionId)) {
+		const auto missionEmailBase = "MissionEmail_" + std::to_string(email->ID) + "_";
 
-	for (const auto& email : missionEmails) {
-		const auto missionEmailBase = "MissionEmail_" + std::to_string(email.ID) + "_";
-
-		if (email.messageType == 1) {
+		if (email->messageType == 1) {
 			const auto subject = "%[" + missionEmailBase + "subjectText]";
 			const auto body = "%[" + missionEmailBase + "bodyText]";
 			const auto sender = "%[" + missionEmailBase + "senderName]";
 
-			Mail::SendMail(LWOOBJID_EMPTY, sender, GetAssociate(), subject, body, email.attachmentLOT, 1);
+			Mail::SendMail(LWOOBJID_EMPTY, sender, GetAssociate(), subject, body, email->attachmentLOT, 1);
 		}
 	}
 }
@@ -596,6 +590,8 @@ void Mission::Progress(eMissionTaskType type, int32_t value, LWOOBJID associate,
 void Mission::SetMissionState(const eMissionState state, const bool sendingRewards) {
 	this->m_State = state;
 
+	if (m_MissionComponent != nullptr) m_MissionComponent->OnMissionStateChanged(this);
+
 	auto* entity = GetAssociate();
 
 	if (entity == nullptr) {
@@ -162,14 +162,13 @@ bool MissionPrerequisites::CheckPrerequisites(uint32_t missionId, const std::uno
 	}
 
 	auto* missionsTable = CDClientManager::GetTable<CDMissionsTable>();
-	const auto missionEntries = missionsTable->Query([=](const CDMissions& entry) {
-		return entry.id == static_cast<int>(missionId);
-		});
+	bool found = false;
+	const auto& missionEntry = missionsTable->GetByMissionID(missionId, found);
 
-	if (missionEntries.empty())
+	if (!found)
 		return false;
 
-	auto* expression = new PrerequisiteExpression(missionEntries[0].prereqMissionID);
+	auto* expression = new PrerequisiteExpression(missionEntry.prereqMissionID);
 	expressions.insert_or_assign(missionId, expression);
 
 	return expression->Execute(missions);
@@ -23,14 +23,13 @@ const BrickList& BrickDatabase::GetBricks(const LxfmlPath& lxfmlPath) {
 		return emptyCache;
 	}
 
-	std::stringstream data;
-	data << file.rdbuf();
-	if (data.str().empty()) {
+	const auto data = file.GetData();
+	if (data.empty()) {
 		return emptyCache;
 	}
 
 	tinyxml2::XMLDocument doc;
-	if (doc.Parse(data.str().c_str(), data.str().size()) != 0) {
+	if (doc.Parse(reinterpret_cast<const char*>(data.data()), data.size()) != 0) {
 		return emptyCache;
 	}
 
@@ -1,7 +1,7 @@
 #include "Loot.h"
 
 #include <algorithm>
-#include <unordered_set>
+#include <numeric>
 
 #include "CDComponentsRegistryTable.h"
 #include "CDItemComponentTable.h"
@@ -20,176 +20,194 @@
 #include "eReplicaComponentType.h"
 
 namespace {
-	std::unordered_set<uint32_t> CachedMatrices;
-}
+	// One row of a loot matrix, with everything a roll needs worked out ahead of time.
+	// Which item a drop gives depends only on the rarity roll and the loot table, so the chance of every
+	// item is known up front and a drop can be sampled from a Walker alias table in constant time.
+	struct CompiledMatrixEntry {
+		float percent = 0.0f;
+		uint32_t minToDrop = 0;
+		uint32_t maxToDrop = 0;
+
+		// The outcomes of a single drop.  The outcome one past the end of this is dropping nothing.
+		std::vector<CDLootTable> drops;
+
+		// Alias table over the outcomes.
+		std::vector<float> probability;
+		std::vector<uint32_t> alias;
+
+		// Returns the item a single drop gives, or nullptr for nothing.
+		const CDLootTable* Sample() const {
+			if (probability.empty()) return nullptr;
+
+			const auto column = GeneralUtils::GenerateRandomNumber<uint32_t>(0, probability.size() - 1);
+			const auto outcome = GeneralUtils::GenerateRandomNumber<float>(0, 1) < probability[column] ? column : alias[column];
+			return outcome < drops.size() ? &drops[outcome] : nullptr;
+		}
+	};
+
+	std::unordered_map<uint32_t, std::vector<CompiledMatrixEntry>> CompiledMatrices;
+
+	// The items a drop picks between once the rarity roll has settled on maxRarity.
+	// A loot table without an item of that rarity falls back to the first lower rarity it has.
+	std::vector<uint32_t> GetPossibleDrops(const std::vector<uint32_t>& rarities, uint32_t maxRarity) {
+		std::vector<uint32_t> possibleDrops;
+		bool rarityFound = false;
+		for (uint32_t i = 0; i < rarities.size(); i++) {
+			if (rarities[i] == maxRarity) {
+				possibleDrops.push_back(i);
+				rarityFound = true;
+			} else if (rarities[i] < maxRarity && !rarityFound) {
+				possibleDrops.push_back(i);
+				maxRarity = rarities[i];
+			}
+		}
+		return possibleDrops;
+	}
 
-void Loot::CacheMatrix(uint32_t matrixIndex) {
-	if (CachedMatrices.find(matrixIndex) != CachedMatrices.end()) {
-		return;
+	// Builds an alias table with Vose's method.
+	void BuildAliasTable(const std::vector<double>& weights, std::vector<float>& probability, std::vector<uint32_t>& alias) {
+		const auto count = weights.size();
+		const auto total = std::accumulate(weights.begin(), weights.end(), 0.0);
+		probability.assign(count, 1.0f);
+		alias.resize(count);
+		std::iota(alias.begin(), alias.end(), 0);
+		if (total <= 0.0) return;
+
+		std::vector<double> scaled(count);
+		std::vector<uint32_t> small;
+		std::vector<uint32_t> large;
+		for (uint32_t i = 0; i < count; i++) {
+			scaled[i] = weights[i] * count / total;
+			(scaled[i] < 1.0 ? small : large).push_back(i);
+		}
+
+		while (!small.empty() && !large.empty()) {
+			const auto less = small.back();
+			const auto more = large.back();
+			small.pop_back();
+			probability[less] = static_cast<float>(scaled[less]);
+			alias[less] = more;
+			scaled[more] -= 1.0 - scaled[less];
+			if (scaled[more] < 1.0) {
+				large.pop_back();
+				small.push_back(more);
+			}
+		}
+		// Whatever is left is 1 give or take rounding.
 	}
-	CachedMatrices.insert(matrixIndex);
-	CDComponentsRegistryTable* componentsRegistryTable = CDClientManager::GetTable<CDComponentsRegistryTable>();
-	CDItemComponentTable* itemComponentTable = CDClientManager::GetTable<CDItemComponentTable>();
-	CDLootMatrixTable* lootMatrixTable = CDClientManager::GetTable<CDLootMatrixTable>();
-	CDLootTableTable* lootTableTable = CDClientManager::GetTable<CDLootTableTable>();
-	CDRarityTableTable* rarityTableTable = CDClientManager::GetTable<CDRarityTableTable>();
-
-	const auto& matrix = lootMatrixTable->GetMatrix(matrixIndex);
-
-	for (const auto& entry : matrix) {
-		const auto& lootTable = lootTableTable->GetTable(entry.LootTableIndex);
-		const auto& rarityTable = rarityTableTable->GetRarityTable(entry.RarityTableIndex);
+
+	CompiledMatrixEntry CompileMatrixEntry(const CDLootMatrix& entry) {
+		auto* componentsRegistryTable = CDClientManager::GetTable<CDComponentsRegistryTable>();
+		auto* itemComponentTable = CDClientManager::GetTable<CDItemComponentTable>();
+		const auto& lootTable = CDClientManager::GetTable<CDLootTableTable>()->GetTable(entry.LootTableIndex);
+		const auto& rarityTable = CDClientManager::GetTable<CDRarityTableTable>()->GetRarityTable(entry.RarityTableIndex);
+
+		CompiledMatrixEntry compiled;
+		compiled.percent = entry.percent;
+		compiled.minToDrop = entry.minToDrop;
+		compiled.maxToDrop = entry.maxToDrop;
+		compiled.drops = lootTable;
+
+		std::vector<uint32_t> rarities;
+		rarities.reserve(lootTable.size());
 		for (const auto& loot : lootTable) {
 			uint32_t itemComponentId = componentsRegistryTable->GetByIDAndType(loot.itemid, eReplicaComponentType::ITEM);
-			uint32_t rarity = itemComponentTable->GetItemComponentByID(itemComponentId).rarity;
+			rarities.push_back(itemComponentTable->GetItemComponentByID(itemComponentId).rarity);
+		}
+
+		// The rarity table is sorted by randmax, highest first, and a roll takes the rarity of the lowest
+		// randmax it is under.  A roll above every randmax keeps a max rarity of 1.
+		std::vector<double> weights(lootTable.size() + 1, 0.0);
+		const auto addTier = [&](const double chance, const uint32_t maxRarity) {
+			if (chance <= 0.0) return;
+
+			const auto possibleDrops = GetPossibleDrops(rarities, maxRarity);
+			if (possibleDrops.empty()) weights.back() += chance;
+			for (const auto drop : possibleDrops) weights[drop] += chance / possibleDrops.size();
+		};
+
+		const auto clamp = [](const float randmax) { return std::clamp<double>(randmax, 0.0, 1.0); };
+		addTier(1.0 - (rarityTable.empty() ? 0.0 : clamp(rarityTable.front().randmax)), 1);
+		for (size_t i = 0; i < rarityTable.size(); i++) {
+			const auto below = i + 1 < rarityTable.size() ? clamp(rarityTable[i + 1].randmax) : 0.0;
+			addTier(clamp(rarityTable[i].randmax) - below, rarityTable[i].rarity);
 		}
+
+		// Leave out the nothing outcome when it cannot happen, which is almost always.
+		if (weights.back() <= 0.0) weights.pop_back();
+		BuildAliasTable(weights, compiled.probability, compiled.alias);
+		return compiled;
 	}
+
+	const std::vector<CompiledMatrixEntry>& GetCompiledMatrix(uint32_t matrixIndex) {
+		const auto it = CompiledMatrices.find(matrixIndex);
+		if (it != CompiledMatrices.end()) return it->second;
+
+		std::vector<CompiledMatrixEntry> compiled;
+		for (const auto& entry : CDClientManager::GetTable<CDLootMatrixTable>()->GetMatrix(matrixIndex)) {
+			compiled.push_back(CompileMatrixEntry(entry));
+		}
+		return CompiledMatrices.emplace(matrixIndex, std::move(compiled)).first->second;
+	}
+
+	// Rolls every row of a matrix, calling onDrop with each item that drops.
+	template<typename OnDrop>
+	void RollMatrix(uint32_t matrixIndex, OnDrop onDrop) {
+		for (const auto& entry : GetCompiledMatrix(matrixIndex)) {
+			if (GeneralUtils::GenerateRandomNumber<float>(0, 1) >= entry.percent) continue;
+
+			uint32_t dropCount = GeneralUtils::GenerateRandomNumber<uint32_t>(entry.minToDrop, entry.maxToDrop);
+			for (uint32_t i = 0; i < dropCount; ++i) {
+				const auto* drop = entry.Sample();
+				if (drop) onDrop(*drop);
+			}
+		}
+	}
+};
+
+void Loot::CacheMatrix(uint32_t matrixIndex) {
+	GetCompiledMatrix(matrixIndex);
 }
 
 std::unordered_map<LOT, int32_t> Loot::RollLootMatrix(Entity* player, uint32_t matrixIndex) {
-	CDComponentsRegistryTable* componentsRegistryTable = CDClientManager::GetTable<CDComponentsRegistryTable>();
-	CDItemComponentTable* itemComponentTable = CDClientManager::GetTable<CDItemComponentTable>();
-	CDLootMatrixTable* lootMatrixTable = CDClientManager::GetTable<CDLootMatrixTable>();
-	CDLootTableTable* lootTableTable = CDClientManager::GetTable<CDLootTableTable>();
-	CDRarityTableTable* rarityTableTable = CDClientManager::GetTable<CDRarityTableTable>();
 	auto* missionComponent = player->GetComponent<MissionComponent>();
 
 	std::unordered_map<LOT, int32_t> drops;
 
 	if (missionComponent == nullptr) return drops;
 
-	const auto& matrix = lootMatrixTable->GetMatrix(matrixIndex);
+	RollMatrix(matrixIndex, [&](const CDLootTable& drop) {
+		// filter out uneeded mission items
+		if (drop.MissionDrop && !missionComponent->RequiresItem(drop.itemid))
+			return;
+
+		LOT itemID = drop.itemid;
+		// convert faction token proxy
+		if (itemID == 13763) {
+			if (missionComponent->GetMissionState(545) == eMissionState::COMPLETE)
+				itemID = 8318; // "Assembly Token"
+			else if (missionComponent->GetMissionState(556) == eMissionState::COMPLETE)
+				itemID = 8321; // "Venture League Token"
+			else if (missionComponent->GetMissionState(567) == eMissionState::COMPLETE)
+				itemID = 8319; // "Sentinels Token"
+			else if (missionComponent->GetMissionState(578) == eMissionState::COMPLETE)
+				itemID = 8320; // "Paradox Token"
+		}
 
-	for (const auto& entry : matrix) {
-		if (GeneralUtils::GenerateRandomNumber<float>(0, 1) < entry.percent) { // GetTable
-			const auto& lootTable = lootTableTable->GetTable(entry.LootTableIndex);
-			const auto& rarityTable = rarityTableTable->GetRarityTable(entry.RarityTableIndex);
+		if (itemID == 13763) {
+			return;
+		} // check if we aren't in faction
 
-			uint32_t dropCount = GeneralUtils::GenerateRandomNumber<uint32_t>(entry.minToDrop, entry.maxToDrop);
-			for (uint32_t i = 0; i < dropCount; ++i) {
-				uint32_t maxRarity = 1;
-
-				float rarityRoll = GeneralUtils::GenerateRandomNumber<float>(0, 1);
-
-				for (const auto& rarity : rarityTable) {
-					if (rarity.randmax >= rarityRoll) {
-						maxRarity = rarity.rarity;
-					} else {
-						break;
-					}
-				}
-
-				bool rarityFound = false;
-				std::vector<CDLootTable> possibleDrops;
-
-				for (const auto& loot : lootTable) {
-					uint32_t itemComponentId = componentsRegistryTable->GetByIDAndType(loot.itemid, eReplicaComponentType::ITEM);
-					uint32_t rarity = itemComponentTable->GetItemComponentByID(itemComponentId).rarity;
-
-					if (rarity == maxRarity) {
-						possibleDrops.push_back(loot);
-						rarityFound = true;
-					} else if (rarity < maxRarity && !rarityFound) {
-						possibleDrops.push_back(loot);
-						maxRarity = rarity;
-					}
-				}
-
-				if (possibleDrops.size() > 0) {
-					const auto& drop = possibleDrops[GeneralUtils::GenerateRandomNumber<uint32_t>(0, possibleDrops.size() - 1)];
-
-					// filter out uneeded mission items
-					if (drop.MissionDrop && !missionComponent->RequiresItem(drop.itemid))
-						continue;
-
-					LOT itemID = drop.itemid;
-					// convert faction token proxy
-					if (itemID == 13763) {
-						if (missionComponent->GetMissionState(545) == eMissionState::COMPLETE)
-							itemID = 8318; // "Assembly Token"
-						else if (missionComponent->GetMissionState(556) == eMissionState::COMPLETE)
-							itemID = 8321; // "Venture League Token"
-						else if (missionComponent->GetMissionState(567) == eMissionState::COMPLETE)
-							itemID = 8319; // "Sentinels Token"
-						else if (missionComponent->GetMissionState(578) == eMissionState::COMPLETE)
-							itemID = 8320; // "Paradox Token"
-					}
-
-					if (itemID == 13763) {
-						continue;
-					} // check if we aren't in faction
-
-					// drops[itemID]++; this should work?
-					if (drops.find(itemID) == drops.end()) {
-						drops.insert({ itemID, 1 });
-					} else {
-						++drops[itemID];
-					}
-				}
-			}
-		}
-	}
+		++drops[itemID];
+	});
 
 	return drops;
 }
 
 std::unordered_map<LOT, int32_t> Loot::RollLootMatrix(uint32_t matrixIndex) {
-	CDComponentsRegistryTable* componentsRegistryTable = CDClientManager::GetTable<CDComponentsRegistryTable>();
-	CDItemComponentTable* itemComponentTable = CDClientManager::GetTable<CDItemComponentTable>();
-	CDLootMatrixTable* lootMatrixTable = CDClientManager::GetTable<CDLootMatrixTable>();
-	CDLootTableTable* lootTableTable = CDClientManager::GetTable<CDLootTableTable>();
-	CDRarityTableTable* rarityTableTable = CDClientManager::GetTable<CDRarityTableTable>();
 	std::unordered_map<LOT, int32_t> drops;
 
-	const auto& matrix = lootMatrixTable->GetMatrix(matrixIndex);
-
-	for (const auto& entry : matrix) {
-		if (GeneralUtils::GenerateRandomNumber<float>(0, 1) < entry.percent) {
-			const auto& lootTable = lootTableTable->GetTable(entry.LootTableIndex);
-			const auto& rarityTable = rarityTableTable->GetRarityTable(entry.RarityTableIndex);
-
-			uint32_t dropCount = GeneralUtils::GenerateRandomNumber<uint32_t>(entry.minToDrop, entry.maxToDrop);
-			for (uint32_t i = 0; i < dropCount; ++i) {
-				uint32_t maxRarity = 1;
-
-				float rarityRoll = GeneralUtils::GenerateRandomNumber<float>(0, 1);
-
-				for (const auto& rarity : rarityTable) {
-					if (rarity.randmax >= rarityRoll) {
-						maxRarity = rarity.rarity;
-					} else {
-						break;
-					}
-				}
-
-				bool rarityFound = false;
-				std::vector<CDLootTable> possibleDrops;
-
-				for (const auto& loot : lootTable) {
-					uint32_t itemComponentId = componentsRegistryTable->GetByIDAndType(loot.itemid, eReplicaComponentType::ITEM);
-					uint32_t rarity = itemComponentTable->GetItemComponentByID(itemComponentId).rarity;
-
-					if (rarity == maxRarity) {
-						possibleDrops.push_back(loot);
-						rarityFound = true;
-					} else if (rarity < maxRarity && !rarityFound) {
-						possibleDrops.push_back(loot);
-						maxRarity = rarity;
-					}
-				}
-
-				if (possibleDrops.size() > 0) {
-					const auto& drop = possibleDrops[GeneralUtils::GenerateRandomNumber<uint32_t>(0, possibleDrops.size() - 1)];
-
-					if (drops.find(drop.itemid) == drops.end()) {
-						drops.insert({ drop.itemid, 1 });
-					} else {
-						++drops[drop.itemid];
-					}
-				}
-			}
-		}
-	}
+	RollMatrix(matrixIndex, [&drops](const CDLootTable& drop) { ++drops[drop.itemid]; });
 
 	return drops;
 }
@@ -217,12 +235,10 @@ void Loot::GiveLoot(Entity* player, std::unordered_map<LOT, int32_t>& result, eL
 
 void Loot::GiveActivityLoot(Entity* player, Entity* source, uint32_t activityID, int32_t rating) {
 	CDActivityRewardsTable* activityRewardsTable = CDClientManager::GetTable<CDActivityRewardsTable>();
-	std::vector<CDActivityRewards> activityRewards = activityRewardsTable->Query([activityID](CDActivityRewards entry) { return (entry.objectTemplate == activityID); });
-
 	const CDActivityRewards* selectedReward = nullptr;
-	for (const auto& activityReward : activityRewards) {
-		if (activityReward.activityRating <= rating && (selectedReward == nullptr || activityReward.activityRating > selectedReward->activityRating)) {
-			selectedReward = &activityReward;
+	for (const auto* activityReward : activityRewardsTable->GetByObjectTemplate(activityID)) {
+		if (activityReward->activityRating <= rating && (selectedReward == nullptr || activityReward->activityRating > selectedReward->activityRating)) {
+			selectedReward = activityReward;
 		}
 	}
 
@@ -233,11 +249,11 @@ void Loot::GiveActivityLoot(Entity* player, Entity* source, uint32_t activityID,
 	uint32_t maxCoins = 0;
 
 	CDCurrencyTableTable* currencyTableTable = CDClientManager::GetTable<CDCurrencyTableTable>();
-	std::vector<CDCurrencyTable> currencyTable = currencyTableTable->Query([selectedReward](CDCurrencyTable entry) { return (entry.currencyIndex == selectedReward->CurrencyIndex && entry.npcminlevel == 1); });
+	const auto currencyTable = currencyTableTable->GetByCurrencyIndex(selectedReward->CurrencyIndex, 1);
 
-	if (currencyTable.size() > 0) {
-		minCoins = currencyTable[0].minvalue;
-		maxCoins = currencyTable[0].maxvalue;
+	if (!currencyTable.empty()) {
+		minCoins = currencyTable[0]->minvalue;
+		maxCoins = currencyTable[0]->maxvalue;
 	}
 
 	GiveLoot(player, selectedReward->LootMatrixIndex, eLootSourceType::ACTIVITY);
@@ -287,12 +303,10 @@ void Loot::DropLoot(Entity* player, Entity* killedObject, std::unordered_map<LOT
 
 void Loot::DropActivityLoot(Entity* player, Entity* source, uint32_t activityID, int32_t rating) {
 	CDActivityRewardsTable* activityRewardsTable = CDClientManager::GetTable<CDActivityRewardsTable>();
-	std::vector<CDActivityRewards> activityRewards = activityRewardsTable->Query([activityID](CDActivityRewards entry) { return (entry.objectTemplate == activityID); });
-
 	const CDActivityRewards* selectedReward = nullptr;
-	for (const auto& activityReward : activityRewards) {
-		if (activityReward.activityRating <= rating && (selectedReward == nullptr || activityReward.activityRating > selectedReward->activityRating)) {
-			selectedReward = &activityReward;
+	for (const auto* activityReward : activityRewardsTable->GetByObjectTemplate(activityID)) {
+		if (activityReward->activityRating <= rating && (selectedReward == nullptr || activityReward->activityRating > selectedReward->activityRating)) {
+			selectedReward = activityReward;
 		}
 	}
 
@@ -304,11 +318,11 @@ void Loot::DropActivityLoot(Entity* player, Entity* source, uint32_t activityID,
 	uint32_t maxCoins = 0;
 
 	CDCurrencyTableTable* currencyTableTable = CDClientManager::GetTable<CDCurrencyTableTable>();
-	std::vector<CDCurrencyTable> currencyTable = currencyTableTable->Query([selectedReward](CDCurrencyTable entry) { return (entry.currencyIndex == selectedReward->CurrencyIndex && entry.npcminlevel == 1); });
+	const auto currencyTable = currencyTableTable->GetByCurrencyIndex(selectedReward->CurrencyIndex, 1);
 
-	if (currencyTable.size() > 0) {
-		minCoins = currencyTable[0].minvalue;
-		maxCoins = currencyTable[0].maxvalue;
+	if (!currencyTable.empty()) {
+		minCoins = currencyTable[0]->minvalue;
+		maxCoins = currencyTable[0]->maxvalue;
 	}
 
 	DropLoot(player, source, selectedReward->LootMatrixIndex, minCoins, maxCoins);
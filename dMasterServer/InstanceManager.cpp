@@ -1,4 +1,5 @@
 #include "InstanceManager.h"
+#include <algorithm>
 #include <string>
 #include "Game.h"
 #include "dServer.h"
@@ -20,6 +21,57 @@ InstanceManager::InstanceManager(Logger* logger, const std::string& externalIP)
 	m_LastPort =
 		GeneralUtils::TryParse<uint16_t>(Game::config->GetValue("world_port_start")).value_or(m_LastPort);
 	m_LastInstanceID = LWOINSTANCEID_INVALID;
+
+	// A comma separated list of mapID:count, for example 1100:1,1200:2
+	for (const auto& entry : GeneralUtils::SplitString(Game::config->GetValue("warm_instances"), ',')) {
+		if (entry.empty()) continue;
+
+		const auto pair = GeneralUtils::SplitString(entry, ':');
+		const auto mapID = pair.size() == 2 ? GeneralUtils::TryParse<LWOMAPID>(pair[0]) : std::nullopt;
+		const auto count = pair.size() == 2 ? GeneralUtils::TryParse<uint32_t>(pair[1]) : std::nullopt;
+		if (!mapID || !count || *mapID == 0) {
+			LOG("Ignoring invalid warm instance entry %s", entry.c_str());
+			continue;
+		}
+
+		m_WarmInstances[*mapID] = *count;
+		LOG("Keeping %i spare instance(s) of map %i running", *count, *mapID);
+	}
+
+	m_WarmIdleTime = std::chrono::seconds(
+		GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("warm_instance_idle_time")).value_or(m_WarmIdleTime.count()));
+
+	// A comma separated list of ip:portStart[:capacity], for example 10.0.0.2:3000:8,10.0.0.3:3000:4
+	const auto launchCommand = Game::config->GetValue("world_host_launch_command");
+	for (const auto& entry : GeneralUtils::SplitString(Game::config->GetValue("world_hosts"), ',')) {
+		if (entry.empty()) continue;
+
+		const auto fields = GeneralUtils::SplitString(entry, ':');
+		const auto portStart = fields.size() >= 2 ? GeneralUtils::TryParse<uint16_t>(fields[1]) : std::nullopt;
+		const auto capacity = fields.size() >= 3 ? GeneralUtils::TryParse<float>(fields[2]) : 1.0f;
+		if (fields[0].empty() || !portStart || !capacity || *capacity <= 0.0f) {
+			LOG("Ignoring invalid world host entry %s", entry.c_str());
+			continue;
+		}
+
+		auto& host = m_Hosts.emplace_back();
+		host.ip = fields[0];
+		host.portStart = *portStart;
+		host.capacity = *capacity;
+
+		// World servers for our own machine are started directly.
+		if (!launchCommand.empty() && host.ip != mExternalIP && host.ip != "localhost" && host.ip != "127.0.0.1") {
+			host.launchCommand = launchCommand;
+			for (auto pos = host.launchCommand.find("{host}"); pos != std::string::npos; pos = host.launchCommand.find("{host}", pos)) {
+				host.launchCommand.replace(pos, 6, host.ip);
+			}
+		}
+		LOG("World host %s starts at port %i with capacity %f", host.ip.c_str(), host.portStart, host.capacity);
+	}
+
+	if (m_Hosts.empty()) m_Hosts.push_back(WorldHost{ mExternalIP, m_LastPort, 1.0f, "" });
+
+	m_Placement = PlacementPolicy::Create(Game::config->GetValue("instance_placement"));
 }
 
 InstanceManager::~InstanceManager() {
@@ -55,13 +107,7 @@ Instance* InstanceManager::GetInstance(LWOMAPID mapID, bool isFriendTransfer, LW
 		maxPlayers = GetHardCap(mapID);
 	}
 
-	uint32_t port = GetFreePort();
-	instance = new Instance(mExternalIP, port, mapID, ++m_LastInstanceID, cloneID, softCap, maxPlayers);
-
-	//Start the actual process:
-	StartWorldServer(mapID, port, m_LastInstanceID, maxPlayers, cloneID);
-
-	m_Instances.push_back(instance);
+	instance = StartInstance(mapID, cloneID, softCap, maxPlayers);
 
 	if (instance) {
 		LOG("Created new instance: %i/%i/%i with min/max %i/%i", mapID, m_LastInstanceID, cloneID, softCap, maxPlayers);
@@ -71,9 +117,9 @@ Instance* InstanceManager::GetInstance(LWOMAPID mapID, bool isFriendTransfer, LW
 	return nullptr;
 }
 
-bool InstanceManager::IsPortInUse(uint32_t port) {
+bool InstanceManager::IsPortInUse(const std::string& ip, uint32_t port) {
 	for (Instance* i : m_Instances) {
-		if (i && i->GetPort() == port) {
+		if (i && i->GetIP() == ip && i->GetPort() == port) {
 			return true;
 		}
 	}
@@ -81,11 +127,11 @@ bool InstanceManager::IsPortInUse(uint32_t port) {
 	return false;
 }
 
-uint32_t InstanceManager::GetFreePort() {
-	uint32_t port = m_LastPort;
+uint32_t InstanceManager::GetFreePort(const WorldHost& host) {
+	uint32_t port = host.portStart;
 	std::vector<uint32_t> usedPorts;
 	for (Instance* i : m_Instances) {
-		usedPorts.push_back(i->GetPort());
+		if (i->GetIP() == host.ip) usedPorts.push_back(i->GetPort());
 	}
 
 	std::sort(usedPorts.begin(), usedPorts.end());
@@ -147,6 +193,21 @@ void InstanceManager::RemoveInstance(Instance* instance) {
 }
 
 void InstanceManager::ReadyInstance(Instance* instance) {
+	if (!instance->GetIsReady() && instance->GetStartedAt() != std::chrono::steady_clock::time_point{}) {
+		const auto readyTime = std::chrono::steady_clock::now() - instance->GetStartedAt();
+		auto& stats = m_StartupStats[instance->GetMapID()];
+		stats.readied++;
+		stats.totalReadyTime += readyTime;
+		stats.maxReadyTime = std::max(stats.maxReadyTime, readyTime);
+
+		using Seconds = std::chrono::duration<float>;
+		using Milliseconds = std::chrono::duration<float, std::milli>;
+		LOG("Instance %i/%i/%i is ready after %.2fs. Map %i: %i started, ready after %.2fs on average and %.2fs at most, spawning took %.2fms on average",
+			instance->GetMapID(), instance->GetInstanceID(), instance->GetCloneID(), Seconds(readyTime).count(),
+			instance->GetMapID(), stats.started, Seconds(stats.totalReadyTime).count() / stats.readied, Seconds(stats.maxReadyTime).count(),
+			Milliseconds(stats.totalSpawnTime).count() / stats.started);
+	}
+
 	instance->SetIsReady(true);
 
 	auto& pending = instance->GetPendingRequests();
@@ -173,6 +234,7 @@ void InstanceManager::ReadyInstance(Instance* instance) {
 }
 
 void InstanceManager::RequestAffirmation(Instance* instance, const PendingInstanceRequest& request) {
+	if (instance->GetPendingAffirmations().empty()) instance->SetAffirmationsPendingSince(std::chrono::steady_clock::now());
 	instance->GetPendingAffirmations().push_back(request);
 
 	CBITSTREAM;
@@ -254,13 +316,19 @@ bool InstanceManager::IsInstanceFull(Instance* instance, bool isFriendTransfer)
 }
 
 Instance* InstanceManager::FindInstance(LWOMAPID mapID, bool isFriendTransfer, LWOCLONEID cloneId) {
+	// Prefer an instance that is already loaded, so the player does not have to wait for one to start.
+	std::vector<Instance*> ready;
+	std::vector<Instance*> starting;
 	for (Instance* i : m_Instances) {
 		if (i && i->GetMapID() == mapID && i->GetCloneID() == cloneId && !IsInstanceFull(i, isFriendTransfer) && !i->GetIsPrivate() && !i->GetShutdownComplete() && !i->GetIsShuttingDown()) {
-			return i;
+			(i->GetIsReady() ? ready : starting).push_back(i);
 		}
 	}
 
-	return nullptr;
+	if (ready.empty() && starting.empty()) return nullptr;
+	if (ready.size() + starting.size() == 1) return ready.empty() ? starting.front() : ready.front();
+
+	return m_Placement->ChooseInstance(ready.empty() ? starting : ready, GetHostLoads());
 }
 
 Instance* InstanceManager::FindInstance(LWOMAPID mapID, LWOINSTANCEID instanceID) {
@@ -290,13 +358,7 @@ Instance* InstanceManager::CreatePrivateInstance(LWOMAPID mapID, LWOCLONEID clon
 
 	int maxPlayers = 999;
 
-	uint32_t port = GetFreePort();
-	instance = new Instance(mExternalIP, port, mapID, ++m_LastInstanceID, cloneID, maxPlayers, maxPlayers, true, password);
-
-	//Start the actual process:
-	StartWorldServer(mapID, port, m_LastInstanceID, maxPlayers, cloneID);
-
-	m_Instances.push_back(instance);
+	instance = StartInstance(mapID, cloneID, maxPlayers, maxPlayers, true, password);
 
 	if (instance) return instance;
 	else LOG("Failed to create a new instance!");
@@ -322,6 +384,110 @@ Instance* InstanceManager::FindPrivateInstance(const std::string& password) {
 	return nullptr;
 }
 
+void InstanceManager::MaintainWarmPool() {
+	if (m_IsShuttingDown) return;
+
+	const auto now = std::chrono::steady_clock::now();
+	for (const auto& [mapID, spareTarget] : m_WarmInstances) {
+		uint32_t spare = 0;
+		std::vector<Instance*> idle;
+		for (auto* instance : m_Instances) {
+			if (!instance || instance->GetMapID() != mapID || instance->GetCloneID() != 0 || instance->GetIsPrivate()) continue;
+			if (instance->GetIsShuttingDown() || instance->GetShutdownComplete() || IsInstanceFull(instance, false)) continue;
+
+			// Instances still starting count as spare, since players sent to them will not have to wait as long.
+			spare++;
+			if (instance->GetIsPooled() && instance->GetIsReady() && instance->GetCurrentClientCount() == 0 && now - instance->GetEmptySince() >= m_WarmIdleTime) {
+				idle.push_back(instance);
+			}
+		}
+
+		for (; spare < spareTarget; spare++) {
+			auto* instance = StartInstance(mapID, 0, GetSoftCap(mapID), GetHardCap(mapID));
+			LOG("Started pooled instance %i/%i/%i", mapID, instance->GetInstanceID(), 0);
+		}
+
+		for (; spare > spareTarget && !idle.empty(); spare--) {
+			auto* instance = idle.back();
+			idle.pop_back();
+
+			LOG("Recycling idle pooled instance %i/%i/%i", mapID, instance->GetInstanceID(), instance->GetCloneID());
+			instance->Shutdown();
+			instance->SetIsShuttingDown(true);
+		}
+	}
+}
+
+Instance* InstanceManager::StartInstance(LWOMAPID mapID, LWOCLONEID cloneID, int softCap, int hardCap, bool isPrivate, const std::string& password) {
+	const auto hostLoads = GetHostLoads();
+	const auto hostIndex = m_Hosts.size() == 1 ? 0 : m_Placement->ChooseHost(hostLoads);
+	const auto hostIt = std::find_if(m_Hosts.begin(), m_Hosts.end(), [&hostLoads, hostIndex](const WorldHost& host) { return host.ip == hostLoads[hostIndex].ip; });
+	const auto& host = hostIt != m_Hosts.end() ? *hostIt : m_Hosts.front();
+
+	uint32_t port = GetFreePort(host);
+	auto* instance = new Instance(host.ip, port, mapID, ++m_LastInstanceID, cloneID, softCap, hardCap, isPrivate, password);
+	instance->SetIsPooled(!isPrivate && cloneID == 0 && m_WarmInstances.contains(mapID));
+
+	//Start the actual process:
+	const auto spawnStart = std::chrono::steady_clock::now();
+	StartWorldServer(mapID, port, m_LastInstanceID, hardCap, cloneID, instance->GetIsPooled(), host.launchCommand);
+	instance->SetStartedAt(spawnStart);
+
+	auto& stats = m_StartupStats[mapID];
+	stats.started++;
+	stats.totalSpawnTime += std::chrono::steady_clock::now() - spawnStart;
+
+	m_Instances.push_back(instance);
+	return instance;
+}
+
+std::vector<HostLoad> InstanceManager::GetHostLoads() const {
+	std::vector<HostLoad> hosts;
+	for (const auto& host : m_Hosts) {
+		auto& load = hosts.emplace_back();
+		load.ip = host.ip;
+		load.capacity = host.capacity;
+		load.canStartInstances = true;
+	}
+
+	// Instances that have not reported yet are assumed to be as busy as the average instance that has.
+	float reportedCores = 0.0f;
+	uint32_t reported = 0;
+	for (const auto* instance : m_Instances) {
+		if (!instance || !instance->GetLoad()) continue;
+		reportedCores += instance->GetLoad()->GetCpuCores();
+		reported++;
+	}
+	const float estimatedCores = reported > 0 ? reportedCores / reported : 0.1f;
+
+	for (const auto* instance : m_Instances) {
+		if (!instance || instance->GetShutdownComplete()) continue;
+
+		auto host = std::find_if(hosts.begin(), hosts.end(), [instance](const HostLoad& load) { return load.ip == instance->GetIP(); });
+		if (host == hosts.end()) {
+			host = hosts.emplace(hosts.end());
+			host->ip = instance->GetIP();
+		}
+
+		const auto& load = instance->GetLoad();
+		host->instances++;
+		host->cpuCores += load ? load->GetCpuCores() : estimatedCores;
+		host->rss += load ? load->rss : 0;
+		host->players += load ? load->players : instance->GetCurrentClientCount();
+	}
+
+	return hosts;
+}
+
+void InstanceManager::LogHostLoads() const {
+	if (m_Instances.empty()) return;
+
+	for (const auto& host : GetHostLoads()) {
+		LOG("Host %s: %i instances, %i players, %.2f cores busy of %.2f, %.1fMB resident",
+			host.ip.c_str(), host.instances, host.players, host.cpuCores, host.capacity, host.rss / 1.0e6);
+	}
+}
+
 int InstanceManager::GetSoftCap(LWOMAPID mapID) {
 	CDZoneTableTable* zoneTable = CDClientManager::GetTable<CDZoneTableTable>();
 	if (zoneTable) {
@@ -1,15 +1,33 @@
 #pragma once
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
 #include <vector>
 #include "dCommonVars.h"
 #include "RakNetTypes.h"
 #include "dZMCommon.h"
 #include "Logger.h"
+#include "PlacementPolicy.h"
 
 struct Player {
 	LWOOBJID id;
 	SystemAddress addr;
 };
 
+// What a world server last reported about how busy it is.
+struct InstanceLoad {
+	uint32_t players = 0;
+	// Average CPU time per frame and average frame length, in nanoseconds.
+	int64_t cpuTimePerFrame = 0;
+	int64_t frameTime = 0;
+	uint64_t rss = 0;
+	std::chrono::steady_clock::time_point reportedAt;
+
+	// How many cores this instance keeps busy.
+	float GetCpuCores() const { return frameTime > 0 ? static_cast<float>(cpuTimePerFrame) / frameTime : 0.0f; }
+};
+
 struct PendingInstanceRequest {
 	uint64_t id;
 	bool mythranShift;
@@ -56,12 +74,28 @@ public:
 	int GetSoftCap() const { return m_MaxClientsSoftCap; }
 	int GetCurrentClientCount() const { return m_CurrentClientCount; }
 
-	void SetAffirmationTimeout(const uint32_t value) { m_AffirmationTimeout = value; }
-	uint32_t GetAffirmationTimeout() const { return m_AffirmationTimeout; }
+	// When this instance last went from having no affirmations pending to having some.
+	void SetAffirmationsPendingSince(const std::chrono::steady_clock::time_point value) { m_AffirmationsPendingSince = value; }
+	std::chrono::steady_clock::time_point GetAffirmationsPendingSince() const { return m_AffirmationsPendingSince; }
+
+	// Pooled instances are kept running by master instead of shutting down when they have been empty for a while.
+	bool GetIsPooled() const { return m_IsPooled; }
+	void SetIsPooled(bool value) { m_IsPooled = value; }
+
+	// When master started the world server for this instance, if it did.
+	std::chrono::steady_clock::time_point GetStartedAt() const { return m_StartedAt; }
+	void SetStartedAt(const std::chrono::steady_clock::time_point value) { m_StartedAt = value; }
+
+	const std::optional<InstanceLoad>& GetLoad() const { return m_Load; }
+	void SetLoad(const InstanceLoad& value) { m_Load = value; }
+
+	// When the last player left, or when the instance was created if nobody has joined yet.
+	std::chrono::steady_clock::time_point GetEmptySince() const { return m_EmptySince; }
 
 	void AddPlayer(Player player) { /*m_Players.push_back(player);*/ m_CurrentClientCount++; }
 	void RemovePlayer(Player player) {
 		m_CurrentClientCount--;
+		if (m_CurrentClientCount <= 0) m_EmptySince = std::chrono::steady_clock::now();
 		if (m_CurrentClientCount < 0) m_CurrentClientCount = 0;
 		/*for (size_t i = 0; i < m_Players.size(); ++i)
 			if (m_Players[i].addr == player.addr) m_Players.erase(m_Players.begin() + i);*/
@@ -89,7 +123,12 @@ private:
 	std::vector<PendingInstanceRequest> m_PendingRequests;
 	std::vector<PendingInstanceRequest> m_PendingAffirmations;
 
-	uint32_t m_AffirmationTimeout;
+	std::chrono::steady_clock::time_point m_AffirmationsPendingSince;
+
+	bool m_IsPooled = false;
+	std::optional<InstanceLoad> m_Load;
+	std::chrono::steady_clock::time_point m_StartedAt;
+	std::chrono::steady_clock::time_point m_EmptySince = std::chrono::steady_clock::now();
 
 	bool m_IsPrivate;
 	std::string m_Password;
@@ -105,8 +144,8 @@ public:
 	~InstanceManager();
 
 	Instance* GetInstance(LWOMAPID mapID, bool isFriendTransfer, LWOCLONEID cloneID); //Creates an instance if none found
-	bool IsPortInUse(uint32_t port);
-	uint32_t GetFreePort();
+	bool IsPortInUse(const std::string& ip, uint32_t port);
+	uint32_t GetFreePort(const WorldHost& host);
 
 	void AddPlayer(SystemAddress systemAddr, LWOMAPID mapID, LWOINSTANCEID instanceID);
 	void RemovePlayer(SystemAddress systemAddr, LWOMAPID mapID, LWOINSTANCEID instanceID);
@@ -130,7 +169,34 @@ public:
 	Instance* FindPrivateInstance(const std::string& password);
 	void SetIsShuttingDown(bool value) { this->m_IsShuttingDown = value; };
 
+	/**
+	 * Keeps the configured number of instances with room to spare running for each pooled map, so that
+	 * players transferring there find one that is already loaded.  Pooled instances that have been empty
+	 * for a while are shut down once there are more spare instances than needed.
+	 */
+	void MaintainWarmPool();
+
+	/**
+	 * @return The load of every configured host, and of any other host a world server has connected from.
+	 */
+	std::vector<HostLoad> GetHostLoads() const;
+	void LogHostLoads() const;
+
 private:
+	// How long world servers took to start, per map.
+	struct StartupStats {
+		uint32_t started = 0;
+		uint32_t readied = 0;
+		// Time spent in StartWorldServer, which is how long the master loop was held up.
+		std::chrono::steady_clock::duration totalSpawnTime{};
+		// Time from starting the world server to it reporting ready.
+		std::chrono::steady_clock::duration totalReadyTime{};
+		std::chrono::steady_clock::duration maxReadyTime{};
+	};
+
+	Instance* StartInstance(LWOMAPID mapID, LWOCLONEID cloneID, int softCap, int hardCap, bool isPrivate = false, const std::string& password = "");
+
+
 	Logger* mLogger;
 	std::string mExternalIP;
 	std::vector<Instance*> m_Instances;
@@ -142,6 +208,18 @@ private:
 	 */
 	bool m_IsShuttingDown = false;
 
+	// How many instances with room to spare to keep running for each pooled map.
+	std::map<LWOMAPID, uint32_t> m_WarmInstances;
+
+	// How long a pooled instance has to be empty before it can be shut down.
+	std::chrono::seconds m_WarmIdleTime{ 5 * 60 };
+
+	std::map<LWOMAPID, StartupStats> m_StartupStats;
+
+	// The hosts master can start world servers on.
+	std::vector<WorldHost> m_Hosts;
+	std::unique_ptr<PlacementPolicy> m_Placement;
+
 	//Private functions:
 	bool IsInstanceFull(Instance* instance, bool isFriendTransfer);
 	int GetSoftCap(LWOMAPID mapID);
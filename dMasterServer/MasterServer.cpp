@@ -23,6 +23,7 @@
 #include "dServer.h"
 #include "AssetManager.h"
 #include "BinaryPathFinder.h"
+#include "TimerHeap.h"
 #include "eConnectionType.h"
 #include "MessageType/Master.h"
 
@@ -37,6 +38,7 @@
 #include "MasterPackets.h"
 #include "PersistentIDManager.h"
 #include "FdbToSqlite.h"
+#include "MappedFile.h"
 #include "BitStreamUtils.h"
 #include "Start.h"
 #include "Server.h"
@@ -59,12 +61,14 @@ int ShutdownSequence(int32_t signal = -1);
 int32_t FinalizeShutdown(int32_t signal = -1);
 void HandlePacket(Packet* packet);
 std::map<uint32_t, std::string> activeSessions;
+TimerHeap timers;
+constexpr auto instanceReadyTimeout = std::chrono::seconds(30);
 SystemAddress authServerMasterPeerSysAddr;
 SystemAddress chatServerMasterPeerSysAddr;
 
 int main(int argc, char** argv) {
-	constexpr uint32_t masterFramerate = mediumFramerate;
-	constexpr uint32_t masterFrameDelta = mediumFrameDelta;
+	// Master only wakes up for packets and timers, but never sleeps longer than this so that it notices signals.
+	constexpr auto maxIdleTime = std::chrono::milliseconds(mediumFrameDelta);
 	Diagnostics::SetProcessName("Master");
 	Diagnostics::SetProcessFileName(argv[0]);
 	Diagnostics::Initialize();
@@ -150,8 +154,12 @@ int main(int argc, char** argv) {
 				(resServerPath / "CDServer.sqlite").string().c_str(),
 				(Game::assetManager->GetResPath() / "cdclient.fdb").string().c_str());
 
-			auto cdclientStream = Game::assetManager->GetFile("cdclient.fdb");
-			if (!cdclientStream) {
+			// Map the fdb straight from disk if we can, only packed clients need it read into memory.
+			MappedFile mappedFdb;
+			if (fdbExists) mappedFdb.Open(Game::assetManager->GetResPath() / "cdclient.fdb");
+
+			auto cdclientStream = mappedFdb.IsOpen() ? AssetStream(nullptr, 0, false) : Game::assetManager->GetFile("cdclient.fdb");
+			if (!mappedFdb.IsOpen() && !cdclientStream) {
 				LOG("Failed to load %s", (Game::assetManager->GetResPath() / "cdclient.fdb").string().c_str());
 				throw std::runtime_error("Aborting initialization due to missing cdclient.fdb.");
 			}
@@ -159,7 +167,8 @@ int main(int argc, char** argv) {
 			LOG("Found %s.  Converting to SQLite", (Game::assetManager->GetResPath() / "cdclient.fdb").string().c_str());
 			Game::logger->Flush();
 
-			if (FdbToSqlite::Convert(resServerPath.string()).ConvertDatabase(cdclientStream) == false) {
+			const auto fdb = mappedFdb.IsOpen() ? mappedFdb.GetSpan() : cdclientStream.GetData();
+			if (FdbToSqlite::Convert(resServerPath.string()).ConvertDatabase(fdb) == false) {
 				LOG("Failed to convert fdb to sqlite.");
 				return EXIT_FAILURE;
 			}
@@ -334,86 +343,58 @@ int main(int argc, char** argv) {
 		StartAuthServer();
 	}
 
-	auto t = std::chrono::high_resolution_clock::now();
 	Packet* packet = nullptr;
-	constexpr uint32_t logFlushTime = 15 * masterFramerate;
-	constexpr uint32_t sqlPingTime = 10 * 60 * masterFramerate;
-	constexpr uint32_t shutdownUniverseTime = 10 * 60 * masterFramerate;
-	constexpr uint32_t instanceReadyTimeout = 30 * masterFramerate;
-	uint32_t framesSinceLastFlush = 0;
-	uint32_t framesSinceLastSQLPing = 0;
-	uint32_t framesSinceKillUniverseCommand = 0;
-
-	Game::logger->Flush();
-	while (!Game::ShouldShutdown()) {
-		//In world we'd update our other systems here.
-
-		//Check for packets here:
-		packet = Game::server->Receive();
-		if (packet) {
-			HandlePacket(packet);
-			Game::server->DeallocatePacket(packet);
-			packet = nullptr;
-		}
-
-		//Push our log every 15s:
-		if (framesSinceLastFlush >= logFlushTime) {
-			Game::logger->Flush();
-			framesSinceLastFlush = 0;
-		} else
-			framesSinceLastFlush++;
-
-		//Every 10 min we ping our sql server to keep it alive hopefully:
-		if (framesSinceLastSQLPing >= sqlPingTime) {
-			//Find out the master's IP for absolutely no reason:
-			std::string masterIP;
-			uint32_t masterPort;
-			auto masterInfo = Database::Get()->GetMasterInfo();
-			if (masterInfo) {
-				masterIP = masterInfo->ip;
-				masterPort = masterInfo->port;
-			}
-
-			framesSinceLastSQLPing = 0;
-		} else
-			framesSinceLastSQLPing++;
-
-		//10m shutdown for universe kill command
-		if (Game::universeShutdownRequested) {
-			if (framesSinceKillUniverseCommand >= shutdownUniverseTime) {
-				//Break main loop and exit
-				Game::lastSignal = -1;
-			} else
-				framesSinceKillUniverseCommand++;
-		}
 
-		const auto instances = Game::im->GetInstances();
-
-		for (auto* instance : instances) {
+	//Push our log every 15s:
+	timers.Every(std::chrono::seconds(15), []() { Game::logger->Flush(); });
+
+	//Every 10 min we ping our sql server to keep it alive hopefully:
+	timers.Every(std::chrono::minutes(10), []() {
+		//Find out the master's IP for absolutely no reason:
+		std::string masterIP;
+		uint32_t masterPort;
+		auto masterInfo = Database::Get()->GetMasterInfo();
+		if (masterInfo) {
+			masterIP = masterInfo->ip;
+			masterPort = masterInfo->port;
+		}
+	});
+
+	//Keep spare instances of the busiest maps loaded:
+	Game::im->MaintainWarmPool();
+	timers.Every(std::chrono::seconds(5), []() { Game::im->MaintainWarmPool(); });
+	timers.Every(std::chrono::minutes(1), []() { Game::im->LogHostLoads(); });
+
+	//Shut down instances that have not affirmed a transfer in time. They are checked every second, which is plenty for a 30s timeout.
+	timers.Every(std::chrono::seconds(1), []() {
+		const auto now = std::chrono::steady_clock::now();
+		for (auto* instance : Game::im->GetInstances()) {
 			if (instance == nullptr) {
 				break;
 			}
 
-			auto affirmTimeout = instance->GetAffirmationTimeout();
-
-			if (!instance->GetPendingAffirmations().empty()) {
-				affirmTimeout++;
-			} else {
-				affirmTimeout = 0;
-			}
+			if (instance->GetPendingAffirmations().empty() || instance->GetIsShuttingDown()) continue;
+			if (now - instance->GetAffirmationsPendingSince() < instanceReadyTimeout) continue;
 
-			instance->SetAffirmationTimeout(affirmTimeout);
+			instance->Shutdown();
+			instance->SetIsShuttingDown(true);
 
-			if (affirmTimeout == instanceReadyTimeout) {
-				instance->Shutdown();
-				instance->SetIsShuttingDown(true);
+			Game::im->RedirectPendingRequests(instance);
+		}
+	});
 
-				Game::im->RedirectPendingRequests(instance);
-			}
+	Game::logger->Flush();
+	while (!Game::ShouldShutdown()) {
+		//Handle everything that arrived since we last woke up:
+		while ((packet = Game::server->Receive())) {
+			HandlePacket(packet);
+			Game::server->DeallocatePacket(packet);
 		}
 
+		timers.RunDue();
+
 		//Remove dead instances
-		for (auto* instance : instances) {
+		for (auto* instance : Game::im->GetInstances()) {
 			if (instance == nullptr) {
 				break;
 			}
@@ -423,8 +404,8 @@ int main(int argc, char** argv) {
 			}
 		}
 
-		t += std::chrono::milliseconds(masterFrameDelta);
-		std::this_thread::sleep_until(t);
+		//Sleep until a packet arrives or a timer is due:
+		Game::server->WaitForPackets(timers.GetNextDue(std::chrono::steady_clock::now() + maxIdleTime));
 	}
 	return ShutdownSequence(EXIT_SUCCESS);
 }
@@ -549,7 +530,7 @@ void HandlePacket(Packet* packet) {
 			inStream.Read(theirIP);
 
 			if (theirServerType == ServerType::World) {
-				if (!Game::im->IsPortInUse(theirPort)) {
+				if (!Game::im->IsPortInUse(theirIP.string, theirPort)) {
 					Instance* in = new Instance(theirIP.string, theirPort, theirZoneID, theirInstanceID, 0, 12, 12);
 
 					SystemAddress copy;
@@ -753,6 +734,27 @@ void HandlePacket(Packet* packet) {
 			break;
 		}
 
+		case MessageType::Master::WORLD_LOAD: {
+			RakNet::BitStream inStream(packet->data, packet->length, false);
+			uint64_t header = inStream.Read(header);
+
+			LWOMAPID zoneID;
+			LWOINSTANCEID instanceID;
+			InstanceLoad load;
+
+			inStream.Read(zoneID);
+			inStream.Read(instanceID);
+			inStream.Read(load.players);
+			inStream.Read(load.cpuTimePerFrame);
+			inStream.Read(load.frameTime);
+			inStream.Read(load.rss);
+			load.reportedAt = std::chrono::steady_clock::now();
+
+			auto* instance = Game::im->FindInstance(zoneID, instanceID);
+			if (instance) instance->SetLoad(load);
+			break;
+		}
+
 		case MessageType::Master::PREP_ZONE: {
 			RakNet::BitStream inStream(packet->data, packet->length, false);
 			uint64_t header = inStream.Read(header);
@@ -805,8 +807,14 @@ void HandlePacket(Packet* packet) {
 		}
 
 		case MessageType::Master::SHUTDOWN_UNIVERSE: {
+			if (Game::universeShutdownRequested) break;
+
 			LOG("Received shutdown universe command, shutting down in 10 minutes.");
 			Game::universeShutdownRequested = true;
+			timers.After(std::chrono::minutes(10), []() {
+				//Break main loop and exit
+				Game::lastSignal = -1;
+			});
 			break;
 		}
 
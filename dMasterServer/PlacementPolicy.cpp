@@ -0,0 +1,63 @@
+#include "PlacementPolicy.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "InstanceManager.h"
+
+namespace {
+	const HostLoad* FindHost(const std::vector<HostLoad>& hosts, const std::string& ip) {
+		const auto host = std::find_if(hosts.begin(), hosts.end(), [&ip](const HostLoad& load) { return load.ip == ip; });
+		return host != hosts.end() ? &*host : nullptr;
+	}
+}
+
+std::unique_ptr<PlacementPolicy> PlacementPolicy::Create(const std::string& name) {
+	if (name == "first_fit") return std::make_unique<FirstFitPlacement>();
+	return std::make_unique<LeastLoadedPlacement>();
+}
+
+size_t FirstFitPlacement::ChooseHost(const std::vector<HostLoad>& hosts) {
+	for (size_t i = 0; i < hosts.size(); i++) {
+		if (hosts[i].canStartInstances) return i;
+	}
+
+	return 0;
+}
+
+Instance* FirstFitPlacement::ChooseInstance(const std::vector<Instance*>& candidates, const std::vector<HostLoad>& hosts) {
+	return candidates.front();
+}
+
+size_t LeastLoadedPlacement::ChooseHost(const std::vector<HostLoad>& hosts) {
+	size_t best = 0;
+	float bestScore = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < hosts.size(); i++) {
+		if (!hosts[i].canStartInstances) continue;
+
+		const auto score = hosts[i].GetScore();
+		if (score < bestScore) {
+			best = i;
+			bestScore = score;
+		}
+	}
+
+	return best;
+}
+
+Instance* LeastLoadedPlacement::ChooseInstance(const std::vector<Instance*>& candidates, const std::vector<HostLoad>& hosts) {
+	Instance* best = nullptr;
+	float bestScore = std::numeric_limits<float>::max();
+	for (auto* instance : candidates) {
+		const auto* host = FindHost(hosts, instance->GetIP());
+		const auto score = host ? host->GetScore() : 0.0f;
+
+		// On equally loaded hosts, fill the busier instance first so that empty instances stay empty.
+		if (!best || score < bestScore || (score == bestScore && instance->GetCurrentClientCount() > best->GetCurrentClientCount())) {
+			best = instance;
+			bestScore = score;
+		}
+	}
+
+	return best;
+}
@@ -0,0 +1,82 @@
+#ifndef __PLACEMENTPOLICY__H__
+#define __PLACEMENTPOLICY__H__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Instance;
+
+// A machine master can start world servers on.
+struct WorldHost {
+	// The address players connect to.
+	std::string ip;
+
+	// The first port to give world servers on this host.
+	uint16_t portStart = 3000;
+
+	// How much this host can take compared to the others, for example its number of cores.
+	float capacity = 1.0f;
+
+	// Runs the world server command on this host, with {host} replaced by the ip.  Empty to run it on the master's machine.
+	std::string launchCommand;
+};
+
+// How busy a host is, summed over the instances running on it.
+struct HostLoad {
+	std::string ip;
+	float capacity = 1.0f;
+
+	// How many cores the world servers on this host keep busy.  Instances that have not reported yet are estimated.
+	float cpuCores = 0.0f;
+	uint64_t rss = 0;
+	uint32_t players = 0;
+	uint32_t instances = 0;
+
+	// Whether master can start new world servers on this host, rather than only knowing of it from the world servers on it.
+	bool canStartInstances = false;
+
+	float GetScore() const { return cpuCores / capacity; }
+};
+
+/**
+ * Decides which host new instances start on and which instance a transfer goes to.
+ * Selected with instance_placement in masterconfig.ini.
+ */
+class PlacementPolicy {
+public:
+	virtual ~PlacementPolicy() = default;
+
+	/**
+	 * @param hosts Every known host.  At least one of them can start instances.
+	 * @return The index in hosts of the host to start the next instance on.
+	 */
+	virtual size_t ChooseHost(const std::vector<HostLoad>& hosts) = 0;
+
+	/**
+	 * @param candidates The instances with room for the player, never empty.
+	 * @param hosts Every known host.
+	 * @return The instance to send the player to.
+	 */
+	virtual Instance* ChooseInstance(const std::vector<Instance*>& candidates, const std::vector<HostLoad>& hosts) = 0;
+
+	// Creates a policy by name, falling back to least_loaded for names it does not know.
+	static std::unique_ptr<PlacementPolicy> Create(const std::string& name);
+};
+
+// Starts instances on the first host and fills instances in the order they were started.  This is how master placed instances before it knew of other hosts.
+class FirstFitPlacement : public PlacementPolicy {
+public:
+	size_t ChooseHost(const std::vector<HostLoad>& hosts) override;
+	Instance* ChooseInstance(const std::vector<Instance*>& candidates, const std::vector<HostLoad>& hosts) override;
+};
+
+// Starts instances on the host with the most CPU to spare, and sends players to the instance on the least loaded host.
+class LeastLoadedPlacement : public PlacementPolicy {
+public:
+	size_t ChooseHost(const std::vector<HostLoad>& hosts) override;
+	Instance* ChooseInstance(const std::vector<Instance*>& candidates, const std::vector<HostLoad>& hosts) override;
+};
+
+#endif  //!__PLACEMENTPOLICY__H__
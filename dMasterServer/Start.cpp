@@ -41,7 +41,7 @@ void StartAuthServer() {
 #endif
 }
 
-void StartWorldServer(LWOMAPID mapID, uint16_t port, LWOINSTANCEID lastInstanceID, int maxPlayers, LWOCLONEID cloneID) {
+void StartWorldServer(LWOMAPID mapID, uint16_t port, LWOINSTANCEID lastInstanceID, int maxPlayers, LWOCLONEID cloneID, bool isPooled, const std::string& launchCommand) {
 #ifdef _WIN32
 	std::string cmd = "start /B " + (BinaryPathFinder::GetBinaryDir() / "WorldServer.exe").string() + " -zone ";
 #else
@@ -63,6 +63,12 @@ void StartWorldServer(LWOMAPID mapID, uint16_t port, LWOINSTANCEID lastInstanceI
 	cmd.append(" -clone ");
 	cmd.append(std::to_string(cloneID));
 
+	//Master decides when pooled instances shut down, so they should not time out on their own:
+	if (isPooled) cmd.append(" -pooled");
+
+	//Worlds on other hosts are started through the configured command, which has to find the world server at the same path there:
+	if (!launchCommand.empty()) cmd = launchCommand + " " + cmd;
+
 #ifndef _WIN32
 	cmd.append("&"); //Sends our next process to the background on Linux
 #endif
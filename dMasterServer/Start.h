@@ -1,6 +1,7 @@
 #pragma once
+#include <string>
 #include "dCommonVars.h"
 
 void StartAuthServer();
 void StartChatServer();
-void StartWorldServer(LWOMAPID mapID, uint16_t port, LWOINSTANCEID lastInstanceID, int maxPlayers, LWOCLONEID cloneID);
+void StartWorldServer(LWOMAPID mapID, uint16_t port, LWOINSTANCEID lastInstanceID, int maxPlayers, LWOCLONEID cloneID, bool isPooled = false, const std::string& launchCommand = "");
@@ -1,5 +1,8 @@
 #include "dNavMesh.h"
 
+#include <algorithm>
+#include <deque>
+
 #include "RawFile.h"
 
 #include "Game.h"
@@ -12,16 +15,141 @@
 #include "dZoneManager.h"
 #include "DluAssert.h"
 #include "DetourExtensions.h"
+#include "DetourCrowd.h"
+#include "LruCache.h"
+
+struct dNavMesh::PathCache {
+	using Key = std::pair<dtPolyRef, dtPolyRef>;
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			return std::hash<uint64_t>{}(static_cast<uint64_t>(key.first) * 0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(key.second));
+		}
+	};
+
+	// Copies a cached corridor into polys.  Returns how many polygons it has, or 0 if it is not cached.
+	int Find(const Key& key, dtPolyRef* polys) {
+		std::lock_guard lock(mutex);
+		const auto* corridor = corridors.Find(key);
+		if (!corridor) return 0;
+
+		std::copy(corridor->begin(), corridor->end(), polys);
+		return static_cast<int>(corridor->size());
+	}
+
+	void Insert(const Key& key, const dtPolyRef* polys, const int count) {
+		std::lock_guard lock(mutex);
+		corridors.Insert(key, std::vector<dtPolyRef>(polys, polys + count));
+	}
+
+	std::mutex mutex;
+
+	// The polygons to walk through from the start polygon to the end polygon.  The navmesh never changes,
+	// so a corridor stays valid for as long as it is cached.
+	LruCache<Key, std::vector<dtPolyRef>, KeyHash> corridors{ 1024 };
+};
+
+struct dNavMesh::SlicedQueue {
+	struct Request {
+		float startPos[3];
+		float endPos[3];
+		dtPolyRef startRef = 0;
+		dtPolyRef endRef = 0;
+		std::function<void(std::vector<NiPoint3>)> callback;
+	};
+
+	// Only used for sliced searches, since any other search would throw away the one in progress.
+	dtNavMeshQuery* query = nullptr;
+
+	// The query keeps a pointer to the filter until the search finishes.
+	dtQueryFilter filter{};
+
+	std::deque<Request> requests;
+
+	// If the query is part way through the request at the front.
+	bool searching = false;
+};
+
+namespace {
+	dtPolyRef FindNearestPoly(const dtNavMeshQuery* query, const float* pos, const dtQueryFilter& filter) {
+		// Entities almost always stand on the navmesh, so a small search box finds their polygon while
+		// visiting far fewer polygons than the wide search needed for points off the mesh.
+		const float nearExtents[3] = { 2.0f, 4.0f, 2.0f };
+		const float farExtents[3] = { 32.0f, 32.0f, 32.0f };
+
+		dtPolyRef ref = 0;
+		query->findNearestPoly(pos, nearExtents, &filter, &ref, 0);
+		if (!ref) query->findNearestPoly(pos, farExtents, &filter, &ref, 0);
+		return ref;
+	}
+
+	std::vector<NiPoint3> BuildStraightPath(const dtNavMeshQuery* query, const float* sPos, const float* ePos, const dtPolyRef endRef, const dtPolyRef* polys, const int npolys) {
+		// In case of partial path, make sure the end point is clamped to the last polygon.
+		float epos[3];
+		dtVcopy(epos, ePos);
+
+		if (polys[npolys - 1] != endRef) {
+			query->closestPointOnPoly(polys[npolys - 1], ePos, epos, 0);
+		}
+
+		int nstraightPath = 0;
+		float straightPath[MAX_POLYS * 3];
+		unsigned char straightPathFlags[MAX_POLYS];
+		dtPolyRef straightPathPolys[MAX_POLYS];
+
+		query->findStraightPath(sPos, epos, polys, npolys,
+			straightPath, straightPathFlags,
+			straightPathPolys, &nstraightPath, MAX_POLYS, 0);
+
+		// At this point we have our path. Copy it to the path store
+		std::vector<NiPoint3> path;
+		path.reserve(nstraightPath);
+		for (int nVert = 0; nVert < nstraightPath; nVert++) {
+			float* vert = &straightPath[nVert * 3];
+
+			// We already know which polygon each point is on, so its height comes straight from that polygon.
+			float height = 0.0f;
+			if (dtStatusSucceed(query->getPolyHeight(straightPathPolys[nVert], vert, &height))) vert[1] = height;
+
+			path.emplace_back(vert[0], vert[1], vert[2]);
+		}
+
+		return path;
+	}
+
+	// How many nodes a sliced search visits between checks of the time budget.
+	constexpr int SLICED_ITERATIONS = 32;
+
+	constexpr float CROWD_AGENT_RADIUS = 1.0f;
+	constexpr float CROWD_AGENT_HEIGHT = 4.0f;
+}
 
 dNavMesh::dNavMesh(uint32_t zoneId) {
 	m_ZoneId = zoneId;
 
 	this->LoadNavmesh();
 
+	Initialize();
+}
+
+dNavMesh::dNavMesh(dtNavMesh* navMesh) {
+	m_ZoneId = 0;
+	m_NavMesh = navMesh;
+
+	Initialize();
+}
+
+void dNavMesh::Initialize() {
+	m_PathCache = std::make_unique<PathCache>();
+	m_SlicedQueue = std::make_unique<SlicedQueue>();
+
 	if (m_NavMesh) {
 		m_NavQuery = dtAllocNavMeshQuery();
 		m_NavQuery->init(m_NavMesh, 2048);
 
+		m_SlicedQueue->query = dtAllocNavMeshQuery();
+		m_SlicedQueue->query->init(m_NavMesh, 2048);
+
 		LOG("Navmesh loaded successfully!");
 	} else {
 		LOG("Navmesh loading failed (This may be intended).");
@@ -29,12 +157,199 @@ dNavMesh::dNavMesh(uint32_t zoneId) {
 }
 
 dNavMesh::~dNavMesh() {
+	// Stop the workers first, they may still be using a query
+	m_Workers.reset();
+
 	// Clean up Recast information
 
+	if (m_Crowd) dtFreeCrowd(m_Crowd);
+	if (m_SlicedQueue->query) dtFreeNavMeshQuery(m_SlicedQueue->query);
+	for (auto* query : m_FreeQueries) dtFreeNavMeshQuery(query);
 	if (m_NavMesh) dtFreeNavMesh(m_NavMesh);
 	if (m_NavQuery) dtFreeNavMeshQuery(m_NavQuery);
 }
 
+void dNavMesh::StartWorkers(const uint32_t threadCount) {
+	if (threadCount == 0) return;
+	m_Workers = std::make_unique<WorkerPool>(threadCount);
+}
+
+void dNavMesh::GetPathAsync(const NiPoint3& startPos, const NiPoint3& endPos, const float speed, std::function<void(std::vector<NiPoint3>)> callback) {
+	if (m_Workers) {
+		m_Workers->Submit(
+			[this, startPos, endPos, speed]() {
+				auto* query = m_NavMesh ? AcquireQuery() : nullptr;
+				auto path = FindPath(query, startPos, endPos, speed);
+				if (query) ReleaseQuery(query);
+				return path;
+			},
+			std::move(callback)
+		);
+		return;
+	}
+
+	// Without a navmesh there is nothing to search.
+	if (m_NavMesh == nullptr) {
+		callback(GetPath(startPos, endPos, speed));
+		return;
+	}
+
+	auto& request = m_SlicedQueue->requests.emplace_back();
+	request.startPos[0] = startPos.x;
+	request.startPos[1] = startPos.y;
+	request.startPos[2] = startPos.z;
+	request.endPos[0] = endPos.x;
+	request.endPos[1] = endPos.y;
+	request.endPos[2] = endPos.z;
+	request.callback = std::move(callback);
+}
+
+void dNavMesh::ProcessCompletions() {
+	if (m_Workers) m_Workers->ProcessCompletions();
+	else if (m_NavMesh) ProcessSlicedRequests();
+}
+
+size_t dNavMesh::GetPendingPathCount() {
+	return m_Workers ? m_Workers->GetPendingCount() : m_SlicedQueue->requests.size();
+}
+
+void dNavMesh::ProcessSlicedRequests() {
+	auto& queue = *m_SlicedQueue;
+	const auto deadline = std::chrono::steady_clock::now() + m_PathBudget;
+
+	// Always get some searching done, so requests still finish with a budget that is too small.
+	do {
+		if (queue.requests.empty()) return;
+		auto& request = queue.requests.front();
+
+		if (!queue.searching) {
+			request.startRef = FindNearestPoly(queue.query, request.startPos, queue.filter);
+			request.endRef = FindNearestPoly(queue.query, request.endPos, queue.filter);
+			if (!request.startRef || !request.endRef) {
+				FinishSlicedRequest({});
+				continue;
+			}
+
+			dtPolyRef polys[MAX_POLYS];
+			const int npolys = m_PathCache->Find({ request.startRef, request.endRef }, polys);
+			if (npolys > 0) {
+				FinishSlicedRequest(BuildStraightPath(queue.query, request.startPos, request.endPos, request.endRef, polys, npolys));
+				continue;
+			}
+
+			queue.query->initSlicedFindPath(request.startRef, request.endRef, request.startPos, request.endPos, &queue.filter);
+			queue.searching = true;
+		}
+
+		if (dtStatusInProgress(queue.query->updateSlicedFindPath(SLICED_ITERATIONS, nullptr))) continue;
+
+		dtPolyRef polys[MAX_POLYS];
+		int npolys = 0;
+		queue.query->finalizeSlicedFindPath(polys, &npolys, MAX_POLYS);
+		queue.searching = false;
+
+		if (npolys == 0) {
+			FinishSlicedRequest({});
+			continue;
+		}
+
+		m_PathCache->Insert({ request.startRef, request.endRef }, polys, npolys);
+		FinishSlicedRequest(BuildStraightPath(queue.query, request.startPos, request.endPos, request.endRef, polys, npolys));
+	} while (std::chrono::steady_clock::now() < deadline);
+}
+
+void dNavMesh::FinishSlicedRequest(std::vector<NiPoint3> path) {
+	// The callback may ask for another path, so the request has to be out of the queue first.
+	auto callback = std::move(m_SlicedQueue->requests.front().callback);
+	m_SlicedQueue->requests.pop_front();
+	callback(std::move(path));
+}
+
+void dNavMesh::StartCrowd(const uint32_t maxAgents) {
+	if (maxAgents == 0 || m_NavMesh == nullptr) return;
+
+	m_Crowd = dtAllocCrowd();
+	if (!m_Crowd->init(static_cast<int>(maxAgents), CROWD_AGENT_RADIUS, m_NavMesh)) {
+		LOG("Failed to start a crowd of %i agents", maxAgents);
+		dtFreeCrowd(m_Crowd);
+		m_Crowd = nullptr;
+	}
+}
+
+int32_t dNavMesh::AddCrowdAgent(const NiPoint3& position, const float maxSpeed) {
+	const float pos[3] = { position.x, position.y, position.z };
+
+	dtCrowdAgentParams params{};
+	params.radius = CROWD_AGENT_RADIUS;
+	params.height = CROWD_AGENT_HEIGHT;
+	params.maxAcceleration = maxSpeed * 4.0f;
+	params.maxSpeed = maxSpeed;
+	params.collisionQueryRange = CROWD_AGENT_RADIUS * 12.0f;
+	params.pathOptimizationRange = CROWD_AGENT_RADIUS * 30.0f;
+	params.separationWeight = 2.0f;
+	params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION;
+	params.obstacleAvoidanceType = 3;
+	return m_Crowd->addAgent(pos, &params);
+}
+
+void dNavMesh::RemoveCrowdAgent(const int32_t agent) {
+	m_Crowd->removeAgent(agent);
+}
+
+void dNavMesh::SetCrowdAgentTarget(const int32_t agent, const NiPoint3& target, const float maxSpeed) {
+	const auto* crowdAgent = m_Crowd->getAgent(agent);
+	if (!crowdAgent || !crowdAgent->active) return;
+
+	if (crowdAgent->params.maxSpeed != maxSpeed) {
+		auto params = crowdAgent->params;
+		params.maxSpeed = maxSpeed;
+		params.maxAcceleration = maxSpeed * 4.0f;
+		m_Crowd->updateAgentParameters(agent, &params);
+	}
+
+	const float pos[3] = { target.x, target.y, target.z };
+	const auto ref = FindNearestPoly(m_NavQuery, pos, *m_Crowd->getFilter(crowdAgent->params.queryFilterType));
+	if (ref) m_Crowd->requestMoveTarget(agent, ref, pos);
+}
+
+void dNavMesh::ResetCrowdAgentTarget(const int32_t agent) {
+	m_Crowd->resetMoveTarget(agent);
+}
+
+NiPoint3 dNavMesh::GetCrowdAgentPosition(const int32_t agent) {
+	const auto* crowdAgent = m_Crowd->getAgent(agent);
+	return crowdAgent ? NiPoint3(crowdAgent->npos[0], crowdAgent->npos[1], crowdAgent->npos[2]) : NiPoint3Constant::ZERO;
+}
+
+NiPoint3 dNavMesh::GetCrowdAgentVelocity(const int32_t agent) {
+	const auto* crowdAgent = m_Crowd->getAgent(agent);
+	return crowdAgent ? NiPoint3(crowdAgent->vel[0], crowdAgent->vel[1], crowdAgent->vel[2]) : NiPoint3Constant::ZERO;
+}
+
+void dNavMesh::UpdateCrowd(const float deltaTime) {
+	if (m_Crowd) m_Crowd->update(deltaTime, nullptr);
+}
+
+dtNavMeshQuery* dNavMesh::AcquireQuery() {
+	{
+		std::lock_guard lock(m_QueryMutex);
+		if (!m_FreeQueries.empty()) {
+			auto* query = m_FreeQueries.back();
+			m_FreeQueries.pop_back();
+			return query;
+		}
+	}
+
+	auto* query = dtAllocNavMeshQuery();
+	query->init(m_NavMesh, 2048);
+	return query;
+}
+
+void dNavMesh::ReleaseQuery(dtNavMeshQuery* query) {
+	std::lock_guard lock(m_QueryMutex);
+	m_FreeQueries.push_back(query);
+}
+
 
 void dNavMesh::LoadNavmesh() {
 
@@ -175,6 +490,10 @@ float dNavMesh::GetHeightAtPoint(const NiPoint3& location, const float halfExten
 }
 
 std::vector<NiPoint3> dNavMesh::GetPath(const NiPoint3& startPos, const NiPoint3& endPos, float speed) {
+	return FindPath(m_NavQuery, startPos, endPos, speed);
+}
+
+std::vector<NiPoint3> dNavMesh::FindPath(dtNavMeshQuery* query, const NiPoint3& startPos, const NiPoint3& endPos, float speed) {
 	std::vector<NiPoint3> path;
 
 	// Allows for non-navmesh maps (like new custom maps) to have "basic" enemies.
@@ -211,54 +530,22 @@ std::vector<NiPoint3> dNavMesh::GetPath(const NiPoint3& startPos, const NiPoint3
 	ePos[1] = endPos.y;
 	ePos[2] = endPos.z;
 
-	dtStatus pathFindStatus;
-	dtPolyRef startRef;
-	dtPolyRef endRef;
-	float polyPickExt[3] = { 32.0f, 32.0f, 32.0f };
 	dtQueryFilter filter{};
 
-	//Find our start poly
-	m_NavQuery->findNearestPoly(sPos, polyPickExt, &filter, &startRef, 0);
-
-	//Find our end poly
-	m_NavQuery->findNearestPoly(ePos, polyPickExt, &filter, &endRef, 0);
-
-	pathFindStatus = DT_FAILURE;
-	int m_nstraightPath = 0;
-	int m_npolys = 0;
-	dtPolyRef m_polys[MAX_POLYS];
-	float m_straightPath[MAX_POLYS * 3];
-	unsigned char m_straightPathFlags[MAX_POLYS];
-	dtPolyRef m_straightPathPolys[MAX_POLYS];
-	int m_straightPathOptions = 0;
-
-	if (startRef && endRef) {
-		m_NavQuery->findPath(startRef, endRef, sPos, ePos, &filter, m_polys, &m_npolys, MAX_POLYS);
+	//Find our start and end poly
+	const dtPolyRef startRef = FindNearestPoly(query, sPos, filter);
+	const dtPolyRef endRef = FindNearestPoly(query, ePos, filter);
+	if (!startRef || !endRef) return path;
 
-		if (m_npolys) {
-			// In case of partial path, make sure the end point is clamped to the last polygon.
-			float epos[3];
-			dtVcopy(epos, ePos);
+	dtPolyRef polys[MAX_POLYS];
+	const auto key = std::make_pair(startRef, endRef);
+	int npolys = m_PathCache->Find(key, polys);
+	if (npolys == 0) {
+		query->findPath(startRef, endRef, sPos, ePos, &filter, polys, &npolys, MAX_POLYS);
+		if (npolys == 0) return path;
 
-			if (m_polys[m_npolys - 1] != endRef) {
-				m_NavQuery->closestPointOnPoly(m_polys[m_npolys - 1], ePos, epos, 0);
-			}
-
-			m_NavQuery->findStraightPath(sPos, epos, m_polys, m_npolys,
-				m_straightPath, m_straightPathFlags,
-				m_straightPathPolys, &m_nstraightPath, MAX_POLYS, m_straightPathOptions);
-
-			// At this point we have our path. Copy it to the path store
-			int nIndex = 0;
-			for (int nVert = 0; nVert < m_nstraightPath; nVert++) {
-				NiPoint3 newPoint{ m_straightPath[nIndex++], m_straightPath[nIndex++], m_straightPath[nIndex++] };
-				path.push_back(newPoint);
-			}
-		}
-	} else {
-		m_npolys = 0;
-		m_nstraightPath = 0;
+		m_PathCache->Insert(key, polys, npolys);
 	}
 
-	return path;
+	return BuildStraightPath(query, sPos, ePos, endRef, polys, npolys);
 }
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#include "WorkerPool.h"
+
 class NiPoint3;
 class rcHeightfield;
 class rcCompactHeightfield;
@@ -12,11 +18,18 @@ class rcPolyMeshDetail;
 class InputGeom;
 class dtNavMesh;
 class dtNavMeshQuery;
+class dtCrowd;
 class rcContext;
 
 class dNavMesh {
 public:
 	dNavMesh(uint32_t zoneId);
+
+	/**
+	 * Uses a navmesh built in memory instead of loading the one for a zone, and takes ownership of it.
+	 * Used by tests.
+	 */
+	explicit dNavMesh(dtNavMesh* navMesh);
 	~dNavMesh();
 
 	/**
@@ -28,16 +41,101 @@ public:
 	 * @return float The height at the point. If the point is not on the navmesh, the height of the point is returned.
 	 */
 	float GetHeightAtPoint(const NiPoint3& location, const float halfExtentsHeight = 32.0f) const;
+
+	/**
+	 * Finds a path on the game thread.  The points of the path are already on the navmesh, so they need no
+	 * height correction.
+	 */
 	std::vector<NiPoint3> GetPath(const NiPoint3& startPos, const NiPoint3& endPos, float speed = 10.0f);
 	NiPoint3 NearestPoint(const NiPoint3& location, const float halfExtent = 32.0f) const;
 	bool IsNavmeshLoaded() { return m_NavMesh != nullptr; }
 
+	/**
+	 * Moves path finding onto worker threads.  The navmesh is never changed after loading, so workers only need their own query.
+	 * @param threadCount How many threads find paths.  With 0, paths are found on the game thread within the path budget.
+	 */
+	void StartWorkers(uint32_t threadCount);
+
+	/**
+	 * Sets how long the game thread may spend finding paths each tick when there are no workers.  Searches that do not
+	 * fit carry on in the next tick, so a wave of enemies spawning at once spreads its searches over a few ticks.
+	 */
+	void SetPathBudget(std::chrono::microseconds budget) { m_PathBudget = budget; }
+
+	/**
+	 * Finds a path the same way GetPath does, on a worker thread or a bit at a time on the game thread.
+	 * @param callback Receives the path.  It runs on the thread calling ProcessCompletions, so it may touch game state.
+	 */
+	void GetPathAsync(const NiPoint3& startPos, const NiPoint3& endPos, float speed, std::function<void(std::vector<NiPoint3>)> callback);
+
+	/**
+	 * Runs the callbacks of every path that has been found.  Called once per tick from the game thread.
+	 */
+	void ProcessCompletions();
+
+	// @return How many paths have been asked for whose callbacks have not run yet.
+	[[nodiscard]] size_t GetPendingPathCount();
+
+	/**
+	 * Lets entities that chase targets steer around each other instead of following their own paths, with a Detour crowd.
+	 * @param maxAgents How many entities can be steered at once.  With 0, there is no crowd.
+	 */
+	void StartCrowd(uint32_t maxAgents);
+
+	bool HasCrowd() const { return m_Crowd != nullptr; }
+
+	/**
+	 * @return The index of the new agent, or -1 if the crowd is full
+	 */
+	int32_t AddCrowdAgent(const NiPoint3& position, float maxSpeed);
+	void RemoveCrowdAgent(int32_t agent);
+	void SetCrowdAgentTarget(int32_t agent, const NiPoint3& target, float maxSpeed);
+	void ResetCrowdAgentTarget(int32_t agent);
+	NiPoint3 GetCrowdAgentPosition(int32_t agent);
+	NiPoint3 GetCrowdAgentVelocity(int32_t agent);
+
+	/**
+	 * Moves every crowd agent.  Called once per tick from the game thread, before entities are updated.
+	 */
+	void UpdateCrowd(float deltaTime);
+
 private:
+	// Recently found polygon corridors, defined with the Detour types in the source file.
+	struct PathCache;
+
+	// Paths being found on the game thread, also defined in the source file.
+	struct SlicedQueue;
+
 	void LoadNavmesh();
 
+	// Sets up the queries and caches once m_NavMesh is known.
+	void Initialize();
+
+	std::vector<NiPoint3> FindPath(dtNavMeshQuery* query, const NiPoint3& startPos, const NiPoint3& endPos, float speed);
+
+	void ProcessSlicedRequests();
+	void FinishSlicedRequest(std::vector<NiPoint3> path);
+
+	// Queries keep search state, so each thread finding a path takes one from the pool and gives it back after.
+	dtNavMeshQuery* AcquireQuery();
+	void ReleaseQuery(dtNavMeshQuery* query);
+
 	uint32_t m_ZoneId;
 
 	dtNavMesh* m_NavMesh = nullptr;
+	// Used by the game thread.
 	dtNavMeshQuery* m_NavQuery = nullptr;
 	uint8_t m_NavMeshDrawFlags;
+
+	std::unique_ptr<PathCache> m_PathCache;
+
+	std::mutex m_QueryMutex;
+	std::vector<dtNavMeshQuery*> m_FreeQueries;
+
+	std::unique_ptr<WorkerPool> m_Workers;
+
+	std::unique_ptr<SlicedQueue> m_SlicedQueue;
+	std::chrono::microseconds m_PathBudget{ 2000 };
+
+	dtCrowd* m_Crowd = nullptr;
 };
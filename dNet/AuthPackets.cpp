@@ -24,8 +24,22 @@
 #include "MessageType/Master.h"
 #include "eGameMasterLevel.h"
 #include "StringifiedEnum.h"
+#include "WorkerPool.h"
+#include "Metrics.hpp"
+
 namespace {
 	std::vector<uint32_t> claimCodes;
+
+	std::unique_ptr<WorkerPool> passwordWorkers;
+	// 0 lets any number of logins wait.
+	uint32_t maxPendingLogins = 0;
+
+	// Queue statistics since the last LogLoginQueueStats.
+	size_t peakPendingLogins = 0;
+	uint32_t loginsChecked = 0;
+	uint32_t loginsTurnedAway = 0;
+
+	void FinishLogin(dServer* server, const SystemAddress& system, const std::string& username, const uint32_t accountId, std::vector<Stamp>& stamps, const bool loginSuccess);
 }
 
 void Stamp::Serialize(RakNet::BitStream& outBitStream){
@@ -206,28 +220,93 @@ void AuthPackets::HandleLoginRequest(dServer* server, Packet* packet) {
 		return;
 	}
 
-	bool loginSuccess = ::bcrypt_checkpw(password.GetAsString().c_str(), accountInfo->bcryptPassword.c_str()) == 0;
+	SystemAddress system = packet->systemAddress; //Copy the sysAddr before the Packet gets destroyed from main
 
-	if (!loginSuccess) {
+	if (!passwordWorkers) {
+		const bool loginSuccess = ::bcrypt_checkpw(password.GetAsString().c_str(), accountInfo->bcryptPassword.c_str()) == 0;
+		FinishLogin(server, system, username, accountInfo->id, stamps, loginSuccess);
+		return;
+	}
+
+	const auto pendingLogins = passwordWorkers->GetPendingCount();
+	if (maxPendingLogins != 0 && pendingLogins >= maxPendingLogins) {
+		loginsTurnedAway++;
 		stamps.emplace_back(eStamps::PASSPORT_AUTH_ERROR, 1);
-		AuthPackets::SendLoginResponse(server, packet->systemAddress, eLoginResponse::WRONG_PASS, "", "", 2001, username, stamps);
-		LOG("Wrong password used");
-	} else {
-		SystemAddress system = packet->systemAddress; //Copy the sysAddr before the Packet gets destroyed from main
-
-		if (!server->GetIsConnectedToMaster()) {
-			stamps.emplace_back(eStamps::PASSPORT_AUTH_WORLD_DISCONNECT, 1);
-			AuthPackets::SendLoginResponse(server, system, eLoginResponse::GENERAL_FAILED, "", "", 0, username, stamps);
-			return;
+		AuthPackets::SendLoginResponse(server, system, eLoginResponse::GENERAL_FAILED, "The server is busy, please try again in a moment.", "", 2001, username, stamps);
+		return;
+	}
+	peakPendingLogins = std::max(peakPendingLogins, pendingLogins + 1);
+
+	passwordWorkers->Submit(
+		[password = password.GetAsString(), hash = accountInfo->bcryptPassword]() {
+			return ::bcrypt_checkpw(password.c_str(), hash.c_str()) == 0;
+		},
+		[server, system, username, accountId = accountInfo->id, stamps](bool loginSuccess, std::exception_ptr error) mutable {
+			// A password check that threw leaves loginSuccess false, so the login fails instead of taking the server down.
+			if (error) LOG("Password check for %s threw", username.c_str());
+			FinishLogin(server, system, username, accountId, stamps, loginSuccess);
 		}
-		stamps.emplace_back(eStamps::PASSPORT_AUTH_WORLD_SESSION_CONFIRM_TO_AUTH, 1);
-		ZoneInstanceManager::Instance()->RequestZoneTransfer(server, 0, 0, false, [system, server, username, stamps](bool mythranShift, uint32_t zoneID, uint32_t zoneInstance, uint32_t zoneClone, std::string zoneIP, uint16_t zonePort) mutable {
-			AuthPackets::SendLoginResponse(server, system, eLoginResponse::SUCCESS, "", zoneIP, zonePort, username, stamps);
-			});
+	);
+}
+
+void AuthPackets::StartPasswordWorkers(const uint32_t threadCount, const uint32_t maxPending) {
+	if (threadCount == 0) return;
+
+	// The main loop sleeps until a packet arrives, so wake it up to answer the login.
+	passwordWorkers = std::make_unique<WorkerPool>(threadCount, []() { Game::server->WakeUp(); });
+	maxPendingLogins = maxPending;
+	if (maxPending == 0) LOG("Checking passwords on %i threads with no limit on logins waiting", threadCount);
+	else LOG("Checking passwords on %i threads with up to %i logins waiting", threadCount, maxPending);
+}
+
+void AuthPackets::StopPasswordWorkers() {
+	passwordWorkers.reset();
+}
+
+void AuthPackets::ProcessPasswordChecks() {
+	if (passwordWorkers) passwordWorkers->ProcessCompletions();
+}
+
+size_t AuthPackets::GetPendingLoginCount() {
+	return passwordWorkers ? passwordWorkers->GetPendingCount() : 0;
+}
+
+void AuthPackets::LogLoginQueueStats() {
+	if (loginsChecked == 0 && loginsTurnedAway == 0) return;
+
+	LOG("Logins: %i checked, %i turned away, %llu waiting, at most %llu waiting", loginsChecked, loginsTurnedAway, GetPendingLoginCount(), peakPendingLogins);
+	if (const auto* zoneTransfers = Metrics::GetMetric(MetricVariable::ZoneTransfer)) {
+		LOG("Zone transfers took %.2fms on average, %.2fms at most", Metrics::ToMiliseconds(zoneTransfers->average), Metrics::ToMiliseconds(zoneTransfers->max));
+		Metrics::Clear(MetricVariable::ZoneTransfer);
 	}
+	loginsChecked = 0;
+	loginsTurnedAway = 0;
+	peakPendingLogins = GetPendingLoginCount();
+}
+
+namespace {
+	void FinishLogin(dServer* server, const SystemAddress& system, const std::string& username, const uint32_t accountId, std::vector<Stamp>& stamps, const bool loginSuccess) {
+		loginsChecked++;
 
-	for(auto const code: claimCodes){
-		Database::Get()->InsertRewardCode(accountInfo->id, code);
+		if (!loginSuccess) {
+			stamps.emplace_back(eStamps::PASSPORT_AUTH_ERROR, 1);
+			AuthPackets::SendLoginResponse(server, system, eLoginResponse::WRONG_PASS, "", "", 2001, username, stamps);
+			LOG("Wrong password used");
+		} else {
+			if (!server->GetIsConnectedToMaster()) {
+				stamps.emplace_back(eStamps::PASSPORT_AUTH_WORLD_DISCONNECT, 1);
+				AuthPackets::SendLoginResponse(server, system, eLoginResponse::GENERAL_FAILED, "", "", 0, username, stamps);
+				return;
+			}
+			stamps.emplace_back(eStamps::PASSPORT_AUTH_WORLD_SESSION_CONFIRM_TO_AUTH, 1);
+			ZoneInstanceManager::Instance()->RequestZoneTransfer(server, 0, 0, false, [system, server, username, stamps](bool mythranShift, uint32_t zoneID, uint32_t zoneInstance, uint32_t zoneClone, std::string zoneIP, uint16_t zonePort) mutable {
+				AuthPackets::SendLoginResponse(server, system, eLoginResponse::SUCCESS, "", zoneIP, zonePort, username, stamps);
+				});
+		}
+
+		for(auto const code: claimCodes){
+			Database::Get()->InsertRewardCode(accountId, code);
+		}
 	}
 }
 
@@ -99,6 +99,22 @@ namespace AuthPackets {
 	void SendLoginResponse(dServer* server, const SystemAddress& sysAddr, eLoginResponse responseCode, const std::string& errorMsg, const std::string& wServerIP, uint16_t wServerPort, std::string username, std::vector<Stamp>& stamps);
 	void LoadClaimCodes();
 
+	/**
+	 * Moves password checks onto worker threads so a burst of logins does not stall the auth server.
+	 * @param threadCount How many passwords are checked at once.  With 0, passwords are checked inline.
+	 * @param maxPendingLogins How many logins may wait for a password check before new ones are turned away, or 0 for no limit.
+	 */
+	void StartPasswordWorkers(uint32_t threadCount, uint32_t maxPendingLogins);
+	void StopPasswordWorkers();
+
+	// Finishes the logins whose password check is done.  Called from the main loop.
+	void ProcessPasswordChecks();
+
+	// How many logins are waiting on a password check.
+	size_t GetPendingLoginCount();
+
+	// Logs how deep the password check queue got since the last call, if any logins came in.
+	void LogLoginQueueStats();
 }
 
 #endif // AUTHPACKETS_H
@@ -55,7 +55,7 @@ void ChatPackets::SendChatMessage(const SystemAddress& sysAddr, char chatChannel
 	}
 	bitStream.Write<uint16_t>(0);
 
-	SEND_PACKET_BROADCAST;
+	Game::server->Send(bitStream, UNASSIGNED_SYSTEM_ADDRESS, true, eQosClass::CHAT);
 }
 
 void ChatPackets::SendSystemMessage(const SystemAddress& sysAddr, const std::u16string& message, const bool broadcast) {
@@ -80,11 +80,11 @@ void ChatPackets::SendSystemMessage(const SystemAddress& sysAddr, const std::u16
 
 	//This is so Wincent's announcement works:
 	if (sysAddr != UNASSIGNED_SYSTEM_ADDRESS) {
-		SEND_PACKET;
+		Game::server->Send(bitStream, sysAddr, false, eQosClass::CHAT);
 		return;
 	}
 
-	SEND_PACKET_BROADCAST;
+	Game::server->Send(bitStream, UNASSIGNED_SYSTEM_ADDRESS, true, eQosClass::CHAT);
 }
 
 void ChatPackets::SendMessageFail(const SystemAddress& sysAddr) {
@@ -95,5 +95,5 @@ void ChatPackets::SendMessageFail(const SystemAddress& sysAddr) {
 	BitStreamUtils::WriteHeader(bitStream, eConnectionType::CLIENT, MessageType::Client::SEND_CANNED_TEXT);
 	bitStream.Write<uint8_t>(0); //response type, options above ^
 	//docs say there's a wstring here-- no idea what it's for, or if it's even needed so leaving it as is for now.
-	SEND_PACKET;
+	Game::server->Send(bitStream, sysAddr, false, eQosClass::CHAT);
 }
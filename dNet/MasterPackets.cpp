@@ -77,6 +77,20 @@ void MasterPackets::SendWorldReady(dServer* server, LWOMAPID zoneId, LWOINSTANCE
 	server->SendToMaster(bitStream);
 }
 
+void MasterPackets::SendWorldLoad(dServer* server, LWOMAPID zoneId, LWOINSTANCEID instanceId, uint32_t players, int64_t cpuTimePerFrame, int64_t frameTime, uint64_t rss) {
+	RakNet::BitStream bitStream;
+	BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::WORLD_LOAD);
+
+	bitStream.Write(zoneId);
+	bitStream.Write(instanceId);
+	bitStream.Write(players);
+	bitStream.Write(cpuTimePerFrame);
+	bitStream.Write(frameTime);
+	bitStream.Write(rss);
+
+	server->SendToMaster(bitStream);
+}
+
 void MasterPackets::SendZoneTransferResponse(dServer* server, const SystemAddress& sysAddr, uint64_t requestID, bool mythranShift, uint32_t zoneID, uint32_t zoneInstance, uint32_t zoneClone, const std::string& serverIP, uint32_t serverPort) {
 	RakNet::BitStream bitStream;
 	BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::REQUEST_ZONE_TRANSFER_RESPONSE);
@@ -23,6 +23,14 @@ namespace MasterPackets {
 
 	void SendWorldReady(dServer* server, LWOMAPID zoneId, LWOINSTANCEID instanceId);
 
+	/**
+	 * Tells master how busy this world server is, so it can place new instances and transfers on the least loaded host.
+	 * @param cpuTimePerFrame Average CPU time per frame, in nanoseconds
+	 * @param frameTime Average length of a frame, including sleep, in nanoseconds
+	 * @param rss Resident memory in bytes
+	 */
+	void SendWorldLoad(dServer* server, LWOMAPID zoneId, LWOINSTANCEID instanceId, uint32_t players, int64_t cpuTimePerFrame, int64_t frameTime, uint64_t rss);
+
 	void HandleSetSessionKey(Packet* packet);
 }
 
@@ -4,6 +4,7 @@
 // Custom Classes
 #include "MasterPackets.h"
 #include "dServer.h"
+#include "Metrics.hpp"
 
 // C++
 #include <future>
@@ -45,6 +46,10 @@ void ZoneInstanceManager::HandleRequestZoneTransferResponse(Packet* packet) {
 
 	for (uint32_t i = 0; i < this->requests.size(); ++i) {
 		if (this->requests[i]->requestID == requestID) {
+			// From asking master to hearing back, including any wait for the instance to start and affirm.
+			const auto elapsed = std::chrono::steady_clock::now() - this->requests[i]->requestedAt;
+			Metrics::AddMeasurement(MetricVariable::ZoneTransfer, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
 
 			// Call the request callback
 			this->requests[i]->callback(mythranShift, zoneID, zoneInstance, zoneClone, serverIP.string, serverPort);
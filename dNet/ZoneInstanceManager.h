@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <vector>
 #include <string>
@@ -18,6 +19,7 @@ class dServer;
 struct ZoneTransferRequest {
 	uint64_t requestID;
 	std::function<void(bool, uint32_t, uint32_t, uint32_t, std::string, uint16_t)> callback;
+	std::chrono::steady_clock::time_point requestedAt = std::chrono::steady_clock::now();
 };
 
 //! The zone manager
@@ -106,44 +106,55 @@ Packet* dServer::ReceiveFromMaster() {
 	if (!mMasterConnectionActive) ConnectToMaster();
 
 	Packet* packet = mMasterPeer->Receive();
-	if (packet) {
-		if (packet->length < 1) { mMasterPeer->DeallocatePacket(packet); return nullptr; }
+	return packet ? HandleMasterPacket(packet) : nullptr;
+}
 
-		if (packet->data[0] == ID_DISCONNECTION_NOTIFICATION || packet->data[0] == ID_CONNECTION_LOST) {
-			LOG("Lost our connection to master, shutting DOWN!");
-			mMasterConnectionActive = false;
-			//ConnectToMaster(); //We'll just shut down now
-		}
+void dServer::HandleMasterPackets() {
+	if (!mMasterPeer) return;
+	if (!mMasterConnectionActive) ConnectToMaster();
 
-		if (packet->data[0] == ID_CONNECTION_REQUEST_ACCEPTED) {
-			LOG("Established connection to master, zone (%i), instance (%i)", this->GetZoneID(), this->GetInstanceID());
-			mMasterConnectionActive = true;
-			mMasterSystemAddress = packet->systemAddress;
-			MasterPackets::SendServerInfo(this, packet);
-		}
+	for (Packet* packet = mMasterPeer->Receive(); packet; packet = mMasterPeer->Receive()) {
+		Packet* unhandled = HandleMasterPacket(packet);
+		if (unhandled) mMasterPeer->DeallocatePacket(unhandled);
+	}
+}
 
-		if (packet->data[0] == ID_USER_PACKET_ENUM) {
-			if (static_cast<eConnectionType>(packet->data[1]) == eConnectionType::MASTER) {
-				switch (static_cast<MessageType::Master>(packet->data[3])) {
-				case MessageType::Master::REQUEST_ZONE_TRANSFER_RESPONSE: {
-					ZoneInstanceManager::Instance()->HandleRequestZoneTransferResponse(packet);
-					break;
-				}
-				case MessageType::Master::SHUTDOWN:
-					*mShouldShutdown = -2;
-					break;
-
-				//When we handle these packets in World instead dServer, we just return the packet's pointer.
-				default:
-
-					return packet;
-				}
+Packet* dServer::HandleMasterPacket(Packet* packet) {
+	if (packet->length < 1) { mMasterPeer->DeallocatePacket(packet); return nullptr; }
+
+	if (packet->data[0] == ID_DISCONNECTION_NOTIFICATION || packet->data[0] == ID_CONNECTION_LOST) {
+		LOG("Lost our connection to master, shutting DOWN!");
+		mMasterConnectionActive = false;
+		//ConnectToMaster(); //We'll just shut down now
+	}
+
+	if (packet->data[0] == ID_CONNECTION_REQUEST_ACCEPTED) {
+		LOG("Established connection to master, zone (%i), instance (%i)", this->GetZoneID(), this->GetInstanceID());
+		mMasterConnectionActive = true;
+		mMasterSystemAddress = packet->systemAddress;
+		MasterPackets::SendServerInfo(this, packet);
+	}
+
+	if (packet->data[0] == ID_USER_PACKET_ENUM) {
+		if (static_cast<eConnectionType>(packet->data[1]) == eConnectionType::MASTER) {
+			switch (static_cast<MessageType::Master>(packet->data[3])) {
+			case MessageType::Master::REQUEST_ZONE_TRANSFER_RESPONSE: {
+				ZoneInstanceManager::Instance()->HandleRequestZoneTransferResponse(packet);
+				break;
 			}
-		}
+			case MessageType::Master::SHUTDOWN:
+				*mShouldShutdown = -2;
+				break;
 
-		mMasterPeer->DeallocatePacket(packet);
+			//When we handle these packets in World instead dServer, we just return the packet's pointer.
+			default:
+
+				return packet;
+			}
+		}
 	}
 
+	mMasterPeer->DeallocatePacket(packet);
 	return nullptr;
 }
 
@@ -151,6 +162,24 @@ Packet* dServer::Receive() {
 	return mPeer->Receive();
 }
 
+void dServer::WaitForPackets(const std::chrono::steady_clock::time_point deadline) {
+	std::unique_lock lock(mWakeMutex);
+	mWakeCondition.wait_until(lock, deadline, [this]() { return mWakeRequested; });
+	mWakeRequested = false;
+}
+
+void dServer::WakeUp() {
+	{
+		std::lock_guard lock(mWakeMutex);
+		mWakeRequested = true;
+	}
+	mWakeCondition.notify_one();
+}
+
+void dServer::OnPacketArrived(void* server) {
+	static_cast<dServer*>(server)->WakeUp();
+}
+
 void dServer::DeallocatePacket(Packet* packet) {
 	mPeer->DeallocatePacket(packet);
 }
@@ -159,8 +188,9 @@ void dServer::DeallocateMasterPacket(Packet* packet) {
 	mMasterPeer->DeallocatePacket(packet);
 }
 
-void dServer::Send(RakNet::BitStream& bitStream, const SystemAddress& sysAddr, bool broadcast) {
-	mPeer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, sysAddr, broadcast);
+void dServer::Send(RakNet::BitStream& bitStream, const SystemAddress& sysAddr, bool broadcast, eQosClass qosClass) {
+	const auto parameters = GetSendParameters(qosClass);
+	mPeer->Send(&bitStream, parameters.priority, parameters.reliability, parameters.orderingChannel, sysAddr, broadcast);
 }
 
 void dServer::SendToMaster(RakNet::BitStream& bitStream) {
@@ -186,6 +216,7 @@ bool dServer::Startup() {
 	mPeer = RakNetworkFactory::GetRakPeerInterface();
 
 	if (!mPeer) return false;
+	mPeer->SetPacketArrivalCallback(&dServer::OnPacketArrived, this);
 	if (!mPeer->Startup(mMaxConnections, 10, &mSocketDescriptor, 1)) return false;
 
 	if (mIsInternal) {
@@ -237,7 +268,8 @@ void dServer::Shutdown() {
 void dServer::SetupForMasterConnection() {
 	mMasterSocketDescriptor = SocketDescriptor(uint16_t(mPort + 1), 0);
 	mMasterPeer = RakNetworkFactory::GetRakPeerInterface();
-	bool ret = mMasterPeer->Startup(1, 30, &mMasterSocketDescriptor, 1);
+	mMasterPeer->SetPacketArrivalCallback(&dServer::OnPacketArrived, this);
+	bool ret = mMasterPeer->Startup(1, 10, &mMasterSocketDescriptor, 1);
 	if (!ret) LOG("Failed MasterPeer Startup!");
 }
 
@@ -1,10 +1,13 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include <condition_variable>
 #include <csignal>
+#include <mutex>
 #include "RakPeerInterface.h"
 #include "ReplicaManager.h"
 #include "NetworkIDManager.h"
+#include "eQosClass.h"
 
 class Logger;
 class dConfig;
@@ -29,6 +32,33 @@ namespace Game {
 	using signal_t = volatile std::sig_atomic_t;
 }
 
+struct SendParameters {
+	PacketPriority priority;
+	PacketReliability reliability;
+	char orderingChannel;
+};
+
+/**
+ * How dServer::Send delivers each class of message.
+ *
+ * State and gameplay share ordering channel 0.  Game messages name objects that replica packets construct,
+ * and the client drops a game message for an object it has not constructed yet, so the two have to stay
+ * in order with each other.  Chat and bulk traffic get channels of their own, so their lost datagrams and
+ * large split packets no longer hold up the game.
+ */
+constexpr SendParameters GetSendParameters(const eQosClass qosClass) {
+	switch (qosClass) {
+	case eQosClass::CHAT:
+		return { MEDIUM_PRIORITY, RELIABLE_ORDERED, 1 };
+	case eQosClass::BULK:
+		return { LOW_PRIORITY, RELIABLE_ORDERED, 2 };
+	case eQosClass::STATE:
+	case eQosClass::GAMEPLAY:
+	default:
+		return { SYSTEM_PRIORITY, RELIABLE_ORDERED, 0 };
+	}
+}
+
 class dServer {
 public:
 	// Default constructor should only used for testing!
@@ -51,9 +81,25 @@ public:
 
 	Packet* ReceiveFromMaster();
 	Packet* Receive();
+
+	/**
+	 * Handles every packet waiting from master, dropping any that ReceiveFromMaster would have handed back.
+	 * For servers that have nothing of their own to do with packets from master.
+	 */
+	void HandleMasterPackets();
+
+	/**
+	 * Sleeps until a packet from a client or from master is ready to be received, WakeUp is called or the
+	 * deadline passes.  Returns right away if any of those happened since the last call.
+	 */
+	void WaitForPackets(std::chrono::steady_clock::time_point deadline);
+
+	// Wakes up WaitForPackets.  Safe to call from any thread.
+	void WakeUp();
+
 	void DeallocatePacket(Packet* packet);
 	void DeallocateMasterPacket(Packet* packet);
-	virtual void Send(RakNet::BitStream& bitStream, const SystemAddress& sysAddr, bool broadcast);
+	virtual void Send(RakNet::BitStream& bitStream, const SystemAddress& sysAddr, bool broadcast, eQosClass qosClass = eQosClass::GAMEPLAY);
 	void SendToMaster(RakNet::BitStream& bitStream);
 
 	void Disconnect(const SystemAddress& sysAddr, eServerDisconnectIdentifiers disconNotifyID);
@@ -92,6 +138,12 @@ private:
 	void SetupForMasterConnection();
 	bool ConnectToMaster();
 
+	// Handles the packets from master that every server handles the same way.  Returns the packet if the caller should handle it.
+	Packet* HandleMasterPacket(Packet* packet);
+
+	// Called on the RakNet threads whenever a packet is queued.
+	static void OnPacketArrived(void* server);
+
 protected:
 	Logger* mLogger = nullptr;
 	dConfig* mConfig = nullptr;
@@ -121,4 +173,8 @@ protected:
 	std::string mMasterIP;
 	int mMasterPort;
 	std::chrono::steady_clock::time_point mStartTime = std::chrono::steady_clock::now();
+
+	std::mutex mWakeMutex;
+	std::condition_variable mWakeCondition;
+	bool mWakeRequested = false;
 };
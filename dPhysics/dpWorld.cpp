@@ -120,6 +120,10 @@ dNavMesh* dpWorld::GetNavMesh() {
 	return m_NavMesh;
 }
 
+void dpWorld::_setNavMesh(dNavMesh* navMesh) {
+	m_NavMesh = navMesh;
+}
+
 void dpWorld::AddEntity(dpEntity* entity) {
 	if (m_Grid) entity->SetGrid(m_Grid); //This sorts this entity into the right cell
 	else { //old method, slow
@@ -19,4 +19,8 @@ namespace dpWorld {
 	void RemoveEntity(dpEntity* entity);
 
 	dNavMesh* GetNavMesh();
+
+	// Used for assigning a navmesh built by a test, which Shutdown deletes.
+	// Do not use in production code.
+	void _setNavMesh(dNavMesh* navMesh);
 };
@@ -18,14 +18,13 @@ void QbEnemyStunner::OnQuickBuildComplete(Entity* self, Entity* target) {
 
 	// Get the skill IDs of this object.
 	CDObjectSkillsTable* skillsTable = CDClientManager::GetTable<CDObjectSkillsTable>();
-	auto skills = skillsTable->Query([=](CDObjectSkills entry) {return (entry.objectTemplate == self->GetLOT()); });
 	std::map<uint32_t, uint32_t> skillBehaviorMap;
 	// For each skill, cast it with the associated behavior ID.
-	for (auto skill : skills) {
+	for (const auto* skill : skillsTable->GetByObjectTemplate(self->GetLOT())) {
 		CDSkillBehaviorTable* skillBehaviorTable = CDClientManager::GetTable<CDSkillBehaviorTable>();
-		CDSkillBehavior behaviorData = skillBehaviorTable->GetSkillByID(skill.skillID);
+		CDSkillBehavior behaviorData = skillBehaviorTable->GetSkillByID(skill->skillID);
 
-		skillBehaviorMap.insert(std::make_pair(skill.skillID, behaviorData.behaviorID));
+		skillBehaviorMap.insert(std::make_pair(skill->skillID, behaviorData.behaviorID));
 	}
 
 	// If there are no skills found, insert a default skill to use.
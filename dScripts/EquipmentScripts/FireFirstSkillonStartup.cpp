@@ -12,15 +12,13 @@ void FireFirstSkillonStartup::OnStartup(Entity* self) {
 
 	// Get the skill IDs of this object.
 	CDObjectSkillsTable* skillsTable = CDClientManager::GetTable<CDObjectSkillsTable>();
-	std::vector<CDObjectSkills> skills = skillsTable->Query([=](CDObjectSkills entry) {return (entry.objectTemplate == self->GetLOT()); });
-
 	// For each skill, cast it with the associated behavior ID.
-	for (auto skill : skills) {
+	for (const auto* skill : skillsTable->GetByObjectTemplate(self->GetLOT())) {
 		CDSkillBehaviorTable* skillBehaviorTable = CDClientManager::GetTable<CDSkillBehaviorTable>();
-		CDSkillBehavior behaviorData = skillBehaviorTable->GetSkillByID(skill.skillID);
+		CDSkillBehavior behaviorData = skillBehaviorTable->GetSkillByID(skill->skillID);
 
 		// Should parent entity be null, make the originator self.
 		const auto target = self->GetParentEntity() ? self->GetParentEntity()->GetObjectID() : self->GetObjectID();
-		skillComponent->CalculateBehavior(skill.skillID, behaviorData.behaviorID, LWOOBJID_EMPTY, false, false, target);
+		skillComponent->CalculateBehavior(skill->skillID, behaviorData.behaviorID, LWOOBJID_EMPTY, false, false, target);
 	}
 }
@@ -13,11 +13,14 @@
 #include "Database.h"
 #include "dConfig.h"
 #include "dpWorld.h"
+#include "dNavMesh.h"
 #include "dZoneManager.h"
 #include "Metrics.hpp"
 #include "PerformanceManager.h"
 #include "Diagnostics.h"
 #include "BinaryPathFinder.h"
+#include "BehaviorProgram.h"
+#include "BehaviorWarmup.h"
 #include "dPlatforms.h"
 
 //RakNet includes:
@@ -135,6 +138,7 @@ int main(int argc, char** argv) {
 	uint32_t cloneID = 0;
 	uint32_t maxClients = 8;
 	uint32_t ourPort = 2007;
+	bool isPooled = false;
 
 	//Check our arguments:
 	for (int32_t i = 0; i < argc; ++i) {
@@ -145,6 +149,7 @@ int main(int argc, char** argv) {
 		if (argument == "-clone") cloneID = atoi(argv[i + 1]);
 		if (argument == "-maxclients") maxClients = atoi(argv[i + 1]);
 		if (argument == "-port") ourPort = atoi(argv[i + 1]);
+		if (argument == "-pooled") isPooled = true;
 	}
 
 	Game::config = new dConfig("worldconfig.ini");
@@ -213,6 +218,7 @@ int main(int argc, char** argv) {
 
 	const bool dontGenerateDCF = GeneralUtils::TryParse<bool>(Game::config->GetValue("dont_generate_dcf")).value_or(false);
 	Game::chatFilter = new dChatFilter(Game::assetManager->GetResPath().string() + "/chatplus_en_us", dontGenerateDCF);
+	Game::chatFilter->StartWorkers(GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("chat_filter_threads")).value_or(2));
 
 	Game::server = new dServer(masterIP, ourPort, instanceID, maxClients, false, true, Game::logger, masterIP, masterPort, ServerType::World, Game::config, &Game::lastSignal, zoneID);
 
@@ -228,6 +234,8 @@ int main(int argc, char** argv) {
 	//Set up other things:
 	Game::randomEngine = std::mt19937(time(0));
 
+	BehaviorProgram::SetEnabled(GeneralUtils::TryParse<bool>(Game::config->GetValue("behavior_programs")).value_or(false));
+
 	//Run it until server gets a kill message from Master:
 	auto lastTime = std::chrono::high_resolution_clock::now();
 	auto t = std::chrono::high_resolution_clock::now();
@@ -258,9 +266,21 @@ int main(int argc, char** argv) {
 	//Load our level:
 	if (zoneID != 0) {
 		dpWorld::Initialize(zoneID);
+		auto* navMesh = dpWorld::GetNavMesh();
+		navMesh->StartWorkers(GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("navmesh_path_threads")).value_or(2));
+		const auto pathBudget = GeneralUtils::TryParse<float>(Game::config->GetValue("navmesh_path_budget_ms")).value_or(2.0f);
+		navMesh->SetPathBudget(std::chrono::microseconds(static_cast<int64_t>(pathBudget * 1000.0f)));
+		navMesh->StartCrowd(GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("navmesh_crowd_agents")).value_or(0));
 		Game::zoneManager->Initialize(LWOZONEID(zoneID, instanceID, cloneID));
 		g_CloneID = cloneID;
 
+		if (GeneralUtils::TryParse<bool>(Game::config->GetValue("behavior_warmup")).value_or(true)) {
+			const auto lots = BehaviorWarmup::CollectZoneLots();
+			const auto warmup = BehaviorWarmup::WarmUp(lots, GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("behavior_warmup_threads")).value_or(2));
+			LOG("Built %zu behaviors for %zu skills of %zu objects in %.3fs, using %lld KiB",
+				warmup.behaviors, warmup.skills, warmup.lots, warmup.seconds, static_cast<long long>(warmup.memoryBytes / 1024));
+		}
+
 	} else {
 		Game::entityManager->Initialize();
 	}
@@ -313,6 +333,8 @@ int main(int argc, char** argv) {
 	uint32_t saveTime = 10 * 60 * currentFramerate; // 10 minutes in frames
 	uint32_t sqlPingTime = 10 * 60 * currentFramerate; // 10 minutes in frames
 	uint32_t emptyShutdownTime = (cloneID == 0 ? 30 : 5) * 60 * currentFramerate; // 30 minutes for main worlds, 5 for all others.
+	uint32_t loadReportTime = 5 * currentFramerate; // 5 seconds in frames
+	uint32_t framesSinceLastLoadReport = 0;
 
 	// Register slash commands if not in zone 0
 	if (zoneID != 0) SlashCommandHandler::Startup();
@@ -357,6 +379,8 @@ int main(int argc, char** argv) {
 			framesSinceLastSQLPing *= ratioBeforeToAfter;
 			emptyShutdownTime = (cloneID == 0 ? 30 : 5) * 60 * currentFramerate; // 30 minutes for main worlds, 5 for all others.
 			framesSinceLastUser *= ratioBeforeToAfter;
+			loadReportTime = 5 * currentFramerate; // 5 seconds in frames
+			framesSinceLastLoadReport *= ratioBeforeToAfter;
 		}
 
 		//Warning if we ran slow
@@ -389,6 +413,9 @@ int main(int argc, char** argv) {
 
 		if (zoneID != 0 && deltaTime > 0.0f) {
 			Metrics::StartMeasurement(MetricVariable::UpdateEntities);
+			// Hand entities the paths found since the last tick and steer the crowd before they move:
+			dpWorld::GetNavMesh()->ProcessCompletions();
+			dpWorld::GetNavMesh()->UpdateCrowd(deltaTime);
 			Game::entityManager->UpdateEntities(deltaTime);
 			Metrics::EndMeasurement(MetricVariable::UpdateEntities);
 
@@ -445,6 +472,9 @@ int main(int argc, char** argv) {
 			}
 		}
 
+		// Answer the chat messages that finished filtering:
+		Game::chatFilter->ProcessCompletions();
+
 		Metrics::EndMeasurement(MetricVariable::PacketHandling);
 
 		Metrics::StartMeasurement(MetricVariable::UpdateReplica);
@@ -460,7 +490,18 @@ int main(int argc, char** argv) {
 			framesSinceLastFlush = 0;
 		} else framesSinceLastFlush++;
 
-		if (zoneID != 0 && !occupied) {
+		//Tell master how busy we are every 5s, so it can place instances on the least loaded host:
+		if (framesSinceLastLoadReport >= loadReportTime && ready) {
+			const auto* cpuTime = Metrics::GetMetric(MetricVariable::CPUTime);
+			const auto* frameTime = Metrics::GetMetric(MetricVariable::Frame);
+			if (cpuTime && frameTime) {
+				MasterPackets::SendWorldLoad(Game::server, zoneID, instanceID, static_cast<uint32_t>(UserManager::Instance()->GetUserCount()),
+					cpuTime->average, frameTime->average, Metrics::GetCurrentRSS());
+			}
+			framesSinceLastLoadReport = 0;
+		} else framesSinceLastLoadReport++;
+
+		if (zoneID != 0 && !occupied && !isPooled) {
 			framesSinceLastUser++;
 
 			//If we haven't had any players for a while, time out and shut down:
@@ -565,7 +606,7 @@ void HandlePacketChat(Packet* packet) {
 						bitStream.Write(data);
 					}
 
-					SEND_PACKET; //send routed packet to player
+					Game::server->Send(bitStream, sysAddr, false, eQosClass::CHAT); //send routed packet to player
 					break;
 				}
 
@@ -1132,8 +1173,8 @@ void HandlePacket(Packet* packet) {
 
 						bitStream.WriteAlignedBytes(reinterpret_cast<const unsigned char*>(bbbModel.lxfmlData.str().c_str()), lxfmlSize);
 
-						SystemAddress sysAddr = packet->systemAddress;
-						SEND_PACKET;
+						// Stays on the gameplay channel so the blueprints reach the client before it is told loading is done.
+						Game::server->Send(bitStream, packet->systemAddress, false);
 					}
 				}
 
@@ -1296,16 +1337,22 @@ void HandlePacket(Packet* packet) {
 			}
 		}
 
-		std::vector<std::pair<uint8_t, uint8_t>> segments = Game::chatFilter->IsSentenceOkay(request.message, entity->GetGMLevel(), !(isBestFriend && request.chatLevel == 1));
+		const auto sysAddr = packet->systemAddress;
+		Game::chatFilter->IsSentenceOkayAsync(request.message, entity->GetGMLevel(), !(isBestFriend && request.chatLevel == 1),
+			[sysAddr, requestID = request.requestID, receiver = request.receiver](std::vector<std::pair<uint8_t, uint8_t>> segments) {
+			// The player may have left while the message was being filtered.
+			User* user = UserManager::Instance()->GetUser(sysAddr);
+			if (!user) return;
 
-		bool bAllClean = segments.empty();
+			bool bAllClean = segments.empty();
 
-		if (user->GetIsMuted()) {
-			bAllClean = false;
-		}
+			if (user->GetIsMuted()) {
+				bAllClean = false;
+			}
 
-		user->SetLastChatMessageApproved(bAllClean);
-		WorldPackets::SendChatModerationResponse(packet->systemAddress, bAllClean, request.requestID, request.receiver, segments);
+			user->SetLastChatMessageApproved(bAllClean);
+			WorldPackets::SendChatModerationResponse(sysAddr, bAllClean, requestID, receiver, segments);
+		});
 		break;
 	}
 
@@ -1326,16 +1373,23 @@ void HandlePacket(Packet* packet) {
 				user->GetLastUsedChar()->SendMuteNotice();
 				return;
 			}
-			std::string playerName = user->GetLastUsedChar()->GetName();
-			bool isMythran = user->GetLastUsedChar()->GetGMLevel() > eGameMasterLevel::CIVILIAN;
-			bool isOk = Game::chatFilter->IsSentenceOkay(GeneralUtils::UTF16ToWTF8(chatMessage.message), user->GetLastUsedChar()->GetGMLevel()).empty();
-			LOG_DEBUG("Msg: %s was approved previously? %i", GeneralUtils::UTF16ToWTF8(chatMessage.message).c_str(), user->GetLastChatMessageApproved());
-			if (!isOk) return;
-			if (!isOk && !isMythran) return;
-
+			const auto sysAddr = packet->systemAddress;
 			std::string sMessage = GeneralUtils::UTF16ToWTF8(chatMessage.message);
-			LOG("%s: %s", playerName.c_str(), sMessage.c_str());
-			ChatPackets::SendChatMessage(packet->systemAddress, chatMessage.chatChannel, playerName, user->GetLoggedInChar(), isMythran, chatMessage.message);
+			Game::chatFilter->IsSentenceOkayAsync(sMessage, user->GetLastUsedChar()->GetGMLevel(), true,
+				[sysAddr, sMessage, chatMessage = std::move(chatMessage)](std::vector<std::pair<uint8_t, uint8_t>> segments) {
+				// The player may have left while the message was being filtered.
+				User* user = UserManager::Instance()->GetUser(sysAddr);
+				if (!user || !user->GetLastUsedChar()) return;
+
+				std::string playerName = user->GetLastUsedChar()->GetName();
+				bool isMythran = user->GetLastUsedChar()->GetGMLevel() > eGameMasterLevel::CIVILIAN;
+				bool isOk = segments.empty();
+				LOG_DEBUG("Msg: %s was approved previously? %i", sMessage.c_str(), user->GetLastChatMessageApproved());
+				if (!isOk) return;
+
+				LOG("%s: %s", playerName.c_str(), sMessage.c_str());
+				ChatPackets::SendChatMessage(sysAddr, chatMessage.chatChannel, playerName, user->GetLoggedInChar(), isMythran, chatMessage.message);
+			});
 		}
 
 		break;
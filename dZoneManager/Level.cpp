@@ -4,6 +4,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include "BinaryIO.h"
 #include "Logger.h"
 #include "Spawner.h"
@@ -217,18 +218,7 @@ void Level::ReadSceneObjectDataChunk(std::istream& file, Header& header) {
 	uint32_t objectsCount = 0;
 	BinaryIO::BinaryRead(file, objectsCount);
 
-	CDFeatureGatingTable* featureGatingTable = CDClientManager::GetTable<CDFeatureGatingTable>();
-
-	CDFeatureGating gating;
-	gating.major =
-		GeneralUtils::TryParse<int32_t>(Game::config->GetValue("version_major")).value_or(ClientVersion::major);
-	gating.current =
-		GeneralUtils::TryParse<int32_t>(Game::config->GetValue("version_current")).value_or(ClientVersion::current);
-	gating.minor =
-		GeneralUtils::TryParse<int32_t>(Game::config->GetValue("version_minor")).value_or(ClientVersion::minor);
-
-	const auto zoneControlObject = Game::zoneManager->GetZoneControlObject();
-	DluAssert(zoneControlObject != nullptr);
+	m_Objects.reserve(m_Objects.size() + objectsCount);
 	for (uint32_t i = 0; i < objectsCount; ++i) {
 		std::u16string ldfString;
 		SceneObject obj;
@@ -250,6 +240,34 @@ void Level::ReadSceneObjectDataChunk(std::istream& file, Header& header) {
 		BinaryIO::ReadString<uint32_t>(file, ldfString);
 		BinaryIO::BinaryRead(file, obj.value3);
 
+		// One setting per line
+		const std::string sData = GeneralUtils::UTF16ToWTF8(ldfString);
+		std::string_view remaining = sData;
+		while (!remaining.empty()) {
+			const auto lineEnd = remaining.find('\n');
+			obj.settings.push_back(LDFBaseData::DataFromString(remaining.substr(0, lineEnd)));
+			if (lineEnd == std::string_view::npos) break;
+			remaining.remove_prefix(lineEnd + 1);
+		}
+
+		m_Objects.push_back(std::move(obj));
+	}
+}
+
+void Level::SpawnObjects() {
+	CDFeatureGatingTable* featureGatingTable = CDClientManager::GetTable<CDFeatureGatingTable>();
+
+	CDFeatureGating gating;
+	gating.major =
+		GeneralUtils::TryParse<int32_t>(Game::config->GetValue("version_major")).value_or(ClientVersion::major);
+	gating.current =
+		GeneralUtils::TryParse<int32_t>(Game::config->GetValue("version_current")).value_or(ClientVersion::current);
+	gating.minor =
+		GeneralUtils::TryParse<int32_t>(Game::config->GetValue("version_minor")).value_or(ClientVersion::minor);
+
+	const auto zoneControlObject = Game::zoneManager->GetZoneControlObject();
+	DluAssert(zoneControlObject != nullptr);
+	for (auto& obj : m_Objects) {
 		//This is a little bit of a bodge, but because the alpha client (HF) doesn't store the
 		//spawn position / rotation like the later versions do, we need to check the LOT for the spawn pos & set it.
 		if (obj.lot == LOT_MARKER_PLAYER_START) {
@@ -257,17 +275,6 @@ void Level::ReadSceneObjectDataChunk(std::istream& file, Header& header) {
 			Game::zoneManager->GetZone()->SetSpawnRot(obj.rotation);
 		}
 
-		std::string sData = GeneralUtils::UTF16ToWTF8(ldfString);
-		std::stringstream ssData(sData);
-		std::string token;
-		char deliminator = '\n';
-
-		while (std::getline(ssData, token, deliminator)) {
-			LDFBaseData* ldfData = LDFBaseData::DataFromString(token);
-			obj.settings.push_back(ldfData);
-		}
-
-
 		// We should never have more than 1 zone control object
 		bool skipLoadingObject = obj.lot == zoneControlObject->GetLOT();
 		for (LDFBaseData* data : obj.settings) {
@@ -318,4 +325,7 @@ void Level::ReadSceneObjectDataChunk(std::istream& file, Header& header) {
 			Game::entityManager->CreateEntity(info);
 		}
 	}
+
+	m_Objects.clear();
+	m_Objects.shrink_to_fit();
 }
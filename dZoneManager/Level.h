@@ -38,14 +38,29 @@ public:
 	};
 
 public:
+	/**
+	 * Reads the level file.  Objects are only created once SpawnObjects is called, so this is safe
+	 * to run off the main thread as long as nothing else touches the level meanwhile.
+	 */
 	Level(Zone* parentZone, const std::string& filepath);
-	
+
+	/**
+	 * Creates the objects and spawners read from the level file, in the order they are in the file.
+	 * Must run on the main thread.
+	 */
+	void SpawnObjects();
+
 	static void MakeSpawner(SceneObject obj);
 
+	size_t GetObjectCount() const { return m_Objects.size(); }
+
 	std::map<uint32_t, Header> m_ChunkHeaders;
 private:
 	Zone* m_ParentZone;
 
+	// Read but not spawned yet
+	std::vector<SceneObject> m_Objects;
+
 	//private functions:
 	void ReadChunks(std::istream& file);
 	void ReadFileInfoChunk(std::istream& file, Header& header);
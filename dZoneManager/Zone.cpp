@@ -1,6 +1,9 @@
 #include "Zone.h"
 #include "Level.h"
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include "Game.h"
 #include "Logger.h"
@@ -19,6 +22,8 @@
 #include "eTriggerEventType.h"
 #include "eWaypointCommandType.h"
 #include "dNavMesh.h"
+#include "dConfig.h"
+#include "WorkerPool.h"
 
 Zone::Zone(const LWOMAPID& mapID, const LWOINSTANCEID& instanceID, const LWOCLONEID& cloneID) :
 	m_ZoneID(mapID, instanceID, cloneID) {
@@ -192,14 +197,61 @@ uint32_t Zone::CalculateChecksum() {
 }
 
 void Zone::LoadLevelsIntoMemory() {
+	using Clock = std::chrono::steady_clock;
+
+	struct ReadLevel {
+		Level* level = nullptr;
+		double readMs = 0.0;
+	};
+
+	// Levels are read on the workers and spawned here as soon as they and every level before them have been read,
+	// so objects are created in the same order as when the levels were loaded one after another.
+	std::mutex workDoneMutex;
+	std::condition_variable workDone;
+	size_t workDoneCount = 0;
+	WorkerPool workers(GeneralUtils::TryParse<uint32_t>(Game::config->GetValue("zone_load_threads")).value_or(2), [&]() {
+		std::lock_guard lock(workDoneMutex);
+		workDoneCount++;
+		workDone.notify_one();
+	});
+
 	for (auto& [sceneID, scene] : m_Scenes) {
 		if (scene.level) continue;
-		scene.level = new Level(this, m_ZonePath + scene.filename);
 
-		if (scene.level->m_ChunkHeaders.empty()) continue;
+		const auto filepath = m_ZonePath + scene.filename;
+		workers.Submit(
+			[this, filepath]() {
+				const auto start = Clock::now();
+				ReadLevel read;
+				read.level = new Level(this, filepath);
+				read.readMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				return read;
+			},
+			// The pool rethrows a broken level file here on the main thread, where it used to abort the zone.
+			[this, &scene, sceneID](ReadLevel read) {
+				const auto start = Clock::now();
+				scene.level = read.level;
+				const auto objectCount = scene.level->GetObjectCount();
+				scene.level->SpawnObjects();
+				const auto spawnMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				LOG("Loaded %s with %zu objects, read in %.1f ms and spawned in %.1f ms", scene.filename.c_str(), objectCount, read.readMs, spawnMs);
+
+				if (scene.level->m_ChunkHeaders.empty()) return;
+
+				scene.level->m_ChunkHeaders.begin()->second.lwoSceneID = sceneID;
+				AddRevision(scene.level->m_ChunkHeaders.begin()->second.lwoSceneID, scene.level->m_ChunkHeaders.begin()->second.fileInfo.revision);
+			}
+		);
+	}
 
-		scene.level->m_ChunkHeaders.begin()->second.lwoSceneID = sceneID;
-		AddRevision(scene.level->m_ChunkHeaders.begin()->second.lwoSceneID, scene.level->m_ChunkHeaders.begin()->second.fileInfo.revision);
+	size_t processedCount = 0;
+	while (workers.GetPendingCount() > 0) {
+		{
+			std::unique_lock lock(workDoneMutex);
+			workDone.wait(lock, [&]() { return workDoneCount > processedCount; });
+			processedCount = workDoneCount;
+		}
+		workers.ProcessCompletions();
 	}
 }
 
@@ -247,18 +299,13 @@ void Zone::LoadScene(std::istream& file) {
 void Zone::LoadLUTriggers(std::string triggerFile, SceneRef& scene) {
 	auto file = Game::assetManager->GetFile((m_ZonePath + triggerFile).c_str());
 
-	std::stringstream data;
-	data << file.rdbuf();
-
-	data.seekg(0, std::ios::end);
-	int32_t size = data.tellg();
-	data.seekg(0, std::ios::beg);
+	const auto data = file.GetData();
 
-	if (size == 0) return;
+	if (data.empty()) return;
 
 	tinyxml2::XMLDocument doc;
 
-	if (doc.Parse(data.str().c_str(), size) != tinyxml2::XML_SUCCESS) {
+	if (doc.Parse(reinterpret_cast<const char*>(data.data()), data.size()) != tinyxml2::XML_SUCCESS) {
 		LOG("Failed to load LUTriggers from file %s", triggerFile.c_str());
 		return;
 	}
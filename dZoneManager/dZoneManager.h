@@ -36,6 +36,7 @@ public:
 	void RemoveSpawner(LWOOBJID id);
 	std::vector<Spawner*> GetSpawnersByName(std::string spawnerName);
 	std::vector<Spawner*> GetSpawnersInGroup(std::string group);
+	const std::map<LWOOBJID, Spawner*>& GetSpawners() const { return m_Spawners; }
 	void Update(float deltaTime);
 	Entity* GetZoneControlObject() { return m_ZoneControlObject; }
 	bool GetPlayerLoseCoinOnDeath() { return m_PlayerLoseCoinsOnDeath; }
@@ -242,6 +242,19 @@ TEST_F(LDFTests, LDFParseEdgeCaseTest) {
 	}
 }
 
+TEST_F(LDFTests, LDFKeysAreSharedTest) {
+	LdfUniquePtr parsed(LDFBaseData::DataFromString("sharedKey=1:5"));
+	LdfUniquePtr created(new LDFData<bool>(u"sharedKey", true));
+	LdfUniquePtr copy(created->Copy());
+	ASSERT_NE(parsed, nullptr);
+
+	ASSERT_EQ(&parsed->GetKey(), &created->GetKey());
+	ASSERT_EQ(&copy->GetKey(), &created->GetKey());
+	ASSERT_EQ(&LDFKeys::Intern(u"sharedKey"), &created->GetKey());
+	ASSERT_NE(&LDFKeys::Intern(u"otherKey"), &created->GetKey());
+	ASSERT_EQ(created->GetString(), "sharedKey=7:1");
+}
+
 #ifdef PERF_TEST
 
 TEST_F(LDFTests, LDFSpeedTest) {
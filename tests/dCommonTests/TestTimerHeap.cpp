@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "TimerHeap.h"
+
+using namespace std::chrono_literals;
+
+TEST(TimerHeapTest, RunsTimersWhenDue) {
+	TimerHeap timers;
+	const TimerHeap::Clock::time_point start{};
+	std::vector<int> order;
+	timers.After(20ms, [&order]() { order.push_back(2); }, start);
+	timers.After(0ms, [&order]() { order.push_back(1); }, start);
+	const auto cancelled = timers.After(0ms, [&order]() { order.push_back(3); }, start);
+	timers.Cancel(cancelled);
+
+	const auto latest = start + 1h;
+	ASSERT_EQ(timers.GetNextDue(latest), start);
+
+	timers.RunDue(start);
+	ASSERT_EQ(order, std::vector<int>{ 1 });
+	ASSERT_EQ(timers.GetNextDue(latest), start + 20ms);
+
+	timers.RunDue(start + 19ms);
+	ASSERT_EQ(order, std::vector<int>{ 1 });
+
+	timers.RunDue(start + 20ms);
+	ASSERT_EQ(order, (std::vector<int>{ 1, 2 }));
+	ASSERT_EQ(timers.GetTimerCount(), 0);
+	ASSERT_EQ(timers.GetNextDue(latest), latest);
+}
+
+TEST(TimerHeapTest, RepeatingTimersCanCancelThemselves) {
+	TimerHeap timers;
+	const TimerHeap::Clock::time_point start{};
+	int runs = 0;
+	TimerHeap::TimerId id = 0;
+	id = timers.Every(1ms, [&]() {
+		if (++runs == 3) timers.Cancel(id);
+	}, start);
+
+	// A timer added by a callback waits for the next call.
+	bool nestedRan = false;
+	timers.After(0ms, [&]() { timers.After(0ms, [&nestedRan]() { nestedRan = true; }, start); }, start);
+	timers.RunDue(start);
+	ASSERT_FALSE(nestedRan);
+
+	for (int i = 1; i <= 10; i++) timers.RunDue(start + i * 1ms);
+	ASSERT_TRUE(nestedRan);
+	ASSERT_EQ(runs, 3);
+	ASSERT_EQ(timers.GetTimerCount(), 0);
+}
+
+TEST(TimerHeapTest, RepeatingTimersSkipMissedRuns) {
+	TimerHeap timers;
+	const TimerHeap::Clock::time_point start{};
+	int runs = 0;
+	timers.Every(10ms, [&runs]() { runs++; }, start);
+
+	// Falling several intervals behind runs the timer once and schedules it from the late call.
+	timers.RunDue(start + 35ms);
+	ASSERT_EQ(runs, 1);
+	ASSERT_EQ(timers.GetNextDue(start + 1h), start + 45ms);
+
+	// Running a little late keeps the original schedule.
+	timers.RunDue(start + 47ms);
+	ASSERT_EQ(runs, 2);
+	ASSERT_EQ(timers.GetNextDue(start + 1h), start + 55ms);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "WorkerPool.h"
+
+namespace {
+	// Runs completions until every submitted job has finished.
+	void ProcessAll(WorkerPool& workers) {
+		while (workers.GetPendingCount() > 0) workers.ProcessCompletions();
+	}
+};
+
+TEST(WorkerPoolTest, ExceptionsReachTheCompletion) {
+	WorkerPool workers(2);
+	std::vector<std::string> results;
+
+	workers.Submit(
+		[]() -> int { throw std::runtime_error("broken"); },
+		[&results](const int value, std::exception_ptr error) {
+			ASSERT_EQ(value, 0);
+			ASSERT_TRUE(error);
+			try {
+				std::rethrow_exception(error);
+			} catch (const std::runtime_error& exception) {
+				results.push_back(exception.what());
+			}
+		}
+	);
+	workers.Submit([]() { return 2; }, [&results](const int value, std::exception_ptr error) {
+		ASSERT_FALSE(error);
+		results.push_back(std::to_string(value));
+	});
+
+	ProcessAll(workers);
+	ASSERT_EQ(results, (std::vector<std::string>{ "broken", "2" }));
+}
+
+TEST(WorkerPoolTest, ExceptionsWithoutAnErrorCompletionAreRethrown) {
+	WorkerPool workers(1);
+	std::vector<int> results;
+
+	workers.Submit([]() -> int { throw std::runtime_error("broken"); }, [&results](const int value) { results.push_back(value); });
+	workers.Submit([]() { return 2; }, [&results](const int value) { results.push_back(value); });
+
+	// The completion after the one that threw still runs on the next call.
+	ASSERT_THROW(ProcessAll(workers), std::runtime_error);
+	ProcessAll(workers);
+	ASSERT_EQ(results, std::vector<int>{ 2 });
+
+	// Without threads the work runs inside Submit, and so does the rethrow.
+	WorkerPool noThreads(0);
+	ASSERT_THROW(noThreads.Submit([]() -> int { throw std::runtime_error("broken"); }, [](const int) {}), std::runtime_error);
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "AndBehavior.h"
+#include "Behavior.h"
+#include "BehaviorBranchContext.h"
+#include "BehaviorContext.h"
+#include "BehaviorProgram.h"
+#include "CDComponentsRegistryTable.h"
+#include "CDSkillBehaviorTable.h"
+#include "ChainBehavior.h"
+#include "DestroyableComponent.h"
+#include "EmptyBehavior.h"
+#include "Entity.h"
+#include "EntityManager.h"
+#include "GameDependencies.h"
+#include "SwitchBehavior.h"
+#include "TestBehaviors.h"
+
+namespace {
+	constexpr uint32_t ATTACK_BEHAVIOR = 12;
+	constexpr LOT TARGET_LOT = 1000;
+
+	std::vector<uint32_t> g_Trace;
+
+	// A leaf that writes its id when calculated and records what it reads when handled.
+	class RecordingBehavior final : public Behavior {
+	public:
+		explicit RecordingBehavior(const uint32_t behaviorId) : Behavior(behaviorId) {}
+
+		void Handle(BehaviorContext* context, RakNet::BitStream& bitStream, BehaviorBranchContext branch) override {
+			uint32_t value = 0;
+			g_Trace.push_back(bitStream.Read(value) ? value : UINT32_MAX);
+		}
+
+		void Calculate(BehaviorContext* context, RakNet::BitStream& bitStream, BehaviorBranchContext branch) override {
+			g_Trace.push_back(m_behaviorId);
+			bitStream.Write(m_behaviorId);
+		}
+	};
+
+	// What a cast did besides reading or writing bits.
+	struct Trace {
+		std::vector<uint32_t> calls;
+		size_t syncEntries = 0;
+		size_t timerEntries = 0;
+		size_t endEntries = 0;
+		size_t scheduledUpdates = 0;
+		bool foundTarget = false;
+		int32_t targetHealth = 0;
+
+		bool operator==(const Trace& other) const = default;
+	};
+
+	bool SameBits(RakNet::BitStream& a, RakNet::BitStream& b) {
+		return a.GetNumberOfBitsUsed() == b.GetNumberOfBitsUsed() && std::memcmp(a.GetData(), b.GetData(), a.GetNumberOfBytesUsed()) == 0;
+	}
+};
+
+class BehaviorProgramTest : public GameDependenciesTest {
+protected:
+	// Casts the skills at itself.
+	Entity* target;
+
+	void SetUp() override {
+		SetUpDependencies();
+
+		// One skill for each template the program runs itself, all ending in the same attack.
+		TestBehaviors::Load({ { 1, 10 }, { 2, 20 }, { 3, 30 }, { 4, ATTACK_BEHAVIOR } }, {
+			{ 10, BehaviorTemplate::AND, { { "behavior 1", 11 }, { "behavior 2", 13 } } },
+			{ 11, BehaviorTemplate::CHAIN, { { "behavior 1", ATTACK_BEHAVIOR } } },
+			{ ATTACK_BEHAVIOR, BehaviorTemplate::BASIC_ATTACK, { { "min damage", 1 }, { "max damage", 1 } } },
+			{ 13, BehaviorTemplate::SWITCH, { { "action_true", ATTACK_BEHAVIOR }, { "action_false", 0 }, { "distance", 10 } } },
+			{ 20, BehaviorTemplate::AREA_OF_EFFECT, { { "action", ATTACK_BEHAVIOR }, { "radius", 10 }, { "target_self", 1 } } },
+			{ 30, BehaviorTemplate::TAC_ARC, { { "action", ATTACK_BEHAVIOR }, { "miss action", ATTACK_BEHAVIOR }, { "max range", 10 }, { "target_caster", 1 } } },
+		});
+
+		// Without a registry row for the LOT, making the entity would look its components up in the database.
+		CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>().insert_or_assign(TARGET_LOT, 0);
+		auto targetInfo = GameDependenciesTest::info;
+		targetInfo.lot = TARGET_LOT;
+		target = Game::entityManager->CreateEntity(targetInfo);
+		auto* destroyable = target->AddComponent<DestroyableComponent>();
+		destroyable->SetMaxHealth(1000000.0f);
+		destroyable->SetHealth(1000000);
+	}
+
+	void TearDown() override {
+		Game::entityManager->DestroyEntity(target);
+		Game::entityManager->UpdateEntities(0.0f);
+		CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>().erase(TARGET_LOT);
+		TestBehaviors::Unload();
+		TearDownDependencies();
+	}
+
+	// Casts on a new context against a target at full health, and records what the cast did.
+	Trace Record(const LWOOBJID caster, const std::function<void(BehaviorContext&)>& cast) {
+		auto* destroyable = target->GetComponent<DestroyableComponent>();
+		destroyable->SetHealth(1000000);
+
+		BehaviorContext context{ caster };
+		context.caster = caster;
+		g_Trace.clear();
+		cast(context);
+
+		return { g_Trace, context.syncEntries.size(), context.timerEntries.size(), context.endEntries.size(), context.scheduledUpdates.size(), context.foundTarget, destroyable->GetHealth() };
+	}
+
+	// Runs Calculate both ways and checks they wrote and did the same things.
+	void ExpectSameCalculation(Behavior* root, const BehaviorProgram& program, const LWOOBJID target, const LWOOBJID caster = 1) {
+		RakNet::BitStream expected;
+		const auto expectedTrace = Record(caster, [&](BehaviorContext& context) { root->Calculate(&context, expected, { target, 0 }); });
+
+		RakNet::BitStream actual;
+		const auto actualTrace = Record(caster, [&](BehaviorContext& context) { program.Calculate(&context, actual, { target, 0 }); });
+
+		EXPECT_TRUE(SameBits(expected, actual)) << "behavior " << root->m_behaviorId;
+		EXPECT_TRUE(expectedTrace == actualTrace) << "behavior " << root->m_behaviorId;
+	}
+
+	// Runs Handle both ways on the same input and checks they read and did the same things.
+	void ExpectSameHandling(Behavior* root, const BehaviorProgram& program, RakNet::BitStream& input, const LWOOBJID target = 0, const LWOOBJID caster = 1) {
+		RakNet::BitStream expected(input.GetData(), input.GetNumberOfBytesUsed(), true);
+		const auto expectedTrace = Record(caster, [&](BehaviorContext& context) { root->Handle(&context, expected, { target, 0 }); });
+
+		RakNet::BitStream actual(input.GetData(), input.GetNumberOfBytesUsed(), true);
+		const auto actualTrace = Record(caster, [&](BehaviorContext& context) { program.Handle(&context, actual, { target, 0 }); });
+
+		EXPECT_EQ(expected.GetReadOffset(), actual.GetReadOffset()) << "behavior " << root->m_behaviorId;
+		EXPECT_TRUE(expectedTrace == actualTrace) << "behavior " << root->m_behaviorId;
+	}
+
+	// Casts every loaded skill at the target both ways, then handles what was calculated both ways.
+	void ExpectSameSkills() {
+		const auto self = target->GetObjectID();
+		for (const auto& [skillID, skill] : CDClientManager::GetEntriesMutable<CDSkillBehaviorTable>()) {
+			SCOPED_TRACE("skill " + std::to_string(skillID));
+			auto* root = Behavior::CreateBehavior(skill.behaviorID);
+			const auto& program = BehaviorProgram::Get(skill.behaviorID);
+
+			ExpectSameCalculation(root, program, self, self);
+
+			// What the server calculated is what a client would send back for the same cast.
+			RakNet::BitStream input;
+			Record(self, [&](BehaviorContext& context) { root->Calculate(&context, input, { self, 0 }); });
+			ExpectSameHandling(root, program, input, self, self);
+		}
+	}
+};
+
+TEST_F(BehaviorProgramTest, MatchesBehaviorTree) {
+	// AND(CHAIN(a, b), SWITCH on distance(c, a), unconditional SWITCH(b, c), empty, a)
+	auto* a = new RecordingBehavior(900001);
+	auto* b = new RecordingBehavior(900002);
+	auto* c = new RecordingBehavior(900003);
+	auto* empty = new EmptyBehavior(900004);
+
+	auto* chain = new ChainBehavior(900005);
+	chain->m_behaviors = { a, b };
+
+	auto* distanceSwitch = new SwitchBehavior(900006);
+	distanceSwitch->m_actionTrue = c;
+	distanceSwitch->m_actionFalse = a;
+	distanceSwitch->m_imagination = 0;
+	distanceSwitch->m_isEnemyFaction = false;
+	distanceSwitch->m_targetHasBuff = -1;
+	distanceSwitch->m_Distance = 5.0f;
+
+	auto* alwaysSwitch = new SwitchBehavior(900007);
+	alwaysSwitch->m_actionTrue = b;
+	alwaysSwitch->m_actionFalse = c;
+	alwaysSwitch->m_imagination = 0;
+	alwaysSwitch->m_isEnemyFaction = false;
+	alwaysSwitch->m_targetHasBuff = -1;
+	alwaysSwitch->m_Distance = -1.0f;
+
+	auto* root = new AndBehavior(900008);
+	root->m_behaviors = { chain, distanceSwitch, alwaysSwitch, empty, a };
+
+	const BehaviorProgram program(root);
+	// Shared leaves are only stored once.
+	ASSERT_EQ(program.GetNodeCount(), 8);
+
+	ExpectSameCalculation(root, program, LWOOBJID_EMPTY);
+	ExpectSameCalculation(root, program, 1234);
+
+	// Every chain choice, including one past the end, and truncated input.
+	for (uint32_t chainIndex = 0; chainIndex <= 3; chainIndex++) {
+		RakNet::BitStream input;
+		input.Write(chainIndex);
+		for (uint32_t value = 1; value <= 4; value++) input.Write(value);
+		input.Write(true);
+		ExpectSameHandling(chain, BehaviorProgram(chain), input);
+		ExpectSameHandling(root, program, input);
+	}
+	RakNet::BitStream truncated;
+	ExpectSameHandling(root, program, truncated);
+}
+
+TEST_F(BehaviorProgramTest, MatchesEverySkill) {
+	const auto& skills = CDClientManager::GetEntriesMutable<CDSkillBehaviorTable>();
+	ASSERT_EQ(skills.size(), 4);
+
+	// Every template here is run by the program, so the actions get nodes of their own.
+	for (const auto& [skillID, skill] : skills) EXPECT_GT(BehaviorProgram::Get(skill.behaviorID).GetNodeCount(), 1) << "skill " << skillID;
+
+	ExpectSameSkills();
+}
+
+TEST_F(BehaviorProgramTest, MatchesEverySkillInTheCDClient) {
+	// Point DLU_CDSERVER_PATH at a server's CDServer.sqlite to cast every skill of the game both ways.
+	const char* path = std::getenv("DLU_CDSERVER_PATH");
+	if (!path || !std::filesystem::exists(path)) GTEST_SKIP() << "DLU_CDSERVER_PATH does not point at a CDServer.sqlite";
+
+	TestBehaviors::Unload();
+	TestBehaviors::LoadFile(path);
+	ASSERT_FALSE(CDClientManager::GetEntriesMutable<CDSkillBehaviorTable>().empty());
+
+	ExpectSameSkills();
+}
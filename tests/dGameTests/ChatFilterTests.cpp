@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "AhoCorasick.h"
+#include "Database.h"
+#include "dChatFilter.h"
+#include "eGameMasterLevel.h"
+#include "GameDatabase/TestSQL/TestSQLDatabase.h"
+
+class ChatFilterTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		Database::_setDatabase(new TestSQLDatabase()); // this new is managed by the Database
+
+		std::ofstream allowList("chatfiltertest.txt");
+		allowList << "hello\nworld\nbrick\nbuild\n";
+		allowList.close();
+
+		std::ofstream blockList("blocklist.txt");
+		blockList << "maelstrom\n*darkness\n";
+		blockList.close();
+	}
+
+	void TearDown() override {
+		std::remove("chatfiltertest.txt");
+		std::remove("chatfiltertest.dcf");
+		std::remove("blocklist.txt");
+		std::remove("blocklist.dcf");
+	}
+};
+
+TEST(AhoCorasickTest, MatchesAnyPattern) {
+	AhoCorasick matcher;
+	ASSERT_TRUE(matcher.IsEmpty());
+	ASSERT_FALSE(matcher.Matches("anything"));
+
+	matcher.Build({ "he", "she", "his", "hers" });
+	ASSERT_TRUE(matcher.Matches("ushers"));
+	ASSERT_TRUE(matcher.Matches("ahishers"));
+	ASSERT_TRUE(matcher.Matches("sshe"));
+	ASSERT_FALSE(matcher.Matches("hi"));
+	ASSERT_FALSE(matcher.Matches("sh"));
+	ASSERT_FALSE(matcher.Matches(""));
+}
+
+TEST(AhoCorasickTest, SerializeRoundTrip) {
+	AhoCorasick matcher;
+	matcher.Build({ "abc", "bcd" });
+
+	std::stringstream stream;
+	matcher.Serialize(stream);
+
+	AhoCorasick read;
+	ASSERT_TRUE(read.Deserialize(stream));
+	ASSERT_TRUE(read.Matches("xxbcdxx"));
+	ASSERT_TRUE(read.Matches("abc"));
+	ASSERT_FALSE(read.Matches("abdc"));
+
+	std::stringstream truncated(stream.str().substr(0, 100));
+	ASSERT_FALSE(read.Deserialize(truncated));
+	ASSERT_TRUE(read.IsEmpty());
+}
+
+TEST_F(ChatFilterTest, AllowList) {
+	dChatFilter filter("chatfiltertest", true);
+
+	ASSERT_TRUE(filter.IsSentenceOkay("Hello, World!", eGameMasterLevel::CIVILIAN).empty());
+	ASSERT_TRUE(filter.IsSentenceOkay("brick build?!", eGameMasterLevel::CIVILIAN).empty());
+
+	const auto segments = filter.IsSentenceOkay("hello nope world nope", eGameMasterLevel::CIVILIAN);
+	ASSERT_EQ(segments.size(), 2);
+	ASSERT_EQ(segments[0].first, 6);
+	ASSERT_EQ(segments[0].second, 4);
+	ASSERT_EQ(segments[1].first, 17);
+	ASSERT_EQ(segments[1].second, 4);
+
+	// Asking again hits the cache and must give the same answer.
+	ASSERT_EQ(filter.IsSentenceOkay("hello nope world nope", eGameMasterLevel::CIVILIAN), segments);
+
+	ASSERT_TRUE(filter.IsSentenceOkay("nope", eGameMasterLevel::DEVELOPER).empty());
+}
+
+TEST_F(ChatFilterTest, DenyList) {
+	dChatFilter filter("chatfiltertest", true);
+
+	ASSERT_TRUE(filter.IsSentenceOkay("anything goes", eGameMasterLevel::CIVILIAN, false).empty());
+
+	const auto segments = filter.IsSentenceOkay("the Maelstrom and its DARKNESSES.", eGameMasterLevel::CIVILIAN, false);
+	ASSERT_EQ(segments.size(), 2);
+	ASSERT_EQ(segments[0].first, 4);
+	ASSERT_EQ(segments[0].second, 9);
+	ASSERT_EQ(segments[1].first, 22);
+	ASSERT_EQ(segments[1].second, 11);
+}
+
+TEST_F(ChatFilterTest, DCFRoundTrip) {
+	{
+		dChatFilter filter("chatfiltertest", false);
+	}
+	std::remove("chatfiltertest.txt");
+	std::remove("blocklist.txt");
+
+	dChatFilter filter("chatfiltertest", false);
+	ASSERT_TRUE(filter.IsSentenceOkay("hello world", eGameMasterLevel::CIVILIAN).empty());
+	ASSERT_EQ(filter.IsSentenceOkay("hello nope", eGameMasterLevel::CIVILIAN).size(), 1);
+	ASSERT_EQ(filter.IsSentenceOkay("endless darkness", eGameMasterLevel::CIVILIAN, false).size(), 1);
+}
+
+TEST_F(ChatFilterTest, AsyncCompletesInOrder) {
+	dChatFilter filter("chatfiltertest", true);
+
+	std::vector<std::pair<int, size_t>> results;
+	const auto submit = [&filter, &results](const int index, const std::string& message) {
+		filter.IsSentenceOkayAsync(message, eGameMasterLevel::CIVILIAN, true, [&results, index](std::vector<std::pair<uint8_t, uint8_t>> segments) {
+			results.emplace_back(index, segments.size());
+		});
+	};
+
+	// Without workers the callback runs right away.
+	submit(0, "hello nope");
+	ASSERT_EQ(results.size(), 1);
+
+	filter.StartWorkers(4);
+	for (int i = 1; i <= 100; i++) submit(i, i % 2 == 0 ? "hello world" : "nope nope");
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (results.size() < 101 && std::chrono::steady_clock::now() < deadline) {
+		filter.ProcessCompletions();
+		std::this_thread::yield();
+	}
+
+	ASSERT_EQ(results.size(), 101);
+	for (int i = 0; i <= 100; i++) {
+		ASSERT_EQ(results[i].first, i);
+		ASSERT_EQ(results[i].second, i == 0 ? 1 : (i % 2 == 0 ? 0 : 2));
+	}
+}
+
+#ifdef PERF_TEST
+
+TEST_F(ChatFilterTest, Benchmark) {
+	dChatFilter filter("chatfiltertest", true);
+	const std::string messages[] = {
+		"hello world",
+		"Hello, brick build!",
+		"this has some words that are not on the list",
+		"the maelstrom darkness is coming",
+	};
+
+	constexpr size_t iterations = 100000;
+	size_t badSegments = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		const auto& message = messages[i % std::size(messages)];
+		badSegments += filter.IsSentenceOkay(message, eGameMasterLevel::CIVILIAN, i % 2 == 0).size();
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	ASSERT_GT(badSegments, 0);
+	std::printf("Filtered %zu messages in %.3fs (%.0f messages per second)\n", iterations, elapsed, iterations / elapsed);
+}
+
+#endif //PERF
@@ -0,0 +1,45 @@
+#include "GameDependencies.h"
+#include <gtest/gtest.h>
+
+#include "Entity.h"
+
+class EntityTest : public GameDependenciesTest {
+protected:
+	void SetUp() override {
+		SetUpDependencies();
+	}
+
+	void TearDown() override {
+		TearDownDependencies();
+	}
+};
+
+TEST_F(EntityTest, SettingsAreCopiedOnWrite) {
+	// Spawns of the same spawner node all get the node's settings.
+	std::vector<std::unique_ptr<LDFBaseData>> nodeConfig;
+	nodeConfig.emplace_back(new LDFData<int32_t>(u"number", 1));
+	nodeConfig.emplace_back(new LDFData<std::u16string>(u"name", u"template"));
+
+	auto info = GameDependenciesTest::info;
+	for (const auto& setting : nodeConfig) info.settings.push_back(setting.get());
+
+	Entity first(15, info);
+	Entity second(16, info);
+
+	first.SetVar<int32_t>(u"number", 2);
+	first.SetVar<int32_t>(u"number", 3);
+	first.SetVar<bool>(u"added", true);
+
+	ASSERT_EQ(first.GetVar<int32_t>(u"number"), 3);
+	ASSERT_TRUE(first.GetVar<bool>(u"added"));
+	ASSERT_EQ(first.GetVar<std::u16string>(u"name"), u"template");
+
+	ASSERT_EQ(second.GetVar<int32_t>(u"number"), 1);
+	ASSERT_FALSE(second.HasVar(u"added"));
+	ASSERT_EQ(static_cast<LDFData<int32_t>*>(nodeConfig.front().get())->GetValue(), 1);
+
+	// The setting keeps its place, so the entity still serializes its settings in the same order.
+	ASSERT_EQ(first.GetSettings().size(), 3);
+	ASSERT_EQ(first.GetSettings().front()->GetKey(), u"number");
+	ASSERT_EQ(second.GetSettings().front(), nodeConfig.front().get());
+}
@@ -1,4 +1,5 @@
 #include "GameDependencies.h"
+#include "PlayerContainer.h"
 
 namespace Game {
 	Logger* logger = nullptr;
@@ -12,4 +13,5 @@ namespace Game {
 	SystemAddress chatSysAddr;
 	EntityManager* entityManager = nullptr;
 	std::string projectVersion;
+	PlayerContainer playerContainer;
 }
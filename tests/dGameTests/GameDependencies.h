@@ -22,7 +22,7 @@ public:
 	dServerMock() {};
 	~dServerMock() {};
 	RakNet::BitStream* GetMostRecentBitStream() { return sentBitStream; };
-	void Send(RakNet::BitStream& bitStream, const SystemAddress& sysAddr, bool broadcast) override { sentBitStream = &bitStream; };
+	void Send(RakNet::BitStream& bitStream, const SystemAddress& sysAddr, bool broadcast, eQosClass qosClass) override { sentBitStream = &bitStream; };
 	void SetZoneId(unsigned int zoneId) { mZoneID = zoneId; }
 };
 
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+
+#include "CDComponentsRegistryTable.h"
+#include "CDItemComponentTable.h"
+#include "CDLootMatrixTable.h"
+#include "CDLootTableTable.h"
+#include "CDRarityTableTable.h"
+#include "eReplicaComponentType.h"
+#include "GameDependencies.h"
+#include "GeneralUtils.h"
+#include "Loot.h"
+
+namespace {
+	// Loot::RollLootMatrix as it was before matrices were compiled, which the compiled rolls have to match.
+	std::unordered_map<LOT, int32_t> RollLootMatrixByScan(uint32_t matrixIndex) {
+		CDComponentsRegistryTable* componentsRegistryTable = CDClientManager::GetTable<CDComponentsRegistryTable>();
+		CDItemComponentTable* itemComponentTable = CDClientManager::GetTable<CDItemComponentTable>();
+		CDLootMatrixTable* lootMatrixTable = CDClientManager::GetTable<CDLootMatrixTable>();
+		CDLootTableTable* lootTableTable = CDClientManager::GetTable<CDLootTableTable>();
+		CDRarityTableTable* rarityTableTable = CDClientManager::GetTable<CDRarityTableTable>();
+		std::unordered_map<LOT, int32_t> drops;
+
+		for (const auto& entry : lootMatrixTable->GetMatrix(matrixIndex)) {
+			if (GeneralUtils::GenerateRandomNumber<float>(0, 1) >= entry.percent) continue;
+
+			const auto& lootTable = lootTableTable->GetTable(entry.LootTableIndex);
+			const auto& rarityTable = rarityTableTable->GetRarityTable(entry.RarityTableIndex);
+
+			uint32_t dropCount = GeneralUtils::GenerateRandomNumber<uint32_t>(entry.minToDrop, entry.maxToDrop);
+			for (uint32_t i = 0; i < dropCount; ++i) {
+				uint32_t maxRarity = 1;
+				float rarityRoll = GeneralUtils::GenerateRandomNumber<float>(0, 1);
+				for (const auto& rarity : rarityTable) {
+					if (rarity.randmax >= rarityRoll) {
+						maxRarity = rarity.rarity;
+					} else {
+						break;
+					}
+				}
+
+				bool rarityFound = false;
+				std::vector<CDLootTable> possibleDrops;
+				for (const auto& loot : lootTable) {
+					uint32_t itemComponentId = componentsRegistryTable->GetByIDAndType(loot.itemid, eReplicaComponentType::ITEM);
+					uint32_t rarity = itemComponentTable->GetItemComponentByID(itemComponentId).rarity;
+
+					if (rarity == maxRarity) {
+						possibleDrops.push_back(loot);
+						rarityFound = true;
+					} else if (rarity < maxRarity && !rarityFound) {
+						possibleDrops.push_back(loot);
+						maxRarity = rarity;
+					}
+				}
+
+				if (!possibleDrops.empty()) {
+					++drops[possibleDrops[GeneralUtils::GenerateRandomNumber<uint32_t>(0, possibleDrops.size() - 1)].itemid];
+				}
+			}
+		}
+
+		return drops;
+	}
+
+	// How many of each LOT drop over a number of rolls, with LOT_NULL counting the rolls that dropped nothing.
+	template<typename Roll>
+	std::map<LOT, uint64_t> CountDrops(const uint32_t matrixIndex, const uint32_t rolls, Roll roll) {
+		std::map<LOT, uint64_t> counts;
+		for (uint32_t i = 0; i < rolls; i++) {
+			const auto drops = roll(matrixIndex);
+			if (drops.empty()) counts[LOT_NULL]++;
+			for (const auto& [lot, count] : drops) counts[lot] += count;
+		}
+		return counts;
+	}
+};
+
+class LootTest : public GameDependenciesTest {
+protected:
+	void SetUp() override {
+		SetUpDependencies();
+
+		// Loot tables are sorted with the highest rarity first, as CDLootTableTable sorts them.
+		AddLootTable(1, { { 100, 4 }, { 101, 3 }, { 102, 3 }, { 103, 2 }, { 104, 1 }, { 105, 1 }, { 106, 1 } });
+		// No rarity 1 or 3 items, so those rolls fall back to a lower rarity or drop nothing.
+		AddLootTable(2, { { 200, 4 }, { 201, 2 }, { 202, 2 } });
+		AddLootTable(3, { { 300, 1 } });
+		CDClientManager::GetEntriesMutable<CDLootTableTable>()[3].front().MissionDrop = true;
+
+		// Rarity tables are sorted with the highest randmax first.
+		auto& rarityTables = CDClientManager::GetEntriesMutable<CDRarityTableTable>();
+		rarityTables[1] = { { 1.0f, 1 }, { 0.6f, 2 }, { 0.25f, 3 }, { 0.05f, 4 } };
+		rarityTables[2] = { { 0.9f, 1 }, { 0.5f, 3 }, { 0.2f, 4 } };
+		rarityTables[3] = {};
+
+		AddMatrixEntry(1, 1, 1, 1.0f, 1, 1);
+		AddMatrixEntry(2, 2, 2, 0.7f, 1, 3);
+		AddMatrixEntry(3, 1, 2, 0.5f, 0, 2);
+		AddMatrixEntry(3, 3, 3, 0.3f, 1, 1);
+		AddMatrixEntry(3, 2, 1, 0.9f, 2, 2);
+	}
+
+	void TearDown() override {
+		TearDownDependencies();
+	}
+
+	void AddLootTable(const uint32_t index, const std::vector<std::pair<LOT, uint32_t>>& items) {
+		auto& registry = CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>();
+		auto& itemComponents = CDClientManager::GetEntriesMutable<CDItemComponentTable>();
+		auto& lootTable = CDClientManager::GetEntriesMutable<CDLootTableTable>()[index];
+		for (const auto& [lot, rarity] : items) {
+			// The item component uses the LOT as its ID.
+			registry.insert_or_assign(lot, 0);
+			registry.insert_or_assign(static_cast<uint64_t>(eReplicaComponentType::ITEM) << 32 | static_cast<uint64_t>(lot), lot);
+			CDItemComponent itemComponent{};
+			itemComponent.id = lot;
+			itemComponent.rarity = rarity;
+			itemComponents.insert_or_assign(lot, itemComponent);
+
+			CDLootTable loot{};
+			loot.itemid = lot;
+			loot.LootTableIndex = index;
+			lootTable.push_back(loot);
+		}
+	}
+
+	void AddMatrixEntry(const uint32_t matrixIndex, const uint32_t lootTableIndex, const uint32_t rarityTableIndex, const float percent, const uint32_t minToDrop, const uint32_t maxToDrop) {
+		CDLootMatrix entry{};
+		entry.LootTableIndex = lootTableIndex;
+		entry.RarityTableIndex = rarityTableIndex;
+		entry.percent = percent;
+		entry.minToDrop = minToDrop;
+		entry.maxToDrop = maxToDrop;
+		CDClientManager::GetEntriesMutable<CDLootMatrixTable>()[matrixIndex].push_back(entry);
+	}
+};
+
+TEST_F(LootTest, DropDistributionsAreUnchanged) {
+	constexpr uint32_t rolls = 200000;
+
+	for (const uint32_t matrixIndex : { 1, 2, 3 }) {
+		Game::randomEngine.seed(matrixIndex);
+		const auto expected = CountDrops(matrixIndex, rolls, RollLootMatrixByScan);
+		const auto actual = CountDrops(matrixIndex, rolls, [](uint32_t index) { return Loot::RollLootMatrix(index); });
+
+		// Both rolls have to give the same LOTs...
+		ASSERT_EQ(expected.size(), actual.size()) << "matrix " << matrixIndex;
+		for (const auto& [lot, count] : expected) ASSERT_TRUE(actual.contains(lot)) << "matrix " << matrixIndex << " LOT " << lot;
+
+		// ...about as often, going by a two sample chi-squared test.  The cutoff is well past the 0.1% tail.
+		double chiSquared = 0.0;
+		for (const auto& [lot, count] : expected) {
+			const auto difference = static_cast<double>(count) - static_cast<double>(actual.at(lot));
+			chiSquared += difference * difference / static_cast<double>(count + actual.at(lot));
+		}
+		const auto degreesOfFreedom = static_cast<double>(expected.size() - 1);
+		ASSERT_LT(chiSquared, degreesOfFreedom + 5.0 * std::sqrt(2.0 * degreesOfFreedom)) << "matrix " << matrixIndex;
+	}
+}
+
+TEST_F(LootTest, FallsBackToLowerRarities) {
+	// Matrix 2 never rolls for rarity 3 items, since it has none, and rolls that want rarity 1 drop nothing.
+	Game::randomEngine.seed(0);
+	const auto counts = CountDrops(2, 10000, [](uint32_t index) { return Loot::RollLootMatrix(index); });
+	ASSERT_TRUE(counts.contains(200));
+	ASSERT_TRUE(counts.contains(201));
+	ASSERT_TRUE(counts.contains(202));
+	ASSERT_TRUE(counts.contains(LOT_NULL));
+	ASSERT_EQ(counts.size(), 4);
+}
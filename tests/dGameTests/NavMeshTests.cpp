@@ -0,0 +1,241 @@
+#include "GameDependencies.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "CDClientManager.h"
+#include "CDComponentsRegistryTable.h"
+#include "DetourExtensions.h"
+#include "dNavMesh.h"
+#include "dpWorld.h"
+#include "Entity.h"
+#include "MovementAIComponent.h"
+#include "NiPoint3.h"
+
+namespace {
+	constexpr float QUAD_SIZE = 10.0f;
+	constexpr float CELL_SIZE = 0.5f;
+	constexpr int VERTS_PER_POLY = 4;
+	constexpr uint16_t NO_NEIGHBOR = 0xffff;
+
+	/**
+	 * Builds a navmesh that is a strip of square polygons along the x axis, QUAD_SIZE on a side and at height 0.
+	 * Polygons list their corners so that the edge into the next polygon has its left end first, the way Recast
+	 * winds them, followed by the polygon across each edge.
+	 */
+	dtNavMesh* BuildStrip(const uint16_t quads) {
+		const auto cells = static_cast<uint16_t>(QUAD_SIZE / CELL_SIZE);
+
+		std::vector<uint16_t> verts;
+		for (uint16_t i = 0; i <= quads; i++) {
+			const auto x = static_cast<uint16_t>(i * cells);
+			verts.insert(verts.end(), { x, 0, 0 });
+			verts.insert(verts.end(), { x, 0, cells });
+		}
+
+		std::vector<uint16_t> polys;
+		for (uint16_t i = 0; i < quads; i++) {
+			const auto first = static_cast<uint16_t>(i * 2);
+			const auto next = static_cast<uint16_t>(first + 2);
+			polys.insert(polys.end(), { first, static_cast<uint16_t>(first + 1), static_cast<uint16_t>(next + 1), next });
+			polys.insert(polys.end(), {
+				i > 0 ? static_cast<uint16_t>(i - 1) : NO_NEIGHBOR,
+				NO_NEIGHBOR,
+				i + 1 < quads ? static_cast<uint16_t>(i + 1) : NO_NEIGHBOR,
+				NO_NEIGHBOR
+			});
+		}
+
+		const std::vector<uint16_t> flags(quads, 1);
+		const std::vector<uint8_t> areas(quads, 0);
+
+		dtNavMeshCreateParams params{};
+		params.verts = verts.data();
+		params.vertCount = static_cast<int>(verts.size() / 3);
+		params.polys = polys.data();
+		params.polyFlags = flags.data();
+		params.polyAreas = areas.data();
+		params.polyCount = quads;
+		params.nvp = VERTS_PER_POLY;
+		params.bmax[0] = quads * QUAD_SIZE;
+		params.bmax[1] = 4.0f;
+		params.bmax[2] = QUAD_SIZE;
+		params.walkableHeight = 4.0f;
+		params.walkableRadius = 1.0f;
+		params.walkableClimb = 1.0f;
+		params.cs = CELL_SIZE;
+		params.ch = CELL_SIZE;
+		params.buildBvTree = true;
+
+		unsigned char* data = nullptr;
+		int dataSize = 0;
+		if (!dtCreateNavMeshData(&params, &data, &dataSize)) return nullptr;
+
+		auto* navMesh = dtAllocNavMesh();
+		if (dtStatusFailed(navMesh->init(data, dataSize, DT_TILE_FREE_DATA))) {
+			dtFreeNavMesh(navMesh);
+			return nullptr;
+		}
+		return navMesh;
+	}
+
+	// The middle of a polygon of the strip.
+	NiPoint3 GetQuadCenter(const int quad) {
+		return NiPoint3(quad * QUAD_SIZE + QUAD_SIZE / 2.0f, 0.0f, QUAD_SIZE / 2.0f);
+	}
+
+	// Runs the callbacks of found paths until none are left or a few seconds pass, and returns how many ticks that took.
+	uint32_t ProcessAll(dNavMesh& navMesh) {
+		uint32_t ticks = 0;
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (navMesh.GetPendingPathCount() > 0 && std::chrono::steady_clock::now() < deadline) {
+			navMesh.ProcessCompletions();
+			ticks++;
+			std::this_thread::yield();
+		}
+		return ticks;
+	}
+};
+
+class NavMeshTest : public GameDependenciesTest {
+protected:
+	void SetUp() override {
+		SetUpDependencies();
+	}
+
+	void TearDown() override {
+		dpWorld::Shutdown();
+		TearDownDependencies();
+	}
+
+	// Follows the path a callback gets to check it is on the strip and goes where it was asked to.
+	static void CheckPath(const std::vector<NiPoint3>& path, const NiPoint3& start, const NiPoint3& end) {
+		ASSERT_GE(path.size(), 2);
+		ASSERT_NEAR(path.front().x, start.x, 0.5f);
+		ASSERT_NEAR(path.back().x, end.x, 0.5f);
+		ASSERT_NEAR(path.back().z, end.z, 0.5f);
+		for (const auto& point : path) ASSERT_NEAR(point.y, 0.0f, 0.5f);
+	}
+};
+
+TEST_F(NavMeshTest, WorkerPathsCompleteInRequestOrder) {
+	auto* navMesh = BuildStrip(200);
+	ASSERT_NE(navMesh, nullptr);
+	dNavMesh mesh(navMesh);
+	mesh.StartWorkers(2);
+
+	// The long search goes first, so the short ones can finish on the other worker before it does.
+	std::vector<size_t> order;
+	const std::pair<int, int> requests[] = { { 0, 199 }, { 0, 1 }, { 5, 3 } };
+	for (size_t i = 0; i < std::size(requests); i++) {
+		const auto start = GetQuadCenter(requests[i].first);
+		const auto end = GetQuadCenter(requests[i].second);
+		mesh.GetPathAsync(start, end, 10.0f, [&order, i, start, end](std::vector<NiPoint3> path) {
+			CheckPath(path, start, end);
+			order.push_back(i);
+		});
+	}
+
+	ProcessAll(mesh);
+	ASSERT_EQ(order, (std::vector<size_t>{ 0, 1, 2 }));
+}
+
+TEST_F(NavMeshTest, MovementFollowsOnlyTheNewestPath) {
+	auto* navMesh = BuildStrip(20);
+	ASSERT_NE(navMesh, nullptr);
+	dpWorld::_setNavMesh(new dNavMesh(navMesh));
+
+	// Without a registry row for the LOT, making the entity would look its components up in the database.
+	auto& registry = CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>();
+	registry.insert_or_assign(info.lot, 0);
+
+	info.pos = GetQuadCenter(0);
+	auto* entity = Game::entityManager->CreateEntity(info);
+	auto* movementAI = entity->AddComponent<MovementAIComponent>(MovementAIInfo{ "", 0.0f, 10.0f, 0.0f, 0.0f, 0.0f });
+	auto& mesh = *dpWorld::GetNavMesh();
+
+	// Stopping drops the path still being searched for.
+	movementAI->SetDestination(GetQuadCenter(10));
+	movementAI->Stop();
+	ProcessAll(mesh);
+	ASSERT_TRUE(movementAI->AtFinalWaypoint());
+
+	// A new destination replaces the one still being searched for.
+	movementAI->SetDestination(GetQuadCenter(15));
+	movementAI->SetDestination(GetQuadCenter(5));
+	ProcessAll(mesh);
+	ASSERT_FALSE(movementAI->AtFinalWaypoint());
+	ASSERT_NEAR(movementAI->GetDestination().x, GetQuadCenter(5).x, 0.5f);
+
+	movementAI->Stop();
+	Game::entityManager->DestroyEntity(entity);
+	Game::entityManager->UpdateEntities(0.0f);
+	registry.erase(info.lot);
+}
+
+TEST_F(NavMeshTest, SlicedSearchesSpreadOverTicks) {
+	auto* navMesh = BuildStrip(200);
+	ASSERT_NE(navMesh, nullptr);
+	dNavMesh mesh(navMesh);
+
+	// With no time at all, each tick does the least searching it can, so a long path takes several ticks.
+	mesh.SetPathBudget(std::chrono::microseconds(0));
+
+	std::vector<size_t> order;
+	const std::pair<int, int> requests[] = { { 0, 199 }, { 0, 1 } };
+	for (size_t i = 0; i < std::size(requests); i++) {
+		const auto start = GetQuadCenter(requests[i].first);
+		const auto end = GetQuadCenter(requests[i].second);
+		mesh.GetPathAsync(start, end, 10.0f, [&order, i, start, end](std::vector<NiPoint3> path) {
+			CheckPath(path, start, end);
+			order.push_back(i);
+		});
+	}
+
+	ASSERT_GT(ProcessAll(mesh), 2);
+	ASSERT_EQ(order, (std::vector<size_t>{ 0, 1 }));
+
+	// The corridor of the long path is cached now, so asking again takes a single tick.
+	bool found = false;
+	mesh.GetPathAsync(GetQuadCenter(0), GetQuadCenter(199), 10.0f, [&found](std::vector<NiPoint3> path) {
+		CheckPath(path, GetQuadCenter(0), GetQuadCenter(199));
+		found = true;
+	});
+	ASSERT_EQ(ProcessAll(mesh), 1);
+	ASSERT_TRUE(found);
+}
+
+TEST_F(NavMeshTest, PullToPointDropsThePendingPath) {
+	auto* navMesh = BuildStrip(20);
+	ASSERT_NE(navMesh, nullptr);
+	dpWorld::_setNavMesh(new dNavMesh(navMesh));
+
+	auto& registry = CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>();
+	registry.insert_or_assign(info.lot, 0);
+
+	info.pos = GetQuadCenter(0);
+	auto* entity = Game::entityManager->CreateEntity(info);
+	auto* movementAI = entity->AddComponent<MovementAIComponent>(MovementAIInfo{ "", 0.0f, 10.0f, 0.0f, 0.0f, 0.0f });
+	auto& mesh = *dpWorld::GetNavMesh();
+
+	// The path found for a destination set before the pull is dropped, and new ones are ignored until it ends.
+	movementAI->SetDestination(GetQuadCenter(10));
+	movementAI->PullToPoint(GetQuadCenter(0));
+	movementAI->SetDestination(GetQuadCenter(15));
+	ProcessAll(mesh);
+	ASSERT_TRUE(movementAI->AtFinalWaypoint());
+
+	// The entity is already at the pull point, so one update ends the pull.
+	movementAI->Update(0.1f);
+	movementAI->SetDestination(GetQuadCenter(5));
+	ProcessAll(mesh);
+	ASSERT_FALSE(movementAI->AtFinalWaypoint());
+	ASSERT_NEAR(movementAI->GetDestination().x, GetQuadCenter(5).x, 0.5f);
+
+	movementAI->Stop();
+	Game::entityManager->DestroyEntity(entity);
+	Game::entityManager->UpdateEntities(0.0f);
+	registry.erase(info.lot);
+}
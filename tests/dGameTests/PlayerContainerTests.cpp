@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "BitStreamUtils.h"
+#include "eConnectionType.h"
+#include "eGameMasterLevel.h"
+#include "GameDependencies.h"
+#include "MessageType/Chat.h"
+#include "PlayerContainer.h"
+#include "SocialGraph.h"
+
+// Counts the social queries that reach the database.
+class SocialTestDatabase : public TestSQLDatabase {
+public:
+	// Every character is friends with the characters right before and after it.
+	std::vector<FriendData> GetFriendsList(uint32_t charID) override {
+		friendQueries++;
+		std::vector<FriendData> friends;
+		for (const auto friendID : { charID + 1, charID - 1 }) {
+			if (friendID == 0) continue;
+			auto& friendData = friends.emplace_back();
+			friendData.friendID = friendID;
+			friendData.friendName = "Friend" + std::to_string(friendID);
+		}
+		return friends;
+	}
+
+	std::optional<ICharInfo::Info> GetCharacterInfo(const std::string_view name) override {
+		characterQueries++;
+		if (name != "Stranger") return std::nullopt;
+		ICharInfo::Info info;
+		info.name = name;
+		info.id = 42;
+		return info;
+	}
+
+	uint32_t friendQueries = 0;
+	uint32_t characterQueries = 0;
+};
+
+class PlayerContainerTest : public GameDependenciesTest {
+protected:
+	void SetUp() override {
+		SetUpDependencies();
+	}
+
+	void TearDown() override {
+		TearDownDependencies();
+	}
+
+	// Sends the container the same packet a world server sends when a player logs in.
+	void InsertPlayer(PlayerContainer& container, const LWOOBJID playerID, const std::string& playerName) {
+		CBITSTREAM;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::CHAT, MessageType::Chat::LOGIN_SESSION_NOTIFY);
+		bitStream.Write(playerID);
+		bitStream.Write<uint32_t>(playerName.size());
+		for (const auto character : playerName) bitStream.Write(character);
+		bitStream.Write<uint16_t>(1000);
+		bitStream.Write<uint16_t>(1);
+		bitStream.Write<uint32_t>(0);
+		bitStream.Write<time_t>(0);
+		bitStream.Write(eGameMasterLevel::CIVILIAN);
+
+		Packet packet{};
+		packet.data = bitStream.GetData();
+		packet.length = bitStream.GetNumberOfBytesUsed();
+		packet.systemAddress = UNASSIGNED_SYSTEM_ADDRESS;
+		container.InsertPlayer(&packet);
+	}
+
+	void RemovePlayer(PlayerContainer& container, const LWOOBJID playerID) {
+		CBITSTREAM;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::CHAT, MessageType::Chat::UNEXPECTED_DISCONNECT);
+		bitStream.Write(playerID);
+
+		Packet packet{};
+		packet.data = bitStream.GetData();
+		packet.length = bitStream.GetNumberOfBytesUsed();
+		container.RemovePlayer(&packet);
+	}
+};
+
+TEST_F(PlayerContainerTest, LookupsFollowInsertsAndRemovals) {
+	PlayerContainer container;
+	InsertPlayer(container, 1, "Alpha");
+	InsertPlayer(container, 2, "Beta");
+	InsertPlayer(container, 3, "Gamma");
+	ASSERT_EQ(container.GetPlayerCount(), 3);
+
+	ASSERT_EQ(container.GetPlayerData("beta").playerID, 2);
+	ASSERT_EQ(container.GetPlayerData("GAMMA").playerID, 3);
+	ASSERT_FALSE(container.GetPlayerData("Delta"));
+
+	// Removing a player from the middle moves another one into its slot.
+	RemovePlayer(container, 1);
+	ASSERT_EQ(container.GetPlayerCount(), 2);
+	ASSERT_FALSE(container.GetPlayerData(1));
+	ASSERT_FALSE(container.GetPlayerData("Alpha"));
+	ASSERT_EQ(container.GetPlayerData(3).playerName, "Gamma");
+	ASSERT_EQ(container.GetPlayerData("Gamma").playerID, 3);
+	ASSERT_EQ(container.GetAllPlayers().size(), 2);
+
+	// Logging in again keeps the friends list.
+	container.GetPlayerDataMutable(2).friends.emplace_back();
+	InsertPlayer(container, 2, "Beta");
+	ASSERT_EQ(container.GetPlayerCount(), 2);
+	ASSERT_EQ(container.GetPlayerData(2).friends.size(), 1);
+}
+
+TEST_F(PlayerContainerTest, TeamMembershipIsIndexed) {
+	PlayerContainer container;
+	for (LWOOBJID i = 1; i <= 5; i++) InsertPlayer(container, i, "Player" + std::to_string(i));
+
+	auto* team = container.CreateTeam(1);
+	container.AddMember(team, 2);
+	container.AddMember(team, 3);
+	ASSERT_EQ(container.GetTeam(1), team);
+	ASSERT_EQ(container.GetTeam(3), team);
+	ASSERT_EQ(container.GetTeam(4), nullptr);
+
+	container.RemoveMember(team, 3, false, false, true);
+	ASSERT_EQ(container.GetTeam(3), nullptr);
+	ASSERT_EQ(container.GetTeam(2), team);
+
+	// Dropping to one member disbands the team.
+	container.RemoveMember(team, 2, false, false, true);
+	ASSERT_EQ(container.GetTeam(1), nullptr);
+	ASSERT_EQ(container.GetTeam(2), nullptr);
+}
+
+#ifdef PERF_TEST
+
+TEST_F(PlayerContainerTest, Benchmark) {
+	constexpr LWOOBJID playerCount = 5000;
+	constexpr size_t friendsPerPlayer = 50;
+	constexpr size_t iterations = 200000;
+
+	PlayerContainer container;
+	for (LWOOBJID i = 1; i <= playerCount; i++) InsertPlayer(container, i, "Player" + std::to_string(i));
+
+	for (LWOOBJID i = 1; i <= playerCount; i++) {
+		auto& player = container.GetPlayerDataMutable(i);
+		for (size_t j = 1; j <= friendsPerPlayer; j++) {
+			FriendData friendData;
+			// Every other friend is offline.
+			friendData.friendID = (i + j * 97) % (playerCount * 2) + 1;
+			player.friends.push_back(friendData);
+		}
+	}
+
+	std::vector<std::string> whisperTargets;
+	for (LWOOBJID i = 1; i <= playerCount; i++) whisperTargets.push_back("pLaYeR" + std::to_string(i));
+
+	size_t found = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		const LWOOBJID senderID = i % playerCount + 1;
+		const auto& sender = container.GetPlayerData(senderID);
+
+		if (i % 2 == 0) {
+			// A whisper looks up the sender by ID and the receiver by name.
+			const auto& receiver = container.GetPlayerData(whisperTargets[(i * 31) % whisperTargets.size()]);
+			if (sender && receiver) found++;
+		} else {
+			// A friend list refresh checks which friends are online.
+			for (const auto& friendData : sender.friends) {
+				if (container.GetPlayerData(friendData.friendID)) found++;
+			}
+		}
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	ASSERT_GT(found, iterations / 2);
+	std::printf("Handled %zu whispers and friend list refreshes for %lld players in %.3fs (%.0f per second)\n",
+		iterations, static_cast<long long>(playerCount), elapsed, iterations / elapsed);
+}
+
+#endif //PERF
+
+TEST_F(PlayerContainerTest, SocialGraphCachesAndWritesThrough) {
+	auto* database = new SocialTestDatabase();
+	Database::_setDatabase(database); // this new is managed by the Database
+
+	SocialGraph graph;
+	ASSERT_EQ(graph.GetFriends(1).size(), 1);
+	ASSERT_EQ(graph.GetFriends(1).size(), 1);
+	ASSERT_EQ(database->friendQueries, 1);
+
+	// Names in a friend list are known without asking the database.
+	ASSERT_EQ(graph.GetCharacter("Friend2")->id, 2);
+	ASSERT_EQ(graph.GetCharacter("Stranger")->id, 42);
+	ASSERT_EQ(graph.GetCharacter("Stranger")->id, 42);
+	ASSERT_FALSE(graph.GetCharacter("Nobody"));
+	ASSERT_FALSE(graph.GetCharacter("Nobody"));
+	ASSERT_EQ(database->characterQueries, 3);
+
+	graph.AddFriend({ "Player1", 1 }, { "Stranger", 42 });
+	ASSERT_EQ(graph.GetFriends(1).size(), 2);
+	ASSERT_EQ(graph.GetBestFriendStatus(42, 1)->bestFriendStatus, 0);
+
+	graph.SetBestFriendStatus(1, 42, 3);
+	ASSERT_EQ(graph.GetBestFriendStatus(1, 42)->bestFriendStatus, 3);
+	ASSERT_TRUE(graph.GetFriends(1).back().isBestFriend);
+
+	// A rename shows up in the friend lists of online friends.
+	graph.GetFriends(2);
+	graph.SetCharacterName(2, "Renamed");
+	ASSERT_EQ(graph.GetFriends(1).front().friendName, "Renamed");
+
+	graph.RemoveFriend(42, 1);
+	ASSERT_EQ(graph.GetFriends(1).size(), 1);
+	ASSERT_EQ(database->friendQueries, 2);
+
+	// Deleting or renaming a character drops every list that mentions it.
+	graph.Forget(2);
+	graph.GetFriends(1);
+	ASSERT_EQ(database->friendQueries, 3);
+
+	// Expired entries are read again.
+	graph.SetLifetime(std::chrono::seconds(0));
+	graph.GetFriends(1);
+	ASSERT_EQ(database->friendQueries, 4);
+}
@@ -0,0 +1,95 @@
+#ifndef __TESTBEHAVIORS__H__
+#define __TESTBEHAVIORS__H__
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Behavior.h"
+#include "BehaviorProgram.h"
+#include "BehaviorTemplate.h"
+#include "CDBehaviorParameterTable.h"
+#include "CDBehaviorTemplateTable.h"
+#include "CDClientDatabase.h"
+#include "CDClientManager.h"
+#include "CDSkillBehaviorTable.h"
+
+/**
+ * Skills and behaviors loaded from an in-memory CDClient, so tests can cast real behavior trees.
+ */
+namespace TestBehaviors {
+	struct Row {
+		uint32_t behaviorID;
+		BehaviorTemplate templateID;
+		std::vector<std::pair<std::string, float>> parameters;
+	};
+
+	inline void LoadTables() {
+		CDClientManager::GetEntriesMutable<CDSkillBehaviorTable>().clear();
+		CDClientManager::GetEntriesMutable<CDBehaviorTemplateTable>().clear();
+		CDClientManager::GetEntriesMutable<CDBehaviorParameterTable>().clear();
+		CDClientManager::GetTable<CDSkillBehaviorTable>()->LoadValuesFromDatabase();
+		CDClientManager::GetTable<CDBehaviorTemplateTable>()->LoadValuesFromDatabase();
+		CDClientManager::GetTable<CDBehaviorParameterTable>()->LoadValuesFromDatabase();
+	}
+
+	/**
+	 * Connects an empty in-memory CDClient, adds the skills and behaviors to it and loads the skill and behavior tables from it.
+	 * @param skills Pairs of a skill id and the behavior it casts
+	 */
+	inline void Load(const std::vector<std::pair<uint32_t, uint32_t>>& skills, const std::vector<Row>& behaviors) {
+		CDClientDatabase::Connect(":memory:");
+		CDClientDatabase::ExecuteDML("CREATE TABLE SkillBehavior (skillID, locStatus, behaviorID, imaginationcost, cooldowngroup, cooldown, isNpcEditor, skillIcon, oomSkillID, oomBehaviorEffectID, castTypeDesc, imBonusUI, lifeBonusUI, armorBonusUI, damageUI, hideIcon, localize, gate_version, cancelType);");
+		CDClientDatabase::ExecuteDML("CREATE TABLE BehaviorTemplate (behaviorID, templateID, effectID, effectHandle);");
+		CDClientDatabase::ExecuteDML("CREATE TABLE BehaviorParameter (behaviorID, parameterID, value);");
+
+		for (const auto& [skillID, behaviorID] : skills) {
+			CDClientDatabase::ExecuteDML("INSERT INTO SkillBehavior (skillID, behaviorID, imaginationcost, cooldowngroup, cooldown) VALUES (" + std::to_string(skillID) + ", " + std::to_string(behaviorID) + ", 0, 0, 0);");
+		}
+
+		for (const auto& behavior : behaviors) {
+			CDClientDatabase::ExecuteDML("INSERT INTO BehaviorTemplate VALUES (" + std::to_string(behavior.behaviorID) + ", " + std::to_string(static_cast<uint32_t>(behavior.templateID)) + ", 0, '');");
+			for (const auto& [name, value] : behavior.parameters) {
+				std::stringstream parameter;
+				parameter << "INSERT INTO BehaviorParameter VALUES (" << behavior.behaviorID << ", '" << name << "', " << value << ");";
+				CDClientDatabase::ExecuteDML(parameter.str());
+			}
+		}
+
+		LoadTables();
+	}
+
+	/**
+	 * Connects a CDClient file, such as a server's CDServer.sqlite, and loads the skill and behavior tables from it.  The file is only read.
+	 */
+	inline void LoadFile(const std::string& path) {
+		CDClientDatabase::Connect(path);
+		LoadTables();
+	}
+
+	/**
+	 * Frees every behavior created since, including ones a test made itself, empties the tables again and closes the CDClient.
+	 */
+	inline void Unload() {
+		// Programs point at the behaviors.
+		BehaviorProgram::ClearCache();
+
+		// Every behavior adds itself to the cache when it is constructed.
+		for (const auto& [behaviorID, behavior] : Behavior::Cache) delete behavior;
+		Behavior::Cache.clear();
+
+		// Loading an empty parameter table again also drops the offsets into the old rows.  It is made in memory so a loaded file is left alone.
+		CDClientDatabase::Disconnect();
+		CDClientDatabase::Connect(":memory:");
+		CDClientDatabase::ExecuteDML("CREATE TABLE BehaviorParameter (behaviorID, parameterID, value);");
+		CDClientManager::GetEntriesMutable<CDSkillBehaviorTable>().clear();
+		CDClientManager::GetEntriesMutable<CDBehaviorTemplateTable>().clear();
+		CDClientManager::GetEntriesMutable<CDBehaviorParameterTable>().clear();
+		CDClientManager::GetTable<CDBehaviorParameterTable>()->LoadValuesFromDatabase();
+
+		CDClientDatabase::Disconnect();
+	}
+};
+
+#endif  //!__TESTBEHAVIORS__H__
@@ -0,0 +1,147 @@
+#include "GameDependencies.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "BuffComponent.h"
+#include "CDClientDatabase.h"
+#include "Entity.h"
+#include "tinyxml2.h"
+
+namespace {
+	constexpr int32_t TIMED_BUFF = 101;
+	// Ticks 3 times, a second apart.
+	constexpr int32_t DAMAGE_OVER_TIME_BUFF = 100;
+};
+
+class BuffComponentTest : public GameDependenciesTest {
+protected:
+	Entity* baseEntity;
+	BuffComponent* buffComponent;
+
+	void SetUp() override {
+		SetUpDependencies();
+
+		CDClientDatabase::Connect(":memory:");
+		CDClientDatabase::ExecuteDML("CREATE TABLE BuffParameters (BuffID, ParameterName, NumberValue, StringValue, EffectID);");
+		CDClientDatabase::ExecuteDML("INSERT INTO BuffParameters VALUES (100, 'overtime', 0, '0,3,1,0', 0);");
+
+		baseEntity = new Entity(15, GameDependenciesTest::info);
+		buffComponent = baseEntity->AddComponent<BuffComponent>();
+	}
+
+	void TearDown() override {
+		delete baseEntity;
+		CDClientDatabase::Disconnect();
+		TearDownDependencies();
+	}
+
+	// Reads the stacks a buff has left out of the character xml.
+	int32_t GetStacks(const int32_t id) {
+		tinyxml2::XMLDocument doc;
+		doc.Parse("<obj><dest/></obj>");
+		buffComponent->UpdateXml(doc);
+
+		for (auto* buff = doc.FirstChildElement("obj")->FirstChildElement("dest")->FirstChildElement("buff")->FirstChildElement("b"); buff; buff = buff->NextSiblingElement("b")) {
+			if (buff->IntAttribute("id") == id) return buff->IntAttribute("s");
+		}
+		return -1;
+	}
+};
+
+TEST_F(BuffComponentTest, BuffsRunOutOnTheZoneClock) {
+	buffComponent->ApplyBuff(TIMED_BUFF, 2.0f, LWOOBJID_EMPTY);
+	BuffComponent::UpdateTimers(1.0f);
+	ASSERT_TRUE(buffComponent->HasBuff(TIMED_BUFF));
+	BuffComponent::UpdateTimers(1.5f);
+	ASSERT_FALSE(buffComponent->HasBuff(TIMED_BUFF));
+
+	// Applying a buff again restarts its duration.
+	buffComponent->ApplyBuff(TIMED_BUFF, 2.0f, LWOOBJID_EMPTY);
+	BuffComponent::UpdateTimers(1.5f);
+	buffComponent->ApplyBuff(TIMED_BUFF, 2.0f, LWOOBJID_EMPTY);
+	BuffComponent::UpdateTimers(1.0f);
+	ASSERT_TRUE(buffComponent->HasBuff(TIMED_BUFF));
+	BuffComponent::UpdateTimers(1.5f);
+	ASSERT_FALSE(buffComponent->HasBuff(TIMED_BUFF));
+}
+
+TEST_F(BuffComponentTest, DamageOverTimeTicks) {
+	buffComponent->ApplyBuff(DAMAGE_OVER_TIME_BUFF, 0.0f, LWOOBJID_EMPTY);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 3);
+
+	BuffComponent::UpdateTimers(0.5f);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 3);
+	BuffComponent::UpdateTimers(0.6f);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 2);
+	BuffComponent::UpdateTimers(1.0f);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 1);
+	BuffComponent::UpdateTimers(1.0f);
+	BuffComponent::UpdateTimers(1.0f);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 0);
+
+	// Buffs without a duration stay until they are removed.
+	ASSERT_TRUE(buffComponent->HasBuff(DAMAGE_OVER_TIME_BUFF));
+	buffComponent->RemoveBuff(DAMAGE_OVER_TIME_BUFF);
+	buffComponent->Update(0.0f);
+	ASSERT_FALSE(buffComponent->HasBuff(DAMAGE_OVER_TIME_BUFF));
+}
+
+TEST_F(BuffComponentTest, SleepingEntitiesHoldTheirBuffs) {
+	buffComponent->ApplyBuff(TIMED_BUFF, 3.0f, LWOOBJID_EMPTY);
+	buffComponent->ApplyBuff(DAMAGE_OVER_TIME_BUFF, 0.0f, LWOOBJID_EMPTY);
+
+	// An entity nobody can see sleeps from its next update on, and its buffs stop.
+	baseEntity->SetIsGhostingCandidate(true);
+	baseEntity->Update(0.0f);
+	BuffComponent::UpdateTimers(1.0f);
+	BuffComponent::UpdateTimers(10.0f);
+	ASSERT_TRUE(buffComponent->HasBuff(TIMED_BUFF));
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 3);
+
+	// Once it wakes up they carry on where they left off when it fell asleep, 11 seconds ago.
+	baseEntity->SetIsGhostingCandidate(false);
+	baseEntity->Update(0.0f);
+	BuffComponent::UpdateTimers(1.0f);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 2);
+	BuffComponent::UpdateTimers(1.5f);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 1);
+	ASSERT_TRUE(buffComponent->HasBuff(TIMED_BUFF));
+	BuffComponent::UpdateTimers(1.0f);
+	ASSERT_EQ(GetStacks(DAMAGE_OVER_TIME_BUFF), 0);
+	ASSERT_FALSE(buffComponent->HasBuff(TIMED_BUFF));
+}
+
+#ifdef PERF_TEST
+TEST_F(BuffComponentTest, Benchmark) {
+	constexpr uint32_t entityCount = 1000;
+	constexpr int32_t buffsPerEntity = 16;
+	constexpr float frameTime = 1.0f / 30.0f;
+	constexpr uint32_t frames = 30 * 60;
+
+	// A raid's worth of enemies, every one of them carrying a stack of buffs that run out over the next minute.
+	std::vector<Entity*> entities;
+	std::vector<BuffComponent*> components;
+	for (uint32_t i = 0; i < entityCount; i++) {
+		auto* entity = entities.emplace_back(new Entity(1000 + i, GameDependenciesTest::info));
+		auto* component = components.emplace_back(entity->AddComponent<BuffComponent>());
+		for (int32_t buff = 0; buff < buffsPerEntity; buff++) {
+			component->ApplyBuff(200 + buff, static_cast<float>(5 + (i * 7 + buff * 3) % 50), LWOOBJID_EMPTY);
+		}
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		for (auto* component : components) component->Update(frameTime);
+		BuffComponent::UpdateTimers(frameTime);
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for (auto* component : components) ASSERT_FALSE(component->HasBuff(200));
+	std::printf("Ran %u frames of %u entities with %d buffs each in %.3fs (%.1fus per frame)\n",
+		frames, entityCount, buffsPerEntity, elapsed, elapsed * 1e6 / frames);
+
+	for (auto* entity : entities) delete entity;
+}
+#endif //PERF
@@ -0,0 +1,164 @@
+#include "GameDependencies.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "CDComponentsRegistryTable.h"
+#include "CDItemComponentTable.h"
+#include "Entity.h"
+#include "eInventoryType.h"
+#include "eReplicaComponentType.h"
+#include "Inventory.h"
+#include "InventoryComponent.h"
+#include "Item.h"
+
+namespace {
+	constexpr LOT FIRST_BRICK = 20000;
+};
+
+class InventoryComponentTest : public GameDependenciesTest {
+protected:
+	Entity* baseEntity;
+	InventoryComponent* inventoryComponent;
+	std::vector<LOT> seededBricks;
+
+	void SetUp() override {
+		SetUpDependencies();
+
+		// Object IDs of new items are random, so seed them to keep the tests repeatable.
+		Game::randomEngine.seed(45);
+
+		// The test entity has no components in the registry.
+		CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>().insert_or_assign(GameDependenciesTest::info.lot, 0);
+
+		baseEntity = new Entity(15, GameDependenciesTest::info);
+		inventoryComponent = baseEntity->AddComponent<InventoryComponent>();
+	}
+
+	void TearDown() override {
+		delete baseEntity;
+
+		auto& registry = CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>();
+		auto& itemComponents = CDClientManager::GetEntriesMutable<CDItemComponentTable>();
+		registry.erase(GameDependenciesTest::info.lot);
+		for (const auto lot : seededBricks) {
+			registry.erase(lot);
+			registry.erase(GetItemComponentKey(lot));
+			itemComponents.erase(lot);
+		}
+
+		TearDownDependencies();
+	}
+
+	static uint64_t GetItemComponentKey(const LOT lot) {
+		return static_cast<uint64_t>(eReplicaComponentType::ITEM) << 32 | static_cast<uint64_t>(lot);
+	}
+
+	// Adds the bricks FIRST_BRICK to FIRST_BRICK + count - 1 to the tables.  Every brick uses its LOT as its item component ID.
+	void SeedBricks(const uint32_t count) {
+		auto& registry = CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>();
+		auto& itemComponents = CDClientManager::GetEntriesMutable<CDItemComponentTable>();
+
+		for (LOT lot = FIRST_BRICK; lot < FIRST_BRICK + static_cast<LOT>(count); lot++) {
+			registry.insert_or_assign(lot, 0);
+			registry.insert_or_assign(GetItemComponentKey(lot), lot);
+
+			CDItemComponent itemComponent{};
+			itemComponent.id = lot;
+			itemComponent.itemType = 1; // brick
+			itemComponent.stackSize = 999;
+			itemComponents.insert_or_assign(lot, itemComponent);
+			seededBricks.push_back(lot);
+		}
+	}
+};
+
+TEST_F(InventoryComponentTest, IndexesFollowItems) {
+	SeedBricks(21);
+	auto* bricks = inventoryComponent->GetInventory(eInventoryType::BRICKS);
+
+	for (LOT lot = FIRST_BRICK; lot < FIRST_BRICK + 10; lot++) inventoryComponent->AddItem(lot, 5);
+	ASSERT_EQ(bricks->GetItems().size(), 10);
+	ASSERT_EQ(bricks->GetSlots().size(), 10);
+	ASSERT_EQ(bricks->GetLotCount(FIRST_BRICK + 3), 5);
+
+	// Bricks stack, so adding more of a LOT grows its one stack.
+	inventoryComponent->AddItem(FIRST_BRICK + 3, 7);
+	ASSERT_EQ(bricks->GetItems().size(), 10);
+	ASSERT_EQ(bricks->GetLotCount(FIRST_BRICK + 3), 12);
+
+	auto* item = bricks->FindItemByLot(FIRST_BRICK + 3);
+	ASSERT_NE(item, nullptr);
+	ASSERT_EQ(bricks->FindItemBySlot(item->GetSlot()), item);
+	ASSERT_EQ(bricks->FindEmptySlot(), 10);
+
+	// Removing a stack frees its slot for the next new stack.
+	const auto freedSlot = item->GetSlot();
+	ASSERT_TRUE(inventoryComponent->RemoveItem(FIRST_BRICK + 3, 12));
+	ASSERT_EQ(bricks->FindItemByLot(FIRST_BRICK + 3), nullptr);
+	ASSERT_EQ(bricks->GetLotCount(FIRST_BRICK + 3), 0);
+	ASSERT_TRUE(bricks->IsSlotEmpty(freedSlot));
+	ASSERT_EQ(bricks->FindEmptySlot(), freedSlot);
+
+	inventoryComponent->AddItem(FIRST_BRICK + 20, 1);
+	ASSERT_EQ(bricks->FindItemByLot(FIRST_BRICK + 20)->GetSlot(), freedSlot);
+
+	// Moving onto a taken slot swaps the two items.
+	auto* first = bricks->FindItemBySlot(0);
+	auto* second = bricks->FindItemBySlot(1);
+	first->SetSlot(1);
+	ASSERT_EQ(bricks->FindItemBySlot(0), second);
+	ASSERT_EQ(bricks->FindItemBySlot(1), first);
+
+	// Moving onto an empty slot frees the old one.
+	first->SetSlot(100);
+	ASSERT_TRUE(bricks->IsSlotEmpty(1));
+	ASSERT_EQ(bricks->FindItemBySlot(100), first);
+	ASSERT_EQ(bricks->FindEmptySlot(), 1);
+}
+
+TEST_F(InventoryComponentTest, SlotsOutsideTheInventoryAreRejected) {
+	SeedBricks(1);
+	auto* bricks = inventoryComponent->GetInventory(eInventoryType::BRICKS);
+	inventoryComponent->AddItem(FIRST_BRICK, 1);
+	auto* item = bricks->FindItemByLot(FIRST_BRICK);
+	ASSERT_NE(item, nullptr);
+	const auto slot = item->GetSlot();
+
+	// Clients pick the slot of a move, so one past the end or far beyond it must not reach the slot index.
+	inventoryComponent->MoveStack(item, eInventoryType::BRICKS, UINT32_MAX);
+	inventoryComponent->MoveStack(item, eInventoryType::INVALID, bricks->GetSize());
+	item->SetSlot(UINT32_MAX);
+	ASSERT_EQ(item->GetSlot(), slot);
+	ASSERT_EQ(bricks->FindItemBySlot(slot), item);
+	ASSERT_EQ(bricks->GetSlots().size(), 1);
+
+	// The last slot is still fine.
+	inventoryComponent->MoveStack(item, eInventoryType::BRICKS, bricks->GetSize() - 1);
+	ASSERT_EQ(bricks->FindItemBySlot(bricks->GetSize() - 1), item);
+	ASSERT_EQ(bricks->FindEmptySlot(), slot);
+}
+
+#ifdef PERF_TEST
+TEST_F(InventoryComponentTest, Benchmark) {
+	constexpr uint32_t BRICK_COUNT = 10000;
+	constexpr LOT LAST_BRICK = FIRST_BRICK + BRICK_COUNT;
+	SeedBricks(BRICK_COUNT);
+	auto* bricks = inventoryComponent->GetInventory(eInventoryType::BRICKS);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (LOT lot = FIRST_BRICK; lot < LAST_BRICK; lot++) inventoryComponent->AddItem(lot, 10, eLootSourceType::NONE, eInventoryType::INVALID, {}, LWOOBJID_EMPTY, false);
+	const auto added = std::chrono::steady_clock::now();
+	ASSERT_EQ(bricks->GetItems().size(), BRICK_COUNT);
+
+	for (LOT lot = FIRST_BRICK; lot < LAST_BRICK; lot++) ASSERT_TRUE(inventoryComponent->RemoveItem(lot, 10, eInventoryType::INVALID, false, true));
+	const auto removed = std::chrono::steady_clock::now();
+	ASSERT_TRUE(bricks->GetItems().empty());
+	ASSERT_TRUE(bricks->GetSlots().empty());
+
+	std::printf("Added %u brick stacks in %.3fs and removed them in %.3fs\n", BRICK_COUNT,
+		std::chrono::duration<double>(added - start).count(), std::chrono::duration<double>(removed - added).count());
+}
+#endif //PERF
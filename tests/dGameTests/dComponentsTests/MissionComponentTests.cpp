@@ -0,0 +1,180 @@
+#include "GameDependencies.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "CDClientDatabase.h"
+#include "CDMissionTasksTable.h"
+#include "CDMissionsTable.h"
+#include "Entity.h"
+#include "eMissionState.h"
+#include "eMissionTaskType.h"
+#include "Mission.h"
+#include "MissionComponent.h"
+#include "tinyxml2.h"
+
+namespace {
+	// About what a character that has done everything has: most missions and achievements complete, a hundred still going.
+	constexpr uint32_t MISSION_COUNT = 1800;
+	constexpr uint32_t COMPLETED_COUNT = 1700;
+
+	constexpr eMissionTaskType TASK_TYPES[] = {
+		eMissionTaskType::SMASH, eMissionTaskType::USE_ITEM, eMissionTaskType::GATHER, eMissionTaskType::TALK_TO_NPC,
+		eMissionTaskType::SCRIPT, eMissionTaskType::EMOTE, eMissionTaskType::USE_SKILL, eMissionTaskType::PLAYER_FLAG,
+	};
+
+	// The two tasks of every mission.  Smash tasks also list a few other LOTs in their target group.
+	eMissionTaskType GetTaskType(const uint32_t missionId, const uint32_t task) {
+		return TASK_TYPES[(missionId + task * 3) % std::size(TASK_TYPES)];
+	}
+
+	uint32_t GetTaskTarget(const uint32_t missionId, const uint32_t task) {
+		return 10000 + (missionId * 2 + task) % 500;
+	}
+};
+
+class MissionComponentTest : public GameDependenciesTest {
+protected:
+	Entity* baseEntity;
+	MissionComponent* missionComponent;
+
+	void SetUp() override {
+		SetUpDependencies();
+		LoadMissionTables();
+		baseEntity = new Entity(15, GameDependenciesTest::info);
+		missionComponent = baseEntity->AddComponent<MissionComponent>();
+	}
+
+	void TearDown() override {
+		delete baseEntity;
+		UnloadMissionTables();
+		TearDownDependencies();
+	}
+
+	// Connects an empty in-memory CDClient, fills its mission tables and loads them.
+	void LoadMissionTables() {
+		CDClientDatabase::Connect(":memory:");
+		CDClientDatabase::ExecuteDML("CREATE TABLE Missions (id, defined_type, defined_subtype, UISortOrder, offer_objectID, target_objectID, reward_currency, LegoScore, reward_reputation, isChoiceReward, reward_item1, reward_item1_count, reward_item2, reward_item2_count, reward_item3, reward_item3_count, reward_item4, reward_item4_count, reward_emote, reward_emote2, reward_emote3, reward_emote4, reward_maximagination, reward_maxhealth, reward_maxinventory, reward_maxmodel, reward_maxwidget, reward_maxwallet, repeatable, reward_currency_repeatable, reward_item1_repeatable, reward_item1_repeat_count, reward_item2_repeatable, reward_item2_repeat_count, reward_item3_repeatable, reward_item3_repeat_count, reward_item4_repeatable, reward_item4_repeat_count, time_limit, isMission, missionIconID, prereqMissionID, localize, inMOTD, cooldownTime, isRandom, randomPool, UIPrereqID, gate_version, HUDStates, locStatus, reward_bankinventory);");
+		CDClientDatabase::ExecuteDML("CREATE TABLE MissionTasks (id, locStatus, taskType, target, targetGroup, targetValue, taskParam1, largeTaskIcon, IconID, uid, largeTaskIconID, localize, gate_version);");
+
+		std::stringstream missions;
+		std::stringstream tasks;
+		missions << "INSERT INTO Missions (id, isMission, repeatable) VALUES ";
+		tasks << "INSERT INTO MissionTasks (id, taskType, target, targetGroup, targetValue, taskParam1, uid) VALUES ";
+		for (uint32_t id = 1; id <= MISSION_COUNT; id++) {
+			missions << (id > 1 ? "," : "") << "(" << id << ", " << (id % 3 == 0) << ", 0)";
+			for (uint32_t task = 0; task < 2; task++) {
+				const auto target = GetTaskTarget(id, task);
+				const auto type = GetTaskType(id, task);
+				std::string targetGroup;
+				if (type == eMissionTaskType::SMASH) targetGroup = std::to_string(target + 1) + "," + std::to_string(target + 2);
+				tasks << (id > 1 || task > 0 ? "," : "") << "(" << id << ", " << static_cast<int>(type) << ", " << target << ", '" << targetGroup << "', 1000000, '', " << id * 2 + task << ")";
+			}
+		}
+		CDClientDatabase::ExecuteDML(missions.str());
+		CDClientDatabase::ExecuteDML(tasks.str());
+
+		CDClientManager::GetEntriesMutable<CDMissionsTable>().clear();
+		CDClientManager::GetEntriesMutable<CDMissionTasksTable>().clear();
+		CDClientManager::GetTable<CDMissionsTable>()->LoadValuesFromDatabase();
+		CDClientManager::GetTable<CDMissionTasksTable>()->LoadValuesFromDatabase();
+	}
+
+	// Empties the mission tables again and closes the CDClient.
+	void UnloadMissionTables() {
+		// Loading the now empty tables again also drops their indexes into the old rows.
+		CDClientDatabase::ExecuteDML("DELETE FROM Missions;");
+		CDClientDatabase::ExecuteDML("DELETE FROM MissionTasks;");
+		CDClientManager::GetEntriesMutable<CDMissionsTable>().clear();
+		CDClientManager::GetEntriesMutable<CDMissionTasksTable>().clear();
+		CDClientManager::GetTable<CDMissionsTable>()->LoadValuesFromDatabase();
+		CDClientManager::GetTable<CDMissionTasksTable>()->LoadValuesFromDatabase();
+
+		CDClientDatabase::Disconnect();
+	}
+
+	void LoadCharacterMissions() {
+		std::stringstream xml;
+		xml << "<obj><mis><done>";
+		for (uint32_t id = 1; id <= COMPLETED_COUNT; id++) xml << "<m id=\"" << id << "\" state=\"8\" cct=\"1\" cts=\"0\"/>";
+		xml << "</done><cur>";
+		for (uint32_t id = COMPLETED_COUNT + 1; id <= MISSION_COUNT; id++) xml << "<m id=\"" << id << "\" state=\"2\" o=\"" << id << "\"><sv v=\"0\"/><sv v=\"0\"/></m>";
+		xml << "</cur></mis></obj>";
+
+		tinyxml2::XMLDocument doc;
+		doc.Parse(xml.str().c_str());
+		missionComponent->LoadFromXml(doc);
+	}
+};
+
+TEST_F(MissionComponentTest, TargetIndexMatchesTableScan) {
+	auto* tasksTable = CDClientManager::GetTable<CDMissionTasksTable>();
+	for (const auto type : TASK_TYPES) {
+		for (uint32_t value = 9990; value < 10510; value++) {
+			std::vector<const CDMissionTasks*> expected;
+			for (const auto& task : tasksTable->GetEntries()) {
+				if (task.taskType != static_cast<uint32_t>(type)) continue;
+
+				auto matches = task.target == value;
+				auto stream = std::istringstream(task.targetGroup);
+				std::string token;
+				while (std::getline(stream, token, ',')) matches |= std::stoi(token) == static_cast<int32_t>(value);
+				if (matches) expected.push_back(&task);
+			}
+
+			const auto actual = tasksTable->GetByTypeAndTarget(static_cast<uint32_t>(type), value);
+			ASSERT_EQ(expected, std::vector<const CDMissionTasks*>(actual.begin(), actual.end()));
+		}
+	}
+
+	ASSERT_EQ(tasksTable->GetByTypeAndTargetGroup(static_cast<uint32_t>(eMissionTaskType::USE_ITEM), "").size(), MISSION_COUNT * 2 / std::size(TASK_TYPES));
+}
+
+TEST_F(MissionComponentTest, ProgressOnlyReachesActiveTasks) {
+	LoadCharacterMissions();
+
+	// Find an active and a completed mission with a smash task.
+	uint32_t activeId = 0;
+	uint32_t completedId = 0;
+	for (uint32_t id = 1; id <= MISSION_COUNT; id++) {
+		if (GetTaskType(id, 0) != eMissionTaskType::SMASH) continue;
+		if (id > COMPLETED_COUNT && !activeId) activeId = id;
+		if (id <= COMPLETED_COUNT && !completedId) completedId = id;
+	}
+	ASSERT_NE(activeId, 0);
+	ASSERT_NE(completedId, 0);
+
+	auto* active = missionComponent->GetMission(activeId);
+	missionComponent->Progress(eMissionTaskType::SMASH, GetTaskTarget(activeId, 0) + 2);
+	ASSERT_EQ(active->GetTasks()[0]->GetProgress(), 1);
+	ASSERT_EQ(missionComponent->GetMission(completedId)->GetTasks()[0]->GetProgress(), 0);
+
+	// A completed mission drops out of the index, and one made active again comes back.
+	active->SetMissionState(eMissionState::COMPLETE);
+	missionComponent->Progress(eMissionTaskType::SMASH, GetTaskTarget(activeId, 0));
+	ASSERT_EQ(active->GetTasks()[0]->GetProgress(), 1);
+
+	active->SetMissionState(eMissionState::COMPLETE_ACTIVE);
+	missionComponent->Progress(eMissionTaskType::SMASH, GetTaskTarget(activeId, 0));
+	ASSERT_EQ(active->GetTasks()[0]->GetProgress(), 2);
+}
+
+#ifdef PERF_TEST
+TEST_F(MissionComponentTest, Benchmark) {
+	constexpr size_t events = 200000;
+	LoadCharacterMissions();
+
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < events; i++) {
+		// Mostly kills and item uses, like a player out fighting.
+		const auto type = i % 4 == 3 ? eMissionTaskType::USE_ITEM : eMissionTaskType::SMASH;
+		missionComponent->Progress(type, static_cast<int32_t>(10000 + i % 600));
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf("Progressed %zu events against %u missions in %.3fs (%.0f per second)\n", events, MISSION_COUNT, elapsed, events / elapsed);
+}
+#endif //PERF
@@ -0,0 +1,166 @@
+#include "GameDependencies.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+
+#ifdef PERF_TEST
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif //PERF
+
+#include "BehaviorContext.h"
+#include "BehaviorContextPool.h"
+#include "CDComponentsRegistryTable.h"
+#include "DestroyableComponent.h"
+#include "Entity.h"
+#include "SkillComponent.h"
+#include "TestBehaviors.h"
+
+namespace {
+	constexpr uint32_t SKILL = 1;
+	constexpr uint32_t ROOT_BEHAVIOR = 10;
+	constexpr uint32_t ATTACK_BEHAVIOR = 12;
+	constexpr LOT TARGET_LOT = 1000;
+
+	// Counts the contexts and bitstreams the pool allocates while it is alive.
+	class PoolAllocationCounter {
+	public:
+		PoolAllocationCounter() : m_Start(BehaviorContextPool::GetAllocationCount()) {}
+
+		size_t Get() const { return BehaviorContextPool::GetAllocationCount() - m_Start; }
+
+	private:
+		size_t m_Start;
+	};
+
+#ifdef PERF_TEST
+	std::atomic<size_t> g_HeapAllocations = 0;
+#endif //PERF
+};
+
+#ifdef PERF_TEST
+// Counts every heap allocation in the test binary, so the benchmark can report allocations per cast.
+void* operator new(std::size_t size) {
+	g_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (auto* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+#endif //PERF
+
+class SkillComponentTest : public GameDependenciesTest {
+protected:
+	Entity* baseEntity;
+	SkillComponent* skillComponent;
+	Entity* target;
+	DestroyableComponent* targetDestroyable;
+
+	void SetUp() override {
+		SetUpDependencies();
+
+		// An attack in a chain and the same attack again behind a switch: AND(CHAIN(attack), SWITCH(attack, nothing))
+		TestBehaviors::Load({ { SKILL, ROOT_BEHAVIOR } }, {
+			{ ROOT_BEHAVIOR, BehaviorTemplate::AND, { { "behavior 1", 11 }, { "behavior 2", 13 } } },
+			{ 11, BehaviorTemplate::CHAIN, { { "behavior 1", ATTACK_BEHAVIOR } } },
+			{ ATTACK_BEHAVIOR, BehaviorTemplate::BASIC_ATTACK, { { "min damage", 1 }, { "max damage", 1 } } },
+			{ 13, BehaviorTemplate::SWITCH, { { "action_true", ATTACK_BEHAVIOR }, { "action_false", 0 }, { "distance", 10 } } },
+		});
+
+		baseEntity = new Entity(15, GameDependenciesTest::info);
+		skillComponent = baseEntity->AddComponent<SkillComponent>();
+
+		// Without a registry row for the LOT, making the entity would look its components up in the database.
+		CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>().insert_or_assign(TARGET_LOT, 0);
+		auto targetInfo = GameDependenciesTest::info;
+		targetInfo.lot = TARGET_LOT;
+		target = Game::entityManager->CreateEntity(targetInfo);
+		targetDestroyable = target->AddComponent<DestroyableComponent>();
+		targetDestroyable->SetMaxHealth(1000000.0f);
+		targetDestroyable->SetHealth(1000000);
+	}
+
+	void TearDown() override {
+		delete baseEntity;
+		Game::entityManager->DestroyEntity(target);
+		Game::entityManager->UpdateEntities(0.0f);
+		CDClientManager::GetEntriesMutable<CDComponentsRegistryTable>().erase(TARGET_LOT);
+		BehaviorContextPool::Clear();
+		TestBehaviors::Unload();
+		TearDownDependencies();
+	}
+};
+
+TEST_F(SkillComponentTest, ContextsAreReusedAndReset) {
+	BehaviorContextPool::Clear();
+
+	auto* context = BehaviorContextPool::Acquire(15);
+	context->skillID = 42;
+	context->failed = true;
+	context->scheduledUpdates.reserve(16);
+	BehaviorContextPool::Release(context);
+	ASSERT_EQ(BehaviorContextPool::GetFreeCount(), 1);
+
+	auto* reused = BehaviorContextPool::Acquire(16);
+	ASSERT_EQ(reused, context);
+	ASSERT_EQ(reused->originator, 16);
+	ASSERT_EQ(reused->skillID, 0);
+	ASSERT_FALSE(reused->failed);
+	ASSERT_GE(reused->scheduledUpdates.capacity(), 16);
+	BehaviorContextPool::Release(reused);
+
+	// A finished cast goes back to the pool on the next update.
+	ASSERT_TRUE(skillComponent->CalculateBehavior(SKILL, ROOT_BEHAVIOR, target->GetObjectID()).success);
+	ASSERT_EQ(BehaviorContextPool::GetFreeCount(), 0);
+	skillComponent->Update(0.0f);
+	ASSERT_EQ(BehaviorContextPool::GetFreeCount(), 1);
+}
+
+TEST_F(SkillComponentTest, WarmCastsDoNotAllocateContexts) {
+	ASSERT_TRUE(skillComponent->CalculateBehavior(SKILL, ROOT_BEHAVIOR, target->GetObjectID()).success);
+	skillComponent->Update(0.0f);
+	const auto health = targetDestroyable->GetHealth();
+
+	PoolAllocationCounter allocations;
+	for (int i = 0; i < 10; i++) {
+		ASSERT_TRUE(skillComponent->CalculateBehavior(SKILL, ROOT_BEHAVIOR, target->GetObjectID()).success);
+		skillComponent->Update(0.0f);
+	}
+	ASSERT_EQ(allocations.Get(), 0);
+
+	// Both attacks hit every time.
+	ASSERT_EQ(targetDestroyable->GetHealth(), health - 20);
+}
+
+#ifdef PERF_TEST
+TEST_F(SkillComponentTest, Benchmark) {
+	constexpr size_t casts = 100000;
+
+	// Warm the pool and the behavior cache.
+	skillComponent->CalculateBehavior(SKILL, ROOT_BEHAVIOR, target->GetObjectID());
+	skillComponent->Update(0.0f);
+
+	size_t succeeded = 0;
+	PoolAllocationCounter allocations;
+	const auto heapAllocationsBefore = g_HeapAllocations.load();
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < casts; i++) {
+		if (skillComponent->CalculateBehavior(SKILL, ROOT_BEHAVIOR, target->GetObjectID()).success) succeeded++;
+		skillComponent->Update(0.0f);
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const auto heapAllocations = g_HeapAllocations.load() - heapAllocationsBefore;
+
+	ASSERT_EQ(succeeded, casts);
+	std::printf("Cast %zu skills in %.3fs (%.0f per second), %.2f heap allocations per cast, %zu contexts and bitstreams allocated by the pool\n",
+		casts, elapsed, casts / elapsed, static_cast<double>(heapAllocations) / casts, allocations.Get());
+}
+#endif //PERF
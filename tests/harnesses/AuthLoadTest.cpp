@@ -0,0 +1,173 @@
+// Fires synthetic logins at an auth server and reports how quickly they were answered.
+// Every login uses the same account, so the server does the same database lookup and password check each time.
+//
+// Usage: AuthLoadTest <username> <password> [logins] [concurrent clients] [host] [port]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dCommonVars.h"
+#include "dServer.h"
+#include "AuthPackets.h"
+#include "BitStreamUtils.h"
+#include "GeneralUtils.h"
+#include "eConnectionType.h"
+#include "eLoginResponse.h"
+#include "MessageType/Auth.h"
+#include "MessageType/Client.h"
+#include "MessageType/Server.h"
+
+#include "RakNetworkFactory.h"
+#include "RakPeerInterface.h"
+#include "MessageIdentifiers.h"
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr auto TIMEOUT = std::chrono::seconds(60);
+
+	struct SyntheticClient {
+		RakPeerInterface* peer = nullptr;
+		Clock::time_point connectStart;
+		Clock::time_point loginStart;
+		bool done = false;
+	};
+
+	void SendHandshake(RakPeerInterface* peer, const SystemAddress& server) {
+		RakNet::BitStream bitStream;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::SERVER, MessageType::Server::VERSION_CONFIRM);
+		bitStream.Write<uint32_t>(171022);
+		bitStream.Write<uint32_t>(0);
+		bitStream.Write(ServiceId::Client);
+		bitStream.Write<uint32_t>(0); // process ID
+		bitStream.Write<uint16_t>(peer->GetInternalID().port);
+		for (int i = 0; i < 33; i++) bitStream.Write<uint8_t>(0);
+		peer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, server, false);
+	}
+
+	void SendLoginRequest(RakPeerInterface* peer, const SystemAddress& server, const std::string& username, const std::string& password) {
+		RakNet::BitStream bitStream;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::AUTH, MessageType::Auth::LOGIN_REQUEST);
+		bitStream.Write(LUWString(username));
+		bitStream.Write(LUWString(password, 41));
+		bitStream.Write(LanguageCodeID::en_US);
+		bitStream.Write(ClientOS::WINDOWS);
+		bitStream.Write(LUWString("", 256)); // memory stats
+		bitStream.Write(LUWString("AuthLoadTest", 128)); // video card
+		for (int i = 0; i < 2; i++) bitStream.Write<uint32_t>(0); // processor count and type
+		for (int i = 0; i < 2; i++) bitStream.Write<uint16_t>(0); // processor level and revision
+		for (int i = 0; i < 5; i++) bitStream.Write<uint32_t>(0); // os version info
+		peer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, server, false);
+	}
+
+	double Percentile(std::vector<double>& values, const double percentile) {
+		if (values.empty()) return 0.0;
+		std::sort(values.begin(), values.end());
+		const auto index = std::min(values.size() - 1, static_cast<size_t>(percentile * values.size()));
+		return values[index];
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		std::printf("Usage: %s <username> <password> [logins] [concurrent clients] [host] [port]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::string username = argv[1];
+	const std::string password = argv[2];
+	const uint32_t logins = argc > 3 ? GeneralUtils::TryParse<uint32_t>(argv[3]).value_or(100) : 100;
+	const uint32_t concurrency = std::max(1U, argc > 4 ? GeneralUtils::TryParse<uint32_t>(argv[4]).value_or(100) : std::min(logins, 100U));
+	const std::string host = argc > 5 ? argv[5] : "localhost";
+	const uint16_t port = argc > 6 ? GeneralUtils::TryParse<uint16_t>(argv[6]).value_or(1001) : 1001;
+
+	std::printf("Sending %u logins for %s to %s:%u, %u at a time\n", logins, username.c_str(), host.c_str(), port, concurrency);
+
+	std::vector<SyntheticClient> clients;
+	std::vector<double> connectTimes;
+	std::vector<double> loginTimes;
+	std::map<eLoginResponse, uint32_t> responses;
+	uint32_t started = 0;
+	uint32_t failedConnections = 0;
+	const auto testStart = Clock::now();
+
+	while ((started < logins || !clients.empty()) && Clock::now() - testStart < TIMEOUT) {
+		while (started < logins && clients.size() < concurrency) {
+			auto& client = clients.emplace_back();
+			client.peer = RakNetworkFactory::GetRakPeerInterface();
+			auto socket = SocketDescriptor(0, 0);
+			client.peer->Startup(1, 30, &socket, 1);
+			client.peer->Connect(host.c_str(), port, "3.25 ND1", 8);
+			client.connectStart = Clock::now();
+			started++;
+		}
+
+		for (auto& client : clients) {
+			for (auto* packet = client.peer->Receive(); packet; client.peer->DeallocatePacket(packet), packet = client.peer->Receive()) {
+				const auto now = Clock::now();
+				switch (packet->data[0]) {
+				case ID_CONNECTION_REQUEST_ACCEPTED:
+					connectTimes.push_back(std::chrono::duration<double, std::milli>(now - client.connectStart).count());
+					SendHandshake(client.peer, packet->systemAddress);
+					break;
+				case ID_CONNECTION_ATTEMPT_FAILED:
+				case ID_NO_FREE_INCOMING_CONNECTIONS:
+				case ID_INVALID_PASSWORD:
+				case ID_DISCONNECTION_NOTIFICATION:
+				case ID_CONNECTION_LOST:
+					if (!client.done) failedConnections++;
+					client.done = true;
+					break;
+				case ID_USER_PACKET_ENUM: {
+					if (packet->length < 9) break;
+					const auto connectionType = static_cast<eConnectionType>(packet->data[1]);
+					if (connectionType == eConnectionType::SERVER && packet->data[3] == static_cast<uint8_t>(MessageType::Server::VERSION_CONFIRM)) {
+						client.loginStart = now;
+						SendLoginRequest(client.peer, packet->systemAddress, username, password);
+					} else if (connectionType == eConnectionType::CLIENT && packet->data[3] == static_cast<uint8_t>(MessageType::Client::LOGIN_RESPONSE)) {
+						loginTimes.push_back(std::chrono::duration<double, std::milli>(now - client.loginStart).count());
+						responses[static_cast<eLoginResponse>(packet->data[8])]++;
+						client.done = true;
+					}
+					break;
+				}
+				default:
+					break;
+				}
+			}
+		}
+
+		std::erase_if(clients, [](const SyntheticClient& client) {
+			if (!client.done) return false;
+			client.peer->Shutdown(0);
+			RakNetworkFactory::DestroyRakPeerInterface(client.peer);
+			return true;
+		});
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const auto elapsed = std::chrono::duration<double>(Clock::now() - testStart).count();
+	const auto timedOut = static_cast<uint32_t>(clients.size());
+	for (auto& client : clients) {
+		client.peer->Shutdown(0);
+		RakNetworkFactory::DestroyRakPeerInterface(client.peer);
+	}
+
+	std::printf("Finished in %.2fs: %zu answered (%.1f per second), %u failed to connect, %u timed out\n",
+		elapsed, loginTimes.size(), loginTimes.size() / elapsed, failedConnections, timedOut);
+	for (const auto& [response, count] : responses) {
+		std::printf("  response %u: %u\n", static_cast<uint32_t>(response), count);
+	}
+	std::printf("Connect ms: p50 %.1f, p99 %.1f\n", Percentile(connectTimes, 0.5), Percentile(connectTimes, 0.99));
+	std::printf("Login ms:   p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+		Percentile(loginTimes, 0.5), Percentile(loginTimes, 0.9), Percentile(loginTimes, 0.99), Percentile(loginTimes, 1.0));
+
+	return timedOut == 0 && failedConnections == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,248 @@
+// Pretends to be several world server hosts connected to a running master, then asks master for zone
+// transfers and reports which host each player was sent to.  The simulated world servers report a CPU load
+// that is higher on each following host and grows with every player they get, so a load aware placement
+// policy should spread players so that the hosts end up about equally busy.
+//
+// Run master with prestart_servers=0 so the only instances of the zone are the simulated ones, and
+// compare instance_placement=least_loaded against instance_placement=first_fit.
+//
+// Usage: PlacementHarness [hosts] [instances per host] [transfers] [zone] [master ip] [master port]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dCommonVars.h"
+#include "dServer.h"
+#include "BitStreamUtils.h"
+#include "GeneralUtils.h"
+#include "eConnectionType.h"
+#include "MessageType/Master.h"
+
+#include "RakNetworkFactory.h"
+#include "RakPeerInterface.h"
+#include "MessageIdentifiers.h"
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr auto TIMEOUT = std::chrono::seconds(60);
+	constexpr auto LOAD_REPORT_INTERVAL = std::chrono::milliseconds(250);
+	constexpr auto TRANSFER_INTERVAL = std::chrono::milliseconds(100);
+
+	// A frame at 60 frames per second, and the CPU time an instance uses per frame before and per player.
+	constexpr int64_t FRAME_TIME = 16'666'667;
+	constexpr int64_t BASE_CPU_TIME = 2'000'000;
+	constexpr int64_t PLAYER_CPU_TIME = 1'000'000;
+
+	struct SimulatedWorld {
+		RakPeerInterface* peer = nullptr;
+		SystemAddress master = UNASSIGNED_SYSTEM_ADDRESS;
+		std::string ip;
+		uint32_t hostIndex = 0;
+		uint32_t port = 0;
+		LWOINSTANCEID instanceID = 0;
+		uint32_t players = 0;
+		bool ready = false;
+		Clock::time_point lastLoadReport;
+	};
+
+	RakPeerInterface* Connect(const std::string& masterIP, const uint16_t masterPort) {
+		auto* peer = RakNetworkFactory::GetRakPeerInterface();
+		auto socket = SocketDescriptor(0, 0);
+		peer->Startup(1, 10, &socket, 1);
+		peer->Connect(masterIP.c_str(), masterPort, "3.25 DARKFLAME1", 15);
+		return peer;
+	}
+
+	void SendServerInfo(const SimulatedWorld& world, const LWOMAPID zoneID) {
+		RakNet::BitStream bitStream;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::SERVER_INFO);
+		bitStream.Write<int32_t>(world.port);
+		bitStream.Write<uint32_t>(zoneID);
+		bitStream.Write<int32_t>(world.instanceID);
+		bitStream.Write(ServerType::World);
+		bitStream.Write(LUString(world.ip));
+		world.peer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, world.master, false);
+
+		bitStream.Reset();
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::WORLD_READY);
+		bitStream.Write<LWOMAPID>(zoneID);
+		bitStream.Write<LWOINSTANCEID>(world.instanceID);
+		world.peer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, world.master, false);
+	}
+
+	void SendLoad(const SimulatedWorld& world, const LWOMAPID zoneID) {
+		const int64_t cpuTime = BASE_CPU_TIME * (world.hostIndex + 1) + PLAYER_CPU_TIME * world.players;
+
+		RakNet::BitStream bitStream;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::WORLD_LOAD);
+		bitStream.Write<LWOMAPID>(zoneID);
+		bitStream.Write<LWOINSTANCEID>(world.instanceID);
+		bitStream.Write<uint32_t>(world.players);
+		bitStream.Write<int64_t>(cpuTime);
+		bitStream.Write<int64_t>(FRAME_TIME);
+		bitStream.Write<uint64_t>(100'000'000ULL + world.players * 5'000'000ULL);
+		world.peer->Send(&bitStream, HIGH_PRIORITY, RELIABLE_ORDERED, 0, world.master, false);
+	}
+
+	void SendPlayerAdded(const SimulatedWorld& world, const LWOMAPID zoneID) {
+		RakNet::BitStream bitStream;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::PLAYER_ADDED);
+		bitStream.Write<LWOMAPID>(zoneID);
+		bitStream.Write<LWOINSTANCEID>(world.instanceID);
+		world.peer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, world.master, false);
+	}
+
+	void SendZoneTransferRequest(RakPeerInterface* peer, const SystemAddress& master, const uint64_t requestID, const LWOMAPID zoneID) {
+		RakNet::BitStream bitStream;
+		BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::REQUEST_ZONE_TRANSFER);
+		bitStream.Write(requestID);
+		bitStream.Write<uint8_t>(false);
+		bitStream.Write<uint32_t>(zoneID);
+		bitStream.Write<uint32_t>(0);
+		peer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, master, false);
+	}
+
+	bool IsMasterPacket(const Packet* packet, const MessageType::Master type) {
+		return packet->length >= 8 && packet->data[0] == ID_USER_PACKET_ENUM
+			&& static_cast<eConnectionType>(packet->data[1]) == eConnectionType::MASTER
+			&& packet->data[3] == static_cast<uint8_t>(type);
+	}
+}
+
+int main(int argc, char** argv) {
+	const uint32_t hosts = std::max(1U, argc > 1 ? GeneralUtils::TryParse<uint32_t>(argv[1]).value_or(3) : 3);
+	const uint32_t instancesPerHost = std::max(1U, argc > 2 ? GeneralUtils::TryParse<uint32_t>(argv[2]).value_or(2) : 2);
+	const uint32_t transfers = argc > 3 ? GeneralUtils::TryParse<uint32_t>(argv[3]).value_or(hosts * instancesPerHost * 10) : hosts * instancesPerHost * 10;
+	const LWOMAPID zoneID = argc > 4 ? GeneralUtils::TryParse<LWOMAPID>(argv[4]).value_or(1100) : 1100;
+	const std::string masterIP = argc > 5 ? argv[5] : "localhost";
+	const uint16_t masterPort = argc > 6 ? GeneralUtils::TryParse<uint16_t>(argv[6]).value_or(2000) : 2000;
+
+	std::printf("Simulating %u hosts with %u instances of zone %u each, sending %u transfers through %s:%u\n",
+		hosts, instancesPerHost, zoneID, transfers, masterIP.c_str(), masterPort);
+
+	std::vector<SimulatedWorld> worlds;
+	for (uint32_t i = 0; i < hosts; i++) {
+		for (uint32_t k = 0; k < instancesPerHost; k++) {
+			auto& world = worlds.emplace_back();
+			world.ip = "127.0.0." + std::to_string(i + 2);
+			world.hostIndex = i;
+			world.port = 40000 + i * 100 + k;
+			world.instanceID = 1000 + i * 100 + k;
+			world.peer = Connect(masterIP, masterPort);
+		}
+	}
+
+	auto* player = Connect(masterIP, masterPort);
+	SystemAddress playerMaster = UNASSIGNED_SYSTEM_ADDRESS;
+
+	std::map<std::string, uint32_t> transfersPerHost;
+	uint64_t nextRequestID = 1;
+	uint32_t answered = 0;
+	Clock::time_point lastTransfer;
+	Clock::time_point allReadyAt;
+	const auto testStart = Clock::now();
+
+	while (answered < transfers && Clock::now() - testStart < TIMEOUT) {
+		const auto now = Clock::now();
+
+		for (auto& world : worlds) {
+			for (auto* packet = world.peer->Receive(); packet; world.peer->DeallocatePacket(packet), packet = world.peer->Receive()) {
+				if (packet->data[0] == ID_CONNECTION_REQUEST_ACCEPTED) {
+					world.master = packet->systemAddress;
+					world.ready = true;
+					SendServerInfo(world, zoneID);
+					SendLoad(world, zoneID);
+					world.lastLoadReport = now;
+				} else if (IsMasterPacket(packet, MessageType::Master::AFFIRM_TRANSFER_REQUEST)) {
+					RakNet::BitStream inStream(packet->data, packet->length, false);
+					uint64_t header = inStream.Read(header);
+					uint64_t requestID = 0;
+					inStream.Read(requestID);
+
+					RakNet::BitStream bitStream;
+					BitStreamUtils::WriteHeader(bitStream, eConnectionType::MASTER, MessageType::Master::AFFIRM_TRANSFER_RESPONSE);
+					bitStream.Write(requestID);
+					world.peer->Send(&bitStream, SYSTEM_PRIORITY, RELIABLE_ORDERED, 0, world.master, false);
+
+					// The player arrives right away and makes the instance busier.
+					world.players++;
+					SendPlayerAdded(world, zoneID);
+				}
+			}
+
+			if (world.ready && now - world.lastLoadReport >= LOAD_REPORT_INTERVAL) {
+				SendLoad(world, zoneID);
+				world.lastLoadReport = now;
+			}
+		}
+
+		for (auto* packet = player->Receive(); packet; player->DeallocatePacket(packet), packet = player->Receive()) {
+			if (packet->data[0] == ID_CONNECTION_REQUEST_ACCEPTED) {
+				playerMaster = packet->systemAddress;
+			} else if (IsMasterPacket(packet, MessageType::Master::REQUEST_ZONE_TRANSFER_RESPONSE)) {
+				RakNet::BitStream inStream(packet->data, packet->length, false);
+				uint64_t header = inStream.Read(header);
+				uint64_t requestID = 0;
+				uint8_t mythranShift = 0;
+				uint32_t zone = 0;
+				uint32_t instance = 0;
+				uint32_t clone = 0;
+				uint16_t port = 0;
+				LUString ip(255);
+				inStream.Read(requestID);
+				inStream.Read(mythranShift);
+				inStream.Read(zone);
+				inStream.Read(instance);
+				inStream.Read(clone);
+				inStream.Read(port);
+				inStream.Read(ip);
+
+				transfersPerHost[ip.string]++;
+				answered++;
+			}
+		}
+
+		const bool allReady = playerMaster != UNASSIGNED_SYSTEM_ADDRESS
+			&& std::all_of(worlds.begin(), worlds.end(), [](const SimulatedWorld& world) { return world.ready; });
+		if (allReady && allReadyAt == Clock::time_point{}) allReadyAt = now;
+
+		// Give master time to register every instance and receive a load report from it before sending players.
+		const bool settled = allReady && now - allReadyAt >= std::chrono::seconds(1);
+		if (settled && nextRequestID <= transfers && now - lastTransfer >= TRANSFER_INTERVAL) {
+			SendZoneTransferRequest(player, playerMaster, nextRequestID++, zoneID);
+			lastTransfer = now;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	std::printf("%u of %u transfers answered in %.2fs\n", answered, transfers, std::chrono::duration<double>(Clock::now() - testStart).count());
+	for (uint32_t i = 0; i < hosts; i++) {
+		const auto ip = "127.0.0." + std::to_string(i + 2);
+		uint32_t players = 0;
+		for (const auto& world : worlds) {
+			if (world.hostIndex == i) players += world.players;
+		}
+		const double cores = (static_cast<double>(BASE_CPU_TIME) * (i + 1) * instancesPerHost + static_cast<double>(PLAYER_CPU_TIME) * players) / FRAME_TIME;
+		std::printf("  host %s: %u transfers, %u players, %.2f cores busy\n", ip.c_str(), transfersPerHost[ip], players, cores);
+		transfersPerHost.erase(ip);
+	}
+	for (const auto& [ip, count] : transfersPerHost) {
+		std::printf("  other host %s: %u transfers\n", ip.c_str(), count);
+	}
+
+	for (auto& world : worlds) {
+		world.peer->Shutdown(0);
+		RakNetworkFactory::DestroyRakPeerInterface(world.peer);
+	}
+	player->Shutdown(0);
+	RakNetworkFactory::DestroyRakPeerInterface(player);
+
+	return answered == transfers ? EXIT_SUCCESS : EXIT_FAILURE;
+}
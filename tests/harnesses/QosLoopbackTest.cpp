@@ -0,0 +1,244 @@
+// Measures how long gameplay messages take to reach a client over a lossy link that also carries chat and bulk traffic.
+// A relay between a sending and a receiving peer on localhost drops a share of the datagrams in both directions and
+// delays the rest.  The test runs twice: once with every message on one ordering channel, the way dServer::Send
+// used to send them, and once with the priorities and channels GetSendParameters gives each class of message.
+// It fails if a gameplay message is lost, or if the 99th percentile gameplay latency with per class channels is over
+// the limit.
+//
+// Usage: QosLoopbackTest [seconds] [loss percent] [one way delay ms] [base port] [max gameplay p99 ms]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dServer.h"
+#include "GeneralUtils.h"
+
+#include "RakNetworkFactory.h"
+#include "RakPeerInterface.h"
+#include "MessageIdentifiers.h"
+#include "SocketLayer.h"
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr auto GAMEPLAY_INTERVAL = std::chrono::milliseconds(16);
+	constexpr auto CHAT_INTERVAL = std::chrono::milliseconds(200);
+	constexpr auto BULK_INTERVAL = std::chrono::milliseconds(500);
+	constexpr uint32_t GAMEPLAY_SIZE = 64;
+	constexpr uint32_t CHAT_SIZE = 200;
+	// About the size of a property's model list or a blueprint, split over several dozen datagrams.
+	constexpr uint32_t BULK_SIZE = 32 * 1024;
+	constexpr auto DRAIN_TIMEOUT = std::chrono::seconds(10);
+
+#ifdef _WIN32
+	using socklen_t = int;
+	void CloseSocket(SOCKET socket) { closesocket(socket); }
+#else
+	void CloseSocket(SOCKET socket) { close(socket); }
+#endif
+
+	struct Datagram {
+		Clock::time_point deliverAt;
+		sockaddr_in to{};
+		std::vector<char> data;
+	};
+
+	// Forwards datagrams between the server port and whoever else sends to the relay, dropping `loss` of them.
+	void RunRelay(const SOCKET socket, const uint16_t serverPort, const double loss, const Clock::duration delay, const std::atomic<bool>& stopping) {
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> roll(0.0, 1.0);
+
+		sockaddr_in server{};
+		server.sin_family = AF_INET;
+		server.sin_port = htons(serverPort);
+		server.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+		sockaddr_in client{};
+		bool hasClient = false;
+		// Every datagram gets the same delay, so a queue keeps them in delivery order.
+		std::deque<Datagram> pending;
+		char buffer[2048];
+
+		while (!stopping) {
+			sockaddr_in from{};
+			socklen_t fromLength = sizeof(from);
+			const auto received = recvfrom(socket, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&from), &fromLength);
+			const auto now = Clock::now();
+
+			if (received > 0) {
+				const bool fromServer = ntohs(from.sin_port) == serverPort;
+				if (!fromServer) {
+					client = from;
+					hasClient = true;
+				}
+
+				if ((!fromServer || hasClient) && roll(random) >= loss) {
+					auto& datagram = pending.emplace_back();
+					datagram.deliverAt = now + delay;
+					datagram.to = fromServer ? client : server;
+					datagram.data.assign(buffer, buffer + received);
+				}
+			}
+
+			while (!pending.empty() && pending.front().deliverAt <= now) {
+				const auto& datagram = pending.front();
+				sendto(socket, datagram.data.data(), static_cast<int>(datagram.data.size()), 0, reinterpret_cast<const sockaddr*>(&datagram.to), sizeof(datagram.to));
+				pending.pop_front();
+			}
+
+			if (received <= 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+
+	void SendTestMessage(RakPeerInterface* peer, const SystemAddress& client, const eQosClass qosClass, const uint32_t size, const bool useQos) {
+		RakNet::BitStream bitStream;
+		bitStream.Write<MessageID>(ID_USER_PACKET_ENUM);
+		bitStream.Write(qosClass);
+		bitStream.Write<int64_t>(Clock::now().time_since_epoch().count());
+		while (bitStream.GetNumberOfBytesUsed() < size) bitStream.Write<uint8_t>(0);
+
+		const auto parameters = GetSendParameters(useQos ? qosClass : eQosClass::GAMEPLAY);
+		peer->Send(&bitStream, parameters.priority, parameters.reliability, parameters.orderingChannel, client, false);
+	}
+
+	double Percentile(std::vector<double>& values, const double percentile) {
+		if (values.empty()) return 0.0;
+		std::sort(values.begin(), values.end());
+		const auto index = std::min(values.size() - 1, static_cast<size_t>(percentile * values.size()));
+		return values[index];
+	}
+
+	// Returns the 99th percentile gameplay latency in ms, or nothing if a gameplay message did not arrive.
+	std::optional<double> Run(const bool useQos, const std::chrono::seconds duration, const double loss, const Clock::duration delay, const uint16_t basePort) {
+		const uint16_t serverPort = basePort;
+		const uint16_t relayPort = basePort + 1;
+
+		auto* server = RakNetworkFactory::GetRakPeerInterface();
+		auto serverSocket = SocketDescriptor(serverPort, "127.0.0.1");
+		server->Startup(1, 10, &serverSocket, 1);
+		server->SetMaximumIncomingConnections(1);
+
+		const auto relaySocket = SocketLayer::Instance()->CreateBoundSocket(relayPort, false, "127.0.0.1");
+		std::atomic<bool> stopping = false;
+		std::thread relay(RunRelay, relaySocket, serverPort, loss, delay, std::cref(stopping));
+
+		auto* client = RakNetworkFactory::GetRakPeerInterface();
+		auto clientSocket = SocketDescriptor(0, "127.0.0.1");
+		client->Startup(1, 10, &clientSocket, 1);
+		client->Connect("127.0.0.1", relayPort, nullptr, 0);
+
+		std::map<eQosClass, std::vector<double>> latencies;
+		std::map<eQosClass, uint32_t> sent;
+		SystemAddress clientAddress = UNASSIGNED_SYSTEM_ADDRESS;
+		Clock::time_point start{};
+		Clock::time_point nextGameplay{}, nextChat{}, nextBulk{};
+		const auto connectStart = Clock::now();
+
+		while (true) {
+			const auto now = Clock::now();
+			const bool sending = clientAddress != UNASSIGNED_SYSTEM_ADDRESS && now - start < duration;
+
+			if (sending) {
+				if (now >= nextGameplay) {
+					SendTestMessage(server, clientAddress, eQosClass::GAMEPLAY, GAMEPLAY_SIZE, useQos);
+					sent[eQosClass::GAMEPLAY]++;
+					nextGameplay += GAMEPLAY_INTERVAL;
+				}
+				if (now >= nextChat) {
+					SendTestMessage(server, clientAddress, eQosClass::CHAT, CHAT_SIZE, useQos);
+					sent[eQosClass::CHAT]++;
+					nextChat += CHAT_INTERVAL;
+				}
+				if (now >= nextBulk) {
+					SendTestMessage(server, clientAddress, eQosClass::BULK, BULK_SIZE, useQos);
+					sent[eQosClass::BULK]++;
+					nextBulk += BULK_INTERVAL;
+				}
+			}
+
+			for (auto* packet = server->Receive(); packet; server->DeallocatePacket(packet), packet = server->Receive()) {
+				if (packet->data[0] != ID_NEW_INCOMING_CONNECTION) continue;
+				clientAddress = packet->systemAddress;
+				start = nextGameplay = nextChat = nextBulk = now;
+			}
+
+			for (auto* packet = client->Receive(); packet; client->DeallocatePacket(packet), packet = client->Receive()) {
+				if (packet->data[0] != ID_USER_PACKET_ENUM || packet->length < 10) continue;
+
+				RakNet::BitStream bitStream(packet->data, packet->length, false);
+				bitStream.IgnoreBytes(1);
+				eQosClass qosClass{};
+				int64_t sentAt = 0;
+				bitStream.Read(qosClass);
+				bitStream.Read(sentAt);
+
+				const auto latency = Clock::now() - Clock::time_point(Clock::duration(sentAt));
+				latencies[qosClass].push_back(std::chrono::duration<double, std::milli>(latency).count());
+			}
+
+			if (clientAddress == UNASSIGNED_SYSTEM_ADDRESS && now - connectStart > DRAIN_TIMEOUT) break;
+			if (clientAddress != UNASSIGNED_SYSTEM_ADDRESS && now - start >= duration) {
+				const bool drained = std::ranges::all_of(sent, [&latencies](const auto& pair) { return latencies[pair.first].size() >= pair.second; });
+				if (drained || now - start > duration + DRAIN_TIMEOUT) break;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		stopping = true;
+		relay.join();
+		CloseSocket(relaySocket);
+		client->Shutdown(0);
+		server->Shutdown(0);
+		RakNetworkFactory::DestroyRakPeerInterface(client);
+		RakNetworkFactory::DestroyRakPeerInterface(server);
+
+		if (clientAddress == UNASSIGNED_SYSTEM_ADDRESS) {
+			std::printf("%s: the client never connected through the relay\n", useQos ? "Per class channels" : "One channel");
+			return std::nullopt;
+		}
+
+		std::printf("%s:\n", useQos ? "Per class channels" : "One channel");
+		const std::map<eQosClass, const char*> names = { { eQosClass::GAMEPLAY, "gameplay" }, { eQosClass::CHAT, "chat" }, { eQosClass::BULK, "bulk" } };
+		for (const auto& [qosClass, name] : names) {
+			auto& values = latencies[qosClass];
+			std::printf("  %-8s %5zu of %5u arrived, ms: p50 %6.1f, p99 %6.1f, p99.9 %6.1f, max %6.1f\n", name, values.size(), sent[qosClass],
+				Percentile(values, 0.5), Percentile(values, 0.99), Percentile(values, 0.999), Percentile(values, 1.0));
+		}
+
+		auto& gameplay = latencies[eQosClass::GAMEPLAY];
+		if (gameplay.size() != sent[eQosClass::GAMEPLAY]) return std::nullopt;
+		return Percentile(gameplay, 0.99);
+	}
+};
+
+int main(int argc, char** argv) {
+	const auto seconds = argc > 1 ? GeneralUtils::TryParse<uint32_t>(argv[1]).value_or(10) : 10;
+	const auto lossPercent = argc > 2 ? GeneralUtils::TryParse<double>(argv[2]).value_or(2.0) : 2.0;
+	const auto delayMs = argc > 3 ? GeneralUtils::TryParse<uint32_t>(argv[3]).value_or(20) : 20;
+	const uint16_t basePort = argc > 4 ? GeneralUtils::TryParse<uint16_t>(argv[4]).value_or(2100) : 2100;
+	// At the defaults, per class channels measured between about 250 and 1200ms, and one channel about 2700 to 3200ms.
+	const auto maxGameplayP99 = argc > 5 ? GeneralUtils::TryParse<double>(argv[5]).value_or(1500.0) : 1500.0;
+
+	std::printf("Sending for %us through a relay that drops %.1f%% of datagrams and delays the rest by %ums\n", seconds, lossPercent, delayMs);
+
+	const auto duration = std::chrono::seconds(seconds);
+	const auto delay = std::chrono::milliseconds(delayMs);
+	// One channel is the baseline to compare against, so only lost messages fail it.
+	const auto oneChannel = Run(false, duration, lossPercent / 100.0, delay, basePort);
+	const auto perClass = Run(true, duration, lossPercent / 100.0, delay, basePort + 10);
+
+	const bool fastEnough = perClass && *perClass <= maxGameplayP99;
+	if (perClass && !fastEnough) std::printf("Gameplay p99 of %.1fms with per class channels is over the %.1fms limit\n", *perClass, maxGameplayP99);
+
+	return oneChannel && fastEnough ? EXIT_SUCCESS : EXIT_FAILURE;
+}
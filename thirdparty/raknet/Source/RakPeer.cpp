@@ -189,6 +189,8 @@ RakPeer::RakPeer()
 	bytesSentPerSecond = bytesReceivedPerSecond = 0;
 	endThreads = true;
 	isMainLoopThreadActive = false;
+	packetArrivalCallback = 0;
+	packetArrivalUserData = 0;
 	// isRecvfromThreadActive=false;
 	occasionalPing = false;
 	connectionSockets = 0;
@@ -2377,6 +2379,13 @@ void RakPeer::SetUnreliableTimeout(RakNetTime timeoutMS)
 		remoteSystemList[ i ].reliabilityLayer.SetUnreliableTimeout(unreliableTimeout);
 }
 
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::SetPacketArrivalCallback( void (*callback)(void *userData), void *userData )
+{
+	packetArrivalCallback=callback;
+	packetArrivalUserData=userData;
+}
+
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 /// Send a message to host, with the IP socket option TTL set to 3
 /// This message will not reach the host, but will open the router.
@@ -3983,6 +3992,8 @@ inline void RakPeer::AddPacketToProducer(Packet *p)
 	Packet **packetPtr=packetSingleProducerConsumer.WriteLock();
 	*packetPtr=p;
 	packetSingleProducerConsumer.WriteUnlock();
+	if (packetArrivalCallback)
+		packetArrivalCallback(packetArrivalUserData);
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void ProcessPortUnreachable( unsigned int binaryAddress, unsigned short port, RakPeer *rakPeer )
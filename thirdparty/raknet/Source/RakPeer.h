@@ -445,6 +445,14 @@ public:
 	/// \param[in] timeoutMS How many ms to wait before simply not sending an unreliable message.
 	void SetUnreliableTimeout(RakNetTime timeoutMS);
 
+	/// Set a function to call whenever the network thread queues a packet for Receive()
+	/// Lets a user thread sleep until there is something to read instead of polling.
+	/// The callback runs on the network thread, so it should only signal the user thread.
+	/// \pre Call before Startup()
+	/// \param[in] callback The function to call, or 0 to stop calling one
+	/// \param[in] userData Passed to the callback
+	void SetPacketArrivalCallback( void (*callback)(void *userData), void *userData );
+
 	/// Send a message to host, with the IP socket option TTL set to 3
 	/// This message will not reach the host, but will open the router.
 	/// \param[in] ttl Max hops of datagram
@@ -815,6 +823,8 @@ protected:
 	int defaultMTUSize;
 	bool trackFrequencyTable;
 	int threadSleepTimer;
+	void (*packetArrivalCallback)(void *userData);
+	void *packetArrivalUserData;
 
 	SOCKET *connectionSockets;
 	unsigned connectionSocketsLength;